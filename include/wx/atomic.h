@@ -21,6 +21,11 @@
 //  - wxAtomicDec must return a zero value if the value is zero once
 //  decremented else it must return any non-zero value (the true value is OK
 //  but not necessary).
+//  - wxAtomicCompareAndSwap must set the value to newValue and return true
+//  only if it was equal to oldValue, leaving it unchanged and returning false
+//  otherwise.
+//  - wxAtomicLoad and wxAtomicStore must be full memory barriers, i.e. no
+//  reads or writes can be reordered around them.
 
 #if wxUSE_THREADS
 
@@ -41,6 +46,43 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return __sync_sub_and_fetch(&value, 1);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value,
+                                    wxUint32 oldValue,
+                                    wxUint32 newValue)
+{
+    return __sync_bool_compare_and_swap(&value, oldValue, newValue);
+}
+
+#ifdef __ATOMIC_SEQ_CST
+
+// newer compilers provide __atomic builtins allowing to avoid using expensive
+// read-modify-write instructions just for reading the value
+inline wxUint32 wxAtomicLoad (wxUint32 &value)
+{
+    return __atomic_load_n(&value, __ATOMIC_SEQ_CST);
+}
+
+inline void wxAtomicStore (wxUint32 &value, wxUint32 newValue)
+{
+    __atomic_store_n(&value, newValue, __ATOMIC_SEQ_CST);
+}
+
+#else // !__ATOMIC_SEQ_CST
+
+inline wxUint32 wxAtomicLoad (wxUint32 &value)
+{
+    return __sync_fetch_and_add(&value, 0);
+}
+
+inline void wxAtomicStore (wxUint32 &value, wxUint32 newValue)
+{
+    __sync_synchronize();
+    *static_cast<volatile wxUint32 *>(&value) = newValue;
+    __sync_synchronize();
+}
+
+#endif // __ATOMIC_SEQ_CST/!__ATOMIC_SEQ_CST
+
 
 #elif defined(__WINDOWS__)
 
@@ -57,6 +99,25 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return InterlockedDecrement ((LONG*)&value);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value,
+                                    wxUint32 oldValue,
+                                    wxUint32 newValue)
+{
+    return InterlockedCompareExchange ((LONG*)&value,
+                                       (LONG)newValue,
+                                       (LONG)oldValue) == (LONG)oldValue;
+}
+
+inline wxUint32 wxAtomicLoad (wxUint32 &value)
+{
+    return InterlockedCompareExchange ((LONG*)&value, 0, 0);
+}
+
+inline void wxAtomicStore (wxUint32 &value, wxUint32 newValue)
+{
+    InterlockedExchange ((LONG*)&value, (LONG)newValue);
+}
+
 #elif defined(__DARWIN__)
 
 #include "libkern/OSAtomic.h"
@@ -70,6 +131,26 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return OSAtomicDecrement32 ((int32_t*)&value);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value,
+                                    wxUint32 oldValue,
+                                    wxUint32 newValue)
+{
+    return OSAtomicCompareAndSwap32Barrier (oldValue, newValue,
+                                            (int32_t*)&value);
+}
+
+inline wxUint32 wxAtomicLoad (wxUint32 &value)
+{
+    return OSAtomicAdd32Barrier (0, (int32_t*)&value);
+}
+
+inline void wxAtomicStore (wxUint32 &value, wxUint32 newValue)
+{
+    OSMemoryBarrier ();
+    *static_cast<volatile wxUint32 *>(&value) = newValue;
+    OSMemoryBarrier ();
+}
+
 #elif defined (__SOLARIS__)
 
 #include <atomic.h>
@@ -84,6 +165,23 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
     return atomic_add_32_nv ((uint32_t*)&value, (uint32_t)-1);
 }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value,
+                                    wxUint32 oldValue,
+                                    wxUint32 newValue)
+{
+    return atomic_cas_32 ((uint32_t*)&value, oldValue, newValue) == oldValue;
+}
+
+inline wxUint32 wxAtomicLoad (wxUint32 &value)
+{
+    return atomic_add_32_nv ((uint32_t*)&value, 0);
+}
+
+inline void wxAtomicStore (wxUint32 &value, wxUint32 newValue)
+{
+    atomic_swap_32 ((uint32_t*)&value, newValue);
+}
+
 #else // unknown platform
 
 // it will result in inclusion if the generic implementation code a bit later in this page
@@ -97,6 +195,20 @@ inline wxUint32 wxAtomicDec (wxUint32 &value)
 inline void wxAtomicInc (wxUint32 &value) { ++value; }
 inline wxUint32 wxAtomicDec (wxUint32 &value) { return --value; }
 
+inline bool wxAtomicCompareAndSwap (wxUint32 &value,
+                                    wxUint32 oldValue,
+                                    wxUint32 newValue)
+{
+    if ( value != oldValue )
+        return false;
+
+    value = newValue;
+    return true;
+}
+
+inline wxUint32 wxAtomicLoad (wxUint32 &value) { return value; }
+inline void wxAtomicStore (wxUint32 &value, wxUint32 newValue) { value = newValue; }
+
 #endif // !wxUSE_THREADS
 
 // ----------------------------------------------------------------------------
@@ -132,6 +244,28 @@ public:
         return --m_value;
     }
 
+    bool CompareAndSwap(wxInt32 oldValue, wxInt32 newValue)
+    {
+        wxCriticalSectionLocker lock(m_locker);
+        if ( m_value != oldValue )
+            return false;
+
+        m_value = newValue;
+        return true;
+    }
+
+    wxInt32 Load()
+    {
+        wxCriticalSectionLocker lock(m_locker);
+        return m_value;
+    }
+
+    void Store(wxInt32 newValue)
+    {
+        wxCriticalSectionLocker lock(m_locker);
+        m_value = newValue;
+    }
+
 private:
     volatile wxInt32  m_value;
     wxCriticalSection m_locker;
@@ -139,6 +273,13 @@ private:
 
 inline void wxAtomicInc(wxAtomicInt32 &value) { value.Inc(); }
 inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
+inline bool wxAtomicCompareAndSwap(wxAtomicInt32 &value,
+                                   wxInt32 oldValue,
+                                   wxInt32 newValue)
+    { return value.CompareAndSwap(oldValue, newValue); }
+inline wxInt32 wxAtomicLoad(wxAtomicInt32 &value) { return value.Load(); }
+inline void wxAtomicStore(wxAtomicInt32 &value, wxInt32 newValue)
+    { value.Store(newValue); }
 
 #else // !wxNEEDS_GENERIC_ATOMIC_OPS
 
@@ -146,6 +287,13 @@ inline wxInt32 wxAtomicDec(wxAtomicInt32 &value) { return value.Dec(); }
 
 inline void wxAtomicInc(wxInt32 &value) { wxAtomicInc((wxUint32&)value); }
 inline wxInt32 wxAtomicDec(wxInt32 &value) { return wxAtomicDec((wxUint32&)value); }
+inline bool wxAtomicCompareAndSwap(wxInt32 &value,
+                                   wxInt32 oldValue,
+                                   wxInt32 newValue)
+    { return wxAtomicCompareAndSwap((wxUint32&)value, oldValue, newValue); }
+inline wxInt32 wxAtomicLoad(wxInt32 &value) { return wxAtomicLoad((wxUint32&)value); }
+inline void wxAtomicStore(wxInt32 &value, wxInt32 newValue)
+    { wxAtomicStore((wxUint32&)value, newValue); }
 
 typedef wxInt32 wxAtomicInt32;
 
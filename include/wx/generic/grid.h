@@ -16,6 +16,7 @@
 #if wxUSE_GRID
 
 #include "wx/hashmap.h"
+#include "wx/vector.h"
 
 #include "wx/scrolwin.h"
 
@@ -890,6 +891,117 @@ private:
 
 
 
+// ------ wxGridColumnarTable
+//
+// Data table storing the values of each column contiguously using the column
+// type, which is much more compact and faster to access than the strings used
+// by wxGridStringTable for big tables of numbers
+//
+
+class wxGridColumnarTableColumn;
+
+class WXDLLIMPEXP_ADV wxGridColumnarTable : public wxGridTableBase
+{
+public:
+    wxGridColumnarTable();
+    wxGridColumnarTable( int numRows );
+    virtual ~wxGridColumnarTable();
+
+    // add columns storing values of the given type, which must be one of
+    // wxGRID_VALUE_STRING, wxGRID_VALUE_NUMBER, wxGRID_VALUE_FLOAT or
+    // wxGRID_VALUE_BOOL, optionally followed by the renderer parameters, e.g.
+    // "double:10,2"
+    bool InsertTypedCols( const wxString& typeName,
+                          size_t pos = 0, size_t numCols = 1 );
+    bool AppendTypedCols( const wxString& typeName, size_t numCols = 1 );
+
+    // bulk access to the values of the given number of rows of a single
+    // column starting at the given row, these functions fail if the column
+    // type doesn't correspond to the type of the values
+    bool GetColValuesAsLong( int col, int row, int count, long *values ) const;
+    bool GetColValuesAsDouble( int col, int row, int count, double *values ) const;
+    bool GetColValuesAsBool( int col, int row, int count, bool *values ) const;
+
+    bool SetColValuesAsLong( int col, int row, int count, const long *values );
+    bool SetColValuesAsDouble( int col, int row, int count, const double *values );
+    bool SetColValuesAsBool( int col, int row, int count, const bool *values );
+
+    // cache of the strings formatted by the renderers for a range of rows of
+    // a numeric column, typically the visible ones: GetFormattedValue() only
+    // returns true if the value was formatted using the same format and the
+    // cached strings are forgotten whenever the column values change
+    bool GetFormattedValue( int row, int col, const wxString& format,
+                            wxString *value ) const;
+    void SetFormattedValues( int col, int row, const wxString& format,
+                             const wxArrayString& values );
+
+    // these are pure virtual in wxGridTableBase
+    //
+    virtual int GetNumberRows() wxOVERRIDE { return static_cast<int>(m_numRows); }
+    virtual int GetNumberCols() wxOVERRIDE { return static_cast<int>(m_cols.size()); }
+    virtual wxString GetValue( int row, int col ) wxOVERRIDE;
+    virtual void SetValue( int row, int col, const wxString& s ) wxOVERRIDE;
+
+    // overridden functions from wxGridTableBase
+    //
+    virtual bool IsEmptyCell( int row, int col ) wxOVERRIDE;
+
+    virtual wxString GetTypeName( int row, int col ) wxOVERRIDE;
+    virtual bool CanGetValueAs( int row, int col, const wxString& typeName ) wxOVERRIDE;
+
+    virtual long GetValueAsLong( int row, int col ) wxOVERRIDE;
+    virtual double GetValueAsDouble( int row, int col ) wxOVERRIDE;
+    virtual bool GetValueAsBool( int row, int col ) wxOVERRIDE;
+
+    virtual void SetValueAsLong( int row, int col, long value ) wxOVERRIDE;
+    virtual void SetValueAsDouble( int row, int col, double value ) wxOVERRIDE;
+    virtual void SetValueAsBool( int row, int col, bool value ) wxOVERRIDE;
+
+    void Clear() wxOVERRIDE;
+    bool InsertRows( size_t pos = 0, size_t numRows = 1 ) wxOVERRIDE;
+    bool AppendRows( size_t numRows = 1 ) wxOVERRIDE;
+    bool DeleteRows( size_t pos = 0, size_t numRows = 1 ) wxOVERRIDE;
+
+    // these functions add string columns, use InsertTypedCols() and
+    // AppendTypedCols() to add columns of other types
+    bool InsertCols( size_t pos = 0, size_t numCols = 1 ) wxOVERRIDE;
+    bool AppendCols( size_t numCols = 1 ) wxOVERRIDE;
+    bool DeleteCols( size_t pos = 0, size_t numCols = 1 ) wxOVERRIDE;
+
+    void SetRowLabelValue( int row, const wxString& ) wxOVERRIDE;
+    void SetColLabelValue( int col, const wxString& ) wxOVERRIDE;
+    wxString GetRowLabelValue( int row ) wxOVERRIDE;
+    wxString GetColLabelValue( int col ) wxOVERRIDE;
+
+private:
+    // return the column with the given index or NULL if it's invalid
+    wxGridColumnarTableColumn *GetCol( int col ) const;
+
+    // return the column if the cell is valid, NULL otherwise
+    wxGridColumnarTableColumn *GetCellCol( int row, int col ) const;
+
+    // insert the columns without notifying the view, return false if the
+    // type is invalid
+    bool DoInsertTypedCols( const wxString& typeName,
+                            size_t pos, size_t numCols );
+
+    // send the given notification to the view, if any
+    void NotifyView( int id, int comInt1, int comInt2 = -1 );
+
+
+    size_t m_numRows;
+
+    wxVector<wxGridColumnarTableColumn *> m_cols;
+
+    // only used if the row labels were explicitly set, as in
+    // wxGridStringTable, column labels are stored in the columns themselves
+    wxArrayString m_rowLabels;
+
+    DECLARE_DYNAMIC_CLASS_NO_COPY( wxGridColumnarTable )
+};
+
+
+
 // ============================================================================
 //  Grid view classes
 // ============================================================================
@@ -13,6 +13,8 @@
 
 #include "wx/defs.h"
 
+#include "wx/vector.h"
+
 #if wxUSE_GRID
 
 // Internally used (and hence intentionally not exported) event telling wxGrid
@@ -26,57 +28,6 @@ wxDECLARE_EVENT( wxEVT_GRID_HIDE_EDITOR, wxCommandEvent );
 WX_DEFINE_ARRAY_WITH_DECL_PTR(wxGridCellAttr *, wxArrayAttrs,
                                  class WXDLLIMPEXP_ADV);
 
-struct wxGridCellWithAttr
-{
-    wxGridCellWithAttr(int row, int col, wxGridCellAttr *attr_)
-        : coords(row, col), attr(attr_)
-    {
-        wxASSERT( attr );
-    }
-
-    wxGridCellWithAttr(const wxGridCellWithAttr& other)
-        : coords(other.coords),
-          attr(other.attr)
-    {
-        attr->IncRef();
-    }
-
-    wxGridCellWithAttr& operator=(const wxGridCellWithAttr& other)
-    {
-        coords = other.coords;
-        if (attr != other.attr)
-        {
-            attr->DecRef();
-            attr = other.attr;
-            attr->IncRef();
-        }
-        return *this;
-    }
-
-    void ChangeAttr(wxGridCellAttr* new_attr)
-    {
-        if (attr != new_attr)
-        {
-            // "Delete" (i.e. DecRef) the old attribute.
-            attr->DecRef();
-            attr = new_attr;
-            // Take ownership of the new attribute, i.e. no IncRef.
-        }
-    }
-
-    ~wxGridCellWithAttr()
-    {
-        attr->DecRef();
-    }
-
-    wxGridCellCoords coords;
-    wxGridCellAttr  *attr;
-};
-
-WX_DECLARE_OBJARRAY_WITH_DECL(wxGridCellWithAttr, wxGridCellWithAttrArray,
-                              class WXDLLIMPEXP_ADV);
-
-
 // ----------------------------------------------------------------------------
 // private classes
 // ----------------------------------------------------------------------------
@@ -408,19 +359,60 @@ private:
 // ----------------------------------------------------------------------------
 
 // this class stores attributes set for cells
+//
+// The attributes are kept in a sparse two level index: a vector of the rows
+// having at least one cell attribute, sorted by row number, each of them
+// containing a vector of (column, attribute) pairs sorted by column. This
+// makes looking up the attribute of a cell logarithmic in the number of rows
+// and columns having attributes instead of linear in the total number of
+// attributes and also allows inserting or deleting rows without touching the
+// attributes themselves: only the row numbers of the following rows change.
 class WXDLLIMPEXP_ADV wxGridCellAttrData
 {
 public:
+    wxGridCellAttrData() { }
+    ~wxGridCellAttrData();
+
     void SetAttr(wxGridCellAttr *attr, int row, int col);
     wxGridCellAttr *GetAttr(int row, int col) const;
     void UpdateAttrRows( size_t pos, int numRows );
     void UpdateAttrCols( size_t pos, int numCols );
 
 private:
-    // searches for the attr for given cell, returns wxNOT_FOUND if not found
-    int FindIndex(int row, int col) const;
+    // attribute of a single cell, the attribute is owned by us
+    struct CellAttr
+    {
+        int col;
+        wxGridCellAttr *attr;
+    };
+
+    typedef wxVector<CellAttr> CellAttrs;
+
+    // all the cell attributes of a single row
+    struct RowAttrs
+    {
+        explicit RowAttrs(int row_) : row(row_) { }
+
+        int row;
+        CellAttrs cells;
+    };
+
+    typedef wxVector<RowAttrs *> Rows;
+
+    // return the index of the first row entry with row number greater or
+    // equal to the given one (may be equal to m_rows.size())
+    size_t LowerBoundRow(int row) const;
+
+    // same for the cells of the given row
+    static size_t LowerBoundCol(const CellAttrs& cells, int col);
+
+    // DecRef() all the attributes of the given cells
+    static void FreeCells(CellAttrs& cells, size_t first, size_t last);
+
+
+    Rows m_rows;
 
-    wxGridCellWithAttrArray m_attrs;
+    wxDECLARE_NO_COPY_CLASS(wxGridCellAttrData);
 };
 
 // this class stores attributes set for rows or columns
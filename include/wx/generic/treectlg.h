@@ -247,6 +247,10 @@ protected:
                         *m_hilightUnfocusedBrush;
     bool                 m_hasFocus;
     bool                 m_dirty;
+    // The positions of all items after this one, in display order, need to
+    // be recalculated, or NULL if they are all up to date. This item itself
+    // is always already positioned correctly, unless it is the root one.
+    wxGenericTreeItem   *m_dirtyItem;
     bool                 m_ownsImageListButtons;
     bool                 m_isDragging; // true between BEGIN/END drag events
     bool                 m_lastOnSame;  // last click on the same item as prev
@@ -303,6 +307,11 @@ protected:
                                       int image,
                                       int selectedImage,
                                       wxTreeItemData *data) wxOVERRIDE;
+    virtual void DoInsertItems(const wxTreeItemId& parent,
+                               size_t pos,
+                               const wxArrayString& texts,
+                               int image, int selImage,
+                               wxArrayTreeItemIds *ids) wxOVERRIDE;
     virtual wxTreeItemId DoInsertAfter(const wxTreeItemId& parent,
                                        const wxTreeItemId& idPrevious,
                                        const wxString& text,
@@ -321,11 +330,24 @@ protected:
     void CalculateLineHeight();
     int  GetLineHeight(wxGenericTreeItem *item) const;
     void PaintLevel( wxGenericTreeItem *item, wxDC& dc, int level, int &y );
+    void PaintChildren( wxGenericTreeItem *item, wxDC& dc, int level, int &y );
     void PaintItem( wxGenericTreeItem *item, wxDC& dc);
 
     void CalculateLevel( wxGenericTreeItem *item, wxDC &dc, int level, int &y );
+
+    // Recalculate the positions of the items which need it, i.e. those after
+    // m_dirtyItem, if any.
     void CalculatePositions();
 
+    // Mark the positions of all items after the given one as needing to be
+    // recalculated, or of all of them if it's NULL. This does nothing if the
+    // item is not currently shown, as its position can't affect anything
+    // then.
+    void InvalidatePositions(wxGenericTreeItem *item = NULL);
+
+    // Called when the size of the given item changes.
+    void UpdateItemHeight(wxGenericTreeItem *item);
+
     void RefreshSubtree( wxGenericTreeItem *item );
     void RefreshLine( wxGenericTreeItem *item );
 
@@ -890,6 +890,13 @@ private:
     DECLARE_ABSTRACT_CLASS(wxGraphicsRenderer)
 };
 
+#if wxUSE_CAIRO
+// get the number of cache hits and misses for the text layouts used by the
+// Cairo renderer for drawing and measuring text, for profiling purposes
+WXDLLIMPEXP_CORE void wxGetCairoTextCacheStats(unsigned long *hits,
+                                               unsigned long *misses);
+#endif // wxUSE_CAIRO
+
 
 #if wxUSE_IMAGE
 inline
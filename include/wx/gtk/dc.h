@@ -86,6 +86,7 @@ public:
     wxMemoryDCImpl(wxMemoryDC* owner);
     wxMemoryDCImpl(wxMemoryDC* owner, wxBitmap& bitmap);
     wxMemoryDCImpl(wxMemoryDC* owner, wxDC* dc);
+    virtual ~wxMemoryDCImpl();
     virtual wxBitmap DoGetAsBitmap(const wxRect* subrect) const wxOVERRIDE;
     virtual void DoSelect(const wxBitmap& bitmap) wxOVERRIDE;
     virtual const wxBitmap& GetSelectedBitmap() const wxOVERRIDE;
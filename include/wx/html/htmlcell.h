@@ -428,6 +428,8 @@ protected:
 };
 
 
+class wxHtmlContainerIndex;
+
 // Container contains other cells, thus forming tree structure of rendering
 // elements. Basic code of layout algorithm is contained in this class.
 class WXDLLIMPEXP_HTML wxHtmlContainerCell : public wxHtmlCell
@@ -449,6 +451,10 @@ public:
     // insert cell at the end of m_Cells list
     void InsertCell(wxHtmlCell *cell);
 
+    // forget the cached layout of this container and all its parents, so that
+    // the next Layout() call recomputes it even if the width didn't change
+    void InvalidateLayout();
+
     // sets horizontal/vertical alignment
     void SetAlignHor(int al) {m_AlignHor = al; m_LastLayout = -1;}
     int GetAlignHor() const {return m_AlignHor;}
@@ -540,6 +546,12 @@ protected:
     int m_MaxTotalWidth;
             // Maximum possible length if ignoring line wrap
 
+private:
+    wxHtmlContainerIndex *m_index;
+            // data computed during the last layout and used to speed up
+            // drawing and hit testing, may be NULL
+
+    friend class wxHtmlContainerIndex;
 
     DECLARE_ABSTRACT_CLASS(wxHtmlContainerCell)
     wxDECLARE_NO_COPY_CLASS(wxHtmlContainerCell);
@@ -565,6 +577,8 @@ protected:
     wxColour m_Colour;
     unsigned m_Flags;
 
+    friend class wxHtmlContainerIndex;
+
     DECLARE_ABSTRACT_CLASS(wxHtmlColourCell)
     wxDECLARE_NO_COPY_CLASS(wxHtmlColourCell);
 };
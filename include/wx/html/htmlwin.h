@@ -126,6 +126,15 @@ public:
         Returns mouse cursor of given @a type.
      */
     virtual wxCursor GetHTMLCursor(HTMLCursor type) const = 0;
+
+    /**
+        Called periodically while parsing a long document if the parser
+        progress notifications are enabled.
+
+        @param cell the top level cell of the part of the document parsed
+                    so far, it is still being modified by the parser
+     */
+    virtual void OnHTMLParsingProgress(wxHtmlContainerCell *WXUNUSED(cell)) { }
 };
 
 /**
@@ -313,6 +322,20 @@ public:
     // Sets space between text and window borders.
     void SetBorders(int b) {m_Borders = b;}
 
+    // Show the top of the pages being loaded as soon as it has been parsed,
+    // without waiting until the entire page is parsed.
+    void EnableProgressiveRendering(bool enable = true)
+        { m_progressiveRendering = enable; }
+    bool IsProgressiveRenderingEnabled() const
+        { return m_progressiveRendering; }
+
+    // Set the delay, in milliseconds, after which the part of the page parsed
+    // so far is shown for the first time when progressive rendering is on.
+    void SetProgressiveRenderingDelay(int delay)
+        { m_progressiveRenderingDelay = delay; }
+    int GetProgressiveRenderingDelay() const
+        { return m_progressiveRenderingDelay; }
+
     // Sets the bitmap to use for background (currnetly it will be tiled,
     // when/if we have CSS support we could add other possibilities...)
     void SetBackgroundImage(const wxBitmap& bmpBg) { m_bmpBg = bmpBg; }
@@ -461,6 +484,7 @@ public:
     virtual void SetHTMLBackgroundImage(const wxBitmap& bmpBg) wxOVERRIDE;
     virtual void SetHTMLStatusText(const wxString& text) wxOVERRIDE;
     virtual wxCursor GetHTMLCursor(HTMLCursor type) const wxOVERRIDE;
+    virtual void OnHTMLParsingProgress(wxHtmlContainerCell *cell) wxOVERRIDE;
 
     // implementation of SetPage()
     bool DoSetPage(const wxString& source);
@@ -531,6 +555,12 @@ private:
     // (in order to avoid ugly blinking)
     int m_tmpCanDrawLocks;
 
+    // if true, the page is shown while it's still being parsed
+    bool m_progressiveRendering;
+
+    // delay before showing the page being parsed for the first time, in ms
+    int m_progressiveRenderingDelay;
+
     // list of HTML filters
     static wxList m_Filters;
     // this filter is used when no filter is able to read some file
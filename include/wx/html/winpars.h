@@ -17,6 +17,7 @@
 #include "wx/html/htmlpars.h"
 #include "wx/html/htmlcell.h"
 #include "wx/encconv.h"
+#include "wx/time.h"
 
 class WXDLLIMPEXP_FWD_HTML wxHtmlWindow;
 class WXDLLIMPEXP_FWD_HTML wxHtmlWindowInterface;
@@ -162,6 +163,12 @@ public:
     void SetWhitespaceMode(WhitespaceMode mode) { m_whitespaceMode = mode; }
     WhitespaceMode GetWhitespaceMode() const { return m_whitespaceMode; }
 
+    // If interval is positive, wxHtmlWindowInterface::OnHTMLParsingProgress()
+    // is called after this many milliseconds of parsing and then again with
+    // the interval doubled every time. 0 disables these notifications.
+    void SetProgressInterval(int interval) { m_progressInterval = interval; }
+    int GetProgressInterval() const { return m_progressInterval; }
+
 protected:
     virtual void AddText(const wxString& txt) wxOVERRIDE;
 
@@ -171,6 +178,7 @@ private:
     void AddWord(const wxString& word)
         { AddWord(new wxHtmlWordCell(word, *(GetDC()))); }
     void AddPreBlock(const wxString& text);
+    void NotifyProgressIfNeeded();
 
     bool m_tmpLastWasSpace;
     wxChar *m_tmpStrBuf;
@@ -239,6 +247,12 @@ private:
     // expand TABs; only updated while inside <pre>
     int m_posColumn;
 
+    // parsing progress notifications interval, 0 if disabled, the current
+    // interval and the time of the next notification
+    int m_progressInterval;
+    int m_progressDelay;
+    wxMilliClock_t m_nextProgress;
+
     wxDECLARE_NO_COPY_CLASS(wxHtmlWinParser);
 };
 
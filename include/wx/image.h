@@ -333,6 +333,11 @@ public:
     wxImage BlurHorizontal(int radius) const;
     wxImage BlurVertical(int radius) const;
 
+    // set the number of threads used by the resampling and blurring functions
+    // above, 1 by default, 0 meaning to use as many threads as CPUs
+    static void SetProcessingThreads(int count);
+    static int GetProcessingThreads();
+
     wxImage ShrinkBy( int xFactor , int yFactor ) const ;
 
     // rescales the image in place
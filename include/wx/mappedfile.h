@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/mappedfile.h
+// Purpose:     wxMappedFile and wxMappedInputStream: memory mapped files
+// Author:      wxWidgets team
+// Created:     2016-03-21
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_MAPPEDFILE_H_
+#define _WX_MAPPEDFILE_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_FILE
+
+#include "wx/string.h"
+
+#if wxUSE_STREAMS
+    #include "wx/mstream.h"
+#endif // wxUSE_STREAMS
+
+// ----------------------------------------------------------------------------
+// wxMappedFile: read-only view of the file contents in memory
+// ----------------------------------------------------------------------------
+
+// The file contents is mapped into the process address space, which means
+// that it's read from the disk on demand and is never copied. Mapping files
+// is only supported under Unix and MSW, Open() always fails elsewhere.
+class WXDLLIMPEXP_BASE wxMappedFile
+{
+public:
+    wxMappedFile() { Init(); }
+    explicit wxMappedFile(const wxString& filename)
+    {
+        Init();
+        Open(filename);
+    }
+
+    ~wxMappedFile() { Close(); }
+
+    // Map the given file, closing the previously opened one, if any. Returns
+    // false if the file couldn't be opened or mapped.
+    bool Open(const wxString& filename);
+
+    // Unmap the file, GetData() pointer can't be used any longer after this.
+    void Close();
+
+    bool IsOpened() const { return m_opened; }
+
+    // Return the file contents and its size. Notice that the data pointer
+    // may be NULL even for an opened file if it is empty.
+    const void *GetData() const { return m_data; }
+    size_t GetLength() const { return m_length; }
+
+private:
+    void Init()
+    {
+        m_data = NULL;
+        m_length = 0;
+        m_opened = false;
+    }
+
+    void *m_data;
+    size_t m_length;
+    bool m_opened;
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedFile);
+};
+
+#if wxUSE_STREAMS
+
+// ----------------------------------------------------------------------------
+// wxMappedInputStream: stream reading from a memory mapped file
+// ----------------------------------------------------------------------------
+
+// As this is a wxMemoryInputStream, the code using it can access the data
+// directly using GetCurrentData() instead of reading it.
+class WXDLLIMPEXP_BASE wxMappedInputStream : public wxMemoryInputStream
+{
+public:
+    explicit wxMappedInputStream(const wxString& filename);
+
+    virtual bool IsOk() const wxOVERRIDE
+    {
+        return m_file.IsOpened() && wxMemoryInputStream::IsOk();
+    }
+
+private:
+    wxMappedFile m_file;
+
+    wxDECLARE_NO_COPY_CLASS(wxMappedInputStream);
+};
+
+#endif // wxUSE_STREAMS
+
+#endif // wxUSE_FILE
+
+#endif // _WX_MAPPEDFILE_H_
@@ -18,6 +18,7 @@
 
 #if wxUSE_THREADS
 
+#include "wx/atomic.h"
 #include "wx/stopwatch.h"
 
 #include "wx/beforestd.h"
@@ -28,7 +29,8 @@ enum wxMessageQueueError
 {
     wxMSGQUEUE_NO_ERROR = 0, // operation completed successfully
     wxMSGQUEUE_TIMEOUT,      // no messages received before timeout expired
-    wxMSGQUEUE_MISC_ERROR    // some unexpected (and fatal) error has occurred
+    wxMSGQUEUE_MISC_ERROR,   // some unexpected (and fatal) error has occurred
+    wxMSGQUEUE_FULL          // no space left in a bounded queue
 };
 
 // ---------------------------------------------------------------------------
@@ -163,6 +165,284 @@ private:
     std::queue<T>   m_messages;
 };
 
+// ---------------------------------------------------------------------------
+// Bounded lock-free message queue.
+//
+// This class provides the same API as wxMessageQueue but, unlike it, doesn't
+// use any locks for posting and receiving messages, which makes it much more
+// scalable when many threads post messages to the same queue simultaneously.
+// The mutex and condition are only used for waiting for the new messages when
+// the queue is empty and for waking up the waiting threads.
+//
+// The price to pay for this is that the queue has a fixed capacity specified
+// when creating it and Post() fails with wxMSGQUEUE_FULL if it is exceeded.
+// Also, the message type T must be default constructible.
+//
+// The implementation uses the algorithm by Dmitry Vyukov, see
+// http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// ---------------------------------------------------------------------------
+template <typename T>
+class wxLockFreeMessageQueue
+{
+public:
+    // The type of the messages transported by this queue
+    typedef T Message;
+
+    // Create the queue able to hold at least the given number of messages
+    explicit wxLockFreeMessageQueue(size_t capacity)
+       : m_conditionNotEmpty(m_mutex)
+    {
+        // We need the size to be a power of 2 to be able to map the positions
+        // to the cells indices by just masking them.
+        size_t size = 2;
+        while ( size < capacity )
+            size <<= 1;
+
+        m_mask = size - 1;
+        m_cells = new Cell[size];
+        for ( size_t n = 0; n < size; n++ )
+            m_cells[n].sequence = static_cast<wxInt32>(n);
+
+        m_enqueuePos = 0;
+        m_dequeuePos = 0;
+        m_waiters = 0;
+    }
+
+    ~wxLockFreeMessageQueue()
+    {
+        delete [] m_cells;
+    }
+
+    // Return the maximal number of messages the queue can hold
+    size_t GetCapacity() const
+    {
+        return m_mask + 1;
+    }
+
+    // Add a message to this queue and signal the threads waiting for messages,
+    // if any. Returns wxMSGQUEUE_FULL if there is no space in the queue.
+    //
+    // This method is safe to call from multiple threads in parallel.
+    wxMessageQueueError Post(const Message& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        Cell* cell;
+        wxInt32 pos = wxAtomicLoad(m_enqueuePos);
+        for ( ;; )
+        {
+            cell = &m_cells[pos & m_mask];
+
+            const wxInt32 diff = Diff(wxAtomicLoad(cell->sequence), pos);
+            if ( diff == 0 )
+            {
+                // The cell is free, try to reserve it.
+                if ( wxAtomicCompareAndSwap(m_enqueuePos, pos, Next(pos, 1)) )
+                    break;
+            }
+            else if ( diff < 0 )
+            {
+                // The cell still contains the message posted during the
+                // previous pass over the queue.
+                return wxMSGQUEUE_FULL;
+            }
+
+            // Another thread has taken this cell, try the next one.
+            pos = wxAtomicLoad(m_enqueuePos);
+        }
+
+        cell->data = msg;
+
+        // Publish the message: this is a memory barrier, so the threads
+        // starting to wait after it will see the message and those that had
+        // started before it will be seen by the check below.
+        wxAtomicStore(cell->sequence, Next(pos, 1));
+
+        if ( wxAtomicLoad(m_waiters) > 0 )
+        {
+            wxMutexLocker locker(m_mutex);
+
+            wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+            m_conditionNotEmpty.Signal();
+        }
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Remove all messages from the queue.
+    //
+    // This method is meant to be called from the same thread(s) that call
+    // Post() to discard any still pending requests if they became unnecessary.
+    wxMessageQueueError Clear()
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        Message msg;
+        while ( TryReceive(msg) )
+            ;
+
+        return wxMSGQUEUE_NO_ERROR;
+    }
+
+    // Wait no more than timeout milliseconds until a message becomes available.
+    //
+    // Setting timeout to 0 means to return immediately if no message is
+    // available. See Receive().
+    wxMessageQueueError ReceiveTimeout(long timeout, T& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( TryReceive(msg) )
+            return wxMSGQUEUE_NO_ERROR;
+
+        if ( timeout <= 0 )
+            return wxMSGQUEUE_TIMEOUT;
+
+        return WaitForMessage(timeout, msg);
+    }
+
+    // Same as ReceiveTimeout() but waits for as long as it takes for a message
+    // to become available (so it can't return wxMSGQUEUE_TIMEOUT)
+    wxMessageQueueError Receive(T& msg)
+    {
+        wxCHECK( IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        if ( TryReceive(msg) )
+            return wxMSGQUEUE_NO_ERROR;
+
+        return WaitForMessage(-1, msg);
+    }
+
+    // Return false only if there was a fatal error in ctor
+    bool IsOk() const
+    {
+        return m_conditionNotEmpty.IsOk();
+    }
+
+private:
+    // A single slot of the queue: its sequence number is equal to its position
+    // in the queue if it's free, to its position plus 1 if it contains a
+    // message and is incremented by the queue size when the message is taken.
+    struct Cell
+    {
+        wxAtomicInt sequence;
+        Message data;
+    };
+
+    // The positions wrap around, so use unsigned arithmetic for them.
+    static wxInt32 Next(wxInt32 pos, wxUint32 offset)
+    {
+        return static_cast<wxInt32>(static_cast<wxUint32>(pos) + offset);
+    }
+
+    static wxInt32 Diff(wxInt32 seq, wxInt32 pos)
+    {
+        return static_cast<wxInt32>(static_cast<wxUint32>(seq) -
+                                    static_cast<wxUint32>(pos));
+    }
+
+    // Take the first message from the queue if there is any.
+    bool TryReceive(T& msg)
+    {
+        Cell* cell;
+        wxInt32 pos = wxAtomicLoad(m_dequeuePos);
+        for ( ;; )
+        {
+            cell = &m_cells[pos & m_mask];
+
+            const wxInt32 diff = Diff(wxAtomicLoad(cell->sequence), Next(pos, 1));
+            if ( diff == 0 )
+            {
+                // The cell contains a message, try to take it.
+                if ( wxAtomicCompareAndSwap(m_dequeuePos, pos, Next(pos, 1)) )
+                    break;
+            }
+            else if ( diff < 0 )
+            {
+                // The queue is empty.
+                return false;
+            }
+
+            // Another thread has taken this message, try the next one.
+            pos = wxAtomicLoad(m_dequeuePos);
+        }
+
+        msg = cell->data;
+
+        // Make the cell available for the next pass over the queue.
+        wxAtomicStore(cell->sequence, Next(pos, m_mask + 1));
+
+        return true;
+    }
+
+    // Slow path of Receive() and ReceiveTimeout(): block until a message is
+    // posted or the timeout, if it's not negative, expires.
+    wxMessageQueueError WaitForMessage(long timeout, T& msg)
+    {
+        wxMutexLocker locker(m_mutex);
+
+        wxCHECK( locker.IsOk(), wxMSGQUEUE_MISC_ERROR );
+
+        // Notice that we must check for the messages again after registering
+        // ourselves as a waiter, as a message could have been posted after
+        // the last check but before Post() could see us.
+        wxAtomicInc(m_waiters);
+
+        wxMessageQueueError rc = wxMSGQUEUE_NO_ERROR;
+        const wxMilliClock_t waitUntil = wxGetLocalTimeMillis() + timeout;
+        while ( !TryReceive(msg) )
+        {
+            const wxCondError result = timeout < 0
+                                        ? m_conditionNotEmpty.Wait()
+                                        : m_conditionNotEmpty.WaitTimeout(timeout);
+
+            if ( result == wxCOND_NO_ERROR )
+                continue;
+
+            if ( result != wxCOND_TIMEOUT )
+            {
+                rc = wxMSGQUEUE_MISC_ERROR;
+                break;
+            }
+
+            const wxMilliClock_t now = wxGetLocalTimeMillis();
+
+            if ( now >= waitUntil )
+            {
+                rc = wxMSGQUEUE_TIMEOUT;
+                break;
+            }
+
+            timeout = (waitUntil - now).ToLong();
+        }
+
+        wxAtomicDec(m_waiters);
+
+        return rc;
+    }
+
+    // Disable copy ctor and assignment operator
+    wxLockFreeMessageQueue(const wxLockFreeMessageQueue<T>& rhs);
+    wxLockFreeMessageQueue<T>& operator=(const wxLockFreeMessageQueue<T>& rhs);
+
+    Cell*           m_cells;
+    size_t          m_mask;
+
+    // The positions are modified by different threads, so keep them in
+    // different cache lines.
+    wxAtomicInt     m_enqueuePos;
+    char            m_padding1[64];
+    wxAtomicInt     m_dequeuePos;
+    char            m_padding2[64];
+
+    // The number of threads waiting for the messages in WaitForMessage().
+    wxAtomicInt     m_waiters;
+
+    mutable wxMutex m_mutex;
+    wxCondition     m_conditionNotEmpty;
+};
+
 #endif // wxUSE_THREADS
 
 #endif // _WX_MSGQUEUE_H_
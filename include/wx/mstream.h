@@ -44,7 +44,22 @@ public:
 
     wxStreamBuffer *GetInputStreamBuffer() const { return m_i_streambuf; }
 
+    // Return the pointer to the data which would be returned by the next call
+    // to Read() and fill len with its size, allowing to access it without
+    // copying. Use SeekI(wxFromCurrent) to skip over the data used.
+    //
+    // Returns NULL if the data can't be accessed directly because some of it
+    // was put back into the stream using Ungetch().
+    const void *GetCurrentData(size_t *len) const;
+
 protected:
+    // Default ctor can only be used by the derived classes which must call
+    // InitFromData() from their ctor.
+    wxMemoryInputStream() : m_i_streambuf(NULL), m_length(0) { }
+
+    // Set up the stream to read from the given memory, which is not copied.
+    void InitFromData(const void *data, size_t length);
+
     wxStreamBuffer *m_i_streambuf;
 
     size_t OnSysRead(void *buffer, size_t nbytes) wxOVERRIDE;
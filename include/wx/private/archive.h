@@ -0,0 +1,89 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/private/archive.h
+// Purpose:     Helper for extracting random access archives
+// Author:      wxWidgets team
+// Created:     2016-04-18
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_PRIVATE_ARCHIVE_H_
+#define _WX_PRIVATE_ARCHIVE_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_STREAMS && wxUSE_ARCHIVE_STREAMS
+
+#include "wx/archive.h"
+#include "wx/vector.h"
+
+class WXDLLIMPEXP_FWD_BASE wxThreadPool;
+
+// ----------------------------------------------------------------------------
+// wxArchiveExtractor: extracts all entries of an archive to a directory
+// ----------------------------------------------------------------------------
+
+// This is used by wxZipArchive::ExtractAll() and wxTarArchive::ExtractAll()
+// which add all the entries to extract to it and then call Run(), which
+// creates all the directories first, as doing it concurrently from several
+// threads could fail, and then extracts the files in parallel.
+class WXDLLIMPEXP_BASE wxArchiveExtractor
+{
+public:
+    wxArchiveExtractor(const wxString& dir, size_t count);
+    virtual ~wxArchiveExtractor() { }
+
+    // Add the entry with the given index: directories are just created while
+    // the files are extracted using ExtractEntry(). Entries pointing outside
+    // of the target directory are not extracted and make Run() fail.
+    void AddEntry(size_t n, const wxArchiveEntry& entry);
+
+    // Create the directories and extract all the files, using the given pool
+    // or the global one if it's NULL. Returns false if anything failed.
+    bool Run(wxThreadPool *pool);
+
+    // Extract the entry with the given index to the given file, this is called
+    // from several threads at once.
+    virtual bool ExtractEntry(size_t n, const wxString& path) const = 0;
+
+private:
+    const wxString m_dir;
+
+    // The paths of the files to extract indexed by the entry index, empty for
+    // the entries which are not extracted.
+    wxVector<wxString> m_paths;
+
+    // All the directories which need to exist.
+    wxVector<wxString> m_dirs;
+
+    bool m_ok;
+
+    wxDECLARE_NO_COPY_CLASS(wxArchiveExtractor);
+};
+
+// Implementation of wxArchiveExtractor for the archive classes providing
+// Extract(size_t n, const wxString& path) method.
+template <class ArchiveT>
+class wxArchiveExtractorFor : public wxArchiveExtractor
+{
+public:
+    wxArchiveExtractorFor(const ArchiveT& archive, const wxString& dir)
+        : wxArchiveExtractor(dir, archive.GetCount()),
+          m_archive(archive)
+    {
+    }
+
+    virtual bool ExtractEntry(size_t n, const wxString& path) const wxOVERRIDE
+    {
+        return m_archive.Extract(n, path);
+    }
+
+private:
+    const ArchiveT& m_archive;
+
+    wxDECLARE_NO_COPY_TEMPLATE_CLASS(wxArchiveExtractorFor, ArchiveT);
+};
+
+#endif // wxUSE_STREAMS && wxUSE_ARCHIVE_STREAMS
+
+#endif // _WX_PRIVATE_ARCHIVE_H_
@@ -19,7 +19,16 @@ enum wxFDIODispatcherEntryFlags
     wxFDIO_INPUT = 1,
     wxFDIO_OUTPUT = 2,
     wxFDIO_EXCEPTION = 4,
-    wxFDIO_ALL = wxFDIO_INPUT | wxFDIO_OUTPUT | wxFDIO_EXCEPTION
+    wxFDIO_ALL = wxFDIO_INPUT | wxFDIO_OUTPUT | wxFDIO_EXCEPTION,
+
+    // request edge-triggered notifications, i.e. only notify the handler when
+    // the descriptor becomes ready and not while it remains ready: this is
+    // more efficient but the handler must read or write all the data until
+    // getting EAGAIN then
+    //
+    // this is only a hint as it's only supported by wxEpollDispatcher, the
+    // others keep notifying the handler as long as the descriptor is ready
+    wxFDIO_EDGE_TRIGGERED = 8
 };
 
 // base class for wxSelectDispatcher and wxEpollDispatcher
@@ -163,6 +163,20 @@ public :
     virtual bool Contains( wxDouble x, wxDouble y, wxPolygonFillMode fillStyle = wxODDEVEN_RULE) const=0;
 };
 
+// Cairo renderer caches the surfaces created for the bitmaps drawn with
+// wxGraphicsContext::DrawBitmap(wxBitmap) under the ports which notify it
+// about the bitmaps changed in place, i.e. without un-sharing their data, by
+// calling wxCairoBitmapChanged() from wxBitmap::GetRawData() and
+// UngetRawData() and wxCairoBitmapSelected() when selecting the bitmap into
+// wxMemoryDC, which draws on it directly, and deselecting it. Selected
+// bitmaps are not cached at all.
+#if wxUSE_CAIRO && defined(__WXGTK__)
+    #define wxHAS_CAIRO_BITMAP_CACHE
+
+    extern void wxCairoBitmapChanged(const wxBitmap& bmp);
+    extern void wxCairoBitmapSelected(const wxBitmap& bmp, bool selected);
+#endif
+
 #endif
 
 #endif // _WX_GRAPHICS_PRIVATE_H_
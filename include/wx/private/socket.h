@@ -251,6 +251,16 @@ public:
     int Read(void *buffer, int size);
     int Write(const void *buffer, int size);
 
+    // scatter/gather IO using the given buffers, with the data starting at
+    // the given offset in the first of them: this uses a single system call
+    // for the stream sockets if possible and only reads or writes a single
+    // buffer otherwise, while for the datagram sockets the entire data is
+    // always received or sent as a single datagram
+    //
+    // the return value is the same as for Read() and Write()
+    int ReadV(const wxSocketBuffer *buffers, int count, wxUint32 offset);
+    int WriteV(const wxSocketBuffer *buffers, int count, wxUint32 offset);
+
     // basically a wrapper for select(): returns the condition of the socket,
     // blocking for not longer than timeout if it is specified (otherwise just
     // poll without blocking at all)
@@ -353,6 +363,8 @@ private:
     int RecvDgram(void *buffer, int size);
     int SendStream(const void *buffer, int size);
     int SendDgram(const void *buffer, int size);
+    int RecvStreamV(const wxSocketBuffer *buffers, int count, wxUint32 offset);
+    int SendStreamV(const wxSocketBuffer *buffers, int count, wxUint32 offset);
 
 
     // set in ctor and never changed except that it's reset to NULL when the
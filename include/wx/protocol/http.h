@@ -43,6 +43,11 @@ public:
     bool SetPostBuffer(const wxString& contentType, const wxMemoryBuffer& data);
     void SetProxyMode(bool on);
 
+    // keep the connection open after a request to reuse it for the next one,
+    // this is the default
+    void SetKeepAlive(bool keepAlive) { m_keepAlive = keepAlive; }
+    bool GetKeepAlive() const { return m_keepAlive; }
+
     /* Cookies */
     wxString GetCookie(const wxString& cookie) const;
     bool HasCookies() const { return m_cookies.size() > 0; }
@@ -56,6 +61,9 @@ protected:
     typedef wxStringToStringHashMap::iterator wxCookieIterator;
     typedef wxStringToStringHashMap::const_iterator wxCookieConstIterator;
 
+    // connect to m_addr, closing the current connection if any
+    bool ConnectToServer();
+
     bool BuildRequest(const wxString& path, const wxString& method);
     void SendHeaders();
     bool ParseHeaders();
@@ -78,13 +86,31 @@ protected:
     wxStringToStringHashMap m_cookies;
 
     wxStringToStringHashMap m_headers;
+
+    // the headers sent with the last request: m_headers contains the headers
+    // of the response after it has been received
+    wxStringToStringHashMap m_requestHeaders;
+
     bool m_read,
          m_proxy_mode;
+
+    // true if persistent connections should be used
+    bool m_keepAlive;
+
+    // true if the server agreed to keep the connection open after the
+    // current response
+    bool m_persistent;
+
+    // true if the connection is open and the previous response was entirely
+    // read, so that it can be used for the next request
+    bool m_reusable;
     wxSockAddress *m_addr;
     wxMemoryBuffer m_postBuffer;
     wxString       m_contentType;
     int m_http_response;
 
+    friend class wxHTTPStream;
+
     DECLARE_DYNAMIC_CLASS(wxHTTP)
     DECLARE_PROTOCOL(wxHTTP)
     wxDECLARE_NO_COPY_CLASS(wxHTTP);
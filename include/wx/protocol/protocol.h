@@ -116,6 +116,17 @@ public:
     void LogResponse(const wxString& str);
 
 protected:
+#if wxUSE_SOCKETS
+    // return true if some data was already read from the socket but not
+    // consumed yet, e.g. a part of the line which ReadLine() failed to read
+    bool HasUnreadData() const
+    {
+        wxUint32 size;
+        PeekPushback(&size);
+        return size != 0;
+    }
+#endif // wxUSE_SOCKETS
+
     // the timeout associated with the protocol:
     wxUint32        m_uiDefaultTimeout;
 
@@ -144,6 +144,8 @@ class WXDLLIMPEXP_FWD_RICHTEXT wxRichTextParagraphLayoutBox;
 class WXDLLIMPEXP_FWD_RICHTEXT wxRichTextImageBlock;
 class WXDLLIMPEXP_FWD_XML      wxXmlNode;
 class                          wxRichTextFloatCollector;
+class                          wxRichTextPlainTextExtents;
+class                          wxRichTextParagraphIndex;
 class WXDLLIMPEXP_FWD_BASE wxDataInputStream;
 class WXDLLIMPEXP_FWD_BASE wxDataOutputStream;
 
@@ -2212,7 +2214,7 @@ public:
     wxRichTextDrawingContext(wxRichTextBuffer* buffer);
 
     void Init()
-    { m_buffer = NULL; m_enableVirtualAttributes = true; m_enableImages = true; m_layingOut = false; m_enableDelayedImageLoading = false; }
+    { m_buffer = NULL; m_enableVirtualAttributes = true; m_enableImages = true; m_layingOut = false; m_enableDelayedImageLoading = false; m_enableTextExtentsCache = false; }
 
     /**
         Does this object have virtual attributes?
@@ -2306,11 +2308,25 @@ public:
 
     bool GetDelayedImageLoading() const { return m_enableDelayedImageLoading; }
 
+    /**
+        Enable or disable caching the extents of the text measured while laying
+        out, until wxRichTextPlainText::ClearExtentsCache() is called.
+    */
+
+    void EnableTextExtentsCache(bool b) { m_enableTextExtentsCache = b; }
+
+    /**
+        Returns @true if caching the text extents is enabled.
+    */
+
+    bool GetTextExtentsCacheEnabled() const { return m_enableTextExtentsCache; }
+
     wxRichTextBuffer*   m_buffer;
     bool                m_enableVirtualAttributes;
     bool                m_enableImages;
     bool                m_enableDelayedImageLoading;
     bool                m_layingOut;
+    bool                m_enableTextExtentsCache;
 };
 
 /**
@@ -3006,6 +3022,12 @@ public:
     */
     bool DeleteChildren() ;
 
+    /**
+        Called when the list of children changes. If you modify the list
+        returned by GetChildren() directly, call this function afterwards.
+    */
+    virtual void OnChildrenChanged() { }
+
     /**
         Recursively merges all pieces that can be merged.
     */
@@ -3045,6 +3067,10 @@ public:
 
     virtual int HitTest(wxDC& dc, wxRichTextDrawingContext& context, const wxPoint& pt, long& textPosition, wxRichTextObject** obj, wxRichTextObject** contextObj, int flags = 0);
 
+    virtual bool FindPosition(wxDC& dc, wxRichTextDrawingContext& context, long index, wxPoint& pt, int* height, bool forceLineStart);
+
+    virtual void OnChildrenChanged();
+
     virtual bool Draw(wxDC& dc, wxRichTextDrawingContext& context, const wxRichTextRange& range, const wxRichTextSelection& selection, const wxRect& rect, int descent, int style);
 
     virtual bool Layout(wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, const wxRect& parentRect, int style);
@@ -3623,6 +3649,13 @@ protected:
 
     // The floating layout state
     wxRichTextFloatCollector* m_floatCollector;
+
+    // Returns the index used to find the paragraphs by position, which is
+    // created on demand, or NULL if there are too few paragraphs to need it.
+    const wxRichTextParagraphIndex* GetParagraphIndex() const;
+
+    // The paragraphs index, reset whenever the children change
+    mutable wxRichTextParagraphIndex* m_paragraphIndex;
 };
 
 /**
@@ -4493,7 +4526,12 @@ public:
     /**
         Copy constructor.
     */
-    wxRichTextPlainText(const wxRichTextPlainText& obj): wxRichTextObject() { Copy(obj); }
+    wxRichTextPlainText(const wxRichTextPlainText& obj): wxRichTextObject() { m_extentsCache = NULL; Copy(obj); }
+
+    /**
+        Destructor.
+    */
+    virtual ~wxRichTextPlainText();
 
 // Overridables
 
@@ -4559,6 +4597,12 @@ public:
     */
     void SetText(const wxString& text) { m_text = text; }
 
+    /**
+        Frees the text extents cached while laying out this object with a
+        context with wxRichTextDrawingContext::EnableTextExtentsCache().
+    */
+    void ClearExtentsCache();
+
 // Operations
 
     // Copies the text object,
@@ -4572,6 +4616,11 @@ private:
 
 protected:
     wxString    m_text;
+
+    // The extents of the whole text computed by the last GetRangeSize() call,
+    // reused when laying out the same text again, e.g. for a different width,
+    // only allocated if the layout context enables it.
+    mutable wxRichTextPlainTextExtents* m_extentsCache;
 };
 
 /**
@@ -79,6 +79,8 @@ class WXDLLIMPEXP_FWD_RICHTEXT wxRichTextStyleDefinition;
 #define wxRICHTEXT_DEFAULT_DELAYED_LAYOUT_THRESHOLD 20000
 // Milliseconds before layout occurs after resize
 #define wxRICHTEXT_DEFAULT_LAYOUT_INTERVAL 50
+// Milliseconds spent on laying out a part of the buffer in each idle event
+#define wxRICHTEXT_DEFAULT_LAYOUT_PART_DURATION 30
 // Milliseconds before delayed image processing occurs
 #define wxRICHTEXT_DEFAULT_DELAYED_IMAGE_PROCESSING_INTERVAL 200
 
@@ -1423,6 +1425,13 @@ public:
     */
     virtual void DoLayoutBuffer(wxRichTextBuffer& buffer, wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, const wxRect& parentRect, int flags);
 
+    /**
+        Lays out the next part of the buffer when the delayed full layout is
+        being performed in idle time, keeping the text shown at the top of the
+        window in place. Returns @true if there is still more to lay out.
+    */
+    virtual bool LayoutNextPart();
+
     /**
         Move the caret to the given character position.
 
@@ -2383,6 +2392,12 @@ protected:
     wxLongLong              m_fullLayoutTime;
     long                    m_fullLayoutSavedPosition;
 
+    /// The start of the part of the buffer to lay out next in idle time and
+    /// the height of the part laid out at once, adjusted to take roughly
+    /// wxRICHTEXT_DEFAULT_LAYOUT_PART_DURATION
+    long                    m_fullLayoutNextPosition;
+    int                     m_fullLayoutPartHeight;
+
     /// Threshold for doing delayed layout
     long                    m_delayedLayoutThreshold;
 
@@ -24,6 +24,7 @@
 #include "wx/list.h"
 
 class wxSocketImpl;
+class wxSocketAsyncState;
 
 // ------------------------------------------------------------------------
 // Types and constants
@@ -106,6 +107,54 @@ enum wxSocketType
 };
 
 
+// buffer descriptor used for scatter/gather IO by wxSocketBase::ReadV() and
+// WriteV(): notice that the data is not modified by WriteV() even though the
+// pointer is not const, just as with POSIX iovec
+struct wxSocketBuffer
+{
+    wxSocketBuffer() : data(NULL), size(0) { }
+    wxSocketBuffer(const void *data_, wxUint32 size_)
+        : data(const_cast<void *>(data_)), size(size_) { }
+
+    void *data;
+    wxUint32 size;
+};
+
+
+class WXDLLIMPEXP_FWD_NET wxSocketBase;
+class WXDLLIMPEXP_FWD_NET wxSocketServer;
+
+// --------------------------------------------------------------------------
+// wxSocketAsyncHandler
+// --------------------------------------------------------------------------
+
+// base class for the objects notified about the completion of asynchronous
+// operations started by wxSocketBase::AsyncRead() and others
+//
+// the handlers are called from the event loop, when the socket becomes ready
+class WXDLLIMPEXP_NET wxSocketAsyncHandler
+{
+public:
+    wxSocketAsyncHandler() { }
+    virtual ~wxSocketAsyncHandler() { }
+
+    // called when AsyncRead() or AsyncWrite() completes with the number of
+    // bytes read or written, error is wxSOCKET_NOERROR if it succeeded
+    virtual void OnAsyncRead(wxSocketBase& WXUNUSED(socket),
+                             wxSocketError WXUNUSED(error),
+                             wxUint32 WXUNUSED(nbytes)) { }
+    virtual void OnAsyncWrite(wxSocketBase& WXUNUSED(socket),
+                              wxSocketError WXUNUSED(error),
+                              wxUint32 WXUNUSED(nbytes)) { }
+
+    // called when AsyncAccept() completes with the new socket which must be
+    // destroyed by the handler or NULL if an error occurred
+    virtual void OnAsyncAccept(wxSocketServer& WXUNUSED(server),
+                               wxSocketError WXUNUSED(error),
+                               wxSocketBase *WXUNUSED(socket)) { }
+};
+
+
 // event
 class WXDLLIMPEXP_FWD_NET wxSocketEvent;
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_NET, wxEVT_SOCKET, wxSocketEvent);
@@ -158,6 +207,31 @@ public:
     wxSocketBase& Write(const void *buffer, wxUint32 nbytes);
     wxSocketBase& WriteMsg(const void *buffer, wxUint32 nbytes);
 
+    // scatter/gather IO: read into or write from several buffers at once
+    wxSocketBase& ReadV(const wxSocketBuffer *buffers, unsigned count);
+    wxSocketBase& WriteV(const wxSocketBuffer *buffers, unsigned count);
+
+    // write buffering: if the buffer size is non-zero, the data written to
+    // the socket is accumulated in the buffer and only sent when it becomes
+    // full or when Flush() is called
+    void SetWriteBufferSize(wxUint32 size);
+    wxUint32 GetWriteBufferSize() const { return m_wbuf_alloc; }
+    bool Flush();
+
+    // asynchronous IO: these functions return immediately and the handler is
+    // notified when the operation completes, the buffer must remain valid
+    // until then; they return false if the operation couldn't be started
+    bool AsyncRead(void *buffer, wxUint32 nbytes,
+                   wxSocketAsyncHandler *handler);
+    bool AsyncWrite(const void *buffer, wxUint32 nbytes,
+                    wxSocketAsyncHandler *handler);
+    bool IsAsyncReadPending() const;
+    bool IsAsyncWritePending() const;
+
+    // cancel all pending asynchronous operations without notifying their
+    // handlers, this is done automatically by Close()
+    void CancelAsync();
+
     // all Wait() functions wait until their condition is satisfied or the
     // timeout expires; if seconds == -1 (default) then m_timeout value is used
     //
@@ -233,6 +307,40 @@ private:
     // low level IO
     wxUint32 DoRead(void* buffer, wxUint32 nbytes);
     wxUint32 DoWrite(const void *buffer, wxUint32 nbytes);
+    wxUint32 DoReadV(const wxSocketBuffer *buffers, unsigned count);
+    wxUint32 DoWriteV(const wxSocketBuffer *buffers, unsigned count);
+
+    // write the data using the write buffer if it's enabled
+    wxUint32 DoBufferedWrite(const wxSocketBuffer *buffers, unsigned count);
+
+    // write out as much of the write buffer contents as possible, return true
+    // if it's empty now
+    bool DoFlush();
+
+    // remove the given number of bytes from the start of the write buffer
+    void ConsumeWriteBuffer(wxUint32 size);
+
+    // create m_async if necessary and return it
+    wxSocketAsyncState& GetAsyncState();
+
+    // perform the pending asynchronous operations affected by the given
+    // notification, return true if it was consumed by them
+    bool DoProcessAsync(wxSocketNotify notification);
+
+    // read or write as much as possible for the pending asynchronous
+    // operation without blocking and complete it if it's done
+    void ContinueAsyncRead();
+    void ContinueAsyncWrite();
+    void ContinueAsyncAccept();
+
+    // write as much of the pending asynchronous write data as possible
+    // without blocking and return the error which occurred, if any
+    wxSocketError DoAsyncWrite();
+
+    // complete the pending asynchronous operation by calling its handler
+    void CompleteAsyncRead(wxSocketError error);
+    void CompleteDeferredAsyncRead();
+    void CompleteAsyncWrite(wxSocketError error);
 
     // wait until the given flags are set for this socket or the given timeout
     // (or m_timeout) expires
@@ -258,6 +366,30 @@ private:
     void     Pushback(const void *buffer, wxUint32 size);
     wxUint32 GetPushback(void *buffer, wxUint32 size, bool peek);
 
+    // ensure that at least the given number of bytes can be appended to the
+    // pushback buffer without reallocating it
+    void     ReservePushback(wxUint32 size);
+
+    // read at most nbytes from the socket, waiting until some data is
+    // available, and append them to the pushback buffer: this is used by
+    // wxProtocol to buffer the data read from the socket
+    wxUint32 ReadToPushback(wxUint32 nbytes);
+
+    // direct access to the data in the pushback buffer
+    const char *PeekPushback(wxUint32 *size) const
+    {
+        *size = m_unrd_size - m_unrd_cur;
+        return m_unread + m_unrd_cur;
+    }
+
+    void     SkipPushback(wxUint32 size);
+
+    // read from the socket itself, without using the pushback buffer, into
+    // the given buffers starting at the given offset in the first of them,
+    // the last parameter indicates whether anything was already read before
+    wxUint32 DoReadFromSocket(const wxSocketBuffer *buffers, unsigned count,
+                              wxUint32 offset, bool readSome);
+
     // store the given error as the LastError()
     void SetError(wxSocketError error);
 
@@ -283,11 +415,21 @@ private:
     bool          m_beingDeleted;     // marked for delayed deletion?
     wxIPV4address m_localAddress;     // bind to local address?
 
-    // pushback buffer
-    void         *m_unread;           // pushback buffer
-    wxUint32      m_unrd_size;        // pushback buffer size
+    // pushback buffer, it is kept allocated once it's used as it's also used
+    // for buffering the data read by wxProtocol
+    char         *m_unread;           // pushback buffer
+    wxUint32      m_unrd_alloc;       // pushback buffer allocated size
+    wxUint32      m_unrd_size;        // pushback buffer data end
     wxUint32      m_unrd_cur;         // pushback pointer (index into buffer)
 
+    // write buffer, only allocated if SetWriteBufferSize() was called
+    char         *m_wbuf;             // write buffer
+    wxUint32      m_wbuf_alloc;       // write buffer allocated size
+    wxUint32      m_wbuf_size;        // size of the data in the write buffer
+
+    // pending asynchronous operations, only allocated when they're used
+    wxSocketAsyncState *m_async;
+
     // events
     int           m_id;               // socket id
     wxEvtHandler *m_handler;          // event handler
@@ -297,9 +439,13 @@ private:
     wxSocketEventFlags  m_eventsgot;  // collects events received in OnRequest()
 
 
+    friend class wxSocketAsyncState;
     friend class wxSocketReadGuard;
     friend class wxSocketWriteGuard;
 
+    // for the direct access to the pushback buffer in ReadLine()
+    friend class wxProtocol;
+
     wxDECLARE_NO_COPY_CLASS(wxSocketBase);
     DECLARE_CLASS(wxSocketBase)
 };
@@ -320,6 +466,10 @@ public:
 
     bool WaitForAccept(long seconds = -1, long milliseconds = 0);
 
+    // accept a connection asynchronously, see wxSocketBase::AsyncRead()
+    bool AsyncAccept(wxSocketAsyncHandler *handler);
+    bool IsAsyncAcceptPending() const;
+
     wxDECLARE_NO_COPY_CLASS(wxSocketServer);
     DECLARE_CLASS(wxSocketServer)
 };
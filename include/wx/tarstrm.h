@@ -15,6 +15,7 @@
 
 #include "wx/archive.h"
 #include "wx/hashmap.h"
+#include "wx/vector.h"
 
 
 /////////////////////////////////////////////////////////////////////////////
@@ -141,6 +142,7 @@ private:
     int          m_DevMinor;
 
     friend class wxTarInputStream;
+    friend class wxTarArchive;
 
     DECLARE_DYNAMIC_CLASS(wxTarEntry)
 };
@@ -286,6 +288,85 @@ private:
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxTarArchive
+//
+// Random access reader for tar files. As tar files don't have a central
+// directory, all the headers need to be read once to build an index of the
+// entries, but this index can be saved to a separate file and reused later.
+// After this, the entries can be found by name quickly and their data is read
+// by seeking to it directly, from any number of threads at the same time.
+
+#if wxUSE_FILE
+
+class WXDLLIMPEXP_FWD_BASE wxThreadPool;
+
+class WXDLLIMPEXP_BASE wxTarArchive
+{
+public:
+    // Open the archive in the given file. If indexFile is not empty, the index
+    // is loaded from it if it's up to date, otherwise it is built by reading
+    // the archive and then saved to this file.
+    wxTarArchive(const wxString& filename,
+                 const wxString& indexFile = wxEmptyString,
+                 wxMBConv& conv = wxConvLocal);
+
+    ~wxTarArchive();
+
+    bool IsOk() const { return m_ok; }
+
+    // Save the index to the given file, it can be loaded by passing its name
+    // to the ctor later as long as the archive itself doesn't change.
+    bool SaveIndex(const wxString& indexFile) const;
+
+    // Return the number of entries and the entry with the given index. The
+    // entries must not be modified.
+    size_t GetCount() const { return m_entries.size(); }
+    const wxTarEntry& GetEntry(size_t n) const { return *m_entries[n]; }
+
+    // Return the index of the entry with the given name or wxNOT_FOUND.
+    int Find(const wxString& name, wxPathFormat format = wxPATH_NATIVE) const;
+
+    // Return a new stream reading the data of the given entry, which must be
+    // deleted by the caller, or NULL on error. It's safe to call these
+    // methods and use the returned streams from multiple threads.
+    wxTarInputStream *OpenEntry(size_t n) const;
+    wxTarInputStream *OpenEntry(const wxString& name,
+                                wxPathFormat format = wxPATH_NATIVE) const;
+
+    // Extract all entries into the given directory, in parallel if threads
+    // are available using the given pool or the global one if it's NULL.
+    // Returns false if extracting any of them failed.
+    bool ExtractAll(const wxString& dir, wxThreadPool *pool = NULL) const;
+
+    // Extract the given entry into the specified file, the directory
+    // containing it must already exist. This method is thread-safe.
+    bool Extract(size_t n, const wxString& path) const;
+
+private:
+    bool BuildIndex();
+    bool LoadIndex(const wxString& indexFile);
+    void Clear();
+
+    const wxString m_filename;
+    wxMBConv& m_conv;
+
+    // the archive size and modification time, used for checking whether the
+    // saved index is up to date
+    wxFileOffset m_length;
+    wxLongLong m_modTime;
+
+    wxVector<wxTarEntry*> m_entries;
+    class wxTarArchiveIndex *m_index;
+
+    bool m_ok;
+
+    wxDECLARE_NO_COPY_CLASS(wxTarArchive);
+};
+
+#endif // wxUSE_FILE
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Iterators
 
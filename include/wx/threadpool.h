@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     wxThreadPool: executing tasks in a fixed set of threads
+// Author:      wxWidgets team
+// Created:     2016-03-14
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _WX_THREADPOOL_H_
+#define _WX_THREADPOOL_H_
+
+#include "wx/defs.h"
+
+#if wxUSE_THREADS
+
+#include "wx/atomic.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+class WXDLLIMPEXP_FWD_BASE wxEvtHandler;
+class WXDLLIMPEXP_FWD_BASE wxThreadPool;
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolTask: base class for the tasks executed by wxThreadPool
+// ----------------------------------------------------------------------------
+
+// Task objects are reference counted as they're shared between the code which
+// submitted them and the pool: create them with new and call DecRef() instead
+// of deleting them (or use wxObjectDataPtr<> to do it automatically).
+//
+// The task object also serves as a "future": its results, if any, may be
+// retrieved after IsDone() returns true or Wait() returns.
+class WXDLLIMPEXP_BASE wxThreadPoolTask
+{
+public:
+    wxThreadPoolTask();
+
+    // Reference counting functions, thread-safe.
+    void IncRef();
+    void DecRef();
+
+    // Request posting wxThreadEvent of type wxEVT_THREAD and with the given
+    // id to the specified handler when the task completes. This can be used
+    // to be notified about the task completion in the main thread.
+    //
+    // Must be called before submitting the task to the pool.
+    void SetNotifyHandler(wxEvtHandler* handler, int id = wxID_ANY);
+
+    // Return true if the task has been executed.
+    bool IsDone() const;
+
+    // Wait until the task is executed. If it hasn't started executing yet, it
+    // is executed immediately in the calling thread.
+    void Wait();
+
+protected:
+    // The dtor is protected as the objects of this class are only deleted by
+    // DecRef().
+    virtual ~wxThreadPoolTask();
+
+    // Override this function to do the actual work. It is called only once,
+    // either from one of the pool threads or from Wait().
+    virtual void Execute() = 0;
+
+private:
+    // Execute the task unless it had been already executed by somebody else,
+    // return false in this case.
+    bool Run();
+
+
+    wxAtomicInt m_refCount;
+
+    // One of State_XXX values defined in the implementation file.
+    mutable wxAtomicInt m_state;
+
+    // Used to wait for the task completion.
+    mutable wxMutex m_mutex;
+    wxCondition m_condDone;
+
+    // The handler to notify about the task completion, may be NULL.
+    wxEvtHandler* m_handler;
+    int m_id;
+
+    friend class wxThreadPool;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPoolTask);
+};
+
+// ----------------------------------------------------------------------------
+// wxParallelForBody: the work done by wxThreadPool::ParallelFor()
+// ----------------------------------------------------------------------------
+
+class WXDLLIMPEXP_BASE wxParallelForBody
+{
+public:
+    wxParallelForBody() { }
+    virtual ~wxParallelForBody() { }
+
+    // Process all elements in [first, last) range. This is called from
+    // different threads at once for different, non overlapping, ranges.
+    virtual void Process(int first, int last) = 0;
+
+private:
+    wxDECLARE_NO_COPY_CLASS(wxParallelForBody);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPool: executes the submitted tasks in a fixed set of threads
+// ----------------------------------------------------------------------------
+
+// Each thread of the pool has its own queue of tasks: the tasks submitted from
+// outside of the pool are distributed among them in round robin order, while
+// the tasks submitted from inside a task are added to the queue of the thread
+// executing it. Idle threads steal tasks from the queues of the other ones.
+class WXDLLIMPEXP_BASE wxThreadPool
+{
+public:
+    // Create the pool with the given number of threads or as many threads as
+    // there are CPUs in the system if it is 0.
+    explicit wxThreadPool(int numThreads = 0);
+
+    // Waits until all the already submitted tasks are executed.
+    ~wxThreadPool();
+
+    // Return false if no threads could be created.
+    bool IsOk() const { return !m_workers.empty(); }
+
+    // Return the number of threads in the pool.
+    int GetThreadCount() const { return m_workers.size(); }
+
+    // Schedule the task for execution. Returns false if the pool is not
+    // usable, the task is not going to be executed then.
+    bool Submit(wxThreadPoolTask* task);
+
+    // Call body.Process() for all the elements in [first, last) range,
+    // dividing it into the given number of chunks processed in parallel (if
+    // 0, use as many chunks as there are threads in the pool). The calling
+    // thread processes one of the chunks itself and this function only
+    // returns once all of them have been processed.
+    void ParallelFor(int first, int last, wxParallelForBody& body,
+                     int numChunks = 0);
+
+
+    // Return the global pool, creating it with the default number of threads
+    // on first use. It is destroyed when the library is shut down.
+    static wxThreadPool& Get();
+
+private:
+    class Worker;
+
+    // Return the next task for the given worker to execute, taking it from
+    // its own queue or stealing it from another worker one. Returns NULL if
+    // there are no tasks.
+    wxThreadPoolTask* GetTaskFor(Worker* worker);
+
+    // Return the pool worker corresponding to the current thread, if any.
+    Worker* GetCurrentWorker() const;
+
+    // Implementation of the worker threads.
+    void WorkerMain(Worker* worker);
+
+
+    wxVector<Worker*> m_workers;
+
+    // Index of the worker to add the next task submitted from outside.
+    wxAtomicInt m_nextWorker;
+
+    // The number of tasks in all queues.
+    wxAtomicInt m_pending;
+
+    // Used by the idle workers to wait for more tasks and protects m_stop.
+    wxMutex m_mutexIdle;
+    wxCondition m_condIdle;
+    bool m_stop;
+
+    static wxThreadPool* ms_global;
+
+    friend class wxThreadPoolModule;
+
+    wxDECLARE_NO_COPY_CLASS(wxThreadPool);
+};
+
+#endif // wxUSE_THREADS
+
+#endif // _WX_THREADPOOL_H_
@@ -285,6 +285,17 @@ public:
         return DoInsertItem(parent, (size_t)-1, text, image, selImage, data);
     }
 
+        // append several items with the given labels as the last children of
+        // the parent, this is more efficient than appending them one by one
+        // for some implementations
+    void AppendItems(const wxTreeItemId& parent,
+                     const wxArrayString& texts,
+                     int image = -1, int selImage = -1,
+                     wxArrayTreeItemIds *ids = NULL)
+    {
+        DoInsertItems(parent, (size_t)-1, texts, image, selImage, ids);
+    }
+
         // delete this item and associated data if any
     virtual void Delete(const wxTreeItemId& item) = 0;
         // delete all children (but don't delete the item itself)
@@ -414,6 +425,14 @@ protected:
                                       int image, int selImage,
                                       wxTreeItemData *data) = 0;
 
+    // insert several items at once, the default implementation simply calls
+    // DoInsertItem() for each of them
+    virtual void DoInsertItems(const wxTreeItemId& parent,
+                               size_t pos,
+                               const wxArrayString& texts,
+                               int image, int selImage,
+                               wxArrayTreeItemIds *ids);
+
     // and this function implements overloaded InsertItem() taking wxTreeItemId
     // (it can't be called InsertItem() as we'd have virtual function hiding
     // problem in derived classes then)
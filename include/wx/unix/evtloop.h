@@ -17,6 +17,7 @@
 // ----------------------------------------------------------------------------
 
 class wxEventLoopSource;
+class wxEventLoopSourceHandler;
 class wxFDIODispatcher;
 class wxWakeUpPipeMT;
 
@@ -54,6 +55,20 @@ private:
     // either wxSelectDispatcher or wxEpollDispatcher
     wxFDIODispatcher *m_dispatcher;
 
+#if wxUSE_TIMER && defined(wxHAS_TIMERFD)
+    // timerfd armed to expire when the next wxTimer does, this allows to wait
+    // for the timers with microsecond precision instead of rounding their
+    // remaining time to milliseconds for the dispatcher timeout
+    int m_timerFD;
+
+    // true if m_timerFD is currently armed
+    bool m_timerArmed;
+
+    // the handler draining m_timerFD and its event loop source
+    wxEventLoopSourceHandler *m_timerHandler;
+    wxEventLoopSource *m_timerSource;
+#endif // wxUSE_TIMER && wxHAS_TIMERFD
+
     wxDECLARE_NO_COPY_CLASS(wxConsoleEventLoop);
 };
 
@@ -46,6 +46,14 @@ private:
 
 
     int m_epollDescriptor;
+
+    // the buffer for the events returned by epoll_wait() and its size, i.e.
+    // the maximal number of events processed by a single Dispatch() call
+    epoll_event *m_events;
+    int m_maxEvents;
+
+    // true while m_events is being used by Dispatch()
+    bool m_eventsInUse;
 };
 
 #endif // wxUSE_EPOLL_DISPATCHER
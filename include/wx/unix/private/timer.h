@@ -13,11 +13,14 @@
 #if wxUSE_TIMER
 
 #include "wx/private/timer.h"
+#include "wx/vector.h"
 
 // the type used for milliseconds is large enough for microseconds too but
 // introduce a synonym for it to avoid confusion
 typedef wxMilliClock_t wxUsecClock_t;
 
+struct wxTimerSchedule;
+
 // ----------------------------------------------------------------------------
 // wxTimer implementation class for Unix platforms
 // ----------------------------------------------------------------------------
@@ -43,8 +46,15 @@ public:
         m_isRunning = false;
     }
 
+    // for wxTimerScheduler only: the handle of this timer in the scheduler,
+    // non-NULL only while it is scheduled
+    wxTimerSchedule *GetSchedule() const { return m_schedule; }
+    void SetSchedule(wxTimerSchedule *schedule) { m_schedule = schedule; }
+
 private:
     bool m_isRunning;
+
+    wxTimerSchedule *m_schedule;
 };
 
 // ----------------------------------------------------------------------------
@@ -55,7 +65,9 @@ struct wxTimerSchedule
 {
     wxTimerSchedule(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
         : m_timer(timer),
-          m_expiration(expiration)
+          m_expiration(expiration),
+          m_order(0),
+          m_heapIndex(0)
     {
     }
 
@@ -64,10 +76,14 @@ struct wxTimerSchedule
 
     // the time of its next expiration, in usec
     wxUsecClock_t m_expiration;
-};
 
-// the linked list of all active timers, we keep it sorted by expiration time
-WX_DECLARE_LIST(wxTimerSchedule, wxTimerList);
+    // the sequential number used to order the timers expiring at the same
+    // time in the order in which they were added
+    unsigned long m_order;
+
+    // the position of this schedule in wxTimerScheduler heap
+    size_t m_heapIndex;
+};
 
 // ----------------------------------------------------------------------------
 // wxTimerScheduler: class responsible for updating all timers
@@ -115,20 +131,47 @@ public:
     // if any did
     bool NotifyExpired();
 
+
+    // set the interval, in microseconds, used for coalescing the timers:
+    // if it is non-zero, the wake up times are rounded up to a multiple of it
+    // so that the timers expiring close to each other are notified together
+    // (but never before their expiration)
+    //
+    // the initial value is taken from "unix.timer.slack" system option which
+    // is specified in milliseconds and is 0 by default
+    void SetSlack(wxUsecClock_t slack) { m_slack = slack; }
+    wxUsecClock_t GetSlack() const { return m_slack; }
+
 private:
     // ctor and dtor are private, this is a singleton class only created by
     // Get() and destroyed by Shutdown()
-    wxTimerScheduler() { }
+    wxTimerScheduler();
     ~wxTimerScheduler();
 
-    // add the given timer schedule to the list in the right place
+    // add the given timer schedule to the heap
     //
     // we take ownership of the pointer "s" which must be heap-allocated
     void DoAddTimer(wxTimerSchedule *s);
 
+    // remove the schedule at the given position from the heap and return it
+    wxTimerSchedule *DoRemoveAt(size_t n);
+
+    // helpers for maintaining the heap invariant
+    bool IsBefore(size_t n1, size_t n2) const;
+    void SetAt(size_t n, wxTimerSchedule *s);
+    void SiftUp(size_t n);
+    void SiftDown(size_t n);
+
+
+    // the binary min-heap of all currently active timers ordered by their
+    // expiration time, so that the first element always expires first
+    wxVector<wxTimerSchedule *> m_timers;
+
+    // the value used for wxTimerSchedule::m_order of the next added timer
+    unsigned long m_nextOrder;
 
-    // the list of all currently active timers sorted by expiration
-    wxTimerList m_timers;
+    // see SetSlack()
+    wxUsecClock_t m_slack;
 
     static wxTimerScheduler *ms_instance;
 };
@@ -19,6 +19,9 @@
 
 // This class is not MT-safe, see wxWakeUpPipeMT below for a wake up pipe
 // usable from other threads.
+//
+// Under Linux an eventfd is used instead of a real pipe if possible as it
+// needs only a single descriptor and no buffer space in the kernel.
 
 class wxWakeUpPipe : public wxEventLoopSourceHandler
 {
@@ -28,6 +31,7 @@ public:
     // It's the callers responsibility to add the read end of this pipe,
     // returned by GetReadFd(), to the code blocking on input.
     wxWakeUpPipe();
+    virtual ~wxWakeUpPipe();
 
     // Wake up the blocking operation involving this pipe.
     //
@@ -40,7 +44,15 @@ public:
     // Same as WakeUp() but without locking.
 
     // Return the read end of the pipe.
-    int GetReadFd() { return m_pipe[wxPipe::Read]; }
+    int GetReadFd()
+    {
+#ifdef wxHAS_EVENTFD
+        if ( m_eventFD != wxPipe::INVALID_FD )
+            return m_eventFD;
+#endif // wxHAS_EVENTFD
+
+        return m_pipe[wxPipe::Read];
+    }
 
 
     // Implement wxEventLoopSourceHandler pure virtual methods
@@ -51,6 +63,11 @@ public:
 private:
     wxPipe m_pipe;
 
+#ifdef wxHAS_EVENTFD
+    // The eventfd used instead of m_pipe or INVALID_FD if we use the pipe.
+    int m_eventFD;
+#endif // wxHAS_EVENTFD
+
     // This flag is set to true after writing to the pipe and reset to false
     // after reading from it in the main thread. Having it allows us to avoid
     // overflowing the pipe with too many writes if the main thread can't keep
@@ -320,6 +320,77 @@ private:
     DECLARE_CLASS(wxXmlDocument)
 };
 
+
+// Kinds of the items returned by wxXmlReader::Next().
+enum wxXmlReaderEvent
+{
+    wxXML_READER_NONE,              // end of document or error
+    wxXML_READER_START_ELEMENT,
+    wxXML_READER_END_ELEMENT,
+    wxXML_READER_TEXT,
+    wxXML_READER_CDATA,
+    wxXML_READER_COMMENT,
+    wxXML_READER_PI
+};
+
+// This class allows to read XML documents sequentially, one item at a time,
+// without building the entire tree in memory as wxXmlDocument does. This is
+// more efficient for processing big documents.
+
+class wxXmlReaderImpl;
+
+class WXDLLIMPEXP_XML wxXmlReader
+{
+public:
+    // The stream must remain valid for the lifetime of this object. The flags
+    // have the same meaning as for wxXmlDocument::Load().
+    wxXmlReader(wxInputStream& stream,
+                const wxString& encoding = wxT("UTF-8"),
+                int flags = wxXMLDOC_NONE);
+    ~wxXmlReader();
+
+    // Returns false if a parsing error occurred.
+    bool IsOk() const;
+
+    // Read the next item of the document and return its kind or
+    // wxXML_READER_NONE if there are no more of them.
+    wxXmlReaderEvent Next();
+
+    // Accessors for the item returned by the last call to Next().
+    wxXmlReaderEvent GetEvent() const;
+
+    // Element name or PI target.
+    const wxString& GetName() const;
+
+    // Text, CDATA section, comment or PI contents.
+    const wxString& GetContent() const;
+
+    // Attributes of the element being started.
+    size_t GetAttributeCount() const;
+    const wxString& GetAttributeName(size_t n) const;
+    const wxString& GetAttributeValue(size_t n) const;
+    bool HasAttribute(const wxString& attrName) const;
+    wxString GetAttribute(const wxString& attrName,
+                          const wxString& defaultVal = wxEmptyString) const;
+
+    // Number of elements containing this item, i.e. 0 for the root element.
+    int GetDepth() const;
+
+    int GetLineNumber() const;
+
+    // These are only available after reading the first item.
+    const wxString& GetVersion() const;
+    const wxString& GetFileEncoding() const;
+
+private:
+    // Read more input and parse it, return false if there is no more of it.
+    bool Feed();
+
+    wxXmlReaderImpl *m_impl;
+
+    wxDECLARE_NO_COPY_CLASS(wxXmlReader);
+};
+
 #endif // wxUSE_XML
 
 #endif // _WX_XML_H_
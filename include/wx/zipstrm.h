@@ -15,6 +15,7 @@
 
 #include "wx/archive.h"
 #include "wx/filename.h"
+#include "wx/vector.h"
 
 // some methods from wxZipInputStream and wxZipOutputStream stream do not get
 // exported/imported when compiled with Mingw versions before 3.4.2. So they
@@ -432,6 +433,84 @@ private:
 };
 
 
+/////////////////////////////////////////////////////////////////////////////
+// wxZipArchive
+//
+// Random access reader for zip files in memory or mapped from disk. Unlike
+// wxZipInputStream, it reads the central directory only once, allows to find
+// the entries by name quickly and any number of entries can be read at the
+// same time, including from different threads.
+
+class WXDLLIMPEXP_FWD_BASE wxMappedFile;
+class WXDLLIMPEXP_FWD_BASE wxThreadPool;
+
+class WXDLLIMPEXP_BASE wxZipArchive
+{
+public:
+#if wxUSE_FILE
+    // Open the archive in the given file, which is mapped into memory.
+    wxZipArchive(const wxString& filename, wxMBConv& conv = wxConvLocal);
+#endif // wxUSE_FILE
+
+    // Open the archive in memory, the data must remain valid as long as this
+    // object and any streams returned by its OpenEntry() exist.
+    wxZipArchive(const void *data, size_t length, wxMBConv& conv = wxConvLocal);
+
+    ~wxZipArchive();
+
+    bool IsOk() const { return m_ok; }
+
+    // Return the number of entries and the entry with the given index. The
+    // entries must not be modified.
+    size_t GetCount() const { return m_entries.size(); }
+    const wxZipEntry& GetEntry(size_t n) const { return *m_entries[n]; }
+
+    // Return the index of the entry with the given name or wxNOT_FOUND.
+    int Find(const wxString& name, wxPathFormat format = wxPATH_NATIVE) const;
+
+    // Return a new stream reading the data of the given entry, which must be
+    // deleted by the caller, or NULL on error. It's safe to call this method
+    // and use the returned streams from multiple threads.
+    wxInputStream *OpenEntry(size_t n) const;
+
+    // Extract all entries into the given directory, in parallel if threads
+    // are available using the given pool or the global one if it's NULL.
+    // Returns false if extracting any of them failed.
+    bool ExtractAll(const wxString& dir, wxThreadPool *pool = NULL) const;
+
+    // Extract the given entry into the specified file, the directory
+    // containing it must already exist. This method is thread-safe.
+    bool Extract(size_t n, const wxString& path) const;
+
+private:
+    void Init(wxMBConv& conv);
+
+
+    // The information needed to read the data of an entry, copied from
+    // m_entries to avoid accessing them from OpenEntry().
+    struct EntryInfo
+    {
+        wxFileOffset offset;
+        wxFileOffset compressedSize;
+        wxFileOffset size;
+        wxUint32 crc;
+        int method;
+    };
+
+    wxMappedFile *m_file;
+    const char *m_data;
+    size_t m_length;
+
+    wxVector<wxZipEntry*> m_entries;
+    wxVector<EntryInfo> m_info;
+    class wxZipArchiveIndex *m_index;
+
+    bool m_ok;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipArchive);
+};
+
+
 /////////////////////////////////////////////////////////////////////////////
 // Iterators
 
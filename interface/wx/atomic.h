@@ -38,5 +38,48 @@ void wxAtomicInc(wxAtomicInt& value);
 */
 wxInt32 wxAtomicDec(wxAtomicInt& value);
 
+/**
+    This function atomically replaces @a value with @a newValue if, and only
+    if, it is currently equal to @a oldValue.
+
+    Returns @true if the value was replaced or @false if it was left unchanged
+    because it was different from @a oldValue.
+
+    @see wxAtomicInc
+
+    @since 3.1.0
+
+    @header{wx/atomic.h}
+*/
+bool wxAtomicCompareAndSwap(wxAtomicInt& value,
+                            wxInt32 oldValue,
+                            wxInt32 newValue);
+
+/**
+    This function reads @a value in an atomic manner.
+
+    This function acts as a full memory barrier, i.e. it is guaranteed that
+    the results of all writes done by other threads before they modified
+    @a value using one of the atomic functions are visible after it returns.
+
+    @see wxAtomicStore()
+
+    @since 3.1.0
+
+    @header{wx/atomic.h}
+*/
+wxInt32 wxAtomicLoad(wxAtomicInt& value);
+
+/**
+    This function sets @a value to @a newValue in an atomic manner.
+
+    This function acts as a full memory barrier, see wxAtomicLoad().
+
+    @since 3.1.0
+
+    @header{wx/atomic.h}
+*/
+void wxAtomicStore(wxAtomicInt& value, wxInt32 newValue);
+
 //@}
 
@@ -1409,6 +1409,39 @@ public:
 };
 
 
+
+/** @addtogroup group_funcmacro_gdi */
+//@{
+
+/**
+    Returns the statistics of the cache of text layouts used by the Cairo
+    renderer.
+
+    The Cairo renderer keeps the layouts of the recently drawn or measured
+    strings, together with their already shaped glyphs, in a cache shared by
+    all wxGraphicsContext objects, as the same strings, e.g. labels, are often
+    drawn or measured many times. This function returns the number of times a
+    layout was found in this cache and the number of times it had to be
+    created since the program start, which can be useful for profiling the
+    text drawing code.
+
+    Currently the cache is only used in wxGTK, in the other ports both values
+    are always 0.
+
+    @param hits
+        Receives the number of the cache hits, may be @NULL.
+    @param misses
+        Receives the number of the cache misses, may be @NULL.
+
+    @header{wx/graphics.h}
+
+    @since 3.1.0
+*/
+void wxGetCairoTextCacheStats(unsigned long *hits, unsigned long *misses);
+
+//@}
+
+
 const wxGraphicsPen     wxNullGraphicsPen;
 const wxGraphicsBrush   wxNullGraphicsBrush;
 const wxGraphicsFont    wxNullGraphicsFont;
@@ -1827,6 +1827,190 @@ public:
     wxString GetColLabelValue( int col );
 };
 
+/**
+   @class wxGridColumnarTable
+
+   Data table storing the values of each column in memory using the type of
+   the column.
+
+   Unlike wxGridStringTable, which stores all values as strings, this class
+   stores the values of numeric and boolean columns contiguously as @c long,
+   @c double or @c bool and stores each distinct string of a string column
+   only once. This makes it much more compact and faster to use for big
+   tables, especially of numbers.
+
+   The type of each column is returned by GetTypeName() for all of its cells,
+   so the appropriate renderer and editor are used for it. Moreover,
+   wxGridCellNumberRenderer and wxGridCellFloatRenderer retrieve the values
+   of all the visible rows of a column at once from this table, using
+   GetColValuesAsLong() or GetColValuesAsDouble(), and cache the formatted
+   strings in it using SetFormattedValues(), so that the values are not
+   formatted again each time the grid is redrawn.
+
+   @library{wxadv}
+   @category{grid}
+
+   @since 3.1.0
+*/
+class wxGridColumnarTable : public wxGridTableBase
+{
+public:
+    /**
+        Default constructor creates an empty table.
+     */
+    wxGridColumnarTable();
+
+    /**
+        Constructor creating a table with the given number of rows and no
+        columns.
+
+        Use AppendTypedCols() to add the columns to it.
+     */
+    wxGridColumnarTable( int numRows );
+
+    /**
+        Insert columns of the given type.
+
+        @param typeName
+            One of @c wxGRID_VALUE_STRING, @c wxGRID_VALUE_NUMBER,
+            @c wxGRID_VALUE_FLOAT or @c wxGRID_VALUE_BOOL, optionally followed
+            by a colon and the parameters of the renderer, e.g. "double:10,2".
+        @param pos
+            The position of the first column to insert.
+        @param numCols
+            The number of columns to insert.
+        @return
+            @true on success or @false if the type is not supported.
+     */
+    bool InsertTypedCols( const wxString& typeName,
+                          size_t pos = 0, size_t numCols = 1 );
+
+    /**
+        Append columns of the given type.
+
+        @see InsertTypedCols()
+     */
+    bool AppendTypedCols( const wxString& typeName, size_t numCols = 1 );
+
+    /**
+        Retrieve the values of the given number of rows of a column.
+
+        These functions copy the values of @a count rows of the column @a col
+        starting at @a row into the @a values array, which must be big enough.
+        This is more efficient than calling GetValueAsLong(),
+        GetValueAsDouble() or GetValueAsBool() for each of the cells.
+
+        @return
+            @false if the column type doesn't correspond to the values type
+            or if the range of rows is invalid.
+     */
+    //@{
+    bool GetColValuesAsLong( int col, int row, int count, long *values ) const;
+    bool GetColValuesAsDouble( int col, int row, int count, double *values ) const;
+    bool GetColValuesAsBool( int col, int row, int count, bool *values ) const;
+    //@}
+
+    /**
+        Change the values of the given number of rows of a column.
+
+        These functions are the counterpart of GetColValuesAsLong(),
+        GetColValuesAsDouble() and GetColValuesAsBool() and can be used to
+        fill the table efficiently.
+
+        Notice that, as with the other functions changing the table values,
+        the grid using the table needs to be refreshed after calling them.
+     */
+    //@{
+    bool SetColValuesAsLong( int col, int row, int count, const long *values );
+    bool SetColValuesAsDouble( int col, int row, int count, const double *values );
+    bool SetColValuesAsBool( int col, int row, int count, const bool *values );
+    //@}
+
+    /**
+        Retrieve the cached formatted value of a cell.
+
+        This function and SetFormattedValues() are used by the renderers to
+        avoid formatting the values of the visible cells each time they are
+        drawn, but may be used by custom renderers too.
+
+        @param row
+            The row of the cell.
+        @param col
+            The column of the cell.
+        @param format
+            The format which was used for formatting the value, typically
+            the format string passed to wxString::Format().
+        @param value
+            Receives the cached value, must be non-@NULL.
+        @return
+            @true if the value is cached or @false if it isn't or was
+            formatted using a different format.
+     */
+    bool GetFormattedValue( int row, int col, const wxString& format,
+                            wxString *value ) const;
+
+    /**
+        Cache the formatted values of a range of rows of a column.
+
+        Only the values of a single range of rows are cached for each column,
+        so the values previously cached for this column are forgotten. The
+        cached values are also forgotten when any value of the column changes
+        or when rows are inserted or deleted.
+
+        @param col
+            The column of the cells.
+        @param row
+            The first row of the range.
+        @param format
+            The format used for formatting the values, GetFormattedValue()
+            only returns the value if it is called with the same format.
+        @param values
+            The formatted values of the rows starting at @a row.
+     */
+    void SetFormattedValues( int col, int row, const wxString& format,
+                             const wxArrayString& values );
+
+    // these are pure virtual in wxGridTableBase
+    virtual int GetNumberRows();
+    virtual int GetNumberCols();
+    virtual wxString GetValue( int row, int col );
+    virtual void SetValue( int row, int col, const wxString& value );
+
+    // overridden functions from wxGridTableBase
+    virtual bool IsEmptyCell( int row, int col );
+    virtual wxString GetTypeName( int row, int col );
+    virtual bool CanGetValueAs( int row, int col, const wxString& typeName );
+    virtual long GetValueAsLong( int row, int col );
+    virtual double GetValueAsDouble( int row, int col );
+    virtual bool GetValueAsBool( int row, int col );
+    virtual void SetValueAsLong( int row, int col, long value );
+    virtual void SetValueAsDouble( int row, int col, double value );
+    virtual void SetValueAsBool( int row, int col, bool value );
+
+    void Clear();
+    bool InsertRows( size_t pos = 0, size_t numRows = 1 );
+    bool AppendRows( size_t numRows = 1 );
+    bool DeleteRows( size_t pos = 0, size_t numRows = 1 );
+
+    /**
+        Insert or append string columns.
+
+        Use InsertTypedCols() or AppendTypedCols() to add columns of other
+        types.
+     */
+    //@{
+    bool InsertCols( size_t pos = 0, size_t numCols = 1 );
+    bool AppendCols( size_t numCols = 1 );
+    //@}
+
+    bool DeleteCols( size_t pos = 0, size_t numCols = 1 );
+
+    void SetRowLabelValue( int row, const wxString& );
+    void SetColLabelValue( int col, const wxString& );
+    wxString GetRowLabelValue( int row );
+    wxString GetColLabelValue( int col );
+};
+
 
 
 
@@ -244,6 +244,11 @@ public:
         the screen (and thus invisible). This is not nonsense - some tags (like
         wxHtmlColourCell or font setter) must be drawn even if they are invisible!
 
+        Notice that wxHtmlContainerCell remembers which of its cells change the
+        drawing state when it is laid out and doesn't call this method for the
+        cells which are far from the visible area unless they are font, colour
+        or widget cells. Overriding this method in other cells is not useful.
+
         @param dc
             Device context to which the cell is to be drawn.
         @param x,y
@@ -494,6 +499,18 @@ public:
     */
     void InsertCell(wxHtmlCell* cell);
 
+    /**
+        Forget the cached layout of this container and all its parents.
+
+        Containers don't lay out their contents again if their width didn't
+        change since the last layout, call this function after modifying the
+        contents of an already laid out container to force it to happen.
+        InsertCell() calls it automatically.
+
+        @since 3.1.0
+    */
+    void InvalidateLayout();
+
     /**
         Sets the container's alignment (both horizontal and vertical) according to
         the values stored in @e tag. (Tags @c ALIGN parameter is extracted.)
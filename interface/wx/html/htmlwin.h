@@ -103,6 +103,22 @@ public:
         Returns mouse cursor of given @a type.
      */
     virtual wxCursor GetHTMLCursor(wxHtmlWindowInterface::HTMLCursor type) const = 0;
+
+    /**
+        Called periodically while a document is being parsed if
+        wxHtmlWinParser::SetProgressInterval() was used to enable it.
+
+        The default implementation does nothing, wxHtmlWindow overrides it to
+        show the part of the page parsed so far if progressive rendering is
+        enabled.
+
+        @param cell
+            The top level cell of the part of the document parsed so far. It
+            is still being modified by the parser and must not be stored.
+
+        @since 3.1.0
+     */
+    virtual void OnHTMLParsingProgress(wxHtmlContainerCell* cell);
 };
 
 
@@ -380,6 +396,60 @@ public:
     */
     void SetBorders(int b);
 
+    /**
+        Enable or disable progressive rendering of the pages.
+
+        If this option is enabled, the beginning of a long page is shown as
+        soon as it has been parsed, without waiting until the entire page is
+        parsed, and the displayed part is updated from time to time until the
+        parsing finishes. This can make loading big documents appear much more
+        responsive, but does make the total loading time slightly longer.
+
+        Notice that the pages loaded using LoadPage() with an anchor are never
+        rendered progressively as the window needs to scroll to the anchor
+        position after loading them.
+
+        Progressive rendering is disabled by default.
+
+        @see SetProgressiveRenderingDelay()
+
+        @since 3.1.0
+    */
+    void EnableProgressiveRendering(bool enable = true);
+
+    /**
+        Returns @true if progressive rendering is enabled.
+
+        @see EnableProgressiveRendering()
+
+        @since 3.1.0
+    */
+    bool IsProgressiveRenderingEnabled() const;
+
+    /**
+        Sets the delay after which the beginning of the page is shown for the
+        first time when progressive rendering is enabled.
+
+        The displayed part of the page is then updated after twice as long,
+        and so on, until the parsing finishes.
+
+        @param delay
+            The delay in milliseconds, 200 by default. If it is 0, the page
+            starts being shown as soon as possible.
+
+        @see EnableProgressiveRendering()
+
+        @since 3.1.0
+    */
+    void SetProgressiveRenderingDelay(int delay);
+
+    /**
+        Returns the delay set by SetProgressiveRenderingDelay().
+
+        @since 3.1.0
+    */
+    int GetProgressiveRenderingDelay() const;
+
     /**
         This function sets font sizes and faces. See wxHtmlDCRenderer::SetFonts
         for detailed description.
@@ -228,6 +228,28 @@ public:
    */
     wxHtmlWindowInterface* GetWindowInterface();
 
+    /**
+        Enable periodic progress notifications during parsing.
+
+        If @a interval is positive, wxHtmlWindowInterface::OnHTMLParsingProgress()
+        is called after this many milliseconds of parsing and then again after
+        twice as long as the previous delay, so that the total overhead of the
+        notifications remains small even for very long documents. If it is 0,
+        which is the default, no notifications are sent.
+
+        The notifications are only sent if the window interface is set.
+
+        @since 3.1.0
+    */
+    void SetProgressInterval(int interval);
+
+    /**
+        Returns the value set by SetProgressInterval().
+
+        @since 3.1.0
+    */
+    int GetProgressInterval() const;
+
     /**
         Opens new container and returns pointer to it (see @ref overview_html_cells).
     */
@@ -784,6 +784,41 @@ public:
     */
     wxImage BlurVertical(int blurRadius) const;
 
+    /**
+        Sets the number of threads used for processing the images.
+
+        By default, Blur(), BlurHorizontal(), BlurVertical() and the
+        resampling functions used by Scale() and Rescale() work in the thread
+        they are called from. Calling this function with a value greater
+        than 1 allows them to split sufficiently big images in horizontal
+        bands processed in parallel by the calling thread and the threads of
+        the global wxThreadPool, see wxThreadPool::Get().
+
+        Notice that this setting affects all images. It is mostly useful for
+        processing a few big images, if many images need to be processed it
+        is usually more efficient to process them in different threads.
+
+        This function does nothing if wxUSE_THREADS is 0.
+
+        @param count
+            The maximal number of threads to use, including the calling
+            thread. If it is 0, the number of CPUs is used.
+
+        @see GetProcessingThreads()
+
+        @since 3.1.0
+    */
+    static void SetProcessingThreads(int count);
+
+    /**
+        Returns the number of threads used for processing the images.
+
+        @see SetProcessingThreads()
+
+        @since 3.1.0
+    */
+    static int GetProcessingThreads();
+
     /**
         Returns a mirrored copy of the image.
         The parameter @a horizontally indicates the orientation.
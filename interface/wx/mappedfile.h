@@ -0,0 +1,129 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/mappedfile.h
+// Purpose:     interface of wxMappedFile and wxMappedInputStream
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxMappedFile
+
+    Provides read-only access to the file contents mapped into memory.
+
+    Mapping the file avoids reading its contents into a separate buffer: the
+    data is loaded from disk on demand when it is accessed and is never
+    copied. This is especially advantageous for big files of which only some
+    parts are needed.
+
+    Notice that the behaviour is undefined if the file is modified by another
+    process while it's mapped and, in particular, accessing the data of a
+    file truncated after mapping it may result in the program crash.
+
+    Memory mapping is currently supported under Unix and MSW only, Open()
+    always fails under the other platforms.
+
+    @library{wxbase}
+    @category{file}
+
+    @see wxMappedInputStream, wxFile
+
+    @since 3.1.0
+*/
+class wxMappedFile
+{
+public:
+    /**
+        Default constructor doesn't map any file, use Open() later.
+    */
+    wxMappedFile();
+
+    /**
+        Constructor mapping the given file.
+
+        Use IsOpened() to check if it succeeded.
+    */
+    explicit wxMappedFile(const wxString& filename);
+
+    /**
+        Destructor unmaps the file.
+    */
+    ~wxMappedFile();
+
+    /**
+        Maps the given file into memory.
+
+        The previously mapped file, if any, is unmapped first.
+
+        Returns @false and logs an error if the file couldn't be opened or
+        mapped.
+    */
+    bool Open(const wxString& filename);
+
+    /**
+        Unmaps the file.
+
+        The pointer returned by GetData() can't be used any more after
+        calling this function.
+    */
+    void Close();
+
+    /**
+        Returns @true if a file was successfully mapped.
+    */
+    bool IsOpened() const;
+
+    /**
+        Returns the pointer to the file contents.
+
+        Notice that the returned pointer is @NULL if the file is empty.
+    */
+    const void* GetData() const;
+
+    /**
+        Returns the length of the file contents.
+    */
+    size_t GetLength() const;
+};
+
+/**
+    @class wxMappedInputStream
+
+    Input stream reading from a file mapped into memory.
+
+    This stream is typically more efficient than wxFileInputStream or
+    wxFFileInputStream as it doesn't need to perform any system calls to read
+    the data. Moreover, as it derives from wxMemoryInputStream, its data can
+    be accessed directly using wxMemoryInputStream::GetCurrentData(), which is
+    used by e.g. wxZlibInputStream and wxZipInputStream to decompress the
+    data in place.
+
+    The file data is shared and not copied, so the caveats described in
+    wxMappedFile documentation apply to this class too. This is why the files
+    are never mapped implicitly, e.g. wxImage::LoadFile() and wxFileSystem
+    still use wxFileInputStream for them, and this stream must be explicitly
+    created by the code which can ensure that the file is not truncated while
+    it is being read.
+
+    @library{wxbase}
+    @category{streams}
+
+    @see wxMappedFile, wxFileInputStream
+
+    @since 3.1.0
+*/
+class wxMappedInputStream : public wxMemoryInputStream
+{
+public:
+    /**
+        Maps the given file and creates the stream reading from it.
+
+        Use IsOk() to check if the file could be mapped.
+    */
+    explicit wxMappedInputStream(const wxString& filename);
+
+    /**
+        Returns @true if the file was successfully mapped and no errors
+        occurred on the stream.
+    */
+    virtual bool IsOk() const;
+};
@@ -26,7 +26,16 @@ enum wxMessageQueueError
     wxMSGQUEUE_TIMEOUT,
 
     /// Some unexpected (and fatal) error has occurred.
-    wxMSGQUEUE_MISC_ERROR
+    wxMSGQUEUE_MISC_ERROR,
+
+    /**
+        Indicates that the message couldn't be posted because the queue is full.
+
+        This return value is only used by wxLockFreeMessageQueue<>::Post().
+
+        @since 3.1.0
+     */
+    wxMSGQUEUE_FULL
 };
 
 /**
@@ -109,3 +118,89 @@ public:
     wxMessageQueueError ReceiveTimeout(long timeout, T& msg);
 };
 
+
+/**
+    wxLockFreeMessageQueue is a bounded message queue not using any locks.
+
+    This class has the same API as wxMessageQueue and can be used instead of
+    it, but it doesn't use any locks for posting or receiving the messages,
+    which makes it scale much better when several threads post messages to the
+    same queue, or receive messages from it, concurrently. The mutex and the
+    condition are only used to block the receiving threads when the queue is
+    empty, and to wake them up when a new message is posted.
+
+    The price to pay for this is that the capacity of the queue is fixed when
+    it is created: if it is exceeded, Post() fails with @b wxMSGQUEUE_FULL
+    and the caller is responsible for trying again later.
+
+    @tparam T
+        For this class a message is an object of arbitrary type T which must
+        be default constructible and assignable.
+
+    @since 3.1.0
+    @category{threading}
+*/
+template <typename T>
+class wxLockFreeMessageQueue
+{
+public:
+    /// The type of the messages transported by this queue
+    typedef T Message;
+
+    /**
+        Constructor. Creates a queue able to hold at least @a capacity messages.
+
+        The actual capacity is rounded up to the next power of 2, see
+        GetCapacity().
+    */
+    explicit wxLockFreeMessageQueue(size_t capacity);
+
+    /**
+        Returns the maximal number of messages the queue can hold.
+    */
+    size_t GetCapacity() const;
+
+    /**
+        Remove all messages from the queue.
+    */
+    wxMessageQueueError Clear();
+
+    /**
+        Returns @true if the object had been initialized successfully, @false
+        if an error occurred.
+    */
+    bool IsOk() const;
+
+    /**
+        Add a message to this queue and signal the threads waiting for messages.
+
+        Returns @b wxMSGQUEUE_FULL if there is no space left in the queue.
+
+        This method is safe to call from multiple threads in parallel.
+    */
+    wxMessageQueueError Post(T const& msg);
+
+    /**
+        Block until a message becomes available in the queue.
+        Waits indefinitely long or until an error occurs.
+
+        The message is returned in @a msg.
+
+        This method is safe to call from multiple threads in parallel.
+    */
+    wxMessageQueueError Receive(T& msg);
+
+    /**
+        Block until a message becomes available in the queue, but no more than
+        @a timeout milliseconds has elapsed.
+
+        If no message is available after @a timeout milliseconds then returns
+        @b wxMSGQUEUE_TIMEOUT.
+
+        If @a timeout is 0 then checks for any messages present in the queue
+        and returns immediately without waiting.
+
+        The message is returned in @a msg.
+    */
+    wxMessageQueueError ReceiveTimeout(long timeout, T& msg);
+};
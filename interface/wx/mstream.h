@@ -132,5 +132,25 @@ public:
         for that stream.
     */
     wxStreamBuffer* GetInputStreamBuffer() const;
+
+    /**
+        Returns the pointer to the data which would be returned by the next
+        call to Read().
+
+        This function allows to access the stream data directly, without
+        copying it. After using the data, SeekI() with @c wxFromCurrent mode
+        can be used to skip over it.
+
+        @param len
+            Receives the number of bytes remaining in the stream, must be
+            non-@NULL.
+        @return
+            Pointer to the current stream data or @NULL if it can't be
+            accessed directly because some data was put back into the stream
+            using Ungetch().
+
+        @since 3.1.0
+    */
+    const void* GetCurrentData(size_t* len) const;
 };
 
@@ -70,10 +70,14 @@ public:
         In such case, you may want to use wxInputStream::LastRead() method in a loop
         to get the total size.
 
+        Responses using chunked transfer encoding are decoded transparently.
+
         @return Returns the initialized stream. You must delete it yourself
                  once you don't use it anymore and this must be done before
                  the wxHTTP object itself is destroyed. The destructor
-                 closes the network connection. The next time you will
+                 closes the network connection unless the entire response
+                 had been read and the connection can be kept alive, see
+                 SetKeepAlive(). Otherwise the next time you will
                  try to get a file the network connection will have to
                  be reestablished, but you don't have to take care of
                  this since wxHTTP reestablishes it automatically.
@@ -172,5 +176,37 @@ public:
     bool SetPostText(const wxString& contentType,
                      const wxString& data,
                      const wxMBConv& conv = wxConvUTF8);
+
+    /**
+        Set whether the connection should be kept open between requests.
+
+        If this option is on, which is the default, the connection to the
+        server is kept open after the response to a request has been entirely
+        read from the stream returned by GetInputStream() and is reused for
+        the next request to the same server, if the server allows it. This
+        avoids the overhead of establishing a new connection for each request.
+
+        If it is off, a new connection is used for each request and the
+        server is asked to close it after sending its response.
+
+        If the server closes the kept alive connection before sending anything
+        back, GetInputStream() sends the request again using a new connection,
+        but only if its method is idempotent, i.e. one of GET, HEAD, PUT,
+        DELETE or OPTIONS. Otherwise, or if the server doesn't respond in time,
+        GetInputStream() fails and the request can be sent again by calling it
+        once more, as the post data and headers are preserved in this case.
+
+        @since 3.1.0
+     */
+    void SetKeepAlive(bool keepAlive);
+
+    /**
+        Return whether persistent connections are used.
+
+        @see SetKeepAlive()
+
+        @since 3.1.0
+     */
+    bool GetKeepAlive() const;
 };
 
@@ -2147,11 +2147,29 @@ public:
 
     bool GetDelayedImageLoading() const { return m_enableDelayedImageLoading; }
 
+    /**
+        Enable or disable caching the extents of the text measured while laying
+        out, until wxRichTextPlainText::ClearExtentsCache() is called.
+
+        @since 3.1.0
+    */
+
+    void EnableTextExtentsCache(bool b) { m_enableTextExtentsCache = b; }
+
+    /**
+        Returns @true if caching the text extents is enabled.
+
+        @since 3.1.0
+    */
+
+    bool GetTextExtentsCacheEnabled() const { return m_enableTextExtentsCache; }
+
     wxRichTextBuffer*   m_buffer;
     bool                m_enableVirtualAttributes;
     bool                m_enableImages;
     bool                m_enableDelayedImageLoading;
     bool                m_layingOut;
+    bool                m_enableTextExtentsCache;
 };
 
 /**
@@ -2858,6 +2876,14 @@ public:
     */
     bool DeleteChildren() ;
 
+    /**
+        Called when the list of children changes. If you modify the list
+        returned by GetChildren() directly, call this function afterwards.
+
+        @since 3.1.0
+    */
+    virtual void OnChildrenChanged();
+
     /**
         Recursively merges all pieces that can be merged.
     */
@@ -2896,6 +2922,10 @@ public:
 
     virtual int HitTest(wxDC& dc, wxRichTextDrawingContext& context, const wxPoint& pt, long& textPosition, wxRichTextObject** obj, wxRichTextObject** contextObj, int flags = 0);
 
+    virtual bool FindPosition(wxDC& dc, wxRichTextDrawingContext& context, long index, wxPoint& pt, int* height, bool forceLineStart);
+
+    virtual void OnChildrenChanged();
+
     virtual bool Draw(wxDC& dc, wxRichTextDrawingContext& context, const wxRichTextRange& range, const wxRichTextSelection& selection, const wxRect& rect, int descent, int style);
 
     virtual bool Layout(wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, const wxRect& parentRect, int style);
@@ -4395,6 +4425,14 @@ public:
     */
     void SetText(const wxString& text) { m_text = text; }
 
+    /**
+        Frees the text extents cached while laying out this object with a
+        context with wxRichTextDrawingContext::EnableTextExtentsCache().
+
+        @since 3.1.0
+    */
+    void ClearExtentsCache();
+
 // Operations
 
     // Copies the text object,
@@ -55,6 +55,8 @@
 #define wxRICHTEXT_DEFAULT_DELAYED_LAYOUT_THRESHOLD 20000
 // Milliseconds before layout occurs after resize
 #define wxRICHTEXT_DEFAULT_LAYOUT_INTERVAL 50
+// Milliseconds spent on laying out a part of the buffer in each idle event
+#define wxRICHTEXT_DEFAULT_LAYOUT_PART_DURATION 30
 // Milliseconds before delayed image processing occurs
 #define wxRICHTEXT_DEFAULT_DELAYED_IMAGE_PROCESSING_INTERVAL 200
 
@@ -1379,6 +1381,21 @@ public:
     */
     virtual void DoLayoutBuffer(wxRichTextBuffer& buffer, wxDC& dc, wxRichTextDrawingContext& context, const wxRect& rect, const wxRect& parentRect, int flags);
 
+    /**
+        Lays out the next part of the buffer when the delayed full layout is
+        being performed in idle time, keeping the text shown at the top of the
+        window in place. Returns @true if there is still more to lay out.
+
+        When the control is resized, large buffers (see
+        SetDelayedLayoutThreshold()) are laid out in several parts, each
+        taking approximately @c wxRICHTEXT_DEFAULT_LAYOUT_PART_DURATION
+        milliseconds, during idle time instead of all at once, to keep the
+        program responsive.
+
+        @since 3.1.0
+    */
+    virtual bool LayoutNextPart();
+
     /**
         Move the caret to the given character position.
 
@@ -272,6 +272,35 @@ public:
         @see Accept(), AcceptWith(), wxSocketBase::InterruptWait()
     */
     bool WaitForAccept(long seconds = -1, long millisecond = 0);
+
+    /**
+        Accept an incoming connection asynchronously.
+
+        This function returns immediately and the handler
+        wxSocketAsyncHandler::OnAsyncAccept() method is called from the event
+        loop once a new connection is accepted. The @c wxSOCKET_CONNECTION
+        events are not generated while the operation is pending.
+
+        See wxSocketBase::AsyncRead() for more information about asynchronous
+        operations.
+
+        @param handler
+            The handler to notify, must be non-@NULL.
+        @return
+            @true if the operation was started or @false if it couldn't be,
+            e.g. because another asynchronous accept is already pending.
+
+        @since 3.1.0
+    */
+    bool AsyncAccept(wxSocketAsyncHandler *handler);
+
+    /**
+        Returns @true if an operation started by AsyncAccept() hasn't
+        completed yet.
+
+        @since 3.1.0
+    */
+    bool IsAsyncAcceptPending() const;
 };
 
 
@@ -696,6 +725,118 @@ enum
 };
 
 
+/**
+    Describes a buffer used with wxSocketBase::ReadV() and
+    wxSocketBase::WriteV().
+
+    This is similar to the standard POSIX @c iovec structure. Notice that,
+    just as with it, the data pointer is not const even when the buffer is
+    only used for writing, but the data is not modified by WriteV().
+
+    @library{wxnet}
+    @category{net}
+
+    @since 3.1.0
+*/
+struct wxSocketBuffer
+{
+    /// Default constructor creates an empty buffer.
+    wxSocketBuffer();
+
+    /// Constructor initializing both fields.
+    wxSocketBuffer(const void *data, wxUint32 size);
+
+    /// Pointer to the buffer data.
+    void *data;
+
+    /// Size of the buffer in bytes.
+    wxUint32 size;
+};
+
+
+/**
+    @class wxSocketAsyncHandler
+
+    Base class for the objects notified about the completion of the
+    asynchronous operations started by wxSocketBase::AsyncRead(),
+    wxSocketBase::AsyncWrite() and wxSocketServer::AsyncAccept().
+
+    Override the methods corresponding to the operations you start, the
+    default implementations of all of them do nothing.
+
+    The handlers are called from the event loop when the socket becomes ready,
+    so an event loop must be running for the asynchronous operations to make
+    progress. The socket must not be deleted from inside a handler, use
+    wxSocketBase::Destroy() instead if necessary. It is however allowed to
+    start another asynchronous operation, e.g. to read the next chunk of data,
+    from a handler.
+
+    @library{wxnet}
+    @category{net}
+
+    @since 3.1.0
+*/
+class wxSocketAsyncHandler
+{
+public:
+    /// Default constructor.
+    wxSocketAsyncHandler();
+
+    /// Virtual destructor for the base class.
+    virtual ~wxSocketAsyncHandler();
+
+    /**
+        Called when wxSocketBase::AsyncRead() completes.
+
+        @param socket
+            The socket on which the operation was started.
+        @param error
+            wxSOCKET_NOERROR if the operation succeeded or the error code
+            otherwise, e.g. wxSOCKET_IOERR if the connection was lost.
+        @param nbytes
+            The number of bytes read into the buffer, which may be less than
+            requested even if no error occurred unless wxSOCKET_WAITALL_READ
+            is used.
+    */
+    virtual void OnAsyncRead(wxSocketBase& socket,
+                             wxSocketError error,
+                             wxUint32 nbytes);
+
+    /**
+        Called when wxSocketBase::AsyncWrite() completes.
+
+        @param socket
+            The socket on which the operation was started.
+        @param error
+            wxSOCKET_NOERROR if all the data was written or the error code
+            otherwise.
+        @param nbytes
+            The number of bytes written, which is always equal to the number
+            of bytes passed to AsyncWrite() if no error occurred.
+    */
+    virtual void OnAsyncWrite(wxSocketBase& socket,
+                              wxSocketError error,
+                              wxUint32 nbytes);
+
+    /**
+        Called when wxSocketServer::AsyncAccept() completes.
+
+        @param server
+            The server socket on which the operation was started.
+        @param error
+            wxSOCKET_NOERROR if a new connection was accepted or the error
+            code otherwise.
+        @param socket
+            The new socket representing the accepted connection, which is
+            owned by the handler and must be destroyed by it, or @NULL if an
+            error occurred.
+    */
+    virtual void OnAsyncAccept(wxSocketServer& server,
+                               wxSocketError error,
+                               wxSocketBase *socket);
+};
+
+
 /**
     @class wxSocketBase
 
@@ -954,6 +1095,9 @@ public:
         you won't need to do it yourself, unless you explicitly want to shut down
         the socket, typically to notify the peer that you are closing the connection.
 
+        If write buffering is used, see SetWriteBufferSize(), any data remaining
+        in the write buffer is sent before closing the socket.
+
         @remarks
         Although Close() immediately disables events for the socket, it is possible
         that event messages may be waiting in the application's event queue.
@@ -983,6 +1127,37 @@ public:
     */
     wxSocketBase& Discard();
 
+    /**
+        Send the data accumulated in the write buffer.
+
+        This function is only useful if write buffering is enabled, see
+        SetWriteBufferSize(), and must be called to ensure that all the data
+        previously written to the socket is really sent, e.g. before waiting
+        for a reply to it.
+
+        It always waits until all the buffered data is sent, as if the @b
+        wxSOCKET_WAITALL flag were set, unless an error occurs or the timeout
+        expires.
+
+        This function doesn't change the value returned by LastCount() or
+        LastWriteCount().
+
+        @return @true if all the buffered data was sent, @false otherwise.
+
+        @since 3.1.0
+    */
+    bool Flush();
+
+    /**
+        Returns the size of the write buffer or 0 if write buffering is not
+        used.
+
+        @see SetWriteBufferSize()
+
+        @since 3.1.0
+    */
+    wxUint32 GetWriteBufferSize() const;
+
     /**
         Returns current IO flags, as set with SetFlags()
     */
@@ -1086,6 +1261,30 @@ public:
     */
     wxSocketBase& ReadMsg(void* buffer, wxUint32 nbytes);
 
+    /**
+        Read data from the socket into several buffers.
+
+        This function is similar to Read() but fills the given buffers in
+        order, using a single system call (@c readv()) when possible. It
+        behaves exactly as if Read() were called for a single buffer
+        containing all the data.
+
+        Use LastReadCount() to verify the total number of bytes actually read.
+        Use Error() to determine if the operation succeeded.
+
+        @param buffers
+            Array of buffers to read the data into.
+        @param count
+            Number of elements in the array.
+
+        @return Returns a reference to the current object.
+
+        @see Read(), WriteV()
+
+        @since 3.1.0
+    */
+    wxSocketBase& ReadV(const wxSocketBuffer *buffers, unsigned count);
+
     /**
         Use SetFlags to customize IO operation for this socket.
 
@@ -1325,6 +1524,160 @@ public:
     */
     wxSocketBase& WriteMsg(const void* buffer, wxUint32 nbytes);
 
+    /**
+        Write data from several buffers to the socket.
+
+        This function is similar to Write() but sends the data from all the
+        given buffers, in order, using a single system call (@c sendmsg())
+        when possible instead of one call per buffer. This avoids both the
+        overhead of extra system calls and the delays which can result from
+        sending several small packets with Nagle's algorithm enabled.
+
+        For datagram sockets, all the data is sent as a single datagram.
+
+        Use LastWriteCount() to verify the total number of bytes actually
+        written. Use Error() to determine if the operation succeeded.
+
+        @param buffers
+            Array of buffers with the data to be sent.
+        @param count
+            Number of elements in the array.
+
+        @return Returns a reference to the current object.
+
+        @see Write(), ReadV()
+
+        @since 3.1.0
+    */
+    wxSocketBase& WriteV(const wxSocketBuffer *buffers, unsigned count);
+
+    /**
+        Enable or disable write buffering.
+
+        If @a size is non-zero, the data written to the socket by Write(),
+        WriteV() and WriteMsg() is not sent immediately but accumulated in an
+        internal buffer of the given size. The buffered data is sent, together
+        with the new data, when the buffer becomes full, or when Flush() or
+        Close() is called. This allows to send many small chunks of data
+        using much fewer system calls, but it means that Flush() must be
+        called explicitly before waiting for the peer to reply to the data
+        sent.
+
+        The data accumulated in the buffer is considered to have been
+        written by LastWriteCount().
+
+        Passing 0 disables buffering, which is the default. If the existing
+        buffer contains more data than fits into the new one, it is sent
+        first.
+
+        Write buffering can't be used with datagram sockets.
+
+        @see GetWriteBufferSize(), Flush()
+
+        @since 3.1.0
+    */
+    void SetWriteBufferSize(wxUint32 size);
+
+    //@}
+
+
+    /**
+        @name Asynchronous I/O
+
+        These functions start an operation and return immediately, without
+        waiting for it to complete. Instead, the wxSocketAsyncHandler passed
+        to them is notified when the operation completes. This allows to
+        handle many sockets from a single thread without using any blocking
+        calls.
+
+        At most one asynchronous read and one asynchronous write can be
+        pending for the same socket at any time, but they can be pending
+        simultaneously. The asynchronous operations can be started on a
+        client socket which is still connecting, they will proceed once the
+        connection is established.
+
+        The socket events corresponding to the asynchronous operations, e.g.
+        @c wxSOCKET_INPUT while an asynchronous read is pending, are not
+        generated, while @c wxSOCKET_LOST is still sent after completing all
+        the pending operations with an error.
+
+        @since 3.1.0
+    */
+    //@{
+
+    /**
+        Start reading data asynchronously.
+
+        If any data was pushed back using Unread(), it is used first. The
+        handler is always called from the event loop, and never before this
+        function returns, once some data is available, even if the pushed back
+        data was enough. If wxSOCKET_WAITALL_READ flag is set, the handler is
+        only called when all @a nbytes were read or an error occurred.
+
+        @param buffer
+            Buffer receiving the data, it must remain valid until the handler
+            is called or the operation is cancelled.
+        @param nbytes
+            The maximal number of bytes to read, must be positive.
+        @param handler
+            The handler to notify, must be non-@NULL and remain valid until
+            it is called or the operation is cancelled.
+        @return
+            @true if the operation was started or @false if it couldn't be,
+            e.g. because the socket is not connected or another asynchronous
+            read is already pending.
+
+        @see AsyncWrite(), CancelAsync()
+    */
+    bool AsyncRead(void *buffer, wxUint32 nbytes,
+                   wxSocketAsyncHandler *handler);
+
+    /**
+        Start writing data asynchronously.
+
+        As much data as possible is written immediately, but the handler is
+        always called from the event loop later, after all @a nbytes were
+        written or an error occurred. Any data accumulated in the write
+        buffer, see SetWriteBufferSize(), is sent first, as part of this
+        operation and without blocking, but is not counted in the number of
+        bytes passed to the handler.
+
+        @param buffer
+            The data to write, it must remain valid until the handler is
+            called or the operation is cancelled.
+        @param nbytes
+            The number of bytes to write, must be positive.
+        @param handler
+            The handler to notify, must be non-@NULL and remain valid until
+            it is called or the operation is cancelled.
+        @return
+            @true if the operation was started or @false if it couldn't be.
+
+        @see AsyncRead(), CancelAsync()
+    */
+    bool AsyncWrite(const void *buffer, wxUint32 nbytes,
+                    wxSocketAsyncHandler *handler);
+
+    /**
+        Returns @true if an asynchronous read started by AsyncRead() hasn't
+        completed yet.
+    */
+    bool IsAsyncReadPending() const;
+
+    /**
+        Returns @true if an asynchronous write started by AsyncWrite() hasn't
+        completed yet.
+    */
+    bool IsAsyncWritePending() const;
+
+    /**
+        Cancel all pending asynchronous operations.
+
+        The handlers of the cancelled operations are not called. This is done
+        automatically when the socket is closed.
+    */
+    void CancelAsync();
+
     //@}
 
 
@@ -84,6 +84,29 @@
     @endFlagTable
 
 
+    @section sysopt_unix Unix
+
+    @beginFlagTable
+    @flag{unix.timer.slack}
+        If set to a positive value, the expiration times of wxTimer used in
+        console applications (and in the ports using the Unix event loop
+        implementation, such as wxDFB) are rounded up to a multiple of this
+        number of milliseconds, so that the timers expiring close to each other
+        are notified together, reducing the number of program wake-ups at the
+        price of notifying them up to this number of milliseconds late.
+        Default: 0, meaning that no rounding is done. This option must be set
+        before starting any timers to take effect. This option is available
+        since wxWidgets 3.1.0.
+    @flag{unix.epoll.max-events}
+        The maximal number of events retrieved from epoll in a single call
+        when using epoll-based event loop, i.e. in console applications and
+        in the ports using the Unix event loop implementation under Linux.
+        Increasing it may help programs monitoring a lot of descriptors.
+        Default: 256. This option must be set before the event loop is
+        created to take effect and is available since wxWidgets 3.1.0.
+    @endFlagTable
+
+
     @section sysopt_gtk GTK+
 
     @beginFlagTable
@@ -403,3 +403,149 @@ public:
     wxTarEntry& operator operator=(const wxTarEntry& entry);
 };
 
+
+
+/**
+    @class wxTarArchive
+
+    Random access reader for tar archives.
+
+    Tar archives don't have a central directory, so finding an entry in them
+    with wxTarInputStream requires reading all the preceding headers. This
+    class reads all of them only once, when it is created, and builds an index
+    allowing to quickly find the entries by their names using Find(). The data
+    of the entries is then read by seeking directly to it, so that any entry
+    can be accessed without reading the rest of the archive.
+
+    As building the index can still take a long time for big archives, it can
+    be saved into a separate file using SaveIndex() and loaded from it when
+    the archive is opened later. The index file is only used if the archive
+    size and modification time didn't change since it was created.
+
+    Any number of entries can be read at the same time, as each stream
+    returned by OpenEntry() uses its own file, including from different
+    threads.
+
+    Example of extracting a single file from a big archive:
+    @code
+    wxTarArchive archive("data.tar", "data.tar.idx");
+    wxScopedPtr<wxInputStream> in(archive.OpenEntry("docs/readme.txt"));
+    if ( in )
+    {
+        wxFileOutputStream out("readme.txt");
+        in->Read(out);
+    }
+    @endcode
+
+    @library{wxbase}
+    @category{archive,streams}
+
+    @see wxTarInputStream, wxZipArchive, wxThreadPool
+
+    @since 3.1.0
+*/
+class wxTarArchive
+{
+public:
+    /**
+        Opens the archive in the given file.
+
+        If @a indexFile is not empty and contains an up to date index of this
+        archive, it is used instead of reading the archive headers. Otherwise
+        the index is built by reading them and saved into @a indexFile, if it
+        is specified.
+
+        Use IsOk() to check if the archive was opened successfully.
+    */
+    wxTarArchive(const wxString& filename,
+                 const wxString& indexFile = wxEmptyString,
+                 wxMBConv& conv = wxConvLocal);
+
+    /**
+        Destructor.
+    */
+    ~wxTarArchive();
+
+    /**
+        Returns @true if the archive was opened and indexed successfully.
+    */
+    bool IsOk() const;
+
+    /**
+        Saves the index of the archive into the given file.
+
+        The saved index can be used by passing its name to the constructor.
+    */
+    bool SaveIndex(const wxString& indexFile) const;
+
+    /**
+        Returns the number of entries in the archive.
+    */
+    size_t GetCount() const;
+
+    /**
+        Returns the entry with the given index.
+
+        The entries are owned by the archive and must not be modified.
+    */
+    const wxTarEntry& GetEntry(size_t n) const;
+
+    /**
+        Returns the index of the entry with the given name or @c wxNOT_FOUND.
+
+        This function uses a hash table and so is fast even for archives with
+        many entries. If there are several entries with the same name, the
+        index of the last one, which would replace the others when extracting
+        the archive, is returned.
+    */
+    int Find(const wxString& name, wxPathFormat format = wxPATH_NATIVE) const;
+
+    /**
+        Returns a new stream reading the data of the given entry.
+
+        The returned stream must be deleted by the caller. It is positioned
+        at the start of the entry data directly, without reading the archive
+        from the beginning.
+
+        This function is thread-safe and the streams returned by it are
+        independent of each other, so they can be used from different threads.
+
+        Returns @NULL if the entry can't be read.
+    */
+    wxTarInputStream* OpenEntry(size_t n) const;
+
+    /**
+        Returns a new stream reading the data of the entry with the given
+        name.
+
+        This is the same as calling Find() and then OpenEntry() with the
+        returned index, and also returns @NULL if there is no such entry.
+    */
+    wxTarInputStream* OpenEntry(const wxString& name,
+                                wxPathFormat format = wxPATH_NATIVE) const;
+
+    /**
+        Extracts all regular files and directories into the given directory.
+
+        The directory and all the directories for the entries are created if
+        necessary, while the files are extracted in parallel by the threads
+        of the given pool or of the global pool, as returned by
+        wxThreadPool::Get(), if it is @NULL. Links and special files are
+        skipped.
+
+        The entries with the names which would result in them being created
+        outside of @a dir are not extracted.
+
+        Returns @false if any of the entries couldn't be extracted.
+    */
+    bool ExtractAll(const wxString& dir, wxThreadPool* pool = NULL) const;
+
+    /**
+        Extracts the given entry into a file with the given path.
+
+        The directory containing the file must already exist.
+
+        This function is thread-safe.
+    */
+    bool Extract(size_t n, const wxString& path) const;
+};
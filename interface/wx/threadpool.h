@@ -0,0 +1,252 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        wx/threadpool.h
+// Purpose:     interface of wxThreadPool and related classes
+// Author:      wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+/**
+    @class wxThreadPoolTask
+
+    Base class for the tasks executed by wxThreadPool.
+
+    Derive from this class and override its Execute() method to do the
+    actual work. The task objects also serve as "futures": the results of
+    the task, which are typically stored in the derived class members, may be
+    retrieved once IsDone() returns @true or after calling Wait().
+
+    The objects of this class are reference counted, as they are shared
+    between the code submitting them and the pool, and must be allocated on
+    the heap. A newly created task has the reference count of 1, so DecRef()
+    must be called when it is not needed any more instead of deleting it,
+    e.g.
+    @code
+    class SumTask : public wxThreadPoolTask
+    {
+    public:
+        SumTask(const wxVector<int>& values) : m_values(values), m_sum(0) { }
+
+        int GetSum() const { return m_sum; }
+
+    protected:
+        virtual void Execute()
+        {
+            for ( size_t n = 0; n < m_values.size(); n++ )
+                m_sum += m_values[n];
+        }
+
+    private:
+        const wxVector<int> m_values;
+        int m_sum;
+    };
+
+    SumTask* task = new SumTask(values);
+    wxThreadPool::Get().Submit(task);
+
+    ... do something else ...
+
+    task->Wait();
+    wxLogMessage("Sum is %d", task->GetSum());
+    task->DecRef();
+    @endcode
+
+    wxObjectDataPtr<> can also be used for managing the tasks lifetime.
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThreadPool
+
+    @since 3.1.0
+*/
+class wxThreadPoolTask
+{
+public:
+    /**
+        Default constructor.
+
+        The reference count of the new object is 1.
+    */
+    wxThreadPoolTask();
+
+    /**
+        Increment the reference count of the task.
+
+        This function is thread-safe.
+    */
+    void IncRef();
+
+    /**
+        Decrement the reference count of the task and delete it if it
+        becomes 0.
+
+        This function is thread-safe.
+    */
+    void DecRef();
+
+    /**
+        Request a notification when the task completes.
+
+        If this function is called, a wxThreadEvent of type @c wxEVT_THREAD
+        and with the given @a id is queued to the @a handler using
+        wxEvtHandler::QueueEvent() after the task execution. This is the
+        simplest way to learn about the task completion in the main thread.
+
+        The @a handler must remain alive until the task is executed.
+
+        This function must be called before submitting the task to the pool.
+    */
+    void SetNotifyHandler(wxEvtHandler* handler, int id = wxID_ANY);
+
+    /**
+        Returns @true if the task has already been executed.
+    */
+    bool IsDone() const;
+
+    /**
+        Wait until the task is executed.
+
+        If the task hasn't been started by any of the pool threads yet, it is
+        executed directly in the calling thread by this function. This means
+        that it is safe to call it from inside another task executed by the
+        same pool, even if it has only a single thread.
+    */
+    void Wait();
+
+protected:
+    /**
+        Destructor is protected, use DecRef() instead of deleting the task.
+    */
+    virtual ~wxThreadPoolTask();
+
+    /**
+        Override this function to perform the task.
+
+        It is called exactly once, either from one of the pool threads or
+        from the thread calling Wait().
+    */
+    virtual void Execute() = 0;
+};
+
+/**
+    @class wxParallelForBody
+
+    The work to be done by wxThreadPool::ParallelFor().
+
+    @library{wxbase}
+    @category{threading}
+
+    @since 3.1.0
+*/
+class wxParallelForBody
+{
+public:
+    /// Default constructor.
+    wxParallelForBody();
+
+    /// Trivial but virtual destructor.
+    virtual ~wxParallelForBody();
+
+    /**
+        Process all elements in the [@a first, @a last) range.
+
+        This function is called from several threads at once for different,
+        non overlapping ranges, so it must be thread-safe.
+    */
+    virtual void Process(int first, int last) = 0;
+};
+
+/**
+    @class wxThreadPool
+
+    Thread pool executes tasks in a fixed set of threads.
+
+    Using a thread pool avoids the overhead of creating a new thread for each
+    task. Most programs should use the global pool returned by Get(), but it
+    is also possible to create additional pools.
+
+    Each thread of the pool has its own queue of tasks: the tasks submitted
+    from outside of the pool are distributed among the threads in round robin
+    order, while the tasks submitted from inside another task are added to
+    the queue of the thread executing it, as they are likely to use the same
+    data. A thread without any tasks in its queue steals them from the other
+    threads queues, so that all of them are kept busy.
+
+    Besides executing individual wxThreadPoolTask objects, the pool can also
+    be used to process a range of elements in parallel using ParallelFor().
+
+    @library{wxbase}
+    @category{threading}
+
+    @see wxThread, wxMessageQueue
+
+    @since 3.1.0
+*/
+class wxThreadPool
+{
+public:
+    /**
+        Create the pool with the given number of threads.
+
+        If @a numThreads is 0, as many threads as there are CPUs in the
+        system, as returned by wxThread::GetCPUCount(), are created.
+    */
+    explicit wxThreadPool(int numThreads = 0);
+
+    /**
+        Destructor waits until all the already submitted tasks are executed
+        and stops the pool threads.
+    */
+    ~wxThreadPool();
+
+    /**
+        Returns @false if the pool threads couldn't be created.
+    */
+    bool IsOk() const;
+
+    /**
+        Returns the number of threads in the pool.
+    */
+    int GetThreadCount() const;
+
+    /**
+        Schedule the task for execution by one of the pool threads.
+
+        The pool keeps a reference to the task until it is executed, so the
+        caller may call wxThreadPoolTask::DecRef() immediately if it is not
+        interested in the task results.
+
+        Returns @false if the task couldn't be submitted because the pool is
+        not usable.
+    */
+    bool Submit(wxThreadPoolTask* task);
+
+    /**
+        Process all elements in [@a first, @a last) range in parallel.
+
+        This function divides the range in @a numChunks parts of roughly
+        equal size and calls wxParallelForBody::Process() for each of them,
+        with the calling thread processing the first one itself. It only
+        returns once all of them have been processed.
+
+        @param first
+            The first element of the range.
+        @param last
+            One past the last element of the range.
+        @param body
+            The object doing the actual processing.
+        @param numChunks
+            The number of parts to divide the range into. If it is 0, the
+            number of threads in the pool is used.
+    */
+    void ParallelFor(int first, int last, wxParallelForBody& body,
+                     int numChunks = 0);
+
+    /**
+        Returns the global thread pool.
+
+        The pool is created with the default number of threads on first use
+        and is destroyed when the library is shut down.
+    */
+    static wxThreadPool& Get();
+};
@@ -232,6 +232,33 @@ public:
                             int selImage = -1,
                             wxTreeItemData* data = NULL);
 
+    /**
+        Appends several items to the end of the branch identified by
+        @a parent.
+
+        This is equivalent to calling AppendItem() for each of the elements
+        of @a texts, but is much faster in the generic version when adding
+        many items at once.
+
+        @param parent
+            The item to append the new items to.
+        @param texts
+            The labels of the items to append.
+        @param image
+            The image to use for all new items, see AppendItem().
+        @param selImage
+            The image to use for all new items when they're selected.
+        @param ids
+            If non-@NULL, the ids of the new items are appended to this array.
+
+        @since 3.1.0
+    */
+    void AppendItems(const wxTreeItemId& parent,
+                     const wxArrayString& texts,
+                     int image = -1,
+                     int selImage = -1,
+                     wxArrayTreeItemIds* ids = NULL);
+
     /**
         Sets the buttons image list. The button images assigned with this method
         will be automatically deleted by wxTreeCtrl as appropriate (i.e. it
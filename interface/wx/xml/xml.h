@@ -529,7 +529,7 @@ enum wxXmlDocumentLoadFlag
     @library{wxxml}
     @category{xml}
 
-    @see wxXmlNode, wxXmlAttribute
+    @see wxXmlNode, wxXmlAttribute, wxXmlReader
 */
 class wxXmlDocument : public wxObject
 {
@@ -727,3 +727,196 @@ public:
     static wxVersionInfo GetLibraryVersionInfo();
 };
 
+
+/**
+    Kinds of items returned by wxXmlReader::Next().
+
+    @since 3.1.0
+*/
+enum wxXmlReaderEvent
+{
+    /// No more items: the end of the document was reached or an error occurred.
+    wxXML_READER_NONE,
+
+    /// Start of an element, its attributes are available.
+    wxXML_READER_START_ELEMENT,
+
+    /// End of an element. This is also returned for empty elements.
+    wxXML_READER_END_ELEMENT,
+
+    /// Text contents of an element.
+    wxXML_READER_TEXT,
+
+    /// CDATA section.
+    wxXML_READER_CDATA,
+
+    /// Comment.
+    wxXML_READER_COMMENT,
+
+    /// Processing instruction.
+    wxXML_READER_PI
+};
+
+/**
+    @class wxXmlReader
+
+    This class reads XML documents sequentially, one item at a time.
+
+    Unlike wxXmlDocument, it doesn't build the tree of all the document nodes
+    in memory, so the memory used by it doesn't depend on the size of the
+    document. This makes it more suitable for processing big documents,
+    especially if only a small part of their contents is needed.
+
+    Example of using it:
+    @code
+    wxFileInputStream stream("myfile.xml");
+    wxXmlReader reader(stream);
+
+    while ( reader.Next() != wxXML_READER_NONE )
+    {
+        if ( reader.GetEvent() == wxXML_READER_START_ELEMENT &&
+                reader.GetName() == "item" )
+        {
+            wxString id = reader.GetAttribute("id");
+
+            ...
+        }
+    }
+
+    if ( !reader.IsOk() )
+    {
+        ... the document was not well-formed ...
+    }
+    @endcode
+
+    The text of an element is always returned as a single
+    wxXML_READER_TEXT item, even if it is very long. Notice that, as with
+    wxXmlDocument::Load(), the items consisting of white space only are
+    skipped by default, use wxXMLDOC_KEEP_WHITESPACE_NODES to get them too.
+
+    @library{wxxml}
+    @category{xml}
+
+    @see wxXmlDocument
+
+    @since 3.1.0
+*/
+class wxXmlReader
+{
+public:
+    /**
+        Create the reader for the given stream.
+
+        The stream must remain valid for the entire reader lifetime.
+
+        @param stream
+            The stream to read the document from.
+        @param encoding
+            The encoding of the strings returned by the reader, only used in
+            ANSI build. The encoding of the document itself is determined
+            from its XML declaration.
+        @param flags
+            Either wxXMLDOC_NONE or wxXMLDOC_KEEP_WHITESPACE_NODES.
+    */
+    wxXmlReader(wxInputStream& stream,
+                const wxString& encoding = "UTF-8",
+                int flags = wxXMLDOC_NONE);
+
+    /**
+        Destructor.
+    */
+    ~wxXmlReader();
+
+    /**
+        Returns @false if an error occurred while parsing the document.
+
+        The error is also logged using wxLogError().
+    */
+    bool IsOk() const;
+
+    /**
+        Read the next item from the document.
+
+        Returns the kind of the item read, which can also be retrieved with
+        GetEvent() later, or wxXML_READER_NONE if there are no more items,
+        either because the end of the document was reached or because an
+        error occurred.
+    */
+    wxXmlReaderEvent Next();
+
+    /**
+        Returns the kind of the current item.
+    */
+    wxXmlReaderEvent GetEvent() const;
+
+    /**
+        Returns the name of the element for wxXML_READER_START_ELEMENT and
+        wxXML_READER_END_ELEMENT items or the target of a processing
+        instruction for wxXML_READER_PI.
+    */
+    const wxString& GetName() const;
+
+    /**
+        Returns the text for wxXML_READER_TEXT, wxXML_READER_CDATA and
+        wxXML_READER_COMMENT items or the data of a processing instruction
+        for wxXML_READER_PI.
+    */
+    const wxString& GetContent() const;
+
+    /**
+        Returns the number of attributes of the element.
+
+        Only elements being started, i.e. wxXML_READER_START_ELEMENT items,
+        have attributes.
+    */
+    size_t GetAttributeCount() const;
+
+    /**
+        Returns the name of the attribute with the given index.
+    */
+    const wxString& GetAttributeName(size_t n) const;
+
+    /**
+        Returns the value of the attribute with the given index.
+    */
+    const wxString& GetAttributeValue(size_t n) const;
+
+    /**
+        Returns @true if the element has an attribute with the given name.
+    */
+    bool HasAttribute(const wxString& attrName) const;
+
+    /**
+        Returns the value of the attribute with the given name or
+        @a defaultVal if there is no such attribute.
+    */
+    wxString GetAttribute(const wxString& attrName,
+                          const wxString& defaultVal = wxEmptyString) const;
+
+    /**
+        Returns the number of elements enclosing the current item.
+
+        This is 0 for the start and end of the root element and 1 for its
+        direct children.
+    */
+    int GetDepth() const;
+
+    /**
+        Returns the line of the document at which the current item was found.
+    */
+    int GetLineNumber() const;
+
+    /**
+        Returns the version of the document from its XML declaration.
+
+        This is only available after the first call to Next().
+    */
+    const wxString& GetVersion() const;
+
+    /**
+        Returns the encoding of the document from its XML declaration.
+
+        This is only available after the first call to Next().
+    */
+    const wxString& GetFileEncoding() const;
+};
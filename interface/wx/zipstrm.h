@@ -569,3 +569,129 @@ public:
     void SetComment(const wxString& comment);
 };
 
+
+
+
+/**
+    @class wxZipArchive
+
+    Random access reader for zip archives.
+
+    Unlike wxZipInputStream, this class reads the central directory of the
+    archive only once, when it is created, and builds an index allowing to
+    quickly find the entries by their names using Find(). It also allows to
+    read any number of entries at the same time, as each stream returned by
+    OpenEntry() is independent, including doing it from different threads.
+
+    The archive must be either in memory or in a file, which is mapped into
+    memory using wxMappedFile. Entries using compression methods other than
+    store and deflate are not supported.
+
+    Example of extracting all entries of an archive:
+    @code
+    wxZipArchive archive("assets.zip");
+    if ( !archive.IsOk() || !archive.ExtractAll("assets") )
+    {
+        wxLogError("Failed to extract assets.");
+    }
+    @endcode
+
+    @library{wxbase}
+    @category{archive,streams}
+
+    @see wxZipInputStream, wxThreadPool
+
+    @since 3.1.0
+*/
+class wxZipArchive
+{
+public:
+    /**
+        Opens the archive in the given file.
+
+        The file is mapped into memory and remains mapped for the lifetime of
+        this object. Use IsOk() to check if it was opened successfully.
+    */
+    wxZipArchive(const wxString& filename, wxMBConv& conv = wxConvLocal);
+
+    /**
+        Opens the archive in memory.
+
+        The data is not copied, so it must remain valid as long as this
+        object and any of the streams returned by OpenEntry() exist.
+    */
+    wxZipArchive(const void* data, size_t length, wxMBConv& conv = wxConvLocal);
+
+    /**
+        Destructor.
+
+        All streams returned by OpenEntry() must be deleted before destroying
+        the archive.
+    */
+    ~wxZipArchive();
+
+    /**
+        Returns @true if the archive was opened and its central directory was
+        read successfully.
+    */
+    bool IsOk() const;
+
+    /**
+        Returns the number of entries in the archive.
+    */
+    size_t GetCount() const;
+
+    /**
+        Returns the entry with the given index.
+
+        The entries are owned by the archive and must not be modified.
+    */
+    const wxZipEntry& GetEntry(size_t n) const;
+
+    /**
+        Returns the index of the entry with the given name or @c wxNOT_FOUND.
+
+        This function uses a hash table and so is fast even for archives with
+        many entries. If there are several entries with the same name, the
+        index of the first one is returned.
+    */
+    int Find(const wxString& name, wxPathFormat format = wxPATH_NATIVE) const;
+
+    /**
+        Returns a new stream reading the data of the given entry.
+
+        The returned stream must be deleted by the caller. Its length and crc
+        are checked when the end of the entry is reached and the error is
+        reported if they don't match the values in the archive.
+
+        This function is thread-safe and the streams returned by it are
+        independent of each other, so they can be used from different threads.
+
+        Returns @NULL if the entry can't be read.
+    */
+    wxInputStream* OpenEntry(size_t n) const;
+
+    /**
+        Extracts all entries into the given directory.
+
+        The directory and all the directories for the entries are created if
+        necessary, while the entries themselves are extracted in parallel by
+        the threads of the given pool or of the global pool, as returned by
+        wxThreadPool::Get(), if it is @NULL.
+
+        The entries with the names which would result in them being created
+        outside of @a dir are not extracted.
+
+        Returns @false if any of the entries couldn't be extracted.
+    */
+    bool ExtractAll(const wxString& dir, wxThreadPool* pool = NULL) const;
+
+    /**
+        Extracts the given entry into a file with the given path.
+
+        The directory containing the file must already exist.
+
+        This function is thread-safe.
+    */
+    bool Extract(size_t n, const wxString& path) const;
+};
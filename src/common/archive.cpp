@@ -17,6 +17,16 @@
 
 #include "wx/archive.h"
 
+#ifndef WX_PRECOMP
+    #include "wx/intl.h"
+    #include "wx/log.h"
+#endif
+
+#include "wx/atomic.h"
+#include "wx/filename.h"
+#include "wx/threadpool.h"
+#include "wx/private/archive.h"
+
 IMPLEMENT_ABSTRACT_CLASS(wxArchiveEntry, wxObject)
 IMPLEMENT_ABSTRACT_CLASS(wxArchiveClassFactory, wxFilterClassFactoryBase)
 
@@ -94,4 +104,118 @@ void wxArchiveClassFactory::Remove()
     }
 }
 
+
+/////////////////////////////////////////////////////////////////////////////
+// wxArchiveExtractor
+
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Extracts a range of the archive entries for ParallelFor().
+class wxArchiveExtractBody : public wxParallelForBody
+{
+public:
+    wxArchiveExtractBody(const wxArchiveExtractor& extractor,
+                         const wxVector<wxString>& paths)
+        : m_extractor(extractor),
+          m_paths(paths),
+          m_failed(0)
+    {
+    }
+
+    virtual void Process(int first, int last) wxOVERRIDE
+    {
+        for (int n = first; n < last; n++) {
+            if (!m_paths[n].empty() && !m_extractor.ExtractEntry(n, m_paths[n]))
+                wxAtomicInc(m_failed);
+        }
+    }
+
+    bool HasFailed() { return wxAtomicLoad(m_failed) != 0; }
+
+private:
+    const wxArchiveExtractor& m_extractor;
+    const wxVector<wxString>& m_paths;
+    wxAtomicInt m_failed;
+};
+
+} // anonymous namespace
+
+#endif // wxUSE_THREADS
+
+wxArchiveExtractor::wxArchiveExtractor(const wxString& dir, size_t count)
+  : m_dir(dir),
+    m_paths(count),
+    m_ok(true)
+{
+}
+
+void wxArchiveExtractor::AddEntry(size_t n, const wxArchiveEntry& entry)
+{
+    wxCHECK_RET(n < m_paths.size(), wxT("invalid archive entry index"));
+
+    if (entry.GetInternalName().empty())
+        return;
+
+    // don't allow the entries to escape from the target directory
+    const wxFileName internal(entry.GetInternalName(), wxPATH_UNIX);
+    if (internal.GetFullName() == wxT("..") ||
+            internal.GetDirs().Index(wxT("..")) != wxNOT_FOUND) {
+        wxLogError(_("Not extracting archive entry \"%s\" outside of \"%s\"."),
+                   entry.GetName(), m_dir);
+        m_ok = false;
+        return;
+    }
+
+    wxString path = m_dir + wxFILE_SEP_PATH + entry.GetName();
+    if (entry.IsDir()) {
+        m_dirs.push_back(path);
+        return;
+    }
+
+    m_dirs.push_back(wxFileName(path).GetPath());
+    m_paths[n].swap(path);
+}
+
+bool wxArchiveExtractor::Run(wxThreadPool *pool)
+{
+    // create the directories first, as doing it concurrently from several
+    // threads could fail, sorting them to skip the duplicates
+    wxVectorSort(m_dirs);
+
+    for (size_t n = 0; n < m_dirs.size(); n++) {
+        if (n > 0 && m_dirs[n] == m_dirs[n - 1])
+            continue;
+
+        if (!wxFileName::DirExists(m_dirs[n]) &&
+                !wxFileName::Mkdir(m_dirs[n], wxS_DIR_DEFAULT,
+                                   wxPATH_MKDIR_FULL))
+            m_ok = false;
+    }
+
+#if wxUSE_THREADS
+    if (!pool)
+        pool = &wxThreadPool::Get();
+
+    // use more chunks than threads as the entries may have very different
+    // sizes, the pool balances the work between its threads anyhow
+    wxArchiveExtractBody body(*this, m_paths);
+    pool->ParallelFor(0, m_paths.size(), body, 4*pool->GetThreadCount());
+
+    if (body.HasFailed())
+        m_ok = false;
+#else // !wxUSE_THREADS
+    wxUnusedVar(pool);
+
+    for (size_t n = 0; n < m_paths.size(); n++) {
+        if (!m_paths[n].empty() && !ExtractEntry(n, m_paths[n]))
+            m_ok = false;
+    }
+#endif // wxUSE_THREADS/!wxUSE_THREADS
+
+    return m_ok;
+}
+
 #endif // wxUSE_STREAMS && wxUSE_ARCHIVE_STREAMS
@@ -40,6 +40,7 @@
 #include  "wx/config.h"
 #include  "wx/fileconf.h"
 #include  "wx/filefn.h"
+#include  "wx/hashmap.h"
 
 #include "wx/base64.h"
 
@@ -63,8 +64,11 @@
 // ----------------------------------------------------------------------------
 
 // compare functions for sorting the arrays
-static int LINKAGEMODE CompareEntries(wxFileConfigEntry *p1, wxFileConfigEntry *p2);
-static int LINKAGEMODE CompareGroups(wxFileConfigGroup *p1, wxFileConfigGroup *p2);
+static int LINKAGEMODE CompareEntries(wxFileConfigEntry **p1, wxFileConfigEntry **p2);
+static int LINKAGEMODE CompareGroups(wxFileConfigGroup **p1, wxFileConfigGroup **p2);
+
+// return the key used for the given name in the entries/groups hashes
+static inline wxString GetIndexKey(const wxString& name);
 
 // filter strings
 static wxString FilterInValue(const wxString& str);
@@ -84,15 +88,12 @@ static wxString GetAppName(const wxString& appname);
 // "template" array types
 // ----------------------------------------------------------------------------
 
-#ifdef WXMAKINGDLL_BASE
-    WX_DEFINE_SORTED_USER_EXPORTED_ARRAY(wxFileConfigEntry *, ArrayEntries,
-                                         WXDLLIMPEXP_BASE);
-    WX_DEFINE_SORTED_USER_EXPORTED_ARRAY(wxFileConfigGroup *, ArrayGroups,
-                                         WXDLLIMPEXP_BASE);
-#else
-    WX_DEFINE_SORTED_ARRAY(wxFileConfigEntry *, ArrayEntries);
-    WX_DEFINE_SORTED_ARRAY(wxFileConfigGroup *, ArrayGroups);
-#endif
+WX_DEFINE_ARRAY(wxFileConfigEntry *, ArrayEntries);
+WX_DEFINE_ARRAY(wxFileConfigGroup *, ArrayGroups);
+
+// hashes used for finding the entries/subgroups of a group by name
+WX_DECLARE_STRING_HASH_MAP(wxFileConfigEntry *, HashEntries);
+WX_DECLARE_STRING_HASH_MAP(wxFileConfigGroup *, HashGroups);
 
 // ----------------------------------------------------------------------------
 // wxFileConfigLineList
@@ -108,7 +109,7 @@ public:
   // ctor
   wxFileConfigLineList(const wxString& str,
                        wxFileConfigLineList *pNext = NULL) : m_strLine(str)
-    { SetNext(pNext); SetPrev(NULL); }
+    { SetNext(pNext); SetPrev(NULL); m_pEntry = NULL; m_pGroup = NULL; }
 
   // next/prev nodes in the linked list
   wxFileConfigLineList *Next() const { return m_pNext;  }
@@ -118,10 +119,19 @@ public:
   void SetText(const wxString& str) { m_strLine = str;  }
   const wxString& Text() const { return m_strLine; }
 
+  // get/change the entry or the (non root) group this line belongs to, this
+  // allows to find them from the line without searching
+  void SetEntry(wxFileConfigEntry *pEntry) { m_pEntry = pEntry; }
+  wxFileConfigEntry *Entry() const { return m_pEntry; }
+  void SetGroup(wxFileConfigGroup *pGroup) { m_pGroup = pGroup; }
+  wxFileConfigGroup *Group() const { return m_pGroup; }
+
 private:
   wxString  m_strLine;                  // line contents
   wxFileConfigLineList *m_pNext,        // next node
                        *m_pPrev;        // previous one
+  wxFileConfigEntry *m_pEntry;          // entry defined by this line or NULL
+  wxFileConfigGroup *m_pGroup;          // group whose header this line is
 
     wxDECLARE_NO_COPY_CLASS(wxFileConfigLineList);
 };
@@ -176,8 +186,12 @@ class wxFileConfigGroup
 private:
   wxFileConfig *m_pConfig;          // config object we belong to
   wxFileConfigGroup  *m_pParent;    // parent group (NULL for root group)
-  ArrayEntries  m_aEntries;         // entries in this group
-  ArrayGroups   m_aSubgroups;       // subgroups
+  mutable ArrayEntries m_aEntries; // entries in this group
+  mutable ArrayGroups m_aSubgroups; // subgroups
+  HashEntries   m_hashEntries;      // the same entries and subgroups indexed
+  HashGroups    m_hashSubgroups;    // by GetIndexKey() of their names
+  mutable bool  m_bEntriesSorted:1, // the arrays are only sorted when they're
+                m_bSubgroupsSorted:1;// needed for the enumeration
   wxString      m_strName;          // group's name
   wxFileConfigLineList *m_pLine;    // pointer to our line in the linked list
   wxFileConfigEntry *m_pLastEntry;  // last entry/subgroup of this group in the
@@ -201,9 +215,10 @@ public:
   wxFileConfigGroup    *Parent()  const { return m_pParent; }
   wxFileConfig   *Config()  const { return m_pConfig; }
 
-  const ArrayEntries& Entries() const { return m_aEntries;   }
-  const ArrayGroups&  Groups()  const { return m_aSubgroups; }
-  bool  IsEmpty() const { return Entries().IsEmpty() && Groups().IsEmpty(); }
+  // these functions return the arrays sorted in alphabetical order
+  const ArrayEntries& Entries() const;
+  const ArrayGroups&  Groups()  const;
+  bool  IsEmpty() const { return m_aEntries.IsEmpty() && m_aSubgroups.IsEmpty(); }
 
   // find entry/subgroup (NULL if not found)
   wxFileConfigGroup *FindSubgroup(const wxString& name) const;
@@ -1335,14 +1350,15 @@ bool wxFileConfig::LineListIsEmpty()
 wxFileConfigGroup::wxFileConfigGroup(wxFileConfigGroup *pParent,
                                        const wxString& strName,
                                        wxFileConfig *pConfig)
-                         : m_aEntries(CompareEntries),
-                           m_aSubgroups(CompareGroups),
-                           m_strName(strName)
+                         : m_strName(strName)
 {
   m_pConfig = pConfig;
   m_pParent = pParent;
   m_pLine   = NULL;
 
+  m_bEntriesSorted =
+  m_bSubgroupsSorted = true;
+
   m_pLastEntry = NULL;
   m_pLastGroup = NULL;
 }
@@ -1372,6 +1388,15 @@ void wxFileConfigGroup::SetLine(wxFileConfigLineList *pLine)
     wxASSERT_MSG( !m_pParent || !m_pLine || !pLine,
                    wxT("changing line for a non-root group?") );
 
+    if ( m_pParent )
+    {
+        if ( m_pLine && m_pLine->Group() == this )
+            m_pLine->SetGroup(NULL);
+
+        if ( pLine )
+            pLine->SetGroup(this);
+    }
+
     m_pLine = pLine;
 }
 
@@ -1437,6 +1462,7 @@ wxFileConfigLineList *wxFileConfigGroup::GetGroupLine()
                         << wxT("]");
             m_pLine = m_pConfig->LineListInsert(strFullName,
                                                 pParent->GetLastGroupLine());
+            m_pLine->SetGroup(this);
             pParent->SetLastGroup(this);  // we're surely after all the others
         }
         //else: this is the root group and so we return NULL because we don't
@@ -1533,13 +1559,15 @@ void wxFileConfigGroup::Rename(const wxString& newName)
     if ( newName == m_strName )
         return;
 
-    // we need to remove the group from the parent and it back under the new
-    // name to keep the parents array of subgroups alphabetically sorted
-    m_pParent->m_aSubgroups.Remove(this);
+    // we need to remove the group from the parent index and add it back under
+    // the new name, the parent array of subgroups will be sorted again when
+    // it's needed
+    m_pParent->m_hashSubgroups.erase(GetIndexKey(m_strName));
 
     m_strName = newName;
 
-    m_pParent->m_aSubgroups.Add(this);
+    m_pParent->m_hashSubgroups[GetIndexKey(m_strName)] = this;
+    m_pParent->m_bSubgroupsSorted = false;
 
     // update the group lines recursively
     UpdateGroupAndSubgroupsLines();
@@ -1558,65 +1586,49 @@ wxString wxFileConfigGroup::GetFullName() const
 // find an item
 // ----------------------------------------------------------------------------
 
-// use binary search because the array is sorted
 wxFileConfigEntry *
 wxFileConfigGroup::FindEntry(const wxString& name) const
 {
-  size_t i,
-       lo = 0,
-       hi = m_aEntries.GetCount();
-  int res;
-  wxFileConfigEntry *pEntry;
-
-  while ( lo < hi ) {
-    i = (lo + hi)/2;
-    pEntry = m_aEntries[i];
-
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pEntry->Name().compare(name);
-    #else
-      res = pEntry->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pEntry;
-  }
+  HashEntries::const_iterator it = m_hashEntries.find(GetIndexKey(name));
 
-  return NULL;
+  return it == m_hashEntries.end() ? NULL : it->second;
 }
 
 wxFileConfigGroup *
 wxFileConfigGroup::FindSubgroup(const wxString& name) const
 {
-  size_t i,
-       lo = 0,
-       hi = m_aSubgroups.GetCount();
-  int res;
-  wxFileConfigGroup *pGroup;
-
-  while ( lo < hi ) {
-    i = (lo + hi)/2;
-    pGroup = m_aSubgroups[i];
-
-    #if wxCONFIG_CASE_SENSITIVE
-      res = pGroup->Name().compare(name);
-    #else
-      res = pGroup->Name().CmpNoCase(name);
-    #endif
-
-    if ( res > 0 )
-      hi = i;
-    else if ( res < 0 )
-      lo = i + 1;
-    else
-      return pGroup;
+  HashGroups::const_iterator it = m_hashSubgroups.find(GetIndexKey(name));
+
+  return it == m_hashSubgroups.end() ? NULL : it->second;
+}
+
+// ----------------------------------------------------------------------------
+// enumerate items
+// ----------------------------------------------------------------------------
+
+// the arrays are not kept sorted when adding the items to them as this would
+// make adding many of them quadratic in their number, so sort them only when
+// they're really needed
+const ArrayEntries& wxFileConfigGroup::Entries() const
+{
+  if ( !m_bEntriesSorted )
+  {
+    m_aEntries.Sort(CompareEntries);
+    m_bEntriesSorted = true;
   }
 
-  return NULL;
+  return m_aEntries;
+}
+
+const ArrayGroups& wxFileConfigGroup::Groups() const
+{
+  if ( !m_bSubgroupsSorted )
+  {
+    m_aSubgroups.Sort(CompareGroups);
+    m_bSubgroupsSorted = true;
+  }
+
+  return m_aSubgroups;
 }
 
 // ----------------------------------------------------------------------------
@@ -1630,7 +1642,13 @@ wxFileConfigEntry *wxFileConfigGroup::AddEntry(const wxString& strName, int nLin
 
     wxFileConfigEntry   *pEntry = new wxFileConfigEntry(this, strName, nLine);
 
+    // the array remains sorted if the entries are added in order
+    if ( m_bEntriesSorted && !m_aEntries.IsEmpty() &&
+            CompareEntries(&m_aEntries.Last(), &pEntry) > 0 )
+        m_bEntriesSorted = false;
+
     m_aEntries.Add(pEntry);
+    m_hashEntries[GetIndexKey(pEntry->Name())] = pEntry;
     return pEntry;
 }
 
@@ -1641,7 +1659,12 @@ wxFileConfigGroup *wxFileConfigGroup::AddSubgroup(const wxString& strName)
 
     wxFileConfigGroup   *pGroup = new wxFileConfigGroup(this, strName, m_pConfig);
 
+    if ( m_bSubgroupsSorted && !m_aSubgroups.IsEmpty() &&
+            CompareGroups(&m_aSubgroups.Last(), &pGroup) > 0 )
+        m_bSubgroupsSorted = false;
+
     m_aSubgroups.Add(pGroup);
+    m_hashSubgroups[GetIndexKey(strName)] = pGroup;
     return pGroup;
 }
 
@@ -1738,23 +1761,17 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
             // our last entry is being deleted, so find the last one which
             // stays by going back until we find a subgroup or reach the
             // group line
-            const size_t nSubgroups = m_aSubgroups.GetCount();
-
             m_pLastGroup = NULL;
             for ( wxFileConfigLineList *pl = pLine->Prev();
                   pl && !m_pLastGroup;
                   pl = pl->Prev() )
             {
                 // does this line belong to our subgroup?
-                for ( size_t n = 0; n < nSubgroups; n++ )
+                wxFileConfigGroup * const pOwner = pl->Group();
+                if ( pOwner && pOwner->m_pParent == this )
                 {
-                    // do _not_ call GetGroupLine! we don't want to add it to
-                    // the local file if it's not already there
-                    if ( m_aSubgroups[n]->m_pLine == pl )
-                    {
-                        m_pLastGroup = m_aSubgroups[n];
-                        break;
-                    }
+                    m_pLastGroup = pOwner;
+                    break;
                 }
 
                 if ( pl == m_pLine )
@@ -1772,6 +1789,7 @@ bool wxFileConfigGroup::DeleteSubgroup(wxFileConfigGroup *pGroup)
     }
 
     m_aSubgroups.Remove(pGroup);
+    m_hashSubgroups.erase(GetIndexKey(pGroup->Name()));
     delete pGroup;
 
     return true;
@@ -1798,13 +1816,9 @@ bool wxFileConfigGroup::DeleteEntry(const wxString& name)
       wxFileConfigEntry *pNewLast = NULL;
       const wxFileConfigLineList * const
         pNewLastLine = m_pLastEntry->GetLine()->Prev();
-      const size_t nEntries = m_aEntries.GetCount();
-      for ( size_t n = 0; n < nEntries; n++ ) {
-        if ( m_aEntries[n]->GetLine() == pNewLastLine ) {
-          pNewLast = m_aEntries[n];
-          break;
-        }
-      }
+      if ( pNewLastLine && pNewLastLine->Entry() &&
+            pNewLastLine->Entry()->Group() == this )
+        pNewLast = pNewLastLine->Entry();
 
       // pNewLast can be NULL here -- it's ok and can happen if we have no
       // entries left
@@ -1820,6 +1834,7 @@ bool wxFileConfigGroup::DeleteEntry(const wxString& name)
   }
 
   m_aEntries.Remove(pEntry);
+  m_hashEntries.erase(GetIndexKey(pEntry->Name()));
   delete pEntry;
 
   return true;
@@ -1859,9 +1874,13 @@ void wxFileConfigEntry::SetLine(wxFileConfigLineList *pLine)
   if ( m_pLine != NULL ) {
     wxLogWarning(_("entry '%s' appears more than once in group '%s'"),
                  Name().c_str(), m_pParent->GetFullName().c_str());
+
+    m_pLine->SetEntry(NULL);
   }
 
   m_pLine = pLine;
+  if ( m_pLine )
+    m_pLine->SetEntry(this);
   Group()->SetLastEntry(this);
 }
 
@@ -1912,6 +1931,7 @@ void wxFileConfigEntry::SetValue(const wxString& strValue, bool bUser)
             // line to LineListInsert() means to prepend new line to the list
             wxFileConfigLineList *line = Group()->GetLastEntryLine();
             m_pLine = Group()->Config()->LineListInsert(strLine, line);
+            m_pLine->SetEntry(this);
 
             Group()->SetLastEntry(this);
         }
@@ -1926,21 +1946,30 @@ void wxFileConfigEntry::SetValue(const wxString& strValue, bool bUser)
 // compare functions for array sorting
 // ----------------------------------------------------------------------------
 
-int CompareEntries(wxFileConfigEntry *p1, wxFileConfigEntry *p2)
+int CompareEntries(wxFileConfigEntry **p1, wxFileConfigEntry **p2)
+{
+#if wxCONFIG_CASE_SENSITIVE
+    return (*p1)->Name().compare((*p2)->Name());
+#else
+    return (*p1)->Name().CmpNoCase((*p2)->Name());
+#endif
+}
+
+int CompareGroups(wxFileConfigGroup **p1, wxFileConfigGroup **p2)
 {
 #if wxCONFIG_CASE_SENSITIVE
-    return p1->Name().compare(p2->Name());
+    return (*p1)->Name().compare((*p2)->Name());
 #else
-    return p1->Name().CmpNoCase(p2->Name());
+    return (*p1)->Name().CmpNoCase((*p2)->Name());
 #endif
 }
 
-int CompareGroups(wxFileConfigGroup *p1, wxFileConfigGroup *p2)
+wxString GetIndexKey(const wxString& name)
 {
 #if wxCONFIG_CASE_SENSITIVE
-    return p1->Name().compare(p2->Name());
+    return name;
 #else
-    return p1->Name().CmpNoCase(p2->Name());
+    return name.Lower();
 #endif
 }
 
@@ -41,12 +41,31 @@
 IMPLEMENT_DYNAMIC_CLASS(wxHTTP, wxProtocol)
 IMPLEMENT_PROTOCOL(wxHTTP, wxT("http"), wxT("80"), true)
 
+namespace
+{
+
+// Return true if sending the request using the given method more than once
+// has the same effect as sending it just once (see RFC 7231, section 4.2.2).
+bool IsIdempotentMethod(const wxString& method)
+{
+    return method == wxS("GET") ||
+           method == wxS("HEAD") ||
+           method == wxS("PUT") ||
+           method == wxS("DELETE") ||
+           method == wxS("OPTIONS");
+}
+
+} // anonymous namespace
+
 wxHTTP::wxHTTP()
   : wxProtocol()
 {
     m_addr = NULL;
     m_read = false;
     m_proxy_mode = false;
+    m_keepAlive = true;
+    m_persistent = false;
+    m_reusable = false;
     m_http_response = 0;
 
     SetNotify(wxSOCKET_LOST_FLAG);
@@ -130,7 +149,9 @@ wxHTTP::wxCookieConstIterator wxHTTP::FindCookie(const wxString& cookie) const
 void wxHTTP::SetHeader(const wxString& header, const wxString& h_data)
 {
     if (m_read) {
-        ClearHeaders();
+        // start with the headers of the previous request and not with the
+        // ones of its response
+        m_headers = m_requestHeaders;
         m_read = false;
     }
 
@@ -295,6 +316,8 @@ bool wxHTTP::Connect(const wxString& host, unsigned short port)
         Close();
     }
 
+    m_reusable = false;
+
     m_addr = addr = new wxIPV4address();
 
     if (!addr->Hostname(host)) {
@@ -324,6 +347,8 @@ bool wxHTTP::Connect(const wxSockAddress& addr, bool WXUNUSED(wait))
         Close();
     }
 
+    m_reusable = false;
+
     m_addr = addr.Clone();
 
     wxIPV4address *ipv4addr = wxDynamicCast(&addr, wxIPV4address);
@@ -342,6 +367,19 @@ bool wxHTTP::Connect(const wxSockAddress& addr, bool WXUNUSED(wait))
 
 bool wxHTTP::BuildRequest(const wxString& path, const wxString& method)
 {
+    // If no headers were set since the last request, m_headers contains the
+    // headers of its response, so use the headers of the request itself
+    // again, otherwise remember the headers for the next request.
+    if ( m_read )
+    {
+        m_headers = m_requestHeaders;
+        m_read = false;
+    }
+    else
+    {
+        m_requestHeaders = m_headers;
+    }
+
     // Use the data in the post buffer, if any.
     if ( !m_postBuffer.IsEmpty() )
     {
@@ -370,6 +408,10 @@ bool wxHTTP::BuildRequest(const wxString& path, const wxString& method)
         SetHeader(wxT("Authorization"), GenerateAuthString(m_username, m_password));
     }
 
+    // HTTP/1.1 connections are persistent by default
+    if ( !m_keepAlive )
+        SetHeader(wxS("Connection"), wxS("close"));
+
     SaveState();
 
     // we may use non blocking sockets only if we can dispatch events from them
@@ -381,7 +423,7 @@ bool wxHTTP::BuildRequest(const wxString& path, const wxString& method)
     Notify(false);
 
     wxString buf;
-    buf.Printf(wxT("%s %s HTTP/1.0\r\n"), method, path);
+    buf.Printf(wxT("%s %s HTTP/1.1\r\n"), method, path);
     const wxWX2MBbuf pathbuf = buf.mb_str();
     Write(pathbuf, strlen(pathbuf));
     SendHeaders();
@@ -441,12 +483,25 @@ bool wxHTTP::BuildRequest(const wxString& path, const wxString& method)
 
     m_lastError = wxPROTO_NOERR;
     ret_value = ParseHeaders();
+
+    // Check if the connection can be kept alive after this response: this is
+    // the default for HTTP/1.1 but must be explicitly requested in HTTP/1.0.
+    const wxString connection = GetHeader(wxS("Connection"));
+    if ( tmp_str.StartsWith(wxS("HTTP/1.0")) )
+        m_persistent = connection.CmpNoCase(wxS("keep-alive")) == 0;
+    else
+        m_persistent = connection.CmpNoCase(wxS("close")) != 0;
+
+    m_persistent = m_persistent && m_keepAlive;
+
     RestoreState();
     return ret_value;
 }
 
 bool wxHTTP::Abort(void)
 {
+    m_reusable = false;
+
     return wxSocketClient::Close();
 }
 
@@ -461,34 +516,138 @@ public:
     size_t m_httpsize;
     unsigned long m_read_bytes;
 
+    // true if the response uses chunked transfer encoding
+    bool m_chunked;
+
+    // the number of bytes remaining in the current chunk
+    size_t m_chunkLeft;
+
+    // true if the last chunk has been read
+    bool m_lastChunk;
+
     wxHTTPStream(wxHTTP *http) : wxSocketInputStream(*http)
     {
         m_http = http;
         m_httpsize = 0;
         m_read_bytes = 0;
+        m_chunked = false;
+        m_chunkLeft = 0;
+        m_lastChunk = false;
     }
 
     size_t GetSize() const wxOVERRIDE { return m_httpsize; }
-    virtual ~wxHTTPStream(void) { m_http->Abort(); }
+    virtual ~wxHTTPStream(void)
+    {
+        // keep the connection open for the next request if the entire
+        // response was read and the server allows it
+        if ( m_http->m_persistent && IsComplete() )
+            m_http->m_reusable = true;
+        else
+            m_http->Abort();
+    }
 
 protected:
     size_t OnSysRead(void *buffer, size_t bufsize) wxOVERRIDE;
 
+private:
+    // return true if the entire response body was read
+    bool IsComplete() const
+    {
+        if ( m_chunked )
+            return m_lastChunk;
+
+        return m_httpsize != (size_t)-1 && m_read_bytes >= m_httpsize;
+    }
+
+    // read the line containing the size of the next chunk and update
+    // m_chunkLeft and m_lastChunk
+    bool ReadChunkHeader();
+
+    // read the CRLF following the chunk data
+    bool ReadChunkTrailer();
+
     wxDECLARE_NO_COPY_CLASS(wxHTTPStream);
 };
 
+bool wxHTTPStream::ReadChunkHeader()
+{
+    wxString line;
+    if ( wxProtocol::ReadLine(m_http, line) != wxPROTO_NOERR )
+        return false;
+
+    // ignore the chunk extensions, if any
+    unsigned long size;
+    if ( !line.BeforeFirst(';').Strip(wxString::both).ToULong(&size, 16) )
+        return false;
+
+    if ( !size )
+    {
+        // skip the trailer headers, if any, up to the terminating empty line
+        do
+        {
+            if ( wxProtocol::ReadLine(m_http, line) != wxPROTO_NOERR )
+                return false;
+        }
+        while ( !line.empty() );
+
+        m_lastChunk = true;
+    }
+
+    m_chunkLeft = size;
+
+    return true;
+}
+
+bool wxHTTPStream::ReadChunkTrailer()
+{
+    wxString line;
+    return wxProtocol::ReadLine(m_http, line) == wxPROTO_NOERR && line.empty();
+}
+
 size_t wxHTTPStream::OnSysRead(void *buffer, size_t bufsize)
 {
-    if (m_read_bytes >= m_httpsize)
+    if ( m_chunked )
     {
-        m_lasterror = wxSTREAM_EOF;
-        return 0;
+        if ( !m_chunkLeft && !m_lastChunk && !ReadChunkHeader() )
+        {
+            m_lasterror = wxSTREAM_READ_ERROR;
+            return 0;
+        }
+
+        if ( m_lastChunk )
+        {
+            m_lasterror = wxSTREAM_EOF;
+            return 0;
+        }
+
+        // don't read beyond the end of this chunk
+        if ( bufsize > m_chunkLeft )
+            bufsize = m_chunkLeft;
+    }
+    else // not chunked
+    {
+        if (m_read_bytes >= m_httpsize)
+        {
+            m_lasterror = wxSTREAM_EOF;
+            return 0;
+        }
+
+        // don't try to read beyond the end of the response as we would block
+        // until timeout if the connection is kept alive
+        if ( m_httpsize != (size_t)-1 && bufsize > m_httpsize - m_read_bytes )
+            bufsize = m_httpsize - m_read_bytes;
     }
 
     size_t ret = wxSocketInputStream::OnSysRead(buffer, bufsize);
     m_read_bytes += ret;
 
-    if (m_httpsize==(size_t)-1 && m_lasterror == wxSTREAM_READ_ERROR )
+    if ( m_chunked )
+    {
+        m_chunkLeft -= ret;
+        if ( ret && !m_chunkLeft && !ReadChunkTrailer() )
+            m_lasterror = wxSTREAM_READ_ERROR;
+    }
+    else if (m_httpsize==(size_t)-1 && m_lasterror == wxSTREAM_READ_ERROR )
     {
         // if m_httpsize is (size_t) -1 this means read until connection closed
         // which is equivalent to getting a READ_ERROR, for clients however this
@@ -500,6 +659,19 @@ size_t wxHTTPStream::OnSysRead(void *buffer, size_t bufsize)
     return ret;
 }
 
+bool wxHTTP::ConnectToServer()
+{
+    // We set m_connected back to false so wxSocketBase will know what to do.
+#ifdef __WXMAC__
+    wxSocketClient::Connect(*m_addr , false );
+    wxSocketClient::WaitOnConnect(10);
+
+    return wxSocketClient::IsConnected();
+#else
+    return wxProtocol::Connect(*m_addr);
+#endif
+}
+
 wxInputStream *wxHTTP::GetInputStream(const wxString& path)
 {
     wxHTTPStream *inp_stream;
@@ -510,17 +682,12 @@ wxInputStream *wxHTTP::GetInputStream(const wxString& path)
     if (!m_addr)
         return NULL;
 
-    // We set m_connected back to false so wxSocketBase will know what to do.
-#ifdef __WXMAC__
-    wxSocketClient::Connect(*m_addr , false );
-    wxSocketClient::WaitOnConnect(10);
+    // Reuse the connection kept alive after the previous request, if any.
+    const bool reuse = m_reusable && IsConnected() && !IsClosed();
+    m_reusable = false;
 
-    if (!wxSocketClient::IsConnected())
+    if (!reuse && !ConnectToServer())
         return NULL;
-#else
-    if (!wxProtocol::Connect(*m_addr))
-        return NULL;
-#endif
 
     // Use the user-specified method if any or determine the method to use
     // automatically depending on whether we have anything to post or not.
@@ -528,12 +695,59 @@ wxInputStream *wxHTTP::GetInputStream(const wxString& path)
     if (method.empty())
         method = m_postBuffer.IsEmpty() ? wxS("GET"): wxS("POST");
 
-    if (!BuildRequest(path, method))
-        return NULL;
+    // BuildRequest() clears the post buffer and modifies the headers, keep
+    // them to restore them if it fails. Notice that the buffer data must be
+    // copied as wxMemoryBuffer copies share it and Clear() would empty both.
+    wxMemoryBuffer postBuffer;
+    postBuffer.AppendData(m_postBuffer.GetData(), m_postBuffer.GetDataLen());
+    const wxStringToStringHashMap headers = m_headers,
+                                  requestHeaders = m_requestHeaders;
+    const bool read = m_read;
+
+    // Only the requests which can be safely sent twice are retried if the
+    // reused connection turns out to be closed.
+    for ( bool retry = reuse && IsIdempotentMethod(method);
+          !BuildRequest(path, method);
+          retry = false )
+    {
+        // Leave everything as it was before the request which couldn't be
+        // sent, so that it could be sent again later.
+        m_postBuffer = wxMemoryBuffer();
+        m_postBuffer.AppendData(postBuffer.GetData(), postBuffer.GetDataLen());
+        m_headers = headers;
+        m_requestHeaders = requestHeaders;
+        m_read = read;
+
+        // The server could have closed the kept alive connection since the
+        // last request, so try again once using a new connection. But only do
+        // it if it really closed it without sending back anything at all: if
+        // it just didn't respond in time, or started responding, it could
+        // have already processed the request.
+        if ( !retry || m_lastError != wxPROTO_NETERR ||
+                m_http_response || HasUnreadData() ||
+                    !IsClosed() || LastError() == wxSOCKET_TIMEDOUT )
+            return NULL;
+
+        m_lastError = wxPROTO_CONNERR;
+        if ( !ConnectToServer() )
+            return NULL;
+    }
 
     inp_stream = new wxHTTPStream(this);
 
-    if (!GetHeader(wxT("Content-Length")).empty())
+    // Responses to HEAD requests and some others never have any body.
+    if ( method == wxS("HEAD") ||
+            m_http_response == 204 || m_http_response == 304 ||
+                (m_http_response >= 100 && m_http_response < 200) )
+    {
+        inp_stream->m_httpsize = 0;
+    }
+    else if ( GetHeader(wxS("Transfer-Encoding")).Lower().Contains(wxS("chunked")) )
+    {
+        inp_stream->m_chunked = true;
+        inp_stream->m_httpsize = (size_t)-1;
+    }
+    else if (!GetHeader(wxT("Content-Length")).empty())
         inp_stream->m_httpsize = wxAtoi(GetHeader(wxT("Content-Length")));
     else
         inp_stream->m_httpsize = (size_t)-1;
@@ -30,6 +30,8 @@
 
 #include "wx/wfstream.h"
 #include "wx/xpmdecod.h"
+#include "wx/threadpool.h"
+#include "wx/vector.h"
 
 // For memcpy
 #include <string.h>
@@ -553,6 +555,82 @@ wxImage wxImage::ResampleNearest(int width, int height) const
 namespace
 {
 
+// ----------------------------------------------------------------------------
+// helpers for processing the image rows, possibly in parallel
+// ----------------------------------------------------------------------------
+
+// Don't use several threads for processing images with fewer rows than this
+// per thread, the overhead of creating them would outweigh any gains.
+const int MIN_ROWS_PER_THREAD = 32;
+
+// The number of threads to use for image processing, see
+// wxImage::SetProcessingThreads().
+int gs_processingThreads = 1;
+
+// Base class for the image processing algorithms which compute each row of
+// the destination image independently of all the others.
+class ImageRowsProcessor
+{
+public:
+    virtual ~ImageRowsProcessor() { }
+
+    // Compute the rows in [first, last) range. This can be called from
+    // several threads at once for different, non overlapping, ranges.
+    virtual void ProcessRows(int first, int last) = 0;
+};
+
+#if wxUSE_THREADS
+
+// Adapter allowing to use ImageRowsProcessor with wxThreadPool::ParallelFor().
+class ImageRowsBody : public wxParallelForBody
+{
+public:
+    explicit ImageRowsBody(ImageRowsProcessor& processor)
+        : m_processor(processor)
+    {
+    }
+
+    virtual void Process(int first, int last) wxOVERRIDE
+    {
+        m_processor.ProcessRows(first, last);
+    }
+
+private:
+    ImageRowsProcessor& m_processor;
+};
+
+#endif // wxUSE_THREADS
+
+// Process all rows in [0, count) range, splitting them in bands processed by
+// the threads of the global thread pool if allowed by
+// wxImage::SetProcessingThreads().
+void ProcessImageRows(ImageRowsProcessor& processor, int count)
+{
+    if ( count <= 0 )
+        return;
+
+#if wxUSE_THREADS
+    int threads = gs_processingThreads;
+    if ( threads <= 0 )
+        threads = wxThread::GetCPUCount();
+
+    threads = wxMin(threads, count / MIN_ROWS_PER_THREAD);
+    if ( threads > 1 )
+    {
+        ImageRowsBody body(processor);
+        wxThreadPool::Get().ParallelFor(0, count, body, threads);
+
+        return;
+    }
+#endif // wxUSE_THREADS
+
+    processor.ProcessRows(0, count);
+}
+
+// ----------------------------------------------------------------------------
+// box averaging resampling
+// ----------------------------------------------------------------------------
+
 struct BoxPrecalc
 {
     int boxStart;
@@ -584,8 +662,129 @@ void ResampleBoxPrecalc(wxVector<BoxPrecalc>& boxes, int oldDim)
     }
 }
 
+class BoxResampler : public ImageRowsProcessor
+{
+public:
+    BoxResampler(const unsigned char* srcData,
+                 const unsigned char* srcAlpha,
+                 int srcWidth,
+                 unsigned char* dstData,
+                 unsigned char* dstAlpha,
+                 const wxVector<BoxPrecalc>& hPrecalcs,
+                 const wxVector<BoxPrecalc>& vPrecalcs)
+        : m_srcData(srcData),
+          m_srcAlpha(srcAlpha),
+          m_srcWidth(srcWidth),
+          m_dstData(dstData),
+          m_dstAlpha(dstAlpha),
+          m_hPrecalcs(hPrecalcs),
+          m_vPrecalcs(vPrecalcs)
+    {
+    }
+
+    virtual void ProcessRows(int first, int last) wxOVERRIDE
+    {
+        const int width = m_hPrecalcs.size();
+        const int srcStride = m_srcWidth * 3;
+
+        // Sums of the source pixels in the current box rows for each column:
+        // by summing up the rows first we only need to add the columns of
+        // each box once instead of all of its pixels.
+        wxVector<wxUint32> sums(srcStride);
+        wxVector<wxUint32> sumsAlpha(m_srcAlpha ? m_srcWidth : 0);
+
+        for ( int y = first; y < last; y++ )
+        {
+            const BoxPrecalc& vPrecalc = m_vPrecalcs[y];
+
+            wxUint32* const s = &sums[0];
+            for ( int i = 0; i < srcStride; i++ )
+                s[i] = 0;
+            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; j++ )
+            {
+                const unsigned char* const src = m_srcData + j*srcStride;
+                for ( int i = 0; i < srcStride; i++ )
+                    s[i] += src[i];
+            }
+
+            if ( m_srcAlpha )
+            {
+                wxUint32* const sa = &sumsAlpha[0];
+                for ( int i = 0; i < m_srcWidth; i++ )
+                    sa[i] = 0;
+                for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; j++ )
+                {
+                    const unsigned char* const src = m_srcAlpha + j*m_srcWidth;
+                    for ( int i = 0; i < m_srcWidth; i++ )
+                        sa[i] += src[i];
+                }
+            }
+
+            const wxUint32 rows = vPrecalc.boxEnd - vPrecalc.boxStart + 1;
+
+            unsigned char* dst = m_dstData + y*width*3;
+            unsigned char* dstAlpha = m_dstAlpha ? m_dstAlpha + y*width : NULL;
+            for ( int x = 0; x < width; x++ )
+            {
+                const BoxPrecalc& hPrecalc = m_hPrecalcs[x];
+
+                // Box of pixels to average
+                wxUint32 sum_r = 0, sum_g = 0, sum_b = 0;
+                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; i++ )
+                {
+                    sum_r += s[i*3 + 0];
+                    sum_g += s[i*3 + 1];
+                    sum_b += s[i*3 + 2];
+                }
+
+                // Calculate the average from the sum and number of averaged
+                // pixels
+                const wxUint32 averaged_pixels =
+                    rows*(hPrecalc.boxEnd - hPrecalc.boxStart + 1);
+
+                dst[0] = (unsigned char)(sum_r / averaged_pixels);
+                dst[1] = (unsigned char)(sum_g / averaged_pixels);
+                dst[2] = (unsigned char)(sum_b / averaged_pixels);
+                dst += 3;
+
+                if ( dstAlpha )
+                {
+                    wxUint32 sum_a = 0;
+                    for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; i++ )
+                        sum_a += sumsAlpha[i];
+
+                    *dstAlpha++ = (unsigned char)(sum_a / averaged_pixels);
+                }
+            }
+        }
+    }
+
+private:
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    const int m_srcWidth;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const wxVector<BoxPrecalc>& m_hPrecalcs;
+    const wxVector<BoxPrecalc>& m_vPrecalcs;
+
+    wxDECLARE_NO_COPY_CLASS(BoxResampler);
+};
+
 } // anonymous namespace
 
+/* static */
+void wxImage::SetProcessingThreads(int count)
+{
+    gs_processingThreads = count;
+}
+
+/* static */
+int wxImage::GetProcessingThreads()
+{
+    return gs_processingThreads;
+}
+
 wxImage wxImage::ResampleBox(int width, int height) const
 {
     // This function implements a simple pre-blur/box averaging method for
@@ -602,9 +801,7 @@ wxImage wxImage::ResampleBox(int width, int height) const
     ResampleBoxPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
     unsigned char* dst_alpha = NULL;
 
     if ( src_alpha )
@@ -613,64 +810,68 @@ wxImage wxImage::ResampleBox(int width, int height) const
         dst_alpha = ret_image.GetAlpha();
     }
 
-    int averaged_pixels, src_pixel_index;
-    double sum_r, sum_g, sum_b, sum_a;
+    BoxResampler resampler(M_IMGDATA->m_data, src_alpha, M_IMGDATA->m_width,
+                           ret_image.GetData(), dst_alpha,
+                           hPrecalcs, vPrecalcs);
+    ProcessImageRows(resampler, height);
 
-    for ( int y = 0; y < height; y++ )         // Destination image - Y direction
-    {
-        // Source pixel in the Y direction
-        const BoxPrecalc& vPrecalc = vPrecalcs[y];
+    return ret_image;
+}
 
-        for ( int x = 0; x < width; x++ )      // Destination image - X direction
-        {
-            // Source pixel in the X direction
-            const BoxPrecalc& hPrecalc = hPrecalcs[x];
+// ----------------------------------------------------------------------------
+// bilinear and bicubic resampling
+// ----------------------------------------------------------------------------
 
-            // Box of pixels to average
-            averaged_pixels = 0;
-            sum_r = sum_g = sum_b = sum_a = 0.0;
+namespace
+{
 
-            for ( int j = vPrecalc.boxStart; j <= vPrecalc.boxEnd; ++j )
-            {
-                for ( int i = hPrecalc.boxStart; i <= hPrecalc.boxEnd; ++i )
-                {
-                    // Calculate the actual index in our source pixels
-                    src_pixel_index = j * M_IMGDATA->m_width + i;
+// Both bilinear and bicubic algorithms are separable and are implemented by
+// first interpolating the source rows horizontally and then combining the
+// interpolated rows vertically. The weights used for this are fixed point
+// numbers with RESAMPLE_WEIGHT_BITS fractional bits and sum up to 1 for each
+// destination pixel, so that the image areas of uniform colour remain exactly
+// the same, while the intermediate horizontally interpolated values keep
+// RESAMPLE_ROW_BITS fractional bits. The sum of all the weights applied to a
+// pixel is then limited to 255 << (RESAMPLE_WEIGHT_BITS + RESAMPLE_ROW_BITS)
+// which still fits in 32 bits.
+const int RESAMPLE_WEIGHT_BITS = 14;
+const int RESAMPLE_WEIGHT_ONE = 1 << RESAMPLE_WEIGHT_BITS;
+const int RESAMPLE_ROW_BITS = 8;
+const int RESAMPLE_ROW_SHIFT = RESAMPLE_WEIGHT_BITS - RESAMPLE_ROW_BITS;
+const int RESAMPLE_RESULT_SHIFT = RESAMPLE_WEIGHT_BITS + RESAMPLE_ROW_BITS;
+
+// Source pixels contributing to a destination pixel and their weights.
+template <int N>
+struct ResamplePrecalc
+{
+    int offset[N];
+    int weight[N];
+};
 
-                    sum_r += src_data[src_pixel_index * 3 + 0];
-                    sum_g += src_data[src_pixel_index * 3 + 1];
-                    sum_b += src_data[src_pixel_index * 3 + 2];
-                    if ( src_alpha )
-                        sum_a += src_alpha[src_pixel_index];
+typedef ResamplePrecalc<2> BilinearPrecalc;
+typedef ResamplePrecalc<4> BicubicPrecalc;
 
-                    averaged_pixels++;
-                }
-            }
+// Convert floating point weights summing up to 1 to fixed point ones while
+// preserving this property.
+template <int N>
+void SetResampleWeights(ResamplePrecalc<N>& precalc, const double* weights)
+{
+    int sum = 0,
+        biggest = 0;
+    for ( int k = 0; k < N; k++ )
+    {
+        precalc.weight[k] = int(weights[k]*RESAMPLE_WEIGHT_ONE + 0.5);
+        sum += precalc.weight[k];
 
-            // Calculate the average from the sum and number of averaged pixels
-            dst_data[0] = (unsigned char)(sum_r / averaged_pixels);
-            dst_data[1] = (unsigned char)(sum_g / averaged_pixels);
-            dst_data[2] = (unsigned char)(sum_b / averaged_pixels);
-            dst_data += 3;
-            if ( src_alpha )
-                *dst_alpha++ = (unsigned char)(sum_a / averaged_pixels);
-        }
+        if ( precalc.weight[k] > precalc.weight[biggest] )
+            biggest = k;
     }
 
-    return ret_image;
+    // Compensate for the rounding errors using the biggest weight, where the
+    // adjustment matters the least.
+    precalc.weight[biggest] += RESAMPLE_WEIGHT_ONE - sum;
 }
 
-namespace
-{
-
-struct BilinearPrecalc
-{
-    int offset1;
-    int offset2;
-    double dd;
-    double dd1;
-};
-
 void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
 {
     const int newDim = precalcs.size();
@@ -686,14 +887,16 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
 
         BilinearPrecalc& precalc = precalcs[dsty];
 
-        precalc.dd = srcpix - (int)srcpix;
-        precalc.dd1 = 1.0 - precalc.dd;
-        precalc.offset1 = srcpix1 < 0.0
+        const double dd = srcpix - (int)srcpix;
+        const double weights[2] = { 1.0 - dd, dd };
+        SetResampleWeights(precalc, weights);
+
+        precalc.offset[0] = srcpix1 < 0.0
                             ? 0
                             : srcpix1 > srcpixmax
                                 ? srcpixmax
                                 : (int)srcpix1;
-        precalc.offset2 = srcpix2 < 0.0
+        precalc.offset[1] = srcpix2 < 0.0
                             ? 0
                             : srcpix2 > srcpixmax
                                 ? srcpixmax
@@ -701,95 +904,14 @@ void ResampleBilinearPrecalc(wxVector<BilinearPrecalc>& precalcs, int oldDim)
     }
 }
 
-} // anonymous namespace
-
-wxImage wxImage::ResampleBilinear(int width, int height) const
-{
-    // This function implements a Bilinear algorithm for resampling.
-    wxImage ret_image(width, height, false);
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
-    unsigned char* dst_alpha = NULL;
-
-    if ( src_alpha )
-    {
-        ret_image.SetAlpha();
-        dst_alpha = ret_image.GetAlpha();
-    }
-
-    wxVector<BilinearPrecalc> vPrecalcs(height);
-    wxVector<BilinearPrecalc> hPrecalcs(width);
-    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
-    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
-
-    // initialize alpha values to avoid g++ warnings about possibly
-    // uninitialized variables
-    double r1, g1, b1, a1 = 0;
-    double r2, g2, b2, a2 = 0;
-
-    for ( int dsty = 0; dsty < height; dsty++ )
-    {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BilinearPrecalc& vPrecalc = vPrecalcs[dsty];
-        const int y_offset1 = vPrecalc.offset1;
-        const int y_offset2 = vPrecalc.offset2;
-        const double dy = vPrecalc.dd;
-        const double dy1 = vPrecalc.dd1;
-
-
-        for ( int dstx = 0; dstx < width; dstx++ )
-        {
-            // X-axis of pixel to interpolate from
-            const BilinearPrecalc& hPrecalc = hPrecalcs[dstx];
-
-            const int x_offset1 = hPrecalc.offset1;
-            const int x_offset2 = hPrecalc.offset2;
-            const double dx = hPrecalc.dd;
-            const double dx1 = hPrecalc.dd1;
-
-            int src_pixel_index00 = y_offset1 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index01 = y_offset1 * M_IMGDATA->m_width + x_offset2;
-            int src_pixel_index10 = y_offset2 * M_IMGDATA->m_width + x_offset1;
-            int src_pixel_index11 = y_offset2 * M_IMGDATA->m_width + x_offset2;
-
-            // first line
-            r1 = src_data[src_pixel_index00 * 3 + 0] * dx1 + src_data[src_pixel_index01 * 3 + 0] * dx;
-            g1 = src_data[src_pixel_index00 * 3 + 1] * dx1 + src_data[src_pixel_index01 * 3 + 1] * dx;
-            b1 = src_data[src_pixel_index00 * 3 + 2] * dx1 + src_data[src_pixel_index01 * 3 + 2] * dx;
-            if ( src_alpha )
-                a1 = src_alpha[src_pixel_index00] * dx1 + src_alpha[src_pixel_index01] * dx;
-
-            // second line
-            r2 = src_data[src_pixel_index10 * 3 + 0] * dx1 + src_data[src_pixel_index11 * 3 + 0] * dx;
-            g2 = src_data[src_pixel_index10 * 3 + 1] * dx1 + src_data[src_pixel_index11 * 3 + 1] * dx;
-            b2 = src_data[src_pixel_index10 * 3 + 2] * dx1 + src_data[src_pixel_index11 * 3 + 2] * dx;
-            if ( src_alpha )
-                a2 = src_alpha[src_pixel_index10] * dx1 + src_alpha[src_pixel_index11] * dx;
-
-            // result lines
-
-            dst_data[0] = static_cast<unsigned char>(r1 * dy1 + r2 * dy + .5);
-            dst_data[1] = static_cast<unsigned char>(g1 * dy1 + g2 * dy + .5);
-            dst_data[2] = static_cast<unsigned char>(b1 * dy1 + b2 * dy + .5);
-            dst_data += 3;
-
-            if ( src_alpha )
-                *dst_alpha++ = static_cast<unsigned char>(a1 * dy1 + a2 * dy);
-        }
-    }
-
-    return ret_image;
-}
-
 // The following two local functions are for the B-spline weighting of the
 // bicubic sampling algorithm
-static inline double spline_cube(double value)
+inline double spline_cube(double value)
 {
     return value <= 0.0 ? 0.0 : value * value * value;
 }
 
-static inline double spline_weight(double value)
+inline double spline_weight(double value)
 {
     return (spline_cube(value + 2) -
             4 * spline_cube(value + 1) +
@@ -797,16 +919,6 @@ static inline double spline_weight(double value)
             4 * spline_cube(value - 1)) / 6;
 }
 
-
-namespace
-{
-
-struct BicubicPrecalc
-{
-    double weight[4];
-    int offset[4];
-};
-
 void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
 {
     const int newDim = aWeight.size();
@@ -818,6 +930,7 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
 
         BicubicPrecalc &precalc = aWeight[dstd];
 
+        double weights[4];
         for ( int k = -1; k <= 2; k++ )
         {
             precalc.offset[k + 1] = srcpixd + k < 0.0
@@ -826,13 +939,190 @@ void ResampleBicubicPrecalc(wxVector<BicubicPrecalc> &aWeight, int oldDim)
                     ? oldDim - 1
                     : static_cast<int>(srcpixd + k);
 
-            precalc.weight[k + 1] = spline_weight(k - dd);
+            weights[k + 1] = spline_weight(k - dd);
         }
+
+        SetResampleWeights(precalc, weights);
     }
 }
 
+// Generic separable resampler using N source pixels in each direction.
+template <int N>
+class SeparableResampler : public ImageRowsProcessor
+{
+public:
+    typedef ResamplePrecalc<N> Precalc;
+
+    SeparableResampler(const unsigned char* srcData,
+                       const unsigned char* srcAlpha,
+                       int srcWidth,
+                       unsigned char* dstData,
+                       unsigned char* dstAlpha,
+                       const wxVector<Precalc>& hPrecalcs,
+                       const wxVector<Precalc>& vPrecalcs)
+        : m_srcData(srcData),
+          m_srcAlpha(srcAlpha),
+          m_srcWidth(srcWidth),
+          m_dstData(dstData),
+          m_dstAlpha(dstAlpha),
+          m_hPrecalcs(hPrecalcs),
+          m_vPrecalcs(vPrecalcs)
+    {
+    }
+
+    virtual void ProcessRows(int first, int last) wxOVERRIDE
+    {
+        const int width = m_hPrecalcs.size();
+        const int stride = width * 3;
+
+        // Cache of the horizontally interpolated source rows: as the source
+        // rows used for consecutive destination rows are consecutive too,
+        // there are never more than N of them needed at once and source row
+        // "n" can always be stored in the slot "n % N".
+        wxVector<wxInt32> rows(N * stride);
+        wxVector<wxInt32> rowsAlpha(m_srcAlpha ? N * width : 0);
+        int cachedRows[N];
+        for ( int k = 0; k < N; k++ )
+            cachedRows[k] = -1;
+
+        for ( int y = first; y < last; y++ )
+        {
+            const Precalc& vPrecalc = m_vPrecalcs[y];
+
+            const wxInt32* src[N];
+            const wxInt32* srcAlpha[N];
+            for ( int k = 0; k < N; k++ )
+            {
+                const int row = vPrecalc.offset[k];
+                const int slot = row % N;
+                if ( cachedRows[slot] != row )
+                {
+                    InterpolateRow(row,
+                                   &rows[slot * stride],
+                                   m_srcAlpha ? &rowsAlpha[slot * width]
+                                              : NULL);
+                    cachedRows[slot] = row;
+                }
+
+                src[k] = &rows[slot * stride];
+                srcAlpha[k] = m_srcAlpha ? &rowsAlpha[slot * width] : NULL;
+            }
+
+            // Combine the rows vertically: this loop is simple enough to be
+            // vectorized by the compiler.
+            unsigned char* const dst = m_dstData + y*stride;
+            for ( int i = 0; i < stride; i++ )
+            {
+                wxInt32 sum = 1 << (RESAMPLE_RESULT_SHIFT - 1);
+                for ( int k = 0; k < N; k++ )
+                    sum += vPrecalc.weight[k] * src[k][i];
+
+                dst[i] = static_cast<unsigned char>(sum >> RESAMPLE_RESULT_SHIFT);
+            }
+
+            // Notice that alpha is truncated and not rounded, as it always
+            // was done by these algorithms.
+            if ( m_dstAlpha )
+            {
+                unsigned char* const dstAlpha = m_dstAlpha + y*width;
+                for ( int i = 0; i < width; i++ )
+                {
+                    wxInt32 sum = 0;
+                    for ( int k = 0; k < N; k++ )
+                        sum += vPrecalc.weight[k] * srcAlpha[k][i];
+
+                    dstAlpha[i] = static_cast<unsigned char>(sum >> RESAMPLE_RESULT_SHIFT);
+                }
+            }
+        }
+    }
+
+private:
+    // Interpolate the given source row horizontally.
+    void InterpolateRow(int row, wxInt32* dst, wxInt32* dstAlpha) const
+    {
+        const int width = m_hPrecalcs.size();
+        const unsigned char* const src = m_srcData + row*m_srcWidth*3;
+
+        for ( int x = 0; x < width; x++ )
+        {
+            const Precalc& hPrecalc = m_hPrecalcs[x];
+
+            wxInt32 sum_r = 0, sum_g = 0, sum_b = 0;
+            for ( int k = 0; k < N; k++ )
+            {
+                const unsigned char* const p = src + hPrecalc.offset[k]*3;
+                const wxInt32 weight = hPrecalc.weight[k];
+
+                sum_r += p[0] * weight;
+                sum_g += p[1] * weight;
+                sum_b += p[2] * weight;
+            }
+
+            const wxInt32 round = 1 << (RESAMPLE_ROW_SHIFT - 1);
+            dst[0] = (sum_r + round) >> RESAMPLE_ROW_SHIFT;
+            dst[1] = (sum_g + round) >> RESAMPLE_ROW_SHIFT;
+            dst[2] = (sum_b + round) >> RESAMPLE_ROW_SHIFT;
+            dst += 3;
+        }
+
+        if ( dstAlpha )
+        {
+            const unsigned char* const srcAlpha = m_srcAlpha + row*m_srcWidth;
+
+            for ( int x = 0; x < width; x++ )
+            {
+                const Precalc& hPrecalc = m_hPrecalcs[x];
+
+                wxInt32 sum_a = 0;
+                for ( int k = 0; k < N; k++ )
+                    sum_a += srcAlpha[hPrecalc.offset[k]] * hPrecalc.weight[k];
+
+                dstAlpha[x] = sum_a >> RESAMPLE_ROW_SHIFT;
+            }
+        }
+    }
+
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    const int m_srcWidth;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const wxVector<Precalc>& m_hPrecalcs;
+    const wxVector<Precalc>& m_vPrecalcs;
+
+    wxDECLARE_NO_COPY_CLASS(SeparableResampler);
+};
+
 } // anonymous namespace
 
+wxImage wxImage::ResampleBilinear(int width, int height) const
+{
+    // This function implements a Bilinear algorithm for resampling.
+    wxImage ret_image(width, height, false);
+    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
+    unsigned char* dst_alpha = NULL;
+
+    if ( src_alpha )
+    {
+        ret_image.SetAlpha();
+        dst_alpha = ret_image.GetAlpha();
+    }
+
+    wxVector<BilinearPrecalc> vPrecalcs(height);
+    wxVector<BilinearPrecalc> hPrecalcs(width);
+    ResampleBilinearPrecalc(vPrecalcs, M_IMGDATA->m_height);
+    ResampleBilinearPrecalc(hPrecalcs, M_IMGDATA->m_width);
+
+    SeparableResampler<2> resampler(M_IMGDATA->m_data, src_alpha,
+                                    M_IMGDATA->m_width,
+                                    ret_image.GetData(), dst_alpha,
+                                    hPrecalcs, vPrecalcs);
+    ProcessImageRows(resampler, height);
+
+    return ret_image;
+}
+
 // This is the bicubic resampling algorithm
 wxImage wxImage::ResampleBicubic(int width, int height) const
 {
@@ -866,9 +1156,7 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
 
     ret_image.Create(width, height, false);
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
     const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_data = ret_image.GetData();
     unsigned char* dst_alpha = NULL;
 
     if ( src_alpha )
@@ -884,268 +1172,238 @@ wxImage wxImage::ResampleBicubic(int width, int height) const
     ResampleBicubicPrecalc(vPrecalcs, M_IMGDATA->m_height);
     ResampleBicubicPrecalc(hPrecalcs, M_IMGDATA->m_width);
 
-    for ( int dsty = 0; dsty < height; dsty++ )
+    SeparableResampler<4> resampler(M_IMGDATA->m_data, src_alpha,
+                                    M_IMGDATA->m_width,
+                                    ret_image.GetData(), dst_alpha,
+                                    hPrecalcs, vPrecalcs);
+    ProcessImageRows(resampler, height);
+
+    return ret_image;
+}
+
+// ----------------------------------------------------------------------------
+// blurring
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Both blur algorithms replace each pixel with the average of the pixels in
+// the blur radius around it, duplicating the edge pixels as needed.
+
+class HorizontalBlur : public ImageRowsProcessor
+{
+public:
+    HorizontalBlur(const unsigned char* srcData,
+                   const unsigned char* srcAlpha,
+                   unsigned char* dstData,
+                   unsigned char* dstAlpha,
+                   int width,
+                   int blurRadius)
+        : m_srcData(srcData),
+          m_srcAlpha(srcAlpha),
+          m_dstData(dstData),
+          m_dstAlpha(dstAlpha),
+          m_width(width),
+          m_blurRadius(blurRadius)
     {
-        // We need to calculate the source pixel to interpolate from - Y-axis
-        const BicubicPrecalc& vPrecalc = vPrecalcs[dsty];
+    }
 
-        for ( int dstx = 0; dstx < width; dstx++ )
+    virtual void ProcessRows(int first, int last) wxOVERRIDE
+    {
+        const wxUint32 blurArea = m_blurRadius*2 + 1;
+
+        for ( int y = first; y < last; y++ )
         {
-            // X-axis of pixel to interpolate from
-            const BicubicPrecalc& hPrecalc = hPrecalcs[dstx];
+            const unsigned char* const src = m_srcData + y*m_width*3;
+            unsigned char* dst = m_dstData + y*m_width*3;
+
+            // Calculate the sum of all pixels in the blur radius for the
+            // first pixel of the row...
+            wxUint32 sum_r = 0,
+                     sum_g = 0,
+                     sum_b = 0;
+            for ( int kernel_x = -m_blurRadius; kernel_x <= m_blurRadius; kernel_x++ )
+            {
+                const unsigned char* const p = src + Clamp(kernel_x)*3;
+                sum_r += p[0];
+                sum_g += p[1];
+                sum_b += p[2];
+            }
 
-            // Sums for each color channel
-            double sum_r = 0, sum_g = 0, sum_b = 0, sum_a = 0;
+            // ... and then just move the blur radius box along the row.
+            for ( int x = 0; ; )
+            {
+                dst[0] = (unsigned char)(sum_r / blurArea);
+                dst[1] = (unsigned char)(sum_g / blurArea);
+                dst[2] = (unsigned char)(sum_b / blurArea);
+                dst += 3;
+
+                if ( ++x == m_width )
+                    break;
+
+                const unsigned char* const
+                    removed = src + Clamp(x - m_blurRadius - 1)*3;
+                const unsigned char* const
+                    added = src + Clamp(x + m_blurRadius)*3;
+
+                sum_r += added[0] - removed[0];
+                sum_g += added[1] - removed[1];
+                sum_b += added[2] - removed[2];
+            }
 
-            // Here we actually determine the RGBA values for the destination pixel
-            for ( int k = -1; k <= 2; k++ )
+            if ( m_srcAlpha )
             {
-                // Y offset
-                const int y_offset = vPrecalc.offset[k + 1];
+                const unsigned char* const srcAlpha = m_srcAlpha + y*m_width;
+                unsigned char* const dstAlpha = m_dstAlpha + y*m_width;
+
+                wxUint32 sum_a = 0;
+                for ( int kernel_x = -m_blurRadius; kernel_x <= m_blurRadius; kernel_x++ )
+                    sum_a += srcAlpha[Clamp(kernel_x)];
 
-                // Loop across the X axis
-                for ( int i = -1; i <= 2; i++ )
+                for ( int x = 0; ; )
                 {
-                    // X offset
-                    const int x_offset = hPrecalc.offset[i + 1];
-
-                    // Calculate the exact position where the source data
-                    // should be pulled from based on the x_offset and y_offset
-                    int src_pixel_index = y_offset*M_IMGDATA->m_width + x_offset;
-
-                    // Calculate the weight for the specified pixel according
-                    // to the bicubic b-spline kernel we're using for
-                    // interpolation
-                    const double
-                        pixel_weight = vPrecalc.weight[k + 1] * hPrecalc.weight[i + 1];
-
-                    // Create a sum of all velues for each color channel
-                    // adjusted for the pixel's calculated weight
-                    sum_r += src_data[src_pixel_index * 3 + 0] * pixel_weight;
-                    sum_g += src_data[src_pixel_index * 3 + 1] * pixel_weight;
-                    sum_b += src_data[src_pixel_index * 3 + 2] * pixel_weight;
-                    if ( src_alpha )
-                        sum_a += src_alpha[src_pixel_index] * pixel_weight;
-                }
-            }
+                    dstAlpha[x] = (unsigned char)(sum_a / blurArea);
 
-            // Put the data into the destination image.  The summed values are
-            // of double data type and are rounded here for accuracy
-            dst_data[0] = (unsigned char)(sum_r + 0.5);
-            dst_data[1] = (unsigned char)(sum_g + 0.5);
-            dst_data[2] = (unsigned char)(sum_b + 0.5);
-            dst_data += 3;
+                    if ( ++x == m_width )
+                        break;
 
-            if ( src_alpha )
-                *dst_alpha++ = (unsigned char)sum_a;
+                    sum_a += srcAlpha[Clamp(x + m_blurRadius)] -
+                                srcAlpha[Clamp(x - m_blurRadius - 1)];
+                }
+            }
         }
     }
 
-    return ret_image;
-}
-
-// Blur in the horizontal direction
-wxImage wxImage::BlurHorizontal(int blurRadius) const
-{
-    wxImage ret_image(MakeEmptyClone());
+private:
+    int Clamp(int x) const
+    {
+        return x < 0 ? 0 : x >= m_width ? m_width - 1 : x;
+    }
 
-    wxCHECK( ret_image.IsOk(), ret_image );
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const int m_width;
+    const int m_blurRadius;
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
+    wxDECLARE_NO_COPY_CLASS(HorizontalBlur);
+};
 
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+// Vertical blur works row by row too, instead of column by column, to access
+// the memory sequentially, by keeping the running sums for all columns.
+class VerticalBlur : public ImageRowsProcessor
+{
+public:
+    VerticalBlur(const unsigned char* srcData,
+                 const unsigned char* srcAlpha,
+                 unsigned char* dstData,
+                 unsigned char* dstAlpha,
+                 int width,
+                 int height,
+                 int blurRadius)
+        : m_srcData(srcData),
+          m_srcAlpha(srcAlpha),
+          m_dstData(dstData),
+          m_dstAlpha(dstAlpha),
+          m_width(width),
+          m_height(height),
+          m_blurRadius(blurRadius)
+    {
+    }
 
-    // Horizontal blurring algorithm - average all pixels in the specified blur
-    // radius in the X or horizontal direction
-    for ( int y = 0; y < M_IMGDATA->m_height; y++ )
+    virtual void ProcessRows(int first, int last) wxOVERRIDE
     {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
+        DoProcessRows(m_srcData, m_dstData, m_width*3, first, last);
 
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
+        if ( m_srcAlpha )
+            DoProcessRows(m_srcAlpha, m_dstAlpha, m_width, first, last);
+    }
+
+private:
+    void DoProcessRows(const unsigned char* srcData,
+                       unsigned char* dstData,
+                       int stride,
+                       int first,
+                       int last) const
+    {
+        const wxUint32 blurArea = m_blurRadius*2 + 1;
 
-        // Calculate the average of all pixels in the blur radius for the first
-        // pixel of the row
-        for ( int kernel_x = -blurRadius; kernel_x <= blurRadius; kernel_x++ )
+        // Calculate the sums of all pixels in the blur radius for the first
+        // row...
+        wxVector<wxUint32> sumsVector(stride);
+        wxUint32* const sums = &sumsVector[0];
+        for ( int kernel_y = -m_blurRadius; kernel_y <= m_blurRadius; kernel_y++ )
         {
-            // To deal with the pixels at the start of a row so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous row
-            if ( kernel_x < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = kernel_x + y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
+            const unsigned char* const src = srcData + Clamp(first + kernel_y)*stride;
+            for ( int i = 0; i < stride; i++ )
+                sums[i] += src[i];
         }
 
-        dst = dst_data + y * M_IMGDATA->m_width*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-
-        // Now average the values of the rest of the pixels by just moving the
-        // blur radius box along the row
-        for ( int x = 1; x < M_IMGDATA->m_width; x++ )
+        // ... and then just move the blur radius box down.
+        for ( int y = first; ; )
         {
-            // Take care of edge pixels on the left edge by essentially
-            // duplicating the edge pixel
-            if ( x - blurRadius - 1 < 0 )
-                pixel_idx = y * M_IMGDATA->m_width;
-            else
-                pixel_idx = (x - blurRadius - 1) + y * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the left side of the blur
-            // radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of edge pixels on the right edge
-            if ( x + blurRadius > M_IMGDATA->m_width - 1 )
-                pixel_idx = M_IMGDATA->m_width - 1 + y * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + blurRadius + y * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + x*3 + y*M_IMGDATA->m_width*3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
+            unsigned char* const dst = dstData + y*stride;
+            for ( int i = 0; i < stride; i++ )
+                dst[i] = (unsigned char)(sums[i] / blurArea);
+
+            if ( ++y == last )
+                break;
+
+            const unsigned char* const
+                removed = srcData + Clamp(y - m_blurRadius - 1)*stride;
+            const unsigned char* const
+                added = srcData + Clamp(y + m_blurRadius)*stride;
+            for ( int i = 0; i < stride; i++ )
+                sums[i] += added[i] - removed[i];
         }
     }
 
-    return ret_image;
-}
+    int Clamp(int y) const
+    {
+        return y < 0 ? 0 : y >= m_height ? m_height - 1 : y;
+    }
 
-// Blur in the vertical direction
-wxImage wxImage::BlurVertical(int blurRadius) const
+    const unsigned char* const m_srcData;
+    const unsigned char* const m_srcAlpha;
+    unsigned char* const m_dstData;
+    unsigned char* const m_dstAlpha;
+    const int m_width;
+    const int m_height;
+    const int m_blurRadius;
+
+    wxDECLARE_NO_COPY_CLASS(VerticalBlur);
+};
+
+} // anonymous namespace
+
+// Blur in the horizontal direction
+wxImage wxImage::BlurHorizontal(int blurRadius) const
 {
     wxImage ret_image(MakeEmptyClone());
 
     wxCHECK( ret_image.IsOk(), ret_image );
 
-    const unsigned char* src_data = M_IMGDATA->m_data;
-    unsigned char* dst_data = ret_image.GetData();
-    const unsigned char* src_alpha = M_IMGDATA->m_alpha;
-    unsigned char* dst_alpha = ret_image.GetAlpha();
-
-    // number of pixels we average over
-    const int blurArea = blurRadius*2 + 1;
+    HorizontalBlur blur(M_IMGDATA->m_data, M_IMGDATA->m_alpha,
+                        ret_image.GetData(), ret_image.GetAlpha(),
+                        M_IMGDATA->m_width, blurRadius);
+    ProcessImageRows(blur, M_IMGDATA->m_height);
 
-    // Vertical blurring algorithm - same as horizontal but switched the
-    // opposite direction
-    for ( int x = 0; x < M_IMGDATA->m_width; x++ )
-    {
-        // Variables used in the blurring algorithm
-        long sum_r = 0,
-             sum_g = 0,
-             sum_b = 0,
-             sum_a = 0;
-
-        long pixel_idx;
-        const unsigned char *src;
-        unsigned char *dst;
+    return ret_image;
+}
 
-        // Calculate the average of all pixels in our blur radius box for the
-        // first pixel of the column
-        for ( int kernel_y = -blurRadius; kernel_y <= blurRadius; kernel_y++ )
-        {
-            // To deal with the pixels at the start of a column so it's not
-            // grabbing GOK values from memory at negative indices of the
-            // image's data or grabbing from the previous column
-            if ( kernel_y < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + kernel_y * M_IMGDATA->m_width;
-
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-        }
+// Blur in the vertical direction
+wxImage wxImage::BlurVertical(int blurRadius) const
+{
+    wxImage ret_image(MakeEmptyClone());
 
-        dst = dst_data + x*3;
-        dst[0] = (unsigned char)(sum_r / blurArea);
-        dst[1] = (unsigned char)(sum_g / blurArea);
-        dst[2] = (unsigned char)(sum_b / blurArea);
-        if ( src_alpha )
-            dst_alpha[x] = (unsigned char)(sum_a / blurArea);
+    wxCHECK( ret_image.IsOk(), ret_image );
 
-        // Now average the values of the rest of the pixels by just moving the
-        // box along the column from top to bottom
-        for ( int y = 1; y < M_IMGDATA->m_height; y++ )
-        {
-            // Take care of pixels that would be beyond the top edge by
-            // duplicating the top edge pixel for the column
-            if ( y - blurRadius - 1 < 0 )
-                pixel_idx = x;
-            else
-                pixel_idx = x + (y - blurRadius - 1) * M_IMGDATA->m_width;
-
-            // Subtract the value of the pixel at the top of our blur radius box
-            src = src_data + pixel_idx*3;
-            sum_r -= src[0];
-            sum_g -= src[1];
-            sum_b -= src[2];
-            if ( src_alpha )
-                sum_a -= src_alpha[pixel_idx];
-
-            // Take care of the pixels that would be beyond the bottom edge of
-            // the image similar to the top edge
-            if ( y + blurRadius > M_IMGDATA->m_height - 1 )
-                pixel_idx = x + (M_IMGDATA->m_height - 1) * M_IMGDATA->m_width;
-            else
-                pixel_idx = x + (blurRadius + y) * M_IMGDATA->m_width;
-
-            // Add the value of the pixel being added to the end of our box
-            src = src_data + pixel_idx*3;
-            sum_r += src[0];
-            sum_g += src[1];
-            sum_b += src[2];
-            if ( src_alpha )
-                sum_a += src_alpha[pixel_idx];
-
-            // Save off the averaged data
-            dst = dst_data + (x + y * M_IMGDATA->m_width) * 3;
-            dst[0] = (unsigned char)(sum_r / blurArea);
-            dst[1] = (unsigned char)(sum_g / blurArea);
-            dst[2] = (unsigned char)(sum_b / blurArea);
-            if ( src_alpha )
-                dst_alpha[x + y * M_IMGDATA->m_width] = (unsigned char)(sum_a / blurArea);
-        }
-    }
+    VerticalBlur blur(M_IMGDATA->m_data, M_IMGDATA->m_alpha,
+                      ret_image.GetData(), ret_image.GetAlpha(),
+                      M_IMGDATA->m_width, M_IMGDATA->m_height, blurRadius);
+    ProcessImageRows(blur, M_IMGDATA->m_height);
 
     return ret_image;
 }
@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/mappedfile.cpp
+// Purpose:     wxMappedFile and wxMappedInputStream implementation
+// Author:      wxWidgets team
+// Created:     2016-03-21
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#if wxUSE_FILE
+
+#include "wx/mappedfile.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/log.h"
+    #include "wx/intl.h"
+#endif // WX_PRECOMP
+
+#include "wx/file.h"
+
+#if defined(__UNIX__)
+    #include <sys/mman.h>
+
+    #define wxHAS_MAPPED_FILES
+#elif defined(__WINDOWS__)
+    #include "wx/msw/wrapwin.h"
+    #include <io.h>
+
+    #define wxHAS_MAPPED_FILES
+#endif
+
+// ============================================================================
+// wxMappedFile implementation
+// ============================================================================
+
+bool wxMappedFile::Open(const wxString& filename)
+{
+    Close();
+
+#ifdef wxHAS_MAPPED_FILES
+    wxFile file;
+    if ( !file.Open(filename) )
+        return false;
+
+    const wxFileOffset length = file.Length();
+    if ( length == wxInvalidOffset )
+        return false;
+
+    // Check that the file can be mapped entirely, this can fail for very big
+    // files in 32 bit programs.
+    if ( (wxFileOffset)(size_t)length != length )
+    {
+        wxLogError(_("File \"%s\" is too big to be mapped into memory."),
+                   filename);
+        return false;
+    }
+
+    // Empty files can't be mapped but there is no need to do it anyhow.
+    // However some special files (e.g. under /proc) have 0 length while not
+    // being really empty, check for this and refuse to handle them.
+    if ( !length )
+    {
+        char ch;
+        if ( file.Read(&ch, 1) != 0 )
+            return false;
+    }
+    else
+    {
+#ifdef __UNIX__
+        void * const data = mmap(NULL, length, PROT_READ, MAP_PRIVATE,
+                                 file.fd(), 0);
+        if ( data == MAP_FAILED )
+        {
+            wxLogSysError(_("Failed to map file \"%s\" into memory"),
+                          filename);
+            return false;
+        }
+#else // __WINDOWS__
+        HANDLE hMapping = ::CreateFileMapping
+                            (
+                                (HANDLE)_get_osfhandle(file.fd()),
+                                NULL,           // default security
+                                PAGE_READONLY,
+                                0, 0,           // map the entire file
+                                NULL            // no name
+                            );
+        if ( !hMapping )
+        {
+            wxLogSysError(_("Failed to map file \"%s\" into memory"),
+                          filename);
+            return false;
+        }
+
+        // The view remains valid after closing the mapping handle.
+        void * const data = ::MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0);
+        ::CloseHandle(hMapping);
+
+        if ( !data )
+        {
+            wxLogSysError(_("Failed to map file \"%s\" into memory"),
+                          filename);
+            return false;
+        }
+#endif // __UNIX__/__WINDOWS__
+
+        m_data = data;
+        m_length = length;
+    }
+
+    // The file itself can be closed now, the mapping keeps it alive.
+    m_opened = true;
+
+    return true;
+#else // !wxHAS_MAPPED_FILES
+    wxUnusedVar(filename);
+
+    return false;
+#endif // wxHAS_MAPPED_FILES/!wxHAS_MAPPED_FILES
+}
+
+void wxMappedFile::Close()
+{
+#ifdef wxHAS_MAPPED_FILES
+    if ( m_data )
+    {
+#ifdef __UNIX__
+        munmap(m_data, m_length);
+#else // __WINDOWS__
+        ::UnmapViewOfFile(m_data);
+#endif // __UNIX__/__WINDOWS__
+    }
+#endif // wxHAS_MAPPED_FILES
+
+    Init();
+}
+
+// ============================================================================
+// wxMappedInputStream implementation
+// ============================================================================
+
+#if wxUSE_STREAMS
+
+wxMappedInputStream::wxMappedInputStream(const wxString& filename)
+    : m_file(filename)
+{
+    InitFromData(m_file.GetData(), m_file.GetLength());
+}
+
+#endif // wxUSE_STREAMS
+
+#endif // wxUSE_FILE
@@ -44,6 +44,11 @@
 IMPLEMENT_ABSTRACT_CLASS(wxMemoryInputStream, wxInputStream)
 
 wxMemoryInputStream::wxMemoryInputStream(const void *data, size_t len)
+{
+    InitFromData(data, len);
+}
+
+void wxMemoryInputStream::InitFromData(const void *data, size_t len)
 {
     m_i_streambuf = new wxStreamBuffer(wxStreamBuffer::read);
     m_i_streambuf->SetBufferIO(const_cast<void *>(data), len);
@@ -98,6 +103,20 @@ wxMemoryInputStream::InitFromStream(wxInputStream& stream, wxFileOffset lenFile)
     m_length = stream.LastRead();
 }
 
+const void *wxMemoryInputStream::GetCurrentData(size_t *len) const
+{
+    wxCHECK_MSG( len, NULL, wxT("NULL pointer") );
+
+    // We can't return the data from the write back buffer together with the
+    // rest of it.
+    if ( m_wback )
+        return NULL;
+
+    *len = m_length - m_i_streambuf->GetIntPosition();
+
+    return m_i_streambuf->GetBufferPos();
+}
+
 bool wxMemoryInputStream::CanRead() const
 {
     return m_i_streambuf->GetIntPosition() != m_length;
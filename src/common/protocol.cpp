@@ -28,6 +28,7 @@
 #include "wx/log.h"
 
 #include <stdlib.h>
+#include <string.h>
 
 // ----------------------------------------------------------------------------
 // wxProtoInfo
@@ -111,73 +112,47 @@ bool wxProtocol::Reconnect()
 /* static */
 wxProtocolError wxProtocol::ReadLine(wxSocketBase *sock, wxString& result)
 {
-    static const int LINE_BUF = 4095;
+    static const int LINE_BUF = 4096;
 
     result.clear();
 
-    wxCharBuffer buf(LINE_BUF);
-    char *pBuf = buf.data();
-    while ( sock->WaitForRead() )
+    // The data is read from the socket in big chunks into its pushback
+    // buffer which is then scanned for the end of line directly, so that only
+    // the data up to the end of the line is consumed and the rest of it
+    // remains available for the subsequent reads from the socket.
+    wxUint32 scanned = 0;
+    for ( ;; )
     {
-        // peek at the socket to see if there is a CRLF
-        sock->Peek(pBuf, LINE_BUF);
+        wxUint32 size;
+        const char * const data = sock->PeekPushback(&size);
 
-        size_t nRead = sock->LastCount();
-        if ( !nRead && sock->Error() )
-            return wxPROTO_NETERR;
-
-        // look for "\r\n" paying attention to a special case: "\r\n" could
-        // have been split by buffer boundary, so check also for \r at the end
-        // of the last chunk and \n at the beginning of this one
-        pBuf[nRead] = '\0';
-        const char *eol = strchr(pBuf, '\n');
+        const char *eol = static_cast<const char *>
+                          (
+                            memchr(data + scanned, '\n', size - scanned)
+                          );
 
-        // if we found '\n', is there a '\r' as well?
         if ( eol )
         {
-            if ( eol == pBuf )
-            {
-                // check for case of "\r\n" being split
-                if ( result.empty() || result.Last() != wxT('\r') )
-                {
-                    // ignore the stray '\n'
-                    eol = NULL;
-                }
-                //else: ok, got real EOL
-
-                // read just this '\n' and restart
-                nRead = 1;
-            }
-            else // '\n' in the middle of the buffer
+            const wxUint32 len = eol - data + 1;
+
+            // only "\r\n" terminates the line, stray '\n' are kept in it
+            if ( eol != data && eol[-1] == '\r' )
             {
-                // in any case, read everything up to and including '\n'
-                nRead = eol - pBuf + 1;
-
-                if ( eol[-1] != '\r' )
-                {
-                    // as above, simply ignore stray '\n'
-                    eol = NULL;
-                }
-            }
-        }
+                result = wxString::FromAscii(data, len - 2);
+                sock->SkipPushback(len);
 
-        sock->Read(pBuf, nRead);
-        if ( sock->LastCount() != nRead )
-            return wxPROTO_NETERR;
+                return wxPROTO_NOERR;
+            }
 
-        pBuf[nRead] = '\0';
-        result += wxString::FromAscii(pBuf);
+            scanned = len;
+            continue;
+        }
 
-        if ( eol )
-        {
-            // remove trailing "\r\n"
-            result.RemoveLast(2);
+        scanned = size;
 
-            return wxPROTO_NOERR;
-        }
+        if ( !sock->ReadToPushback(LINE_BUF) )
+            return wxPROTO_NETERR;
     }
-
-    return wxPROTO_NETERR;
 }
 
 wxProtocolError wxProtocol::ReadLine(wxString& result)
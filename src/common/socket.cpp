@@ -38,6 +38,7 @@
 #endif
 
 #include "wx/apptrait.h"
+#include "wx/vector.h"
 #include "wx/sckaddr.h"
 #include "wx/scopeguard.h"
 #include "wx/stopwatch.h"
@@ -50,6 +51,8 @@
 
 #ifdef __UNIX__
     #include <errno.h>
+    #include <limits.h>
+    #include <sys/uio.h>
 #endif
 
 // we use MSG_NOSIGNAL to avoid getting SIGPIPE when sending data to a remote
@@ -141,6 +144,92 @@ void SetTimeValFromMS(timeval& tv, unsigned long ms)
     tv.tv_usec = (ms % 1000) * 1000;
 }
 
+// return the total size of the data in the given buffers, starting at the
+// given offset in the first of them
+wxUint32
+GetTotalSize(const wxSocketBuffer *buffers, unsigned count, wxUint32 offset)
+{
+    wxUint32 total = 0;
+    for ( unsigned n = 0; n < count; n++ )
+        total += buffers[n].size;
+
+    return total - offset;
+}
+
+// copy the data from the given buffers into a contiguous memory block which
+// must be big enough
+void GatherData(char *data,
+                const wxSocketBuffer *buffers, unsigned count, wxUint32 offset)
+{
+    for ( unsigned n = 0; n < count; n++ )
+    {
+        const wxUint32 size = buffers[n].size - offset;
+        memcpy(data, static_cast<const char *>(buffers[n].data) + offset, size);
+        data += size;
+        offset = 0;
+    }
+}
+
+// copy the data from a contiguous memory block to the given buffers which
+// must be big enough to hold all of it
+void ScatterData(const char *data, wxUint32 size,
+                 const wxSocketBuffer *buffers, wxUint32 offset)
+{
+    for ( ; size; buffers++ )
+    {
+        const wxUint32 len = wxMin(size, buffers->size - offset);
+        memcpy(static_cast<char *>(buffers->data) + offset, data, len);
+        data += len;
+        size -= len;
+        offset = 0;
+    }
+}
+
+// advance the current position, given by the index of the buffer and the
+// offset in it, by the given number of bytes, skipping over the buffers which
+// are consumed entirely or were empty from the beginning
+void AdvanceBuffers(const wxSocketBuffer *buffers, unsigned count,
+                    unsigned& n, wxUint32& offset, wxUint32 nbytes)
+{
+    offset += nbytes;
+    while ( n < count && offset >= buffers[n].size )
+    {
+        offset -= buffers[n].size;
+        n++;
+    }
+}
+
+#ifdef __UNIX__
+
+// maximal number of buffers passed to a single readv() or sendmsg() call: we
+// don't need to pass all of them at once, so don't use more than 64 even if
+// IOV_MAX is much bigger, as it is under Linux
+#if defined(IOV_MAX) && IOV_MAX < 64
+    #define wxSOCKET_IOV_MAX IOV_MAX
+#else
+    #define wxSOCKET_IOV_MAX 64
+#endif
+
+// fill the iovec array with the given buffers and return the number of its
+// elements actually used
+int FillIOVec(iovec *iov, const wxSocketBuffer *buffers, int count,
+              wxUint32 offset)
+{
+    if ( count > wxSOCKET_IOV_MAX )
+        count = wxSOCKET_IOV_MAX;
+
+    for ( int n = 0; n < count; n++ )
+    {
+        iov[n].iov_base = static_cast<char *>(buffers[n].data) + offset;
+        iov[n].iov_len = buffers[n].size - offset;
+        offset = 0;
+    }
+
+    return count;
+}
+
+#endif // __UNIX__
+
 } // anonymous namespace
 
 // --------------------------------------------------------------------------
@@ -199,6 +288,73 @@ private:
     wxDECLARE_NO_COPY_CLASS(wxSocketWaitModeChanger);
 };
 
+// wxSocketAsyncOp: a pending asynchronous read or write operation
+struct wxSocketAsyncOp
+{
+    wxSocketAsyncOp() { Reset(); }
+
+    void Reset()
+    {
+        handler = NULL;
+        buffer = NULL;
+        size =
+        done =
+        buffered = 0;
+    }
+
+    bool IsPending() const { return handler != NULL; }
+
+    // return true if the read operation can be completed
+    bool IsReadDone(bool waitall) const
+    {
+        return done == size || (done && !waitall);
+    }
+
+    wxSocketAsyncHandler *handler;
+    char *buffer;
+    wxUint32 size;      // total size of the buffer
+    wxUint32 done;      // number of bytes already read or written
+    wxUint32 buffered;  // number of bytes of the write buffer to send first
+};
+
+// wxSocketAsyncState: all pending asynchronous operations of a socket
+class wxSocketAsyncState : public wxEvtHandler
+{
+public:
+    wxSocketAsyncState(wxSocketBase& socket)
+        : m_socket(socket)
+    {
+        acceptHandler = NULL;
+
+        Bind(wxEVT_SOCKET, &wxSocketAsyncState::OnDeferredRead, this);
+    }
+
+    // complete the pending read operation, which doesn't need to read
+    // anything from the socket any more, from the event loop
+    void DeferReadCompletion()
+    {
+        wxSocketEvent event;
+        event.m_event = wxSOCKET_INPUT;
+        AddPendingEvent(event);
+    }
+
+    wxSocketAsyncOp read,
+                    write;
+
+    // only used for the server sockets
+    wxSocketAsyncHandler *acceptHandler;
+
+private:
+    void OnDeferredRead(wxSocketEvent& WXUNUSED(event))
+    {
+        m_socket.CompleteDeferredAsyncRead();
+    }
+
+    wxSocketBase& m_socket;
+
+    wxDECLARE_NO_COPY_CLASS(wxSocketAsyncState);
+};
+
 // wxSocketRead/WriteGuard are instantiated before starting reading
 // from/writing to the socket
 class wxSocketReadGuard
@@ -419,7 +575,9 @@ wxSocketError wxSocketImpl::CreateServer()
 
     if ( IsOk() )
     {
-        if ( listen(m_fd, 5) != 0 )
+        // use the maximal backlog as a server handling many connections
+        // asynchronously may not accept them immediately
+        if ( listen(m_fd, SOMAXCONN) != 0 )
             m_error = wxSOCKET_IOERR;
     }
 
@@ -716,6 +874,65 @@ int wxSocketImpl::SendDgram(const void *buffer, int size)
     return ret;
 }
 
+int wxSocketImpl::RecvStreamV(const wxSocketBuffer *buffers, int count,
+                              wxUint32 offset)
+{
+#ifdef __UNIX__
+    iovec iov[wxSOCKET_IOV_MAX];
+    const int iovcnt = FillIOVec(iov, buffers, count, offset);
+
+    int ret;
+    DO_WHILE_EINTR( ret, readv(m_fd, iov, iovcnt) );
+
+    if ( !ret )
+    {
+        // the connection was closed by peer, see RecvStream()
+        m_establishing = false;
+        NotifyOnStateChange(wxSOCKET_LOST);
+
+        Shutdown();
+    }
+
+    return ret;
+#else // !__UNIX__
+    // we don't have scatter IO with Winsock 1, so just read into the first
+    // buffer, the caller will call us again to fill the other ones if needed
+    wxUnusedVar(count);
+
+    return RecvStream(static_cast<char *>(buffers[0].data) + offset,
+                      buffers[0].size - offset);
+#endif // __UNIX__/!__UNIX__
+}
+
+int wxSocketImpl::SendStreamV(const wxSocketBuffer *buffers, int count,
+                              wxUint32 offset)
+{
+#ifdef __UNIX__
+#ifdef wxNEEDS_IGNORE_SIGPIPE
+    IgnoreSignal ignore(SIGPIPE);
+#endif
+
+    iovec iov[wxSOCKET_IOV_MAX];
+
+    // use sendmsg() and not writev() as the latter doesn't take the flags
+    // and so can't be prevented from generating SIGPIPE
+    msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = FillIOVec(iov, buffers, count, offset);
+
+    int ret;
+    DO_WHILE_EINTR( ret, sendmsg(m_fd, &msg, wxSOCKET_MSG_NOSIGNAL) );
+
+    return ret;
+#else // !__UNIX__
+    wxUnusedVar(count);
+
+    return SendStream(static_cast<const char *>(buffers[0].data) + offset,
+                      buffers[0].size - offset);
+#endif // __UNIX__/!__UNIX__
+}
+
 int wxSocketImpl::Read(void *buffer, int size)
 {
     // server sockets can't be used for IO, only to accept new connections
@@ -749,6 +966,76 @@ int wxSocketImpl::Write(const void *buffer, int size)
     return ret;
 }
 
+int wxSocketImpl::ReadV(const wxSocketBuffer *buffers, int count,
+                        wxUint32 offset)
+{
+    if ( count == 1 )
+    {
+        return Read(static_cast<char *>(buffers[0].data) + offset,
+                    buffers[0].size - offset);
+    }
+
+    if ( m_fd == INVALID_SOCKET || m_server )
+    {
+        m_error = wxSOCKET_INVSOCK;
+        return -1;
+    }
+
+    int ret;
+    if ( m_stream )
+    {
+        ret = RecvStreamV(buffers, count, offset);
+    }
+    else // datagram socket
+    {
+        // a datagram must be received at once, so receive it into a buffer
+        // big enough for all the data and then scatter it
+        const wxUint32 size = GetTotalSize(buffers, count, offset);
+        wxCharBuffer buf(size);
+        ret = RecvDgram(buf.data(), size);
+        if ( ret > 0 )
+            ScatterData(buf.data(), ret, buffers, offset);
+    }
+
+    m_error = ret == SOCKET_ERROR ? GetLastError() : wxSOCKET_NOERROR;
+
+    return ret;
+}
+
+int wxSocketImpl::WriteV(const wxSocketBuffer *buffers, int count,
+                         wxUint32 offset)
+{
+    if ( count == 1 )
+    {
+        return Write(static_cast<const char *>(buffers[0].data) + offset,
+                     buffers[0].size - offset);
+    }
+
+    if ( m_fd == INVALID_SOCKET || m_server )
+    {
+        m_error = wxSOCKET_INVSOCK;
+        return -1;
+    }
+
+    int ret;
+    if ( m_stream )
+    {
+        ret = SendStreamV(buffers, count, offset);
+    }
+    else // datagram socket
+    {
+        // all the data must be sent as a single datagram, so gather it first
+        const wxUint32 size = GetTotalSize(buffers, count, offset);
+        wxCharBuffer buf(size);
+        GatherData(buf.data(), buffers, count, offset);
+        ret = SendDgram(buf.data(), size);
+    }
+
+    m_error = ret == SOCKET_ERROR ? GetLastError() : wxSOCKET_NOERROR;
+
+    return ret;
+}
+
 // ==========================================================================
 // wxSocketBase
 // ==========================================================================
@@ -831,9 +1118,18 @@ void wxSocketBase::Init()
 
     // pushback buffer
     m_unread       = NULL;
+    m_unrd_alloc   = 0;
     m_unrd_size    = 0;
     m_unrd_cur     = 0;
 
+    // write buffer
+    m_wbuf         = NULL;
+    m_wbuf_alloc   = 0;
+    m_wbuf_size    = 0;
+
+    // asynchronous operations
+    m_async        = NULL;
+
     // events
     m_id           = wxID_ANY;
     m_handler      = NULL;
@@ -878,8 +1174,11 @@ wxSocketBase::~wxSocketBase()
     // Destroy the implementation object
     delete m_impl;
 
-    // Free the pushback buffer
+    // Free the pushback and write buffers
     free(m_unread);
+    free(m_wbuf);
+
+    delete m_async;
 }
 
 bool wxSocketBase::Destroy()
@@ -936,6 +1235,22 @@ wxSocketError wxSocketBase::LastError() const
 // {Read, Write, ReadMsg, WriteMsg, Peek, Unread, Discard}
 bool wxSocketBase::Close()
 {
+    // Send the data remaining in the write buffer, if any, before closing
+    if ( m_wbuf_size )
+    {
+        if ( m_impl && m_connected && !m_writing )
+        {
+            wxSocketWriteGuard write(this);
+            DoFlush();
+        }
+
+        m_wbuf_size = 0;
+    }
+
+    // Don't notify about the completion of any asynchronous operations any
+    // more
+    CancelAsync();
+
     // Interrupt pending waits
     InterruptWait();
 
@@ -962,22 +1277,62 @@ wxSocketBase& wxSocketBase::Read(void* buffer, wxUint32 nbytes)
     return *this;
 }
 
-wxUint32 wxSocketBase::DoRead(void* buffer_, wxUint32 nbytes)
+wxSocketBase& wxSocketBase::ReadV(const wxSocketBuffer *buffers,
+                                  unsigned count)
 {
-    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+    wxSocketReadGuard read(this);
+
+    m_lcount_read = DoReadV(buffers, count);
+    m_lcount = m_lcount_read;
+
+    return *this;
+}
 
-    // We use pointer arithmetic here which doesn't work with void pointers.
-    char *buffer = static_cast<char *>(buffer_);
+wxUint32 wxSocketBase::DoRead(void* buffer, wxUint32 nbytes)
+{
     wxCHECK_MSG( buffer, 0, "NULL buffer" );
 
+    const wxSocketBuffer buf(buffer, nbytes);
+    return DoReadV(&buf, 1);
+}
+
+wxUint32 wxSocketBase::DoReadV(const wxSocketBuffer *buffers, unsigned count)
+{
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+
+    unsigned n = 0;
+    wxUint32 offset = 0;
+    AdvanceBuffers(buffers, count, n, offset, 0);
+
     // Try the push back buffer first, even before checking whether the socket
     // is valid to allow reading previously pushed back data from an already
     // closed socket.
-    wxUint32 total = GetPushback(buffer, nbytes, false);
-    nbytes -= total;
-    buffer += total;
+    wxUint32 total = 0;
+    while ( n < count )
+    {
+        const wxUint32 ret =
+            GetPushback(static_cast<char *>(buffers[n].data) + offset,
+                        buffers[n].size - offset, false);
+        if ( !ret )
+            break;
+
+        total += ret;
+        AdvanceBuffers(buffers, count, n, offset, ret);
+    }
 
-    while ( nbytes )
+    return total + DoReadFromSocket(buffers + n, count - n, offset, total != 0);
+}
+
+wxUint32
+wxSocketBase::DoReadFromSocket(const wxSocketBuffer *buffers, unsigned count,
+                               wxUint32 offset, bool readSome)
+{
+    wxUint32 total = 0;
+
+    unsigned n = 0;
+    AdvanceBuffers(buffers, count, n, offset, 0);
+
+    while ( n < count )
     {
         // our socket is non-blocking so Read() will return immediately if
         // there is nothing to read yet and it's more efficient to try it first
@@ -986,7 +1341,7 @@ wxUint32 wxSocketBase::DoRead(void* buffer_, wxUint32 nbytes)
         // where we're not going to get notifications about socket being ready
         // for reading before we read all the existing data from it
         const int ret = !m_impl->m_stream || m_connected
-                            ? m_impl->Read(buffer, nbytes)
+                            ? m_impl->ReadV(buffers + n, count - n, offset)
                             : 0;
         if ( ret == -1 )
         {
@@ -1029,20 +1384,19 @@ wxUint32 wxSocketBase::DoRead(void* buffer_, wxUint32 nbytes)
             // we're not going to read anything else and so if we haven't read
             // anything (or not everything in wxSOCKET_WAITALL case) already,
             // signal an error
-            if ( (m_flags & wxSOCKET_WAITALL_READ) || !total )
+            if ( (m_flags & wxSOCKET_WAITALL_READ) || !(total || readSome) )
                 SetError(wxSOCKET_IOERR);
             break;
         }
 
         total += ret;
 
-        // if we are happy to read something and not the entire nbytes bytes,
+        // if we are happy to read something and not all the buffers entirely,
         // then we're done
         if ( !(m_flags & wxSOCKET_WAITALL_READ) )
             break;
 
-        nbytes -= ret;
-        buffer += ret;
+        AdvanceBuffers(buffers, count, n, offset, ret);
     }
 
     return total;
@@ -1084,12 +1438,25 @@ wxSocketBase& wxSocketBase::ReadMsg(void* buffer, wxUint32 nbytes)
             else
                 len2 = 0;
 
-            // Don't attempt to read if the msg was zero bytes long.
-            m_lcount_read = len ? DoRead(buffer, len) : 0;
-            m_lcount = m_lcount_read;
+            bool gotTrailer;
+            if ( !len2 )
+            {
+                // Read the message and the trailer following it at once.
+                const wxSocketBuffer buffers[] =
+                {
+                    wxSocketBuffer(buffer, len),
+                    wxSocketBuffer(&msg, sizeof(msg))
+                };
 
-            if ( len2 )
+                const wxUint32 count = DoReadV(buffers, WXSIZEOF(buffers));
+                m_lcount_read = wxMin(count, len);
+                gotTrailer = count == len + sizeof(msg);
+            }
+            else
             {
+                // Don't attempt to read if the msg was zero bytes long.
+                m_lcount_read = len ? DoRead(buffer, len) : 0;
+
                 char discard_buffer[MAX_DISCARD_SIZE];
                 long discard_len;
 
@@ -1103,9 +1470,13 @@ wxSocketBase& wxSocketBase::ReadMsg(void* buffer, wxUint32 nbytes)
                     len2 -= (wxUint32)discard_len;
                 }
                 while ((discard_len > 0) && len2);
+
+                gotTrailer = !len2 && DoRead(&msg, sizeof(msg)) == sizeof(msg);
             }
 
-            if ( !len2 && DoRead(&msg, sizeof(msg)) == sizeof(msg) )
+            m_lcount = m_lcount_read;
+
+            if ( gotTrailer )
             {
                 sig = (wxUint32)msg.sig[0];
                 sig |= (wxUint32)(msg.sig[1] << 8);
@@ -1142,24 +1513,56 @@ wxSocketBase& wxSocketBase::Write(const void *buffer, wxUint32 nbytes)
 {
     wxSocketWriteGuard write(this);
 
-    m_lcount_write = DoWrite(buffer, nbytes);
+    if ( m_wbuf_alloc )
+    {
+        wxCHECK_MSG( buffer, *this, "NULL buffer" );
+
+        const wxSocketBuffer buf(buffer, nbytes);
+        m_lcount_write = DoBufferedWrite(&buf, 1);
+    }
+    else
+    {
+        m_lcount_write = DoWrite(buffer, nbytes);
+    }
+
     m_lcount = m_lcount_write;
 
     return *this;
 }
 
-// This function is a mirror image of DoRead() except that it doesn't use the
-// push back buffer and doesn't treat 0 return value specially (normally this
-// shouldn't happen at all here), so please see comments there for explanations
-wxUint32 wxSocketBase::DoWrite(const void *buffer_, wxUint32 nbytes)
+wxSocketBase& wxSocketBase::WriteV(const wxSocketBuffer *buffers,
+                                   unsigned count)
 {
-    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+    wxSocketWriteGuard write(this);
+
+    m_lcount_write = DoBufferedWrite(buffers, count);
+    m_lcount = m_lcount_write;
+
+    return *this;
+}
 
-    const char *buffer = static_cast<const char *>(buffer_);
+wxUint32 wxSocketBase::DoWrite(const void *buffer, wxUint32 nbytes)
+{
     wxCHECK_MSG( buffer, 0, "NULL buffer" );
 
+    const wxSocketBuffer buf(buffer, nbytes);
+    return DoWriteV(&buf, 1);
+}
+
+// This function is a mirror image of DoReadFromSocket() except that it
+// doesn't treat 0 return value specially (normally this shouldn't happen at
+// all here), so please see comments there for explanations
+wxUint32 wxSocketBase::DoWriteV(const wxSocketBuffer *buffers, unsigned count)
+{
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+
     wxUint32 total = 0;
-    while ( nbytes )
+
+    unsigned n = 0;
+    wxUint32 offset = 0;
+    AdvanceBuffers(buffers, count, n, offset, 0);
+
+    while ( n < count )
     {
         if ( m_impl->m_stream && !m_connected )
         {
@@ -1168,7 +1571,7 @@ wxUint32 wxSocketBase::DoWrite(const void *buffer_, wxUint32 nbytes)
             break;
         }
 
-        const int ret = m_impl->Write(buffer, nbytes);
+        const int ret = m_impl->WriteV(buffers + n, count - n, offset);
         if ( ret == -1 )
         {
             if ( m_impl->GetLastError() == wxSOCKET_WOULDBLOCK )
@@ -1196,57 +1599,167 @@ wxUint32 wxSocketBase::DoWrite(const void *buffer_, wxUint32 nbytes)
         if ( !(m_flags & wxSOCKET_WAITALL_WRITE) )
             break;
 
-        nbytes -= ret;
-        buffer += ret;
+        AdvanceBuffers(buffers, count, n, offset, ret);
     }
 
     return total;
 }
 
-wxSocketBase& wxSocketBase::WriteMsg(const void *buffer, wxUint32 nbytes)
+wxUint32
+wxSocketBase::DoBufferedWrite(const wxSocketBuffer *buffers, unsigned count)
 {
-    struct
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+
+    if ( !m_wbuf_alloc )
+        return DoWriteV(buffers, count);
+
+    // If the new data fits into the buffer, just append it there.
+    const wxUint32 nbytes = GetTotalSize(buffers, count, 0);
+    if ( nbytes <= m_wbuf_alloc - m_wbuf_size )
     {
-        unsigned char sig[4];
-        unsigned char len[4];
-    } msg;
+        GatherData(m_wbuf + m_wbuf_size, buffers, count, 0);
+        m_wbuf_size += nbytes;
+        return nbytes;
+    }
 
-    wxSocketWriteGuard write(this);
+    if ( !m_wbuf_size )
+        return DoWriteV(buffers, count);
 
-    wxSocketWaitModeChanger changeFlags(this, wxSOCKET_WAITALL_WRITE);
+    // Otherwise send the buffered data together with the new data using a
+    // single write.
+    wxVector<wxSocketBuffer> all;
+    all.reserve(count + 1);
+    all.push_back(wxSocketBuffer(m_wbuf, m_wbuf_size));
+    for ( unsigned n = 0; n < count; n++ )
+        all.push_back(buffers[n]);
 
-    msg.sig[0] = (unsigned char) 0xad;
-    msg.sig[1] = (unsigned char) 0xde;
-    msg.sig[2] = (unsigned char) 0xed;
-    msg.sig[3] = (unsigned char) 0xfe;
+    const wxUint32 buffered = m_wbuf_size;
+    const wxUint32 written = DoWriteV(&all[0], all.size());
+    if ( written < buffered )
+    {
+        // Not even all the previously buffered data could be written, keep
+        // the rest of it and don't write any of the new data to preserve the
+        // order.
+        ConsumeWriteBuffer(written);
+        return 0;
+    }
 
-    msg.len[0] = (unsigned char) (nbytes & 0xff);
-    msg.len[1] = (unsigned char) ((nbytes >> 8) & 0xff);
-    msg.len[2] = (unsigned char) ((nbytes >> 16) & 0xff);
-    msg.len[3] = (unsigned char) ((nbytes >> 24) & 0xff);
+    m_wbuf_size = 0;
 
-    bool ok = false;
-    if ( DoWrite(&msg, sizeof(msg)) == sizeof(msg) )
+    return written - buffered;
+}
+
+void wxSocketBase::ConsumeWriteBuffer(wxUint32 size)
+{
+    m_wbuf_size -= size;
+    memmove(m_wbuf, m_wbuf + size, m_wbuf_size);
+}
+
+bool wxSocketBase::DoFlush()
+{
+    if ( m_wbuf_size )
     {
-        m_lcount_write = DoWrite(buffer, nbytes);
-        m_lcount = m_lcount_write;
-        if ( m_lcount_write == nbytes )
+        wxSocketWaitModeChanger changeFlags(this, wxSOCKET_WAITALL_WRITE);
+
+        ConsumeWriteBuffer(DoWrite(m_wbuf, m_wbuf_size));
+    }
+
+    return !m_wbuf_size;
+}
+
+bool wxSocketBase::Flush()
+{
+    wxSocketWriteGuard write(this);
+
+    return DoFlush();
+}
+
+void wxSocketBase::SetWriteBufferSize(wxUint32 size)
+{
+    wxCHECK_RET( m_type != wxSOCKET_DATAGRAM,
+                 "write buffering can't be used with datagram sockets" );
+
+    if ( m_wbuf_size > size )
+    {
+        // If we can't send the data which doesn't fit into the new buffer, we
+        // can only discard it, the connection is probably broken anyhow.
+        if ( !Flush() )
         {
-            msg.sig[0] = (unsigned char) 0xed;
-            msg.sig[1] = (unsigned char) 0xfe;
-            msg.sig[2] = (unsigned char) 0xad;
-            msg.sig[3] = (unsigned char) 0xde;
-            msg.len[0] =
-            msg.len[1] =
-            msg.len[2] =
-            msg.len[3] = (char) 0;
-
-            if ( DoWrite(&msg, sizeof(msg)) == sizeof(msg))
-                ok = true;
+            wxLogTrace(wxTRACE_Socket,
+                       "Discarding %u bytes of buffered socket data",
+                       m_wbuf_size);
+            m_wbuf_size = 0;
         }
     }
 
-    if ( !ok )
+    if ( size )
+    {
+        char * const wbuf = static_cast<char *>(realloc(m_wbuf, size));
+        wxCHECK_RET( wbuf, "failed to allocate socket write buffer" );
+
+        m_wbuf = wbuf;
+    }
+    else
+    {
+        free(m_wbuf);
+        m_wbuf = NULL;
+    }
+
+    m_wbuf_alloc = size;
+}
+
+wxSocketBase& wxSocketBase::WriteMsg(const void *buffer, wxUint32 nbytes)
+{
+    struct
+    {
+        unsigned char sig[4];
+        unsigned char len[4];
+    } header, trailer;
+
+    wxCHECK_MSG( buffer || !nbytes, *this, "NULL buffer" );
+
+    wxSocketWriteGuard write(this);
+
+    wxSocketWaitModeChanger changeFlags(this, wxSOCKET_WAITALL_WRITE);
+
+    header.sig[0] = (unsigned char) 0xad;
+    header.sig[1] = (unsigned char) 0xde;
+    header.sig[2] = (unsigned char) 0xed;
+    header.sig[3] = (unsigned char) 0xfe;
+
+    header.len[0] = (unsigned char) (nbytes & 0xff);
+    header.len[1] = (unsigned char) ((nbytes >> 8) & 0xff);
+    header.len[2] = (unsigned char) ((nbytes >> 16) & 0xff);
+    header.len[3] = (unsigned char) ((nbytes >> 24) & 0xff);
+
+    trailer.sig[0] = (unsigned char) 0xed;
+    trailer.sig[1] = (unsigned char) 0xfe;
+    trailer.sig[2] = (unsigned char) 0xad;
+    trailer.sig[3] = (unsigned char) 0xde;
+    trailer.len[0] =
+    trailer.len[1] =
+    trailer.len[2] =
+    trailer.len[3] = (char) 0;
+
+    // Write everything at once to avoid both the extra system calls and the
+    // delays due to the interaction with Nagle's algorithm.
+    const wxSocketBuffer buffers[] =
+    {
+        wxSocketBuffer(&header, sizeof(header)),
+        wxSocketBuffer(buffer, nbytes),
+        wxSocketBuffer(&trailer, sizeof(trailer))
+    };
+
+    const wxUint32 written = DoBufferedWrite(buffers, WXSIZEOF(buffers));
+
+    // Only the message data itself is counted in m_lcount.
+    const wxUint32 headerSize = sizeof(header);
+    m_lcount_write = written > headerSize
+                        ? wxMin(written - headerSize, nbytes)
+                        : 0;
+    m_lcount = m_lcount_write;
+
+    if ( written != headerSize + nbytes + sizeof(trailer) )
         SetError(wxSOCKET_IOERR);
 
     return *this;
@@ -1544,7 +2057,7 @@ bool wxSocketBase::Wait(long seconds, long milliseconds)
 bool wxSocketBase::WaitForRead(long seconds, long milliseconds)
 {
     // Check pushback buffer before entering DoWait
-    if ( m_unread )
+    if ( m_unrd_cur < m_unrd_size )
         return true;
 
     // Check if the socket is not already ready for input, if it is, there is
@@ -1714,6 +2227,11 @@ void wxSocketBase::OnRequest(wxSocketNotify notification)
     // use this in DoWait()
     m_eventsgot |= flag;
 
+    // the IO performed by the pending asynchronous operations is not visible
+    // to the user code and so doesn't generate any events
+    if ( m_async && DoProcessAsync(notification) )
+        return;
+
     // send the wx event if enabled and we're interested in it
     if ( m_notify && (m_eventmask & flag) && m_handler )
     {
@@ -1751,6 +2269,365 @@ void wxSocketBase::SetEventHandler(wxEvtHandler& handler, int id)
     m_id      = id;
 }
 
+// --------------------------------------------------------------------------
+// Asynchronous IO
+// --------------------------------------------------------------------------
+
+wxSocketAsyncState& wxSocketBase::GetAsyncState()
+{
+    if ( !m_async )
+        m_async = new wxSocketAsyncState(*this);
+
+    return *m_async;
+}
+
+bool wxSocketBase::IsAsyncReadPending() const
+{
+    return m_async && m_async->read.IsPending();
+}
+
+bool wxSocketBase::IsAsyncWritePending() const
+{
+    return m_async && m_async->write.IsPending();
+}
+
+void wxSocketBase::CancelAsync()
+{
+    if ( m_async )
+    {
+        m_async->read.Reset();
+        m_async->write.Reset();
+        m_async->acceptHandler = NULL;
+    }
+}
+
+bool wxSocketBase::AsyncRead(void *buffer, wxUint32 nbytes,
+                             wxSocketAsyncHandler *handler)
+{
+    wxCHECK_MSG( m_impl, false, "socket must be valid" );
+    wxCHECK_MSG( buffer && nbytes, false, "invalid buffer" );
+    wxCHECK_MSG( handler, false, "must have a handler" );
+    wxCHECK_MSG( !IsAsyncReadPending(), false,
+                 "another asynchronous read is already in progress" );
+
+    wxSocketAsyncOp& op = GetAsyncState().read;
+    op.handler = handler;
+    op.buffer = static_cast<char *>(buffer);
+    op.size = nbytes;
+    op.done = GetPushback(buffer, nbytes, false);
+
+    // We can't wait for the socket to become readable if the pushed back data
+    // is already enough to complete this operation, but still call the
+    // handler from the event loop, as for all the other operations, and not
+    // before returning from here.
+    if ( op.IsReadDone((m_flags & wxSOCKET_WAITALL_READ) != 0) )
+    {
+        m_async->DeferReadCompletion();
+        return true;
+    }
+
+    // Notice that it's fine to start reading from a socket which is still
+    // connecting, we'll get the data once the connection is established.
+    if ( m_impl->m_stream && !m_connected && !m_establishing )
+    {
+        op.Reset();
+        SetError(wxSOCKET_IOERR);
+        return false;
+    }
+
+    // Our handler will be called when the socket becomes ready for reading.
+    m_impl->ReenableEvents(wxSOCKET_INPUT_FLAG);
+
+    return true;
+}
+
+bool wxSocketBase::AsyncWrite(const void *buffer, wxUint32 nbytes,
+                              wxSocketAsyncHandler *handler)
+{
+    wxCHECK_MSG( m_impl, false, "socket must be valid" );
+    wxCHECK_MSG( buffer && nbytes, false, "invalid buffer" );
+    wxCHECK_MSG( handler, false, "must have a handler" );
+    wxCHECK_MSG( !IsAsyncWritePending(), false,
+                 "another asynchronous write is already in progress" );
+
+    if ( m_impl->m_stream && !m_connected && !m_establishing )
+    {
+        SetError(wxSOCKET_IOERR);
+        return false;
+    }
+
+    wxSocketAsyncOp& op = GetAsyncState().write;
+    op.handler = handler;
+    op.buffer = static_cast<char *>(const_cast<void *>(buffer));
+    op.size = nbytes;
+    op.done = 0;
+
+    // Any data still remaining in the write buffer is sent as part of this
+    // operation, before its own data, to preserve the order of the data.
+    op.buffered = m_wbuf_size;
+
+    // Write as much as we can right now, this is not going to block, but do
+    // not notify the handler about completion from here even if everything
+    // was written: this will be done when we get the notification about the
+    // socket being writable, which will happen soon. If we're still
+    // connecting, the same notification will also tell us that we can start
+    // writing.
+    if ( !m_establishing )
+    {
+        const wxSocketError error = DoAsyncWrite();
+        if ( error != wxSOCKET_NOERROR )
+        {
+            op.Reset();
+            SetError(error);
+            return false;
+        }
+    }
+
+    m_impl->ReenableEvents(wxSOCKET_OUTPUT_FLAG);
+
+    return true;
+}
+
+bool wxSocketServer::AsyncAccept(wxSocketAsyncHandler *handler)
+{
+    wxCHECK_MSG( m_impl && m_impl->IsServer(), false,
+                 "can only be called for a valid server socket" );
+    wxCHECK_MSG( handler, false, "must have a handler" );
+    wxCHECK_MSG( !IsAsyncAcceptPending(), false,
+                 "another asynchronous accept is already in progress" );
+
+    GetAsyncState().acceptHandler = handler;
+
+    m_impl->ReenableEvents(wxSOCKET_INPUT_FLAG);
+
+    return true;
+}
+
+bool wxSocketServer::IsAsyncAcceptPending() const
+{
+    return m_async && m_async->acceptHandler;
+}
+
+bool wxSocketBase::DoProcessAsync(wxSocketNotify notification)
+{
+    // Notice that we never do anything if m_reading or m_writing is set: this
+    // means that either the synchronous IO is in progress, in which case it
+    // will consume the data, or that we're called from inside ContinueAsync
+    // functions themselves, which will check for errors on their own.
+    switch ( notification )
+    {
+        case wxSOCKET_INPUT:
+            if ( m_async->read.IsPending() && !m_reading )
+            {
+                ContinueAsyncRead();
+                return true;
+            }
+            break;
+
+        case wxSOCKET_OUTPUT:
+            if ( m_async->write.IsPending() && !m_writing )
+            {
+                ContinueAsyncWrite();
+                return true;
+            }
+            break;
+
+        case wxSOCKET_CONNECTION:
+            if ( m_async->acceptHandler )
+            {
+                ContinueAsyncAccept();
+                return true;
+            }
+            break;
+
+        case wxSOCKET_LOST:
+            // Notify the handlers about the error but still generate the
+            // event for this notification.
+            if ( m_async->read.IsPending() && !m_reading )
+                CompleteAsyncRead(wxSOCKET_IOERR);
+            if ( m_async->write.IsPending() && !m_writing )
+                CompleteAsyncWrite(wxSOCKET_IOERR);
+            break;
+    }
+
+    return false;
+}
+
+void wxSocketBase::ContinueAsyncRead()
+{
+    wxSocketAsyncOp& op = m_async->read;
+
+    wxSocketError error = wxSOCKET_NOERROR;
+    bool completed = false;
+
+    m_reading = true;
+    while ( op.done < op.size )
+    {
+        const int ret = m_impl->Read(op.buffer + op.done, op.size - op.done);
+        if ( ret == -1 )
+        {
+            if ( m_impl->GetLastError() != wxSOCKET_WOULDBLOCK )
+            {
+                error = wxSOCKET_IOERR;
+                completed = true;
+            }
+            break;
+        }
+
+        if ( ret == 0 )
+        {
+            // The connection was closed, see the comments in
+            // DoReadFromSocket().
+            m_closed = true;
+            if ( (m_flags & wxSOCKET_WAITALL_READ) || !op.done )
+                error = wxSOCKET_IOERR;
+            completed = true;
+            break;
+        }
+
+        op.done += ret;
+        if ( !(m_flags & wxSOCKET_WAITALL_READ) )
+            break;
+    }
+    m_reading = false;
+
+    if ( completed || op.IsReadDone((m_flags & wxSOCKET_WAITALL_READ) != 0) )
+    {
+        CompleteAsyncRead(error);
+    }
+    else // wait until more data becomes available
+    {
+        m_impl->ReenableEvents(wxSOCKET_INPUT_FLAG);
+    }
+}
+
+wxSocketError wxSocketBase::DoAsyncWrite()
+{
+    wxSocketAsyncOp& op = m_async->write;
+
+    wxSocketError error = wxSOCKET_NOERROR;
+
+    m_writing = true;
+    while ( op.buffered || op.done < op.size )
+    {
+        int ret;
+        if ( op.buffered )
+        {
+            // Send the rest of the previously buffered data together with the
+            // data of this operation using a single write.
+            const wxSocketBuffer buffers[] =
+            {
+                wxSocketBuffer(m_wbuf, op.buffered),
+                wxSocketBuffer(op.buffer, op.size)
+            };
+
+            ret = m_impl->WriteV(buffers, WXSIZEOF(buffers), 0);
+        }
+        else
+        {
+            ret = m_impl->Write(op.buffer + op.done, op.size - op.done);
+        }
+
+        if ( ret == -1 )
+        {
+            if ( m_impl->GetLastError() != wxSOCKET_WOULDBLOCK )
+                error = wxSOCKET_IOERR;
+            break;
+        }
+
+        // Only the data of the operation itself is counted in op.done.
+        wxUint32 written = ret;
+        if ( op.buffered )
+        {
+            const wxUint32 fromBuffer = wxMin(written, op.buffered);
+            ConsumeWriteBuffer(fromBuffer);
+            op.buffered -= fromBuffer;
+            written -= fromBuffer;
+        }
+
+        op.done += written;
+    }
+    m_writing = false;
+
+    return error;
+}
+
+void wxSocketBase::ContinueAsyncWrite()
+{
+    const wxSocketError error = DoAsyncWrite();
+
+    if ( error != wxSOCKET_NOERROR || m_async->write.done == m_async->write.size )
+        CompleteAsyncWrite(error);
+    else // wait until we can write more
+        m_impl->ReenableEvents(wxSOCKET_OUTPUT_FLAG);
+}
+
+void wxSocketBase::ContinueAsyncAccept()
+{
+    wxSocketServer * const server = static_cast<wxSocketServer *>(this);
+
+    wxSocketBase *sock = new wxSocketBase();
+    sock->SetFlags(m_flags);
+
+    wxSocketError error = wxSOCKET_NOERROR;
+    if ( !server->AcceptWith(*sock, false) )
+    {
+        sock->Destroy();
+
+        // This can happen if the connection was aborted by the peer before we
+        // accepted it, just wait for the next one then.
+        error = LastError();
+        if ( error == wxSOCKET_WOULDBLOCK )
+            return;
+
+        sock = NULL;
+    }
+
+    wxSocketAsyncHandler * const handler = m_async->acceptHandler;
+    m_async->acceptHandler = NULL;
+
+    handler->OnAsyncAccept(*server, error, sock);
+}
+
+void wxSocketBase::CompleteDeferredAsyncRead()
+{
+    // The operation could have been cancelled, or completed by reading more
+    // data from the socket and maybe followed by another one, since it was
+    // deferred, so check that there is still something to complete.
+    const wxSocketAsyncOp& op = m_async->read;
+    if ( op.IsPending() && op.IsReadDone((m_flags & wxSOCKET_WAITALL_READ) != 0) )
+        CompleteAsyncRead(wxSOCKET_NOERROR);
+}
+
+void wxSocketBase::CompleteAsyncRead(wxSocketError error)
+{
+    wxSocketAsyncOp& op = m_async->read;
+
+    SetError(error);
+
+    // Reset the operation before calling the handler as it may start another
+    // one and notice that we can't use this object at all after calling it as
+    // it could have been destroyed by it.
+    wxSocketAsyncHandler * const handler = op.handler;
+    const wxUint32 done = op.done;
+    op.Reset();
+
+    handler->OnAsyncRead(*this, error, done);
+}
+
+void wxSocketBase::CompleteAsyncWrite(wxSocketError error)
+{
+    wxSocketAsyncOp& op = m_async->write;
+
+    SetError(error);
+
+    wxSocketAsyncHandler * const handler = op.handler;
+    const wxUint32 done = op.done;
+    op.Reset();
+
+    handler->OnAsyncWrite(*this, error, done);
+}
+
 // --------------------------------------------------------------------------
 // Pushback buffer
 // --------------------------------------------------------------------------
@@ -1759,49 +2636,112 @@ void wxSocketBase::Pushback(const void *buffer, wxUint32 size)
 {
     if (!size) return;
 
-    if (m_unread == NULL)
-        m_unread = malloc(size);
-    else
+    if (m_unrd_cur < size)
     {
-        void *tmp;
+        // there is not enough space before the existing data, make it
+        const wxUint32 len = m_unrd_size - m_unrd_cur;
 
-        tmp = malloc(m_unrd_size + size);
-        memcpy((char *)tmp + size, m_unread, m_unrd_size);
-        free(m_unread);
+        char *tmp = m_unread;
+        if (m_unrd_alloc < len + size)
+        {
+            m_unrd_alloc = len + size;
+            tmp = (char *)malloc(m_unrd_alloc);
+        }
 
-        m_unread = tmp;
+        if (len)
+            memmove(tmp + size, m_unread + m_unrd_cur, len);
+
+        if (tmp != m_unread)
+        {
+            free(m_unread);
+            m_unread = tmp;
+        }
+
+        m_unrd_cur = size;
+        m_unrd_size = len + size;
     }
 
-    m_unrd_size += size;
+    m_unrd_cur -= size;
 
-    memcpy(m_unread, buffer, size);
+    memcpy(m_unread + m_unrd_cur, buffer, size);
 }
 
 wxUint32 wxSocketBase::GetPushback(void *buffer, wxUint32 size, bool peek)
 {
     wxCHECK_MSG( buffer, 0, "NULL buffer" );
 
-    if (!m_unrd_size)
+    if (m_unrd_cur == m_unrd_size)
         return 0;
 
     if (size > (m_unrd_size-m_unrd_cur))
         size = m_unrd_size-m_unrd_cur;
 
-    memcpy(buffer, (char *)m_unread + m_unrd_cur, size);
+    memcpy(buffer, m_unread + m_unrd_cur, size);
 
     if (!peek)
+        SkipPushback(size);
+
+    return size;
+}
+
+void wxSocketBase::SkipPushback(wxUint32 size)
+{
+    wxASSERT_MSG( size <= m_unrd_size - m_unrd_cur, "invalid size" );
+
+    m_unrd_cur += size;
+    if (m_unrd_size == m_unrd_cur)
     {
-        m_unrd_cur += size;
-        if (m_unrd_size == m_unrd_cur)
-        {
-            free(m_unread);
-            m_unread = NULL;
-            m_unrd_size = 0;
-            m_unrd_cur  = 0;
-        }
+        // keep the buffer itself to avoid reallocating it later
+        m_unrd_size = 0;
+        m_unrd_cur  = 0;
     }
+}
 
-    return size;
+void wxSocketBase::ReservePushback(wxUint32 size)
+{
+    if (m_unrd_alloc - m_unrd_size >= size)
+        return;
+
+    const wxUint32 len = m_unrd_size - m_unrd_cur;
+
+    if (m_unrd_alloc >= len + size)
+    {
+        // there is enough space if we move the data to the buffer start
+        memmove(m_unread, m_unread + m_unrd_cur, len);
+    }
+    else
+    {
+        m_unrd_alloc = wxMax(len + size, 2*m_unrd_alloc);
+
+        char * const tmp = (char *)malloc(m_unrd_alloc);
+        if (len)
+            memcpy(tmp, m_unread + m_unrd_cur, len);
+        free(m_unread);
+
+        m_unread = tmp;
+    }
+
+    m_unrd_cur = 0;
+    m_unrd_size = len;
+}
+
+wxUint32 wxSocketBase::ReadToPushback(wxUint32 nbytes)
+{
+    wxCHECK_MSG( m_impl, 0, "socket must be valid" );
+
+    wxSocketReadGuard read(this);
+
+    // wait until some data can be read, whatever the current flags are, but
+    // don't wait for all of nbytes to arrive
+    wxSocketWaitModeChanger changeFlags(this, wxSOCKET_NONE);
+
+    ReservePushback(nbytes);
+
+    const wxSocketBuffer buf(m_unread + m_unrd_size, nbytes);
+    const wxUint32 count = DoReadFromSocket(&buf, 1, 0, false);
+    m_unrd_size += count;
+
+    return count;
 }
 
 
@@ -1987,6 +2927,12 @@ bool wxSocketClient::DoConnect(const wxSockAddress& remote,
 
     m_connected = false;
     m_establishing = false;
+    m_closed = false;
+
+    // any data read from the previous connection, but not consumed, is
+    // meaningless for the new one
+    m_unrd_size = 0;
+    m_unrd_cur = 0;
 
     // Create and set up the new one
     wxSocketManager * const manager = wxSocketManager::Get();
@@ -53,6 +53,15 @@
 #include "wx/osx/core/private/strconv_cf.h"
 #endif //def __DARWIN__
 
+// SSE2 is always available under x86-64 and can be explicitly enabled for
+// 32 bit x86 builds, use it for the UTF-8 conversions fast paths if we can.
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+
+    #define wxHAS_SSE2_INTRINSICS
+#endif
+
 
 #define TRACE_STRCONV wxT("strconv")
 
@@ -940,6 +949,153 @@ static const wxUint32 utf8_max[]=
 const wxUint32 wxUnicodePUA = 0x100000;
 const wxUint32 wxUnicodePUAEnd = wxUnicodePUA + 256;
 
+// The functions below are used to handle the runs of ASCII characters, which
+// are by far the most common case in practice, in bulk instead of going
+// through the general per-character code.
+//
+// Both of them examine at most len characters of src, stop at the first non
+// ASCII character or, if stopAtBackslash is true, at the first backslash, and
+// return the number of characters examined before stopping. The converted
+// characters are stored in dst unless it is NULL, in which case only the
+// length of the run is computed.
+
+static size_t
+wxDecodeASCIIRun(wchar_t *dst, const char *src, size_t len,
+                 bool stopAtBackslash = false)
+{
+    size_t n = 0;
+
+#ifdef wxHAS_SSE2_INTRINSICS
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i backslash = _mm_set1_epi8('\\');
+    for ( ; n + 16 <= len; n += 16 )
+    {
+        const __m128i bytes = _mm_loadu_si128((const __m128i *)(src + n));
+
+        // The high bit is set in all non-ASCII bytes, so this mask is non
+        // zero if any of them is present.
+        int mask = _mm_movemask_epi8(bytes);
+        if ( stopAtBackslash )
+            mask |= _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, backslash));
+        if ( mask )
+            break;
+
+        if ( dst )
+        {
+            const __m128i lo = _mm_unpacklo_epi8(bytes, zero),
+                          hi = _mm_unpackhi_epi8(bytes, zero);
+#if SIZEOF_WCHAR_T == 2
+            _mm_storeu_si128((__m128i *)(dst + n), lo);
+            _mm_storeu_si128((__m128i *)(dst + n + 8), hi);
+#else // SIZEOF_WCHAR_T == 4
+            _mm_storeu_si128((__m128i *)(dst + n), _mm_unpacklo_epi16(lo, zero));
+            _mm_storeu_si128((__m128i *)(dst + n + 4), _mm_unpackhi_epi16(lo, zero));
+            _mm_storeu_si128((__m128i *)(dst + n + 8), _mm_unpacklo_epi16(hi, zero));
+            _mm_storeu_si128((__m128i *)(dst + n + 12), _mm_unpackhi_epi16(hi, zero));
+#endif // SIZEOF_WCHAR_T
+        }
+    }
+#else // !wxHAS_SSE2_INTRINSICS
+    // Check a machine word at a time for the bytes with the high bit set.
+    const unsigned long highBits = ~0UL / 0xff * 0x80;
+    if ( !stopAtBackslash )
+    {
+        for ( ; n + sizeof(unsigned long) <= len; n += sizeof(unsigned long) )
+        {
+            unsigned long word;
+            memcpy(&word, src + n, sizeof(word));
+            if ( word & highBits )
+                break;
+
+            if ( dst )
+            {
+                for ( size_t i = 0; i < sizeof(unsigned long); i++ )
+                    dst[n + i] = (unsigned char)src[n + i];
+            }
+        }
+    }
+#endif // wxHAS_SSE2_INTRINSICS/!wxHAS_SSE2_INTRINSICS
+
+    // Deal with the remaining characters, including the one which made us
+    // stop above, one by one.
+    for ( ; n < len; n++ )
+    {
+        const unsigned char c = src[n];
+        if ( (c & 0x80) || (stopAtBackslash && c == '\\') )
+            break;
+
+        if ( dst )
+            dst[n] = c;
+    }
+
+    return n;
+}
+
+static size_t
+wxEncodeASCIIRun(char *dst, const wchar_t *src, size_t len,
+                 bool stopAtBackslash = false)
+{
+    size_t n = 0;
+
+#ifdef wxHAS_SSE2_INTRINSICS
+    // Process 16 characters at once, we're only interested in the case when
+    // all of them are ASCII, i.e. don't have any bits other than the lowest 7
+    // ones set.
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i backslash = _mm_set1_epi8('\\');
+#if SIZEOF_WCHAR_T == 2
+    const __m128i nonASCII = _mm_set1_epi16(~0x7f);
+    const size_t perVector = 8;
+#else // SIZEOF_WCHAR_T == 4
+    const __m128i nonASCII = _mm_set1_epi32(~0x7f);
+    const size_t perVector = 4;
+#endif // SIZEOF_WCHAR_T
+
+    for ( ; n + 16 <= len; n += 16 )
+    {
+        __m128i v[16 / perVector];
+        __m128i any = zero;
+        for ( size_t i = 0; i < WXSIZEOF(v); i++ )
+        {
+            v[i] = _mm_loadu_si128((const __m128i *)(src + n + i*perVector));
+            any = _mm_or_si128(any, v[i]);
+        }
+
+        if ( _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(any, nonASCII),
+                                              zero)) != 0xffff )
+            break;
+
+        // All values are less than 0x80, so saturating packs are exact.
+#if SIZEOF_WCHAR_T == 2
+        const __m128i bytes = _mm_packus_epi16(v[0], v[1]);
+#else // SIZEOF_WCHAR_T == 4
+        const __m128i bytes = _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]),
+                                               _mm_packs_epi32(v[2], v[3]));
+#endif // SIZEOF_WCHAR_T
+
+        if ( stopAtBackslash &&
+                _mm_movemask_epi8(_mm_cmpeq_epi8(bytes, backslash)) )
+            break;
+
+        if ( dst )
+            _mm_storeu_si128((__m128i *)(dst + n), bytes);
+    }
+#endif // wxHAS_SSE2_INTRINSICS
+
+    // Without SSE2 just use a simple loop which the compiler may vectorize.
+    for ( ; n < len; n++ )
+    {
+        const wchar_t wc = src[n];
+        if ( (wxUint32)wc > 0x7f || (stopAtBackslash && wc == L'\\') )
+            break;
+
+        if ( dst )
+            dst[n] = (char)wc;
+    }
+
+    return n;
+}
+
 // this table gives the length of the UTF-8 encoding from its first character:
 const unsigned char tableUtf8Lengths[256] = {
     // single-byte sequences (ASCII):
@@ -1007,6 +1163,26 @@ wxMBConvStrictUTF8::ToWChar(wchar_t *dst, size_t dstLen,
             return written;
         }
 
+        // Handle the run of ASCII characters starting here, if any, at once.
+        // Notice that srcLen can't be wxNO_LEN here as we computed it above.
+        size_t ascii = out && dstLen < srcLen ? dstLen : srcLen;
+        ascii = wxDecodeASCIIRun(out, p, ascii);
+        if ( ascii )
+        {
+            if ( out )
+            {
+                out += ascii;
+                dstLen -= ascii;
+            }
+
+            written += ascii;
+            srcLen -= ascii;
+
+            // the loop increment will skip over the last ASCII character
+            p += ascii - 1;
+            continue;
+        }
+
         if ( out && !dstLen-- )
             break;
 
@@ -1105,30 +1281,36 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
     char *out = dstLen ? dst : NULL;
     size_t written = 0;
 
+    // Converting the explicit length allows to process the ASCII characters
+    // in bulk below, the trailing NUL is then simply converted as any other
+    // character.
+    if ( srcLen == wxNO_LEN )
+        srcLen = wxWcslen(src) + 1;
+
     for ( const wchar_t *wp = src; ; wp++ )
     {
-        if ( (srcLen == wxNO_LEN ? !*wp : !srcLen) )
+        if ( !srcLen )
+            return written;
+
+        size_t ascii = out && dstLen < srcLen ? dstLen : srcLen;
+        ascii = wxEncodeASCIIRun(out, wp, ascii);
+        if ( ascii )
         {
-            // all done successfully, just add the trailing NULL if we are not
-            // using explicit length
-            if ( srcLen == wxNO_LEN )
+            if ( out )
             {
-                if ( out )
-                {
-                    if ( !dstLen )
-                        break;
-
-                    *out = '\0';
-                }
-
-                written++;
+                out += ascii;
+                dstLen -= ascii;
             }
 
-            return written;
+            written += ascii;
+            srcLen -= ascii;
+
+            // the loop increment will skip over the last ASCII character
+            wp += ascii - 1;
+            continue;
         }
 
-        if ( srcLen != wxNO_LEN )
-            srcLen--;
+        srcLen--;
 
         wxUint32 code;
 #ifdef WC_UTF16
@@ -1137,7 +1319,7 @@ wxMBConvStrictUTF8::FromWChar(char *dst, size_t dstLen,
         {
             // skip the next char too as we decoded a surrogate
             wp++;
-            if ( srcLen != wxNO_LEN )
+            if ( srcLen )
                 srcLen--;
         }
 #else // wchar_t is UTF-32
@@ -1227,8 +1409,27 @@ size_t wxMBConvUTF8::ToWChar(wchar_t *buf, size_t n,
     // The length can be either given explicitly or computed implicitly for the
     // NUL-terminated strings.
     const bool isNulTerminated = srcLen == wxNO_LEN;
-    while ((isNulTerminated ? *psz : srcLen--) && ((!buf) || (len < n)))
+    const char * const end = psz + (isNulTerminated ? strlen(psz) : srcLen);
+
+    // Backslashes need to be escaped in octal mode, so they can't be handled
+    // in the fast path.
+    const bool toOctal = (m_options & MAP_INVALID_UTF8_TO_OCTAL) != 0;
+
+    while ( psz < end && ((!buf) || (len < n)) )
     {
+        size_t ascii = end - psz;
+        if ( buf && n - len < ascii )
+            ascii = n - len;
+        ascii = wxDecodeASCIIRun(buf, psz, ascii, toOctal);
+        if ( ascii )
+        {
+            if ( buf )
+                buf += ascii;
+            psz += ascii;
+            len += ascii;
+            continue;
+        }
+
         const char *opsz = psz;
         bool invalid = false;
         unsigned char cc = *psz++, fc = cc;
@@ -1266,7 +1467,7 @@ size_t wxMBConvUTF8::ToWChar(wchar_t *buf, size_t n,
                 wxUint32 res = cc & (0x3f >> cnt);
                 while (cnt--)
                 {
-                    if (!isNulTerminated && !srcLen)
+                    if (psz == end)
                     {
                         // invalid UTF-8 sequence ending before the end of code
                         // point.
@@ -1283,8 +1484,6 @@ size_t wxMBConvUTF8::ToWChar(wchar_t *buf, size_t n,
                     }
 
                     psz++;
-                    if (!isNulTerminated)
-                        srcLen--;
                     res = (res << 6) | (cc & 0x3f);
                 }
 
@@ -1400,13 +1599,41 @@ size_t wxMBConvUTF8::FromWChar(char *buf, size_t n,
     // The length can be either given explicitly or computed implicitly for the
     // NUL-terminated strings.
     const bool isNulTerminated = srcLen == wxNO_LEN;
-    while ((isNulTerminated ? *psz : srcLen--) && ((!buf) || (len < n)))
+    const wchar_t * const end = psz + (isNulTerminated ? wxWcslen(psz) : srcLen);
+
+    // As in ToWChar(), backslashes must go through the slow path in octal mode.
+    const bool fromOctal = (m_options & MAP_INVALID_UTF8_TO_OCTAL) != 0;
+
+    while ( psz < end && ((!buf) || (len < n)) )
     {
+        size_t ascii = end - psz;
+        if ( buf && n - len < ascii )
+            ascii = n - len;
+        ascii = wxEncodeASCIIRun(buf, psz, ascii, fromOctal);
+        if ( ascii )
+        {
+            if ( buf )
+                buf += ascii;
+            psz += ascii;
+            len += ascii;
+            continue;
+        }
+
         wxUint32 cc;
 
 #ifdef WC_UTF16
-        // cast is ok for WC_UTF16
-        size_t pa = decode_utf16((const wxUint16 *)psz, cc);
+        // cast is ok for WC_UTF16, but don't let decode_utf16() look at the
+        // character after the end if the last one is a surrogate
+        size_t pa;
+        if ( end - psz == 1 && *psz >= 0xd800 && *psz <= 0xdfff )
+        {
+            cc = *psz;
+            pa = wxCONV_FAILED;
+        }
+        else
+        {
+            pa = decode_utf16((const wxUint16 *)psz, cc);
+        }
         psz += (pa == wxCONV_FAILED) ? 1 : pa;
 #else
         cc = (*psz++) & 0x7fffffff;
@@ -1420,7 +1647,7 @@ size_t wxMBConvUTF8::FromWChar(char *buf, size_t n,
             len++;
         }
         else if ( (m_options & MAP_INVALID_UTF8_TO_OCTAL)
-                    && cc == L'\\' && psz[0] == L'\\' )
+                    && cc == L'\\' && end - psz >= 1 && psz[0] == L'\\' )
         {
             if (buf)
                 *buf++ = (char)cc;
@@ -1428,7 +1655,7 @@ size_t wxMBConvUTF8::FromWChar(char *buf, size_t n,
             len++;
         }
         else if ( (m_options & MAP_INVALID_UTF8_TO_OCTAL) &&
-                    cc == L'\\' &&
+                    cc == L'\\' && end - psz >= 3 &&
                         isoctal(psz[0]) && isoctal(psz[1]) && isoctal(psz[2]) )
         {
             if (buf)
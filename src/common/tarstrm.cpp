@@ -25,9 +25,12 @@
 
 #include "wx/buffer.h"
 #include "wx/datetime.h"
+#include "wx/datstrm.h"
 #include "wx/scopedptr.h"
 #include "wx/filename.h"
 #include "wx/thread.h"
+#include "wx/wfstream.h"
+#include "wx/private/archive.h"
 
 #include <ctype.h>
 
@@ -1543,4 +1546,297 @@ size_t wxTarOutputStream::OnSysWrite(const void *buffer, size_t size)
     return lastwrite;
 }
 
+
+/////////////////////////////////////////////////////////////////////////////
+// wxTarArchive
+
+#if wxUSE_FILE
+
+WX_DECLARE_STRING_HASH_MAP(size_t, wxTarArchiveIndexBase);
+
+class wxTarArchiveIndex : public wxTarArchiveIndexBase
+{
+};
+
+namespace
+{
+
+// the index file starts with this signature followed by the format version
+const char TAR_INDEX_MAGIC[8] = { 'w', 'x', 'T', 'a', 'r', 'I', 'd', 'x' };
+const wxUint32 TAR_INDEX_VERSION = 1;
+
+void WriteIndexDate(wxDataOutputStream& out, const wxDateTime& dt)
+{
+    out.Write8(dt.IsValid());
+    if (dt.IsValid())
+        out.Write64(wxUint64(dt.GetValue().GetValue()));
+}
+
+wxDateTime ReadIndexDate(wxDataInputStream& in)
+{
+    if (!in.Read8())
+        return wxDateTime();
+
+    return wxDateTime(wxLongLong(wxInt64(in.Read64())));
+}
+
+} // anonymous namespace
+
+wxTarArchive::wxTarArchive(const wxString& filename,
+                           const wxString& indexFile,
+                           wxMBConv& conv)
+    : m_filename(filename),
+      m_conv(conv),
+      m_length(wxInvalidOffset),
+      m_index(new wxTarArchiveIndex),
+      m_ok(false)
+{
+    const wxFileName fn(filename);
+    if (!fn.FileExists()) {
+        wxLogError(_("Tar file \"%s\" doesn't exist."), filename);
+        return;
+    }
+
+    m_length = fn.GetSize().GetValue();
+    m_modTime = fn.GetModificationTime().GetValue();
+
+    if (!indexFile.empty() && wxFileName::FileExists(indexFile)) {
+        wxLogNull nolog;
+        m_ok = LoadIndex(indexFile);
+    }
+
+    if (!m_ok) {
+        m_ok = BuildIndex();
+
+        if (m_ok && !indexFile.empty())
+            SaveIndex(indexFile);
+    }
+}
+
+wxTarArchive::~wxTarArchive()
+{
+    Clear();
+
+    delete m_index;
+}
+
+void wxTarArchive::Clear()
+{
+    for (size_t n = 0; n < m_entries.size(); n++)
+        delete m_entries[n];
+
+    m_entries.clear();
+    m_index->clear();
+}
+
+bool wxTarArchive::BuildIndex()
+{
+    Clear();
+
+    // As the file stream is seekable, wxTarInputStream skips over the data of
+    // the entries instead of reading it, so only the headers are read here.
+    wxFileInputStream file(m_filename);
+    if (!file.IsOk())
+        return false;
+
+    wxTarInputStream tar(file, m_conv);
+
+    wxTarEntry *entry;
+    while ((entry = tar.GetNextEntry()) != NULL) {
+        // if there are several entries with the same name, the last one
+        // replaces the previous ones, as when extracting the archive
+        (*m_index)[entry->GetInternalName()] = m_entries.size();
+        m_entries.push_back(entry);
+    }
+
+    return tar.GetLastError() == wxSTREAM_EOF;
+}
+
+bool wxTarArchive::LoadIndex(const wxString& indexFile)
+{
+    Clear();
+
+    wxFileInputStream file(indexFile);
+    if (!file.IsOk())
+        return false;
+
+    wxBufferedInputStream buffered(file);
+    wxDataInputStream in(buffered);
+
+    char magic[sizeof(TAR_INDEX_MAGIC)];
+    if (buffered.Read(magic, sizeof(magic)).LastRead() != sizeof(magic) ||
+            memcmp(magic, TAR_INDEX_MAGIC, sizeof(magic)) != 0 ||
+            in.Read32() != TAR_INDEX_VERSION)
+        return false;
+
+    // the archive must not have changed since the index was created
+    if (wxFileOffset(in.Read64()) != m_length ||
+            wxLongLong(wxInt64(in.Read64())) != m_modTime)
+        return false;
+
+    const wxUint32 count = in.Read32();
+    if (!in.IsOk())
+        return false;
+
+    for (wxUint32 n = 0; n < count; n++) {
+        wxTarEntryPtr_ entry(new wxTarEntry);
+
+        entry->SetName(in.ReadString(), wxPATH_UNIX);
+        entry->SetTypeFlag(in.Read8());
+        entry->SetMode(in.Read32());
+        entry->SetUserId(in.Read32());
+        entry->SetGroupId(in.Read32());
+        entry->SetSize(wxFileOffset(in.Read64()));
+        entry->SetOffset(wxFileOffset(in.Read64()));
+        entry->SetDateTime(ReadIndexDate(in));
+        entry->SetAccessTime(ReadIndexDate(in));
+        entry->SetCreateTime(ReadIndexDate(in));
+        entry->SetLinkName(in.ReadString());
+        entry->SetUserName(in.ReadString());
+        entry->SetGroupName(in.ReadString());
+        entry->SetDevMajor(in.Read32());
+        entry->SetDevMinor(in.Read32());
+
+        if (!in.IsOk()) {
+            Clear();
+            return false;
+        }
+
+        (*m_index)[entry->GetInternalName()] = m_entries.size();
+        m_entries.push_back(entry.release());
+    }
+
+    return true;
+}
+
+bool wxTarArchive::SaveIndex(const wxString& indexFile) const
+{
+    if (!IsOk())
+        return false;
+
+    wxFileOutputStream file(indexFile);
+    if (!file.IsOk())
+        return false;
+
+    wxBufferedOutputStream buffered(file);
+    wxDataOutputStream out(buffered);
+
+    buffered.Write(TAR_INDEX_MAGIC, sizeof(TAR_INDEX_MAGIC));
+    out.Write32(TAR_INDEX_VERSION);
+    out.Write64(wxUint64(m_length));
+    out.Write64(wxUint64(m_modTime.GetValue()));
+    out.Write32(m_entries.size());
+
+    for (size_t n = 0; n < m_entries.size(); n++) {
+        const wxTarEntry& entry = *m_entries[n];
+
+        out.WriteString(entry.GetInternalName());
+        out.Write8(entry.GetTypeFlag());
+        out.Write32(entry.GetMode());
+        out.Write32(entry.GetUserId());
+        out.Write32(entry.GetGroupId());
+        out.Write64(wxUint64(entry.GetSize()));
+        out.Write64(wxUint64(entry.GetOffset()));
+        WriteIndexDate(out, entry.GetDateTime());
+        WriteIndexDate(out, entry.GetAccessTime());
+        WriteIndexDate(out, entry.GetCreateTime());
+        out.WriteString(entry.GetLinkName());
+        out.WriteString(entry.GetUserName());
+        out.WriteString(entry.GetGroupName());
+        out.Write32(entry.GetDevMajor());
+        out.Write32(entry.GetDevMinor());
+    }
+
+    return buffered.Close() && file.Close();
+}
+
+int wxTarArchive::Find(const wxString& name, wxPathFormat format) const
+{
+    wxTarArchiveIndex::const_iterator
+        it = m_index->find(wxTarEntry::GetInternalName(name, format));
+
+    return it == m_index->end() ? wxNOT_FOUND : static_cast<int>(it->second);
+}
+
+wxTarInputStream *wxTarArchive::OpenEntry(size_t n) const
+{
+    wxCHECK_MSG(n < m_entries.size(), NULL, wxT("invalid tar entry index"));
+
+    // each stream uses its own file, so that they can be used concurrently
+    wxFileInputStream *file = new wxFileInputStream(m_filename);
+    if (!file->IsOk()) {
+        delete file;
+        return NULL;
+    }
+
+    wxScopedPtr<wxTarInputStream> tar(new wxTarInputStream(file, m_conv));
+
+    // this seeks directly to the entry data
+    wxTarEntry entry(*m_entries[n]);
+    if (!tar->OpenEntry(entry))
+        return NULL;
+
+    return tar.release();
+}
+
+wxTarInputStream *wxTarArchive::OpenEntry(const wxString& name,
+                                          wxPathFormat format) const
+{
+    const int n = Find(name, format);
+    if (n == wxNOT_FOUND)
+        return NULL;
+
+    return OpenEntry(n);
+}
+
+bool wxTarArchive::Extract(size_t n, const wxString& path) const
+{
+    wxScopedPtr<wxInputStream> in(OpenEntry(n));
+    if (!in)
+        return false;
+
+    wxFileOutputStream out(path);
+    if (!out.IsOk())
+        return false;
+
+    in->Read(out);
+
+    return in->GetLastError() == wxSTREAM_EOF && out.Close();
+}
+
+bool wxTarArchive::ExtractAll(const wxString& dir, wxThreadPool *pool) const
+{
+    if (!IsOk())
+        return false;
+
+    wxArchiveExtractorFor<wxTarArchive> extractor(*this, dir);
+
+    for (size_t n = 0; n < m_entries.size(); n++) {
+        const wxTarEntry& entry = *m_entries[n];
+
+        // only regular files are extracted, and only the last entry if there
+        // are several ones with the same name
+        if (!entry.IsDir()) {
+            switch (entry.GetTypeFlag()) {
+                case wxTAR_REGTYPE:
+                case wxTAR_CONTTYPE:
+                case 0:                 // regular file in the old tar format
+                    break;
+
+                default:
+                    continue;
+            }
+
+            if (Find(entry.GetInternalName(), wxPATH_UNIX) != int(n))
+                continue;
+        }
+
+        extractor.AddEntry(n, entry);
+    }
+
+    return extractor.Run(pool);
+}
+
+#endif // wxUSE_FILE
+
 #endif // wxUSE_TARSTREAM
@@ -0,0 +1,471 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        src/common/threadpool.cpp
+// Purpose:     wxThreadPool implementation
+// Author:      wxWidgets team
+// Created:     2016-03-14
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ============================================================================
+// declarations
+// ============================================================================
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+// For compilers that support precompilation, includes "wx.h".
+#include "wx/wxprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#if wxUSE_THREADS
+
+#include "wx/threadpool.h"
+
+#ifndef WX_PRECOMP
+    #include "wx/event.h"
+    #include "wx/module.h"
+#endif // WX_PRECOMP
+
+namespace
+{
+
+// Possible values of wxThreadPoolTask::m_state.
+enum
+{
+    State_Pending,  // not started yet
+    State_Running,  // being executed
+    State_Done      // already executed
+};
+
+// Simple double-ended queue of tasks, implemented as a ring buffer.
+class TaskDeque
+{
+public:
+    TaskDeque() : m_head(0), m_count(0) { }
+
+    bool IsEmpty() const { return m_count == 0; }
+
+    void PushBack(wxThreadPoolTask* task)
+    {
+        if ( m_count == m_tasks.size() )
+            Grow();
+
+        m_tasks[(m_head + m_count) % m_tasks.size()] = task;
+        m_count++;
+    }
+
+    wxThreadPoolTask* PopBack()
+    {
+        if ( !m_count )
+            return NULL;
+
+        m_count--;
+        return m_tasks[(m_head + m_count) % m_tasks.size()];
+    }
+
+    wxThreadPoolTask* PopFront()
+    {
+        if ( !m_count )
+            return NULL;
+
+        wxThreadPoolTask* const task = m_tasks[m_head];
+        m_head = (m_head + 1) % m_tasks.size();
+        m_count--;
+        return task;
+    }
+
+private:
+    void Grow()
+    {
+        wxVector<wxThreadPoolTask*> tasks(wxMax(2*m_tasks.size(), 16));
+        for ( size_t n = 0; n < m_count; n++ )
+            tasks[n] = m_tasks[(m_head + n) % m_tasks.size()];
+
+        m_tasks.swap(tasks);
+        m_head = 0;
+    }
+
+    wxVector<wxThreadPoolTask*> m_tasks;
+    size_t m_head,
+           m_count;
+};
+
+// The task processing a single chunk of wxThreadPool::ParallelFor() range.
+class ParallelForTask : public wxThreadPoolTask
+{
+public:
+    ParallelForTask(wxParallelForBody& body, int first, int last)
+        : m_body(body),
+          m_first(first),
+          m_last(last)
+    {
+    }
+
+protected:
+    virtual void Execute() wxOVERRIDE
+    {
+        m_body.Process(m_first, m_last);
+    }
+
+private:
+    wxParallelForBody& m_body;
+    const int m_first,
+              m_last;
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// wxThreadPool::Worker: a thread of the pool
+// ----------------------------------------------------------------------------
+
+class wxThreadPool::Worker : public wxThread
+{
+public:
+    Worker(wxThreadPool& pool, int index)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_pool(pool),
+          m_index(index)
+    {
+    }
+
+    int GetIndex() const { return m_index; }
+
+    // The tasks queued for execution by this worker, only accessed while
+    // holding m_cs.
+    wxCriticalSection m_cs;
+    TaskDeque m_tasks;
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        m_pool.WorkerMain(this);
+
+        return 0;
+    }
+
+private:
+    wxThreadPool& m_pool;
+    const int m_index;
+
+    wxDECLARE_NO_COPY_CLASS(Worker);
+};
+
+// ----------------------------------------------------------------------------
+// wxThreadPoolModule: destroys the global pool on shutdown
+// ----------------------------------------------------------------------------
+
+class wxThreadPoolModule : public wxModule
+{
+public:
+    wxThreadPoolModule() { }
+
+    virtual bool OnInit() wxOVERRIDE { return true; }
+    virtual void OnExit() wxOVERRIDE
+    {
+        wxDELETE(wxThreadPool::ms_global);
+    }
+
+private:
+    wxDECLARE_DYNAMIC_CLASS(wxThreadPoolModule);
+};
+
+wxIMPLEMENT_DYNAMIC_CLASS(wxThreadPoolModule, wxModule);
+
+// ============================================================================
+// wxThreadPoolTask implementation
+// ============================================================================
+
+wxThreadPoolTask::wxThreadPoolTask()
+    : m_refCount(1),
+      m_state(State_Pending),
+      m_condDone(m_mutex),
+      m_handler(NULL),
+      m_id(wxID_ANY)
+{
+}
+
+wxThreadPoolTask::~wxThreadPoolTask()
+{
+}
+
+void wxThreadPoolTask::IncRef()
+{
+    wxAtomicInc(m_refCount);
+}
+
+void wxThreadPoolTask::DecRef()
+{
+    if ( !wxAtomicDec(m_refCount) )
+        delete this;
+}
+
+void wxThreadPoolTask::SetNotifyHandler(wxEvtHandler* handler, int id)
+{
+    m_handler = handler;
+    m_id = id;
+}
+
+bool wxThreadPoolTask::IsDone() const
+{
+    return wxAtomicLoad(m_state) == State_Done;
+}
+
+bool wxThreadPoolTask::Run()
+{
+    if ( !wxAtomicCompareAndSwap(m_state, State_Pending, State_Running) )
+        return false;
+
+    Execute();
+
+    {
+        wxMutexLocker lock(m_mutex);
+        wxAtomicStore(m_state, State_Done);
+        m_condDone.Broadcast();
+    }
+
+    if ( m_handler )
+        m_handler->QueueEvent(new wxThreadEvent(wxEVT_THREAD, m_id));
+
+    return true;
+}
+
+void wxThreadPoolTask::Wait()
+{
+    // If nobody has started executing this task yet, it's more efficient to
+    // do it right now than to wait until a pool thread takes it. This also
+    // ensures that waiting for a task from inside another one can't deadlock.
+    if ( Run() )
+        return;
+
+    wxMutexLocker lock(m_mutex);
+    while ( wxAtomicLoad(m_state) != State_Done )
+        m_condDone.Wait();
+}
+
+// ============================================================================
+// wxThreadPool implementation
+// ============================================================================
+
+wxThreadPool* wxThreadPool::ms_global = NULL;
+
+wxThreadPool::wxThreadPool(int numThreads)
+    : m_nextWorker(0),
+      m_pending(0),
+      m_condIdle(m_mutexIdle),
+      m_stop(false)
+{
+    if ( numThreads <= 0 )
+        numThreads = wxMax(wxThread::GetCPUCount(), 1);
+
+    // Create all threads before starting any of them as the workers iterate
+    // over m_workers when looking for tasks to steal.
+    m_workers.reserve(numThreads);
+    for ( int n = 0; n < numThreads; n++ )
+    {
+        Worker* const worker = new Worker(*this, n);
+        if ( worker->Create() != wxTHREAD_NO_ERROR )
+        {
+            delete worker;
+            break;
+        }
+
+        m_workers.push_back(worker);
+    }
+
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+    {
+        if ( m_workers[n]->Run() != wxTHREAD_NO_ERROR )
+        {
+            wxFAIL_MSG( "Failed to start thread pool worker" );
+        }
+    }
+}
+
+wxThreadPool::~wxThreadPool()
+{
+    {
+        wxMutexLocker lock(m_mutexIdle);
+        m_stop = true;
+        m_condIdle.Broadcast();
+    }
+
+    for ( size_t n = 0; n < m_workers.size(); n++ )
+    {
+        m_workers[n]->Wait();
+        delete m_workers[n];
+    }
+}
+
+/* static */
+wxThreadPool& wxThreadPool::Get()
+{
+    static wxCriticalSection s_csGlobal;
+
+    wxCriticalSectionLocker lock(s_csGlobal);
+    if ( !ms_global )
+        ms_global = new wxThreadPool;
+
+    return *ms_global;
+}
+
+wxThreadPool::Worker* wxThreadPool::GetCurrentWorker() const
+{
+    wxThread* const self = wxThread::This();
+    if ( self )
+    {
+        for ( size_t n = 0; n < m_workers.size(); n++ )
+        {
+            if ( m_workers[n] == self )
+                return m_workers[n];
+        }
+    }
+
+    return NULL;
+}
+
+bool wxThreadPool::Submit(wxThreadPoolTask* task)
+{
+    wxCHECK_MSG( task, false, "can't submit NULL task" );
+    wxCHECK_MSG( IsOk(), false, "thread pool has no threads" );
+
+    // Tasks submitted from inside a task are most likely related to it, so
+    // keep them in the same thread, other workers will steal them if idle.
+    Worker* worker = GetCurrentWorker();
+    if ( !worker )
+    {
+        const int count = m_workers.size();
+
+        wxInt32 index;
+        do
+        {
+            index = wxAtomicLoad(m_nextWorker);
+        } while ( !wxAtomicCompareAndSwap(m_nextWorker,
+                                          index, (index + 1) % count) );
+
+        worker = m_workers[index];
+    }
+
+    task->IncRef();
+
+    {
+        wxCriticalSectionLocker lock(worker->m_cs);
+        worker->m_tasks.PushBack(task);
+    }
+
+    wxAtomicInc(m_pending);
+
+    wxMutexLocker lock(m_mutexIdle);
+    m_condIdle.Signal();
+
+    return true;
+}
+
+wxThreadPoolTask* wxThreadPool::GetTaskFor(Worker* worker)
+{
+    wxThreadPoolTask* task;
+
+    // Take the most recently added task from our own queue first as it's the
+    // most likely to use the data still in this CPU cache.
+    {
+        wxCriticalSectionLocker lock(worker->m_cs);
+        task = worker->m_tasks.PopBack();
+    }
+
+    // Otherwise steal the oldest task from another worker.
+    const int count = m_workers.size();
+    for ( int n = 1; !task && n < count; n++ )
+    {
+        Worker* const victim = m_workers[(worker->GetIndex() + n) % count];
+
+        wxCriticalSectionLocker lock(victim->m_cs);
+        task = victim->m_tasks.PopFront();
+    }
+
+    if ( task )
+        wxAtomicDec(m_pending);
+
+    return task;
+}
+
+void wxThreadPool::WorkerMain(Worker* worker)
+{
+    for ( ;; )
+    {
+        wxThreadPoolTask* const task = GetTaskFor(worker);
+        if ( task )
+        {
+            // The task could have been already executed by Wait().
+            task->Run();
+            task->DecRef();
+            continue;
+        }
+
+        // Notice that we must check for the pending tasks while holding the
+        // lock, as Submit() signals the condition only after incrementing it.
+        wxMutexLocker lock(m_mutexIdle);
+        if ( wxAtomicLoad(m_pending) > 0 )
+            continue;
+
+        // Only exit when there are no more tasks to execute.
+        if ( m_stop )
+            break;
+
+        m_condIdle.Wait();
+    }
+}
+
+void wxThreadPool::ParallelFor(int first, int last,
+                               wxParallelForBody& body,
+                               int numChunks)
+{
+    const int count = last - first;
+    if ( count <= 0 )
+        return;
+
+    if ( numChunks <= 0 )
+        numChunks = GetThreadCount();
+
+    numChunks = wxMin(numChunks, count);
+    if ( numChunks <= 1 || !IsOk() )
+    {
+        body.Process(first, last);
+        return;
+    }
+
+    // Distribute the remainder over the first chunks.
+    const int chunkSize = count / numChunks,
+              remainder = count % numChunks;
+
+    wxVector<ParallelForTask*> tasks;
+    tasks.reserve(numChunks - 1);
+
+    // Leave the first chunk for this thread and submit all the other ones.
+    const int firstChunkEnd = first + chunkSize + (remainder ? 1 : 0);
+    for ( int n = 1; n < numChunks; n++ )
+    {
+        const int start = first + n*chunkSize + wxMin(n, remainder),
+                  end = start + chunkSize + (n < remainder ? 1 : 0);
+
+        ParallelForTask* const task = new ParallelForTask(body, start, end);
+        Submit(task);
+        tasks.push_back(task);
+    }
+
+    body.Process(first, firstChunkEnd);
+
+    // This executes the tasks which haven't been taken by any worker yet
+    // directly in this thread.
+    for ( size_t n = 0; n < tasks.size(); n++ )
+    {
+        tasks[n]->Wait();
+        tasks[n]->DecRef();
+    }
+}
+
+#endif // wxUSE_THREADS
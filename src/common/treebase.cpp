@@ -290,6 +290,25 @@ wxSize wxTreeCtrlBase::DoGetBestSize() const
     return size;
 }
 
+void wxTreeCtrlBase::DoInsertItems(const wxTreeItemId& parent,
+                                   size_t pos,
+                                   const wxArrayString& texts,
+                                   int image, int selImage,
+                                   wxArrayTreeItemIds *ids)
+{
+    const size_t count = texts.size();
+    for ( size_t n = 0; n < count; n++ )
+    {
+        const wxTreeItemId id = DoInsertItem(parent, pos, texts[n],
+                                             image, selImage, NULL);
+        if ( ids )
+            ids->Add(id);
+
+        if ( pos != (size_t)-1 )
+            pos++;
+    }
+}
+
 void wxTreeCtrlBase::ExpandAll()
 {
     if ( IsEmpty() )
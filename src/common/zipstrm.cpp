@@ -27,8 +27,10 @@
 #include "wx/datstrm.h"
 #include "wx/zstream.h"
 #include "wx/mstream.h"
+#include "wx/mappedfile.h"
 #include "wx/scopedptr.h"
 #include "wx/wfstream.h"
+#include "wx/private/archive.h"
 #include "zlib.h"
 
 // value for the 'version needed to extract' field (20 means 2.0)
@@ -1720,7 +1722,14 @@ bool wxZipInputStream::OpenDecompressor(bool raw /*=false*/)
             m_decomp = m_rawin->Open(OpenDecompressor(m_rawin->GetTee()));
         }
     } else {
-        if (compressedSize != wxInvalidOffset &&
+        // The inflate stream can decompress the data directly from the
+        // memory of wxMemoryInputStream (and so wxMappedInputStream) without
+        // reading past its end, so don't copy it through m_store then.
+        const bool inflateInPlace =
+                m_entry.GetMethod() == wxZIP_METHOD_DEFLATE &&
+                wxDynamicCast(m_parent_i_stream, wxMemoryInputStream);
+
+        if (compressedSize != wxInvalidOffset && !inflateInPlace &&
                 (m_entry.GetMethod() != wxZIP_METHOD_DEFLATE ||
                  wxZlibInputStream::CanHandleGZip())) {
             m_store->Open(compressedSize);
@@ -2330,4 +2339,226 @@ size_t wxZipOutputStream::OnSysWrite(const void *buffer, size_t size)
     return m_comp->LastWrite();
 }
 
+
+
+/////////////////////////////////////////////////////////////////////////////
+// wxZipArchive entry stream
+//
+// Reads the data of a single entry directly from the archive memory, using
+// the in place decompression done by wxZlibInputStream for memory streams,
+// and checks its length and crc at the end.
+
+class wxZipArchiveEntryStream : public wxInputStream
+{
+public:
+    wxZipArchiveEntryStream(const char *data, size_t length, bool deflated,
+                            wxFileOffset size, wxUint32 crc)
+        : m_raw(data, length),
+          m_inflate(deflated ? new wxZlibInputStream(m_raw, wxZLIB_NO_HEADER)
+                             : NULL),
+          m_size(size),
+          m_pos(0),
+          m_crc(crc),
+          m_crcAccumulator(crc32(0, Z_NULL, 0))
+    {
+    }
+
+    virtual ~wxZipArchiveEntryStream() { delete m_inflate; }
+
+    virtual wxFileOffset GetLength() const wxOVERRIDE { return m_size; }
+
+protected:
+    virtual size_t OnSysRead(void *buffer, size_t size) wxOVERRIDE;
+    virtual wxFileOffset OnSysTell() const wxOVERRIDE { return m_pos; }
+
+private:
+    wxMemoryInputStream m_raw;
+    wxZlibInputStream *m_inflate;
+    const wxFileOffset m_size;
+    wxFileOffset m_pos;
+    const wxUint32 m_crc;
+    wxUint32 m_crcAccumulator;
+
+    wxDECLARE_NO_COPY_CLASS(wxZipArchiveEntryStream);
+};
+
+size_t wxZipArchiveEntryStream::OnSysRead(void *buffer, size_t size)
+{
+    wxInputStream& in = m_inflate ? static_cast<wxInputStream&>(*m_inflate)
+                                  : m_raw;
+
+    size_t count = in.Read(buffer, size).LastRead();
+    m_crcAccumulator = crc32(m_crcAccumulator, (Byte*)buffer, count);
+    m_pos += count;
+
+    if (count < size) {
+        m_lasterror = wxSTREAM_READ_ERROR;
+
+        // other errors have been already reported by the decompressor
+        if (in.GetLastError() == wxSTREAM_EOF) {
+            if (m_pos != m_size)
+                wxLogError(_("reading zip stream: bad length"));
+            else if (m_crcAccumulator != m_crc)
+                wxLogError(_("reading zip stream: bad crc"));
+            else
+                m_lasterror = wxSTREAM_EOF;
+        }
+    }
+
+    return count;
+}
+
+
+/////////////////////////////////////////////////////////////////////////////
+// wxZipArchive
+
+WX_DECLARE_STRING_HASH_MAP(size_t, wxZipArchiveIndexBase);
+
+class wxZipArchiveIndex : public wxZipArchiveIndexBase
+{
+};
+
+#if wxUSE_FILE
+
+wxZipArchive::wxZipArchive(const wxString& filename, wxMBConv& conv)
+{
+    m_file = new wxMappedFile(filename);
+    m_data = static_cast<const char *>(m_file->GetData());
+    m_length = m_file->GetLength();
+
+    Init(conv);
+}
+
+#endif // wxUSE_FILE
+
+wxZipArchive::wxZipArchive(const void *data, size_t length, wxMBConv& conv)
+{
+    m_file = NULL;
+    m_data = static_cast<const char *>(data);
+    m_length = length;
+
+    Init(conv);
+}
+
+void wxZipArchive::Init(wxMBConv& conv)
+{
+    m_index = new wxZipArchiveIndex;
+    m_ok = false;
+
+#if wxUSE_FILE
+    if (m_file && !m_file->IsOpened())
+        return;
+#endif // wxUSE_FILE
+
+    // As the stream is seekable, wxZipInputStream only reads the central
+    // directory here and not the local headers.
+    wxMemoryInputStream in(m_data, m_length);
+    wxZipInputStream zip(in, conv);
+
+    m_entries.reserve(zip.GetTotalEntries());
+    m_info.reserve(zip.GetTotalEntries());
+
+    wxZipEntry *entry;
+    while ((entry = zip.GetNextEntry()) != NULL) {
+        EntryInfo info;
+        info.offset = entry->GetOffset();
+        info.compressedSize = entry->GetCompressedSize();
+        info.size = entry->GetSize();
+        info.crc = entry->GetCrc();
+        info.method = entry->GetMethod();
+
+        // keep the first entry if there are several ones with the same name
+        m_index->insert(wxZipArchiveIndex::value_type(entry->GetInternalName(),
+                                                      m_entries.size()));
+
+        m_entries.push_back(entry);
+        m_info.push_back(info);
+    }
+
+    m_ok = zip.GetLastError() == wxSTREAM_EOF;
+}
+
+wxZipArchive::~wxZipArchive()
+{
+    for (size_t n = 0; n < m_entries.size(); n++)
+        delete m_entries[n];
+
+    delete m_index;
+    delete m_file;
+}
+
+int wxZipArchive::Find(const wxString& name, wxPathFormat format) const
+{
+    wxZipArchiveIndex::const_iterator
+        it = m_index->find(wxZipEntry::GetInternalName(name, format));
+
+    return it == m_index->end() ? wxNOT_FOUND : static_cast<int>(it->second);
+}
+
+wxInputStream *wxZipArchive::OpenEntry(size_t n) const
+{
+    wxCHECK_MSG(n < m_info.size(), NULL, wxT("invalid zip entry index"));
+
+    const EntryInfo& info = m_info[n];
+
+    if (info.method != wxZIP_METHOD_STORE &&
+            info.method != wxZIP_METHOD_DEFLATE) {
+        wxLogError(_("unsupported Zip compression method"));
+        return NULL;
+    }
+
+    // skip the local header, which may have a different extra field length
+    // from the central directory one
+    const wxFileOffset offset = info.offset;
+    if (offset < 0 || offset + LOCAL_SIZE > wxFileOffset(m_length) ||
+            CrackUint32(m_data + offset) != LOCAL_MAGIC) {
+        wxLogError(_("bad zipfile offset to entry"));
+        return NULL;
+    }
+
+    const wxFileOffset start = offset + LOCAL_SIZE +
+                               CrackUint16(m_data + offset + 26) +
+                               CrackUint16(m_data + offset + 28);
+
+    if (info.compressedSize < 0 ||
+            start + info.compressedSize > wxFileOffset(m_length)) {
+        wxLogError(_("error reading zip local header"));
+        return NULL;
+    }
+
+    return new wxZipArchiveEntryStream(m_data + start,
+                                       size_t(info.compressedSize),
+                                       info.method == wxZIP_METHOD_DEFLATE,
+                                       info.size,
+                                       info.crc);
+}
+
+bool wxZipArchive::Extract(size_t n, const wxString& path) const
+{
+    wxScopedPtr<wxInputStream> in(OpenEntry(n));
+    if (!in)
+        return false;
+
+    wxFileOutputStream out(path);
+    if (!out.IsOk())
+        return false;
+
+    in->Read(out);
+
+    return in->GetLastError() == wxSTREAM_EOF && out.Close();
+}
+
+bool wxZipArchive::ExtractAll(const wxString& dir, wxThreadPool *pool) const
+{
+    if (!IsOk())
+        return false;
+
+    wxArchiveExtractorFor<wxZipArchive> extractor(*this, dir);
+
+    for (size_t n = 0; n < m_entries.size(); n++)
+        extractor.AddEntry(n, *m_entries[n]);
+
+    return extractor.Run(pool);
+}
+
 #endif // wxUSE_ZIPSTREAM
@@ -18,6 +18,7 @@
 #if wxUSE_ZLIB && wxUSE_STREAMS
 
 #include "wx/zstream.h"
+#include "wx/mstream.h"
 #include "wx/versioninfo.h"
 
 #ifndef WX_PRECOMP
@@ -203,17 +204,43 @@ size_t wxZlibInputStream::OnSysRead(void *buffer, size_t size)
   if (!IsOk() || !size)
     return 0;
 
+  // If the parent stream data is directly accessible, e.g. because it is a
+  // wxMappedInputStream, inflate it in place instead of copying it into our
+  // buffer first. The parent stream position is advanced only by the amount
+  // of data really consumed then, so nothing needs to be put back into it.
+  wxMemoryInputStream * const
+    memory = wxDynamicCast(m_parent_i_stream, wxMemoryInputStream);
+
   int err = Z_OK;
   m_inflate->next_out = (unsigned char *)buffer;
   m_inflate->avail_out = size;
 
+  bool inPlace = memory && m_inflate->avail_in &&
+                 (m_inflate->next_in < m_z_buffer ||
+                  m_inflate->next_in >= m_z_buffer + m_z_size);
+
   while (err == Z_OK && m_inflate->avail_out > 0) {
     if (m_inflate->avail_in == 0 && m_parent_i_stream->IsOk()) {
-      m_parent_i_stream->Read(m_z_buffer, m_z_size);
-      m_inflate->next_in = m_z_buffer;
-      m_inflate->avail_in = m_parent_i_stream->LastRead();
+      size_t len = 0;
+      const void * const
+        data = memory ? memory->GetCurrentData(&len) : NULL;
+
+      inPlace = data && len;
+      if (inPlace) {
+        m_inflate->next_in = (Bytef *)data;
+        m_inflate->avail_in = wx_truncate_cast(uInt, wxMin(len, size_t(INT_MAX)));
+      } else {
+        m_parent_i_stream->Read(m_z_buffer, m_z_size);
+        m_inflate->next_in = m_z_buffer;
+        m_inflate->avail_in = m_parent_i_stream->LastRead();
+      }
     }
+
+    const uInt availIn = m_inflate->avail_in;
     err = inflate(m_inflate, Z_SYNC_FLUSH);
+
+    if (inPlace)
+      memory->SeekI(availIn - m_inflate->avail_in, wxFromCurrent);
   }
 
   switch (err) {
@@ -225,7 +252,9 @@ size_t wxZlibInputStream::OnSysRead(void *buffer, size_t size)
         // Unread any data taken from past the end of the deflate stream, so that
         // any additional data can be read from the underlying stream (the crc
         // in a gzip for example)
-        if (m_inflate->avail_in) {
+        if (inPlace) {
+          m_inflate->avail_in = 0;
+        } else if (m_inflate->avail_in) {
           m_parent_i_stream->Reset();
           m_parent_i_stream->Ungetch(m_inflate->next_in, m_inflate->avail_in);
           m_inflate->avail_in = 0;
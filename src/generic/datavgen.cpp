@@ -49,6 +49,8 @@
 #include "wx/selstore.h"
 #include "wx/stopwatch.h"
 #include "wx/weakref.h"
+#include "wx/hashmap.h"
+#include "wx/vector.h"
 
 //-----------------------------------------------------------------------------
 // classes
@@ -408,6 +410,8 @@ public:
 
 class wxDataViewTreeNode;
 WX_DEFINE_ARRAY( wxDataViewTreeNode *, wxDataViewTreeNodes );
+WX_DECLARE_VOIDPTR_HASH_MAP( wxDataViewTreeNode *, wxDataViewTreeNodeMap );
+WX_DECLARE_VOIDPTR_HASH_MAP( int, wxDataViewRowHeightsMap );
 
 int LINKAGEMODE wxGenericTreeModelNodeCmp( wxDataViewTreeNode ** node1,
                                            wxDataViewTreeNode ** node2);
@@ -418,6 +422,7 @@ public:
     wxDataViewTreeNode(wxDataViewTreeNode *parent, const wxDataViewItem& item)
         : m_parent(parent),
           m_item(item),
+          m_indexInParent(0),
           m_branchData(NULL)
     {
     }
@@ -454,22 +459,55 @@ public:
         return m_branchData->children;
     }
 
+    // Insert the child at the given position if the children are not sorted
+    // or at the position determined by the current sort order otherwise.
     void InsertChild(wxDataViewTreeNode *node, unsigned index)
     {
         if ( !m_branchData )
             m_branchData = new BranchNodeData;
 
-        m_branchData->children.Insert(node, index);
+        wxDataViewTreeNodes& nodes = m_branchData->children;
 
-        // TODO: insert into sorted array directly in O(log n) instead of resorting in O(n log n)
         if (g_column >= -1)
-            m_branchData->children.Sort( &wxGenericTreeModelNodeCmp );
+        {
+            // Insert after all the nodes not greater than this one.
+            unsigned lo = 0,
+                     hi = nodes.size();
+            while ( lo < hi )
+            {
+                const unsigned mid = lo + (hi - lo)/2;
+                if ( wxGenericTreeModelNodeCmp(&node, &nodes[mid]) < 0 )
+                    hi = mid;
+                else
+                    lo = mid + 1;
+            }
+
+            index = lo;
+        }
+
+        nodes.Insert(node, index);
+
+        InvalidateRows();
+    }
+
+    // Append the child without sorting, Resort() must be called after adding
+    // all of them.
+    void AppendChild(wxDataViewTreeNode *node)
+    {
+        if ( !m_branchData )
+            m_branchData = new BranchNodeData;
+
+        m_branchData->children.Add(node);
+
+        InvalidateRows();
     }
 
     void RemoveChild(wxDataViewTreeNode *node)
     {
         wxCHECK_RET( m_branchData != NULL, "leaf node doesn't have children" );
         m_branchData->children.Remove(node);
+
+        InvalidateRows();
     }
 
     // returns position of child node for given item in children list or wxNOT_FOUND
@@ -576,7 +614,53 @@ public:
         wxASSERT( m_branchData->subTreeCount >= 0 );
 
         if( m_parent )
+        {
+            m_parent->ChangeChildRows(this, num);
             m_parent->ChangeSubTreeCount(num);
+        }
+    }
+
+    // Returns the number of rows taken by the children preceding the given
+    // one, which must be a child of this node.
+    int GetRowsBefore(const wxDataViewTreeNode *child) const
+    {
+        UpdateRows();
+
+        const wxVector<int>& rows = m_branchData->rows;
+
+        int sum = 0;
+        for ( int i = child->m_indexInParent; i > 0; i -= i & -i )
+            sum += rows[i - 1];
+
+        return sum;
+    }
+
+    // Finds the child containing the given row, counted from the first row
+    // after this node, and adjusts the row to be relative to this child, i.e.
+    // sets it to 0 if it's the row of the child itself. Returns wxNOT_FOUND
+    // if there are not enough rows.
+    int FindChildByRow(int& row) const
+    {
+        UpdateRows();
+
+        const wxVector<int>& rows = m_branchData->rows;
+        const int count = rows.size();
+
+        int step = 1;
+        while ( step <= count / 2 )
+            step *= 2;
+
+        int pos = 0;
+        for ( ; step; step /= 2 )
+        {
+            if ( pos + step <= count && rows[pos + step - 1] <= row )
+            {
+                pos += step;
+                row -= rows[pos - 1];
+            }
+        }
+
+        return pos < count ? pos : wxNOT_FOUND;
     }
 
     void Resort()
@@ -589,6 +673,7 @@ public:
             wxDataViewTreeNodes& nodes = m_branchData->children;
 
             nodes.Sort( &wxGenericTreeModelNodeCmp );
+            InvalidateRows();
             int len = nodes.GetCount();
             for (int i = 0; i < len; i ++)
             {
@@ -600,11 +685,60 @@ public:
 
 
 private:
+    // Forget the number of rows taken by the children, this must be called
+    // whenever they change.
+    void InvalidateRows()
+    {
+        m_branchData->rows.clear();
+    }
+
+    // Recompute the number of rows taken by the children if necessary.
+    void UpdateRows() const
+    {
+        wxASSERT( m_branchData != NULL );
+
+        wxVector<int>& rows = m_branchData->rows;
+        const wxDataViewTreeNodes& nodes = m_branchData->children;
+        const int count = nodes.size();
+        if ( static_cast<int>(rows.size()) == count )
+            return;
+
+        rows.resize(count);
+        for ( int i = 0; i < count; i++ )
+        {
+            nodes[i]->m_indexInParent = i;
+            rows[i] = 1 + nodes[i]->GetSubTreeCount();
+        }
+
+        for ( int i = 1; i <= count; i++ )
+        {
+            const int next = i + (i & -i);
+            if ( next <= count )
+                rows[next - 1] += rows[i - 1];
+        }
+    }
+
+    // Update the number of rows taken by the given child.
+    void ChangeChildRows(const wxDataViewTreeNode *child, int num)
+    {
+        wxVector<int>& rows = m_branchData->rows;
+        const int count = rows.size();
+        if ( count != static_cast<int>(m_branchData->children.size()) )
+            return; // Will be recomputed when needed anyhow.
+
+        for ( int i = child->m_indexInParent + 1; i <= count; i += i & -i )
+            rows[i - 1] += num;
+    }
+
     wxDataViewTreeNode  *m_parent;
 
     // Corresponding model item.
     wxDataViewItem       m_item;
 
+    // Position of this node among its parent children, only valid if the
+    // parent rows are up to date.
+    mutable int          m_indexInParent;
+
     // Data specific to non-leaf (branch, inner) nodes. They are kept in a
     // separate struct in order to conserve memory.
     struct BranchNodeData
@@ -627,6 +761,14 @@ private:
         // 0 for leaves and is the number of rows the subtree occupies for
         // branch nodes.
         int                  subTreeCount;
+
+        // Number of rows, including their own, taken by the children stored
+        // as a Fenwick tree, i.e. rows[i - 1] is the number of rows taken by
+        // the children in [i - (i & -i), i) range. This allows finding the
+        // child by row and the row of a child in logarithmic time. It is
+        // empty, or generally of different size than children, if it needs to
+        // be recomputed.
+        wxVector<int>        rows;
     };
 
     BranchNodeData *m_branchData;
@@ -670,7 +812,18 @@ public:
         if (!IsVirtualList())
         {
             SortPrepare();
+
+            // The rows order changes when sorting, so remember the heights of
+            // the nodes to put them in the new order afterwards instead of
+            // measuring all the rows again.
+            wxDataViewRowHeightsMap heights;
+            if ( g_column >= SortColumn_Default )
+                SaveRowHeights(heights);
+
             m_root->Resort();
+
+            if ( !heights.empty() )
+                RestoreRowHeights(heights);
         }
         UpdateDisplay();
     }
@@ -799,8 +952,20 @@ public:
     int GetLineHeight( unsigned int row ) const; // m_lineHeight in fixed mode
     int GetLineAt( unsigned int y ) const;       // y / m_lineHeight in fixed mode
 
-    void SetRowHeight( int lineHeight ) { m_lineHeight = lineHeight; }
+    void SetRowHeight( int lineHeight )
+    {
+        m_lineHeight = lineHeight;
+        InvalidateRowHeights();
+    }
     int GetRowHeight() const { return m_lineHeight; }
+
+    // Forget the cached heights of all rows in wxDV_VARIABLE_LINE_HEIGHT mode,
+    // they will be measured again when needed.
+    void InvalidateRowHeights()
+    {
+        m_rowHeights.clear();
+        m_rowHeightsSums.clear();
+    }
     int GetDefaultRowHeight() const;
 
     // Some useful functions for row and item mapping
@@ -853,11 +1018,31 @@ private:
 
     int RecalculateCount() const;
 
+    // Functions used for maintaining the cache of the row heights in
+    // wxDV_VARIABLE_LINE_HEIGHT mode: compute the height of the given row by
+    // asking all the renderers for it, fill the cache if it's not valid and
+    // update it when the rows are added, removed or changed.
+    int MeasureLineHeight( unsigned int row ) const;
+    void CacheRowHeights() const;
+    void InsertRowHeights( unsigned int first, unsigned int count );
+    void DeleteRowHeights( unsigned int first, unsigned int count );
+    void UpdateRowHeight( const wxDataViewItem& item );
+    void SaveRowHeights( wxDataViewRowHeightsMap& heights );
+    void RestoreRowHeights( const wxDataViewRowHeightsMap& heights );
+
     // Return false only if the event was vetoed by its handler.
     bool SendExpanderEvent(wxEventType type, const wxDataViewItem& item);
 
     wxDataViewTreeNode * FindNode( const wxDataViewItem & item );
 
+    // Create the nodes for the children of the given item.
+    void BuildTreeHelper( const wxDataViewModel * model,
+                          const wxDataViewItem & item,
+                          wxDataViewTreeNode * node );
+
+    // Remove the node and all its children from m_itemToNode.
+    void ForgetNode( wxDataViewTreeNode * node );
+
     wxDataViewColumn *FindColumnForEditing(const wxDataViewItem& item, wxDataViewCellMode mode);
 
     bool IsCellEditableInMode(const wxDataViewItem& item, const wxDataViewColumn *col, wxDataViewCellMode mode) const;
@@ -908,6 +1093,19 @@ private:
     wxDataViewTreeNode * m_root;
     int m_count;
 
+    // All the nodes of the tree, except for the root one, indexed by their
+    // items IDs.
+    wxDataViewTreeNodeMap m_itemToNode;
+
+    // The heights of all rows, only used in wxDV_VARIABLE_LINE_HEIGHT mode.
+    // It is empty if the heights need to be measured again.
+    mutable wxVector<int> m_rowHeights;
+
+    // The partial sums of m_rowHeights stored as a Fenwick tree, i.e.
+    // m_rowHeightsSums[i - 1] is the total height of the rows in
+    // [i - (i & -i), i) range. It is empty if it needs to be recomputed.
+    mutable wxVector<int> m_rowHeightsSums;
+
     // This is the tree node under the cursor
     wxDataViewTreeNode * m_underMouse;
 
@@ -1472,10 +1670,6 @@ void wxDataViewRenameTimer::Notify()
 // wxDataViewMainWindow
 //-----------------------------------------------------------------------------
 
-// The tree building helper, declared firstly
-static void BuildTreeHelper( const wxDataViewModel * model,  const wxDataViewItem & item,
-                             wxDataViewTreeNode * node);
-
 IMPLEMENT_ABSTRACT_CLASS(wxDataViewMainWindow, wxWindow)
 
 BEGIN_EVENT_TABLE(wxDataViewMainWindow,wxWindow)
@@ -2368,8 +2562,16 @@ bool wxDataViewMainWindow::ItemAdded(const wxDataViewItem & parent, const wxData
 
         parentNode->ChangeSubTreeCount(+1);
         parentNode->InsertChild(itemNode, nodePos);
+        m_itemToNode[item.GetID()] = itemNode;
 
         InvalidateCount();
+
+        // Only measure the new row, if it's shown, and its parent, which may
+        // look differently now that it has children.
+        const int itemRow = GetRowByItem(item);
+        if ( itemRow != -1 )
+            InsertRowHeights(itemRow, 1);
+        UpdateRowHeight(parent);
     }
 
     GetOwner()->InvalidateColBestWidths();
@@ -2401,24 +2603,14 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             return true;
 
         wxCHECK_MSG( parentNode->HasChildren(), false, "parent node doesn't have children?" );
-        const wxDataViewTreeNodes& parentsChildren = parentNode->GetChildNodes();
 
         // We can't use FindNode() to find 'item', because it was already
-        // removed from the model by the time ItemDeleted() is called, so we
-        // have to do it manually. We keep track of its position as well for
-        // later use.
-        int itemPosInNode = 0;
+        // removed from the model by the time ItemDeleted() is called and so
+        // FindNode() could try to create the nodes for it, just look it up.
         wxDataViewTreeNode *itemNode = NULL;
-        for ( wxDataViewTreeNodes::const_iterator i = parentsChildren.begin();
-              i != parentsChildren.end();
-              ++i, ++itemPosInNode )
-        {
-            if( (*i)->GetItem() == item )
-            {
-                itemNode = *i;
-                break;
-            }
-        }
+        wxDataViewTreeNodeMap::const_iterator itNode = m_itemToNode.find(item.GetID());
+        if ( itNode != m_itemToNode.end() && itNode->second->GetParent() == parentNode )
+            itemNode = itNode->second;
 
         // If the parent wasn't expanded, it's possible that we didn't have a
         // node corresponding to 'item' and so there's nothing left to do.
@@ -2432,9 +2624,14 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             return true;
         }
 
+        // Remember the row of the item before deleting it, this doesn't need
+        // the model.
+        const int itemRow = GetRowByItem(item);
+
         // Delete the item from wxDataViewTreeNode representation:
         const int itemsDeleted = 1 + itemNode->GetSubTreeCount();
 
+        ForgetNode(itemNode);
         parentNode->RemoveChild(itemNode);
         delete itemNode;
         parentNode->ChangeSubTreeCount(-itemsDeleted);
@@ -2457,29 +2654,16 @@ bool wxDataViewMainWindow::ItemDeleted(const wxDataViewItem& parent,
             }
         }
 
-        // Update selection by removing 'item' and its entire children tree from the selection.
-        if ( !m_selection.IsEmpty() )
+        if ( itemRow != -1 )
         {
-            // we can't call GetRowByItem() on 'item', as it's already deleted, so compute it from
-            // the parent ('parentNode') and position in its list of children
-            int itemRow;
-            if ( itemPosInNode == 0 )
-            {
-                // 1st child, row number is that of the parent parentNode + 1
-                itemRow = GetRowByItem(parentNode->GetItem()) + 1;
-            }
-            else
-            {
-                // row number is that of the sibling above 'item' + its subtree if any + 1
-                const wxDataViewTreeNode *siblingNode = parentNode->GetChildNodes()[itemPosInNode - 1];
-
-                itemRow = GetRowByItem(siblingNode->GetItem()) +
-                          siblingNode->GetSubTreeCount() +
-                          1;
-            }
+            // Update selection by removing 'item' and its entire children tree from the selection.
+            if ( !m_selection.IsEmpty() )
+                m_selection.OnItemsDeleted(itemRow, itemsDeleted);
 
-            m_selection.OnItemsDeleted(itemRow, itemsDeleted);
+            DeleteRowHeights(itemRow, itemsDeleted);
         }
+
+        UpdateRowHeight(parent);
     }
 
     // Change the current row to the last row if the current exceed the max row number
@@ -2497,6 +2681,8 @@ bool wxDataViewMainWindow::ItemChanged(const wxDataViewItem & item)
     SortPrepare();
     g_model->Resort();
 
+    UpdateRowHeight(item);
+
     GetOwner()->InvalidateColBestWidths();
 
     // Send event
@@ -2528,6 +2714,8 @@ bool wxDataViewMainWindow::ValueChanged( const wxDataViewItem & item, unsigned i
     SortPrepare();
     g_model->Resort();
 
+    UpdateRowHeight(item);
+
     GetOwner()->InvalidateColBestWidth(view_column);
 
     // Send event
@@ -2842,203 +3030,263 @@ wxRect wxDataViewMainWindow::GetLineRect( unsigned int row ) const
 
 int wxDataViewMainWindow::GetLineStart( unsigned int row ) const
 {
-    const wxDataViewModel *model = GetModel();
+    if ( !GetOwner()->HasFlag(wxDV_VARIABLE_LINE_HEIGHT) )
+        return row * m_lineHeight;
+
+    CacheRowHeights();
 
-    if (GetOwner()->GetWindowStyle() & wxDV_VARIABLE_LINE_HEIGHT)
+    // Rows after the last one are supposed to have the default height.
+    const unsigned int count = m_rowHeights.size();
+    int start = 0;
+    if ( row > count )
     {
-        // TODO make more efficient
+        start = (row - count) * m_lineHeight;
+        row = count;
+    }
 
-        int start = 0;
+    for ( int i = row; i > 0; i -= i & -i )
+        start += m_rowHeightsSums[i - 1];
 
-        unsigned int r;
-        for (r = 0; r < row; r++)
+    return start;
+}
+
+int wxDataViewMainWindow::GetLineAt( unsigned int y ) const
+{
+    // check for the easy case first
+    if ( !GetOwner()->HasFlag(wxDV_VARIABLE_LINE_HEIGHT) )
+        return y / m_lineHeight;
+
+    CacheRowHeights();
+
+    // Find the number of rows which end at or before the given position.
+    const int count = m_rowHeightsSums.size();
+
+    int step = 1;
+    while ( step <= count / 2 )
+        step *= 2;
+
+    int row = 0;
+    unsigned int yy = 0;
+    for ( ; step; step /= 2 )
+    {
+        if ( row + step <= count && yy + m_rowHeightsSums[row + step - 1] <= y )
         {
-            const wxDataViewTreeNode* node = GetTreeNodeByRow(r);
-            if (!node) return start;
+            row += step;
+            yy += m_rowHeightsSums[row - 1];
+        }
+    }
 
-            wxDataViewItem item = node->GetItem();
+    // not really correct for the rows after the last one...
+    if ( row == count )
+        return row + ((y-yy) / m_lineHeight);
 
-            unsigned int cols = GetOwner()->GetColumnCount();
-            unsigned int col;
-            int height = m_lineHeight;
-            for (col = 0; col < cols; col++)
-            {
-                const wxDataViewColumn *column = GetOwner()->GetColumn(col);
-                if (column->IsHidden())
-                    continue;      // skip it!
+    return row;
+}
 
-                if ((col != 0) &&
-                    model->IsContainer(item) &&
-                    !model->HasContainerColumns(item))
-                    continue;      // skip it!
+int wxDataViewMainWindow::GetLineHeight( unsigned int row ) const
+{
+    if ( !GetOwner()->HasFlag(wxDV_VARIABLE_LINE_HEIGHT) )
+        return m_lineHeight;
 
-                wxDataViewRenderer *renderer =
-                    const_cast<wxDataViewRenderer*>(column->GetRenderer());
-                renderer->PrepareForItem(model, item, column->GetModelColumn());
+    wxASSERT( !IsVirtualList() );
 
-                height = wxMax( height, renderer->GetSize().y );
-            }
+    CacheRowHeights();
 
-            start += height;
-        }
+    return row < m_rowHeights.size() ? m_rowHeights[row] : m_lineHeight;
+}
 
-        return start;
-    }
-    else
+int wxDataViewMainWindow::MeasureLineHeight( unsigned int row ) const
+{
+    const wxDataViewTreeNode* node = GetTreeNodeByRow(row);
+    // wxASSERT( node );
+    if (!node) return m_lineHeight;
+
+    const wxDataViewModel *model = GetModel();
+    wxDataViewItem item = node->GetItem();
+
+    int height = m_lineHeight;
+
+    unsigned int cols = GetOwner()->GetColumnCount();
+    unsigned int col;
+    for (col = 0; col < cols; col++)
     {
-        return row * m_lineHeight;
+        const wxDataViewColumn *column = GetOwner()->GetColumn(col);
+        if (column->IsHidden())
+            continue;      // skip it!
+
+        if ((col != 0) &&
+            model->IsContainer(item) &&
+            !model->HasContainerColumns(item))
+            continue;      // skip it!
+
+        wxDataViewRenderer *renderer =
+            const_cast<wxDataViewRenderer*>(column->GetRenderer());
+        renderer->PrepareForItem(model, item, column->GetModelColumn());
+
+        height = wxMax( height, renderer->GetSize().y );
     }
+
+    return height;
 }
 
-int wxDataViewMainWindow::GetLineAt( unsigned int y ) const
+void wxDataViewMainWindow::CacheRowHeights() const
 {
-    const wxDataViewModel *model = GetModel();
+    // Measure all rows again if the number of rows changed without us being
+    // notified about it, this is the case initially and after invalidating.
+    const unsigned int count = GetRowCount();
+    if ( m_rowHeights.size() != count )
+    {
+        m_rowHeights.resize(count);
+        for ( unsigned int row = 0; row < count; row++ )
+            m_rowHeights[row] = MeasureLineHeight(row);
 
-    // check for the easy case first
-    if ( !GetOwner()->HasFlag(wxDV_VARIABLE_LINE_HEIGHT) )
-        return y / m_lineHeight;
+        m_rowHeightsSums.clear();
+    }
 
-    // TODO make more efficient
-    unsigned int row = 0;
-    unsigned int yy = 0;
-    for (;;)
+    if ( m_rowHeightsSums.size() != count )
     {
-        const wxDataViewTreeNode* node = GetTreeNodeByRow(row);
-        if (!node)
+        m_rowHeightsSums = m_rowHeights;
+        for ( unsigned int i = 1; i <= count; i++ )
         {
-            // not really correct...
-            return row + ((y-yy) / m_lineHeight);
+            const unsigned int next = i + (i & -(int)i);
+            if ( next <= count )
+                m_rowHeightsSums[next - 1] += m_rowHeightsSums[i - 1];
         }
+    }
+}
 
-        wxDataViewItem item = node->GetItem();
+void wxDataViewMainWindow::InsertRowHeights( unsigned int first, unsigned int count )
+{
+    // Nothing to do if the heights are not cached yet anyhow.
+    if ( m_rowHeights.empty() || !count )
+        return;
 
-        unsigned int cols = GetOwner()->GetColumnCount();
-        unsigned int col;
-        int height = m_lineHeight;
-        for (col = 0; col < cols; col++)
-        {
-            const wxDataViewColumn *column = GetOwner()->GetColumn(col);
-            if (column->IsHidden())
-                continue;      // skip it!
+    wxCHECK_RET( first <= m_rowHeights.size(), "invalid row" );
 
-            if ((col != 0) &&
-                model->IsContainer(item) &&
-                !model->HasContainerColumns(item))
-                continue;      // skip it!
+    // Measure just the new rows and recompute the sums, which is much faster
+    // than measuring all rows again.
+    const unsigned int oldCount = m_rowHeights.size();
 
-            wxDataViewRenderer *renderer =
-                const_cast<wxDataViewRenderer*>(column->GetRenderer());
-            renderer->PrepareForItem(model, item, column->GetModelColumn());
+    wxVector<int> heights;
+    heights.reserve(oldCount + count);
 
-            height = wxMax( height, renderer->GetSize().y );
-        }
+    unsigned int row;
+    for ( row = 0; row < first; row++ )
+        heights.push_back(m_rowHeights[row]);
+    for ( row = first; row < first + count; row++ )
+        heights.push_back(MeasureLineHeight(row));
+    for ( row = first; row < oldCount; row++ )
+        heights.push_back(m_rowHeights[row]);
 
-        yy += height;
-        if (y < yy)
-            return row;
+    m_rowHeights.swap(heights);
 
-        row++;
-    }
+    m_rowHeightsSums.clear();
 }
 
-int wxDataViewMainWindow::GetLineHeight( unsigned int row ) const
+void wxDataViewMainWindow::DeleteRowHeights( unsigned int first, unsigned int count )
 {
-    const wxDataViewModel *model = GetModel();
+    if ( m_rowHeights.empty() || !count )
+        return;
 
-    if (GetOwner()->GetWindowStyle() & wxDV_VARIABLE_LINE_HEIGHT)
-    {
-        wxASSERT( !IsVirtualList() );
+    wxCHECK_RET( first + count <= m_rowHeights.size(), "invalid rows" );
 
-        const wxDataViewTreeNode* node = GetTreeNodeByRow(row);
-        // wxASSERT( node );
-        if (!node) return m_lineHeight;
+    m_rowHeights.erase(m_rowHeights.begin() + first,
+                       m_rowHeights.begin() + first + count);
 
-        wxDataViewItem item = node->GetItem();
+    m_rowHeightsSums.clear();
+}
 
-        int height = m_lineHeight;
+void wxDataViewMainWindow::UpdateRowHeight( const wxDataViewItem& item )
+{
+    if ( m_rowHeights.empty() || !item.IsOk() )
+        return;
 
-        unsigned int cols = GetOwner()->GetColumnCount();
-        unsigned int col;
-        for (col = 0; col < cols; col++)
-        {
-            const wxDataViewColumn *column = GetOwner()->GetColumn(col);
-            if (column->IsHidden())
-                continue;      // skip it!
+    const int row = GetRowByItem(item);
+    if ( row == -1 || row >= (int)m_rowHeights.size() )
+        return;
 
-            if ((col != 0) &&
-                model->IsContainer(item) &&
-                !model->HasContainerColumns(item))
-                continue;      // skip it!
+    const int delta = MeasureLineHeight(row) - m_rowHeights[row];
+    if ( !delta )
+        return;
 
-            wxDataViewRenderer *renderer =
-                const_cast<wxDataViewRenderer*>(column->GetRenderer());
-            renderer->PrepareForItem(model, item, column->GetModelColumn());
+    m_rowHeights[row] += delta;
 
-            height = wxMax( height, renderer->GetSize().y );
-        }
+    // Update the sums in place if they're valid.
+    const int count = m_rowHeightsSums.size();
+    for ( int i = row + 1; i <= count; i += i & -i )
+        m_rowHeightsSums[i - 1] += delta;
 
-        return height;
-    }
-    else
+    UpdateDisplay();
+}
+
+// Append all the shown descendants of the given node in the rows order.
+static void
+wxDataViewGetShownNodes(const wxDataViewTreeNode* node,
+                        wxVector<const wxDataViewTreeNode*>& nodes)
+{
+    const wxDataViewTreeNodes& children = node->GetChildNodes();
+    const size_t len = children.size();
+    for ( size_t i = 0; i < len; i++ )
     {
-        return m_lineHeight;
+        const wxDataViewTreeNode* const child = children[i];
+        nodes.push_back(child);
+        if ( child->IsOpen() )
+            wxDataViewGetShownNodes(child, nodes);
     }
 }
 
-
-class RowToTreeNodeJob: public DoJob
+void wxDataViewMainWindow::SaveRowHeights( wxDataViewRowHeightsMap& heights )
 {
-public:
-    RowToTreeNodeJob( unsigned int row_ , int current_, wxDataViewTreeNode * node )
+    // There is nothing to save if the heights are not cached.
+    if ( m_rowHeights.empty() )
+        return;
+
+    wxVector<const wxDataViewTreeNode*> nodes;
+    nodes.reserve(m_rowHeights.size());
+    wxDataViewGetShownNodes(m_root, nodes);
+
+    // If the cache is out of sync with the tree, it's going to be recomputed
+    // anyhow.
+    if ( nodes.size() != m_rowHeights.size() )
     {
-        this->row = row_;
-        this->current = current_;
-        ret = NULL;
-        parent = node;
+        InvalidateRowHeights();
+        return;
     }
 
-    virtual int operator() ( wxDataViewTreeNode * node )
+    for ( size_t row = 0; row < nodes.size(); row++ )
+        heights[const_cast<wxDataViewTreeNode*>(nodes[row])] = m_rowHeights[row];
+}
+
+void wxDataViewMainWindow::RestoreRowHeights( const wxDataViewRowHeightsMap& heights )
+{
+    wxVector<const wxDataViewTreeNode*> nodes;
+    nodes.reserve(heights.size());
+    wxDataViewGetShownNodes(m_root, nodes);
+
+    // Sorting only reorders the rows, but be safe and measure them again if
+    // it did anything else.
+    if ( nodes.size() != m_rowHeights.size() )
     {
-        current ++;
-        if( current == static_cast<int>(row))
-        {
-            ret = node;
-            return DoJob::DONE;
-        }
+        InvalidateRowHeights();
+        return;
+    }
 
-        if( node->GetSubTreeCount() + current < static_cast<int>(row) )
+    for ( size_t row = 0; row < nodes.size(); row++ )
+    {
+        wxDataViewRowHeightsMap::const_iterator
+            it = heights.find(const_cast<wxDataViewTreeNode*>(nodes[row]));
+        if ( it == heights.end() )
         {
-            current += node->GetSubTreeCount();
-            return  DoJob::SKIP_SUBTREE;
+            InvalidateRowHeights();
+            return;
         }
-        else
-        {
-            parent = node;
-
-            // If the current node has only leaf children, we can find the
-            // desired node directly. This can speed up finding the node
-            // in some cases, and will have a very good effect for list views.
-            if ( node->HasChildren() &&
-                 (int)node->GetChildNodes().size() == node->GetSubTreeCount() )
-            {
-                const int index = static_cast<int>(row) - current - 1;
-                ret = node->GetChildNodes()[index];
-                return DoJob::DONE;
-            }
 
-            return DoJob::CONTINUE;
-        }
+        m_rowHeights[row] = it->second;
     }
 
-    wxDataViewTreeNode * GetResult() const
-        { return ret; }
+    m_rowHeightsSums.clear();
+}
 
-private:
-    unsigned int row;
-    int current;
-    wxDataViewTreeNode * ret;
-    wxDataViewTreeNode * parent;
-};
 
 wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) const
 {
@@ -3047,9 +3295,25 @@ wxDataViewTreeNode * wxDataViewMainWindow::GetTreeNodeByRow(unsigned int row) co
     if ( row == (unsigned)-1 )
         return NULL;
 
-    RowToTreeNodeJob job( row , -2, m_root );
-    Walker( m_root , job );
-    return job.GetResult();
+    // Descend into the child containing the row at each level.
+    wxDataViewTreeNode *node = m_root;
+    int rowInNode = row;
+    for ( ;; )
+    {
+        if ( !node->HasChildren() )
+            return NULL;
+
+        const int index = node->FindChildByRow(rowInNode);
+        if ( index == wxNOT_FOUND )
+            return NULL;
+
+        node = node->GetChildNodes()[index];
+        if ( rowInNode == 0 )
+            return node;
+
+        // Skip the row of the node itself.
+        rowInNode--;
+    }
 }
 
 wxDataViewItem wxDataViewMainWindow::GetItemByRow(unsigned int row) const
@@ -3140,7 +3404,7 @@ void wxDataViewMainWindow::Expand( unsigned int row )
         if( node->GetChildNodes().empty() )
         {
             SortPrepare();
-            ::BuildTreeHelper(GetModel(), node->GetItem(), node);
+            BuildTreeHelper(GetModel(), node->GetItem(), node);
         }
 
         const unsigned countNewRows = node->GetSubTreeCount();
@@ -3153,6 +3417,7 @@ void wxDataViewMainWindow::Expand( unsigned int row )
 
         if ( m_count != -1 )
             m_count += countNewRows;
+        InsertRowHeights(row + 1, countNewRows);
         UpdateDisplay();
         // Send the expanded event
         SendExpanderEvent(wxEVT_DATAVIEW_ITEM_EXPANDED,node->GetItem());
@@ -3201,6 +3466,7 @@ void wxDataViewMainWindow::Collapse(unsigned int row)
 
             if ( m_count != -1 )
                 m_count -= countDeletedRows;
+            DeleteRowHeights(row + 1, countDeletedRows);
             UpdateDisplay();
             SendExpanderEvent(wxEVT_DATAVIEW_ITEM_COLLAPSED,node->GetItem());
         }
@@ -3215,6 +3481,10 @@ wxDataViewTreeNode * wxDataViewMainWindow::FindNode( const wxDataViewItem & item
     if (!item.IsOk())
         return m_root;
 
+    wxDataViewTreeNodeMap::const_iterator itNode = m_itemToNode.find(item.GetID());
+    if ( itNode != m_itemToNode.end() )
+        return itNode->second;
+
     // Compose the parent-chain for the item we are looking for
     wxVector<wxDataViewItem> parentChain;
     wxDataViewItem it( item );
@@ -3237,7 +3507,7 @@ wxDataViewTreeNode * wxDataViewMainWindow::FindNode( const wxDataViewItem & item
                 // child nodes in the control's representation yet. We have
                 // to realize its subtree now.
                 SortPrepare();
-                ::BuildTreeHelper(model, node->GetItem(), node);
+                BuildTreeHelper(model, node->GetItem(), node);
             }
 
             const wxDataViewTreeNodes& nodes = node->GetChildNodes();
@@ -3268,6 +3538,22 @@ wxDataViewTreeNode * wxDataViewMainWindow::FindNode( const wxDataViewItem & item
     return NULL;
 }
 
+void wxDataViewMainWindow::ForgetNode( wxDataViewTreeNode * node )
+{
+    m_itemToNode.erase(node->GetItem().GetID());
+
+    if ( node->HasChildren() )
+    {
+        const wxDataViewTreeNodes& nodes = node->GetChildNodes();
+        for ( wxDataViewTreeNodes::const_iterator i = nodes.begin();
+              i != nodes.end();
+              ++i )
+        {
+            ForgetNode(*i);
+        }
+    }
+}
+
 void wxDataViewMainWindow::HitTest( const wxPoint & point, wxDataViewItem & item,
                                     wxDataViewColumn* &column )
 {
@@ -3369,49 +3655,6 @@ int wxDataViewMainWindow::RecalculateCount() const
     }
 }
 
-class ItemToRowJob : public DoJob
-{
-public:
-    ItemToRowJob(const wxDataViewItem& item_, wxVector<wxDataViewItem>::reverse_iterator iter)
-        : m_iter(iter),
-        item(item_)
-    {
-        ret = -1;
-    }
-
-    // Maybe binary search will help to speed up this process
-    virtual int operator() ( wxDataViewTreeNode * node)
-    {
-        ret ++;
-        if( node->GetItem() == item )
-        {
-            return DoJob::DONE;
-        }
-
-        if( node->GetItem() == *m_iter )
-        {
-            m_iter++;
-            return DoJob::CONTINUE;
-        }
-        else
-        {
-            ret += node->GetSubTreeCount();
-            return DoJob::SKIP_SUBTREE;
-        }
-
-    }
-
-    // the row number is begin from zero
-    int GetResult() const
-        { return ret -1; }
-
-private:
-    wxVector<wxDataViewItem>::reverse_iterator m_iter;
-    wxDataViewItem item;
-    int ret;
-
-};
-
 int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
 {
     const wxDataViewModel * model = GetModel();
@@ -3427,28 +3670,35 @@ int wxDataViewMainWindow::GetRowByItem(const wxDataViewItem & item) const
         if( !item.IsOk() )
             return -1;
 
-        // Compose the parent-chain of the item we are looking for
-        wxVector<wxDataViewItem> parentChain;
-        wxDataViewItem it( item );
-        while( it.IsOk() )
+        // Notice that we don't use the model here, so this works even for the
+        // items already deleted from it, and that we don't create the nodes
+        // for the items which are not shown yet.
+        wxDataViewTreeNodeMap::const_iterator it = m_itemToNode.find(item.GetID());
+        if ( it == m_itemToNode.end() )
+            return -1;
+
+        // The row of the node is the sum of rows taken by all its preceding
+        // siblings and all the preceding siblings of its parents, which must
+        // all be expanded for the item to be shown at all.
+        int row = -1;
+        for ( const wxDataViewTreeNode *node = it->second;
+              node->GetParent();
+              node = node->GetParent() )
         {
-            parentChain.push_back(it);
-            it = model->GetParent(it);
-        }
+            const wxDataViewTreeNode * const parent = node->GetParent();
+            if ( parent->GetParent() && !parent->IsOpen() )
+                return -1;
 
-        // add an 'invalid' item to represent our 'invisible' root node
-        parentChain.push_back(wxDataViewItem());
+            row += 1 + parent->GetRowsBefore(node);
+        }
 
-        // the parent chain was created by adding the deepest parent first.
-        // so if we want to start at the root node, we have to iterate backwards through the vector
-        ItemToRowJob job( item, parentChain.rbegin() );
-        Walker( m_root, job );
-        return job.GetResult();
+        return row;
     }
 }
 
-static void BuildTreeHelper( const wxDataViewModel * model,  const wxDataViewItem & item,
-                             wxDataViewTreeNode * node)
+void wxDataViewMainWindow::BuildTreeHelper( const wxDataViewModel * model,
+                                            const wxDataViewItem & item,
+                                            wxDataViewTreeNode * node)
 {
     if( !model->IsContainer( item ) )
         return;
@@ -3463,9 +3713,13 @@ static void BuildTreeHelper( const wxDataViewModel * model,  const wxDataViewIte
         if( model->IsContainer(children[index]) )
             n->SetHasChildren( true );
 
-        node->InsertChild(n, index);
+        node->AppendChild(n);
+        m_itemToNode[children[index].GetID()] = n;
     }
 
+    // Sort all the children at once instead of inserting them one by one.
+    node->Resort();
+
     wxASSERT( node->IsOpen() );
     node->ChangeSubTreeCount(+num);
 }
@@ -3494,7 +3748,9 @@ void wxDataViewMainWindow::DestroyTree()
     if (!IsVirtualList())
     {
         wxDELETE(m_root);
+        m_itemToNode.clear();
         m_count = 0;
+        InvalidateRowHeights();
     }
 }
 
@@ -4488,6 +4744,7 @@ void wxDataViewMainWindow::OnColumnsCountChanged()
 
     m_useCellFocus = (editableCount > 0);
 
+    InvalidateRowHeights();
     UpdateDisplay();
 }
 
@@ -4777,6 +5034,9 @@ void wxDataViewCtrl::OnColumnChange(unsigned int idx)
     if ( m_headerArea )
         m_headerArea->UpdateColumn(idx);
 
+    // The column could have been shown or hidden, which can affect the rows
+    // heights.
+    m_clientArea->InvalidateRowHeights();
     m_clientArea->UpdateDisplay();
 }
 
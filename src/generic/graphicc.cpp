@@ -40,6 +40,9 @@ bool wxCairoInit();
 #include "wx/private/graphics.h"
 #include "wx/rawbmp.h"
 #include "wx/vector.h"
+#include "wx/hashmap.h"
+#include "wx/module.h"
+#include "wx/thread.h"
 
 using namespace std;
 
@@ -1333,6 +1336,100 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, cairo_surfac
     m_buffer = NULL;
 }
 
+#ifdef wxHAS_RAW_BITMAP
+
+// Helper functions for converting raw bitmap data to Cairo formats.
+//
+// Notice that they work with the raw row pointers rather than pixel iterators
+// and avoid branches and divisions in the inner loops to allow the compiler to
+// vectorize them, as this conversion is the bottleneck of drawing bitmaps.
+namespace
+{
+
+// Returns the same value as c*alpha/255, but without using the division.
+inline wxUint32 MultiplyAlpha(wxUint32 c, wxUint32 alpha)
+{
+    const wxUint32 x = c*alpha;
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+// Functions converting or updating a single row of pixels.
+typedef void (*wxCairoRowConverter)(const unsigned char* src,
+                                    wxUint32* dst,
+                                    int width);
+
+template <class Format>
+void ConvertRowToARGB32(const unsigned char* src, wxUint32* dst, int width)
+{
+    // Each pixel in CAIRO_FORMAT_ARGB32 is a 32-bit quantity, with alpha in
+    // the upper 8 bits, then red, then green, then blue. The 32-bit quantities
+    // are stored native-endian. Pre-multiplied alpha is used.
+    for ( int x = 0; x < width; x++, src += Format::SizePixel )
+    {
+        const wxUint32 alpha = src[Format::ALPHA];
+        dst[x] = alpha << 24
+                    | MultiplyAlpha(src[Format::RED], alpha) << 16
+                    | MultiplyAlpha(src[Format::GREEN], alpha) << 8
+                    | MultiplyAlpha(src[Format::BLUE], alpha);
+    }
+}
+
+template <class Format>
+void ConvertRowToRGB24(const unsigned char* src, wxUint32* dst, int width)
+{
+    // Each pixel in CAIRO_FORMAT_RGB24 is a 32-bit quantity, with the upper 8
+    // bits unused. Red, Green, and Blue are stored in the remaining 24 bits in
+    // that order. The 32-bit quantities are stored native-endian.
+    for ( int x = 0; x < width; x++, src += Format::SizePixel )
+    {
+        dst[x] = wxUint32(src[Format::RED]) << 16
+                    | wxUint32(src[Format::GREEN]) << 8
+                    | src[Format::BLUE];
+    }
+}
+
+#if defined(__WXMSW__) || defined(__WXGTK3__)
+template <class Format>
+void ApplyMaskToRow(const unsigned char* mask, wxUint32* dst, int width)
+{
+    // Make the pixels fully transparent or fully opaque depending on the mask.
+    for ( int x = 0; x < width; x++, mask += Format::SizePixel )
+    {
+        const bool opaque = (mask[Format::RED] |
+                             mask[Format::GREEN] |
+                             mask[Format::BLUE]) != 0;
+        dst[x] = opaque ? wxUint32(wxALPHA_OPAQUE) << 24 | (dst[x] & 0x00FFFFFF)
+                        : 0;
+    }
+}
+#endif // __WXMSW__ || __WXGTK3__
+
+// Call the given function for all rows of the raw bitmap data and the buffer
+// using the given stride.
+template <class PixelData>
+void ConvertRows(PixelData& pixData,
+                 unsigned char* buffer,
+                 int stride,
+                 wxCairoRowConverter convertRow)
+{
+    typename PixelData::Iterator p(pixData);
+    const unsigned char* src = p.m_ptr;
+
+    const int width = pixData.GetWidth();
+    const int height = pixData.GetHeight();
+    for ( int y = 0; y < height; y++ )
+    {
+        convertRow(src, reinterpret_cast<wxUint32*>(buffer), width);
+
+        src += pixData.GetRowStride();
+        buffer += stride;
+    }
+}
+
+} // anonymous namespace
+
+#endif // wxHAS_RAW_BITMAP
+
 wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitmap& bmp )
     : wxGraphicsBitmapData(renderer)
 {
@@ -1355,7 +1452,6 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitm
     int stride = InitBuffer(bmp.GetWidth(), bmp.GetHeight(), bufferFormat);
 
     wxBitmap bmpSource = bmp;  // we need a non-const instance
-    wxUint32* data = (wxUint32*)m_buffer;
 
     if ( bufferFormat == CAIRO_FORMAT_ARGB32 )
     {
@@ -1364,33 +1460,8 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitm
             pixData(bmpSource, wxPoint(0, 0), wxSize(m_width, m_height));
         wxCHECK_RET( pixData, wxT("Failed to gain raw access to bitmap data."));
 
-        wxAlphaPixelData::Iterator p(pixData);
-        for (int y=0; y<m_height; y++)
-        {
-            wxAlphaPixelData::Iterator rowStart = p;
-            wxUint32* const rowStartDst = data;
-            for (int x=0; x<m_width; x++)
-            {
-                // Each pixel in CAIRO_FORMAT_ARGB32 is a 32-bit quantity,
-                // with alpha in the upper 8 bits, then red, then green, then
-                // blue. The 32-bit quantities are stored native-endian.
-                // Pre-multiplied alpha is used.
-                unsigned char alpha = p.Alpha();
-                if (alpha == 0)
-                    *data = 0;
-                else
-                    *data = ( alpha                      << 24
-                              | (p.Red() * alpha/255)    << 16
-                              | (p.Green() * alpha/255)  <<  8
-                              | (p.Blue() * alpha/255) );
-                ++data;
-                ++p;
-            }
-
-            data = rowStartDst + stride / 4;
-            p = rowStart;
-            p.OffsetY(pixData, 1);
-        }
+        ConvertRows(pixData, m_buffer, stride,
+                    ConvertRowToARGB32<wxAlphaPixelFormat>);
     }
     else  // no alpha
     {
@@ -1398,26 +1469,8 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitm
             pixData(bmpSource, wxPoint(0, 0), wxSize(m_width, m_height));
         wxCHECK_RET( pixData, wxT("Failed to gain raw access to bitmap data."));
 
-        wxNativePixelData::Iterator p(pixData);
-        for (int y=0; y<m_height; y++)
-        {
-            wxNativePixelData::Iterator rowStart = p;
-            wxUint32* const rowStartDst = data;
-            for (int x=0; x<m_width; x++)
-            {
-                // Each pixel in CAIRO_FORMAT_RGB24 is a 32-bit quantity, with
-                // the upper 8 bits unused. Red, Green, and Blue are stored in
-                // the remaining 24 bits in that order.  The 32-bit quantities
-                // are stored native-endian.
-                *data = ( p.Red() << 16 | p.Green() << 8 | p.Blue() );
-                ++data;
-                ++p;
-            }
-
-            data = rowStartDst + stride / 4;
-            p = rowStart;
-            p.OffsetY(pixData, 1);
-        }
+        ConvertRows(pixData, m_buffer, stride,
+                    ConvertRowToRGB24<wxNativePixelFormat>);
     }
 #if defined(__WXMSW__) || defined(__WXGTK3__)
     // if there is a mask, set the alpha bytes in the target buffer to 
@@ -1426,30 +1479,12 @@ wxCairoBitmapData::wxCairoBitmapData( wxGraphicsRenderer* renderer, const wxBitm
     {
         wxBitmap bmpMask = bmpSource.GetMask()->GetBitmap();
         bufferFormat = CAIRO_FORMAT_ARGB32;
-        data = (wxUint32*)m_buffer;
         wxNativePixelData
             pixData(bmpMask, wxPoint(0, 0), wxSize(m_width, m_height));
         wxCHECK_RET( pixData, wxT("Failed to gain raw access to mask data."));
 
-        wxNativePixelData::Iterator p(pixData);
-        for (int y=0; y<m_height; y++)
-        {
-            wxNativePixelData::Iterator rowStart = p;
-            wxUint32* const rowStartDst = data;
-            for (int x=0; x<m_width; x++)
-            {
-                if (p.Red()+p.Green()+p.Blue() == 0)
-                    *data = 0;
-                else
-                    *data = (wxALPHA_OPAQUE << 24) | (*data & 0x00FFFFFF);
-                ++data;
-                ++p;
-            }
-
-            data = rowStartDst + stride / 4;
-            p = rowStart;
-            p.OffsetY(pixData, 1);
-        }
+        ConvertRows(pixData, m_buffer, stride,
+                    ApplyMaskToRow<wxNativePixelFormat>);
     }
 #endif
 
@@ -1637,6 +1672,492 @@ wxCairoBitmapData::~wxCairoBitmapData()
     delete [] m_buffer;
 }
 
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+
+// ----------------------------------------------------------------------------
+// wxCairoBitmapCache: surfaces created for the bitmaps drawn by DrawBitmap()
+// ----------------------------------------------------------------------------
+
+// Converting wxBitmap to a Cairo surface is expensive, so we keep the
+// surfaces created for the bitmaps drawn by wxCairoContext::DrawBitmap() to
+// reuse them when the same bitmaps are drawn again, as is typically the case
+// with the icons drawn on every repaint.
+//
+// The cache is indexed by the bitmap ref data and keeps a reference to the
+// bitmap itself. This ensures that the ref data is not reused for a different
+// bitmap and that changing the bitmap using wxBitmap methods un-shares it and
+// so results in a different key. Modifying the pixels in place using raw
+// bitmap access must be reported by calling wxCairoBitmapChanged(). Drawing
+// on the bitmap selected into wxMemoryDC also modifies it in place, even if
+// it's shared with other wxBitmap objects, so such bitmaps, reported by
+// wxCairoBitmapSelected(), are not cached until they're deselected.
+namespace
+{
+
+class wxCairoBitmapCache
+{
+public:
+    wxCairoBitmapCache() : m_totalSize(0), m_lastUsed(0) { }
+
+    // Return the graphics bitmap corresponding to the given bitmap, creating
+    // and caching it if necessary.
+    wxGraphicsBitmap Get(wxGraphicsRenderer* renderer, const wxBitmap& bmp);
+
+    // Remove the cached data for the given bitmap, if any.
+    void Remove(const wxBitmap& bmp);
+
+    // Mark the bitmap as being selected into a memory DC or not any more.
+    void Select(const wxBitmap& bmp, bool selected);
+
+    // Remove everything from the cache.
+    void Clear();
+
+private:
+    // Maximal number of bytes used by all the surfaces in the cache and the
+    // maximal number of the cached bitmaps.
+    enum
+    {
+        MAX_TOTAL_SIZE = 32*1024*1024,
+        MAX_COUNT = 1024
+    };
+
+    struct Entry
+    {
+        Entry() : size(0), lastUsed(0) { }
+
+        wxBitmap bitmap;
+        wxGraphicsBitmap graphicsBitmap;
+        size_t size;
+        unsigned long lastUsed;
+    };
+
+    WX_DECLARE_HASH_MAP(wxObjectRefData*, Entry,
+                        wxPointerHash, wxPointerEqual,
+                        Map);
+
+    // Remove the entries which can't be used any more because we hold the
+    // only remaining reference to their bitmaps and then the least recently
+    // used ones until there is enough space for a new entry of the given size.
+    void MakeRoom(size_t size);
+
+    void Erase(Map::iterator it)
+    {
+        m_totalSize -= it->second.size;
+        m_map.erase(it);
+    }
+
+    // The number of memory DCs each of the currently selected bitmaps is
+    // selected into.
+    WX_DECLARE_HASH_MAP(wxObjectRefData*, int,
+                        wxPointerHash, wxPointerEqual,
+                        SelectedMap);
+
+    Map m_map;
+    SelectedMap m_selected;
+    size_t m_totalSize;
+    unsigned long m_lastUsed;
+
+    // We can be used from multiple threads drawing on different contexts.
+    wxCRIT_SECT_DECLARE_MEMBER(m_cs);
+};
+
+wxGraphicsBitmap
+wxCairoBitmapCache::Get(wxGraphicsRenderer* renderer, const wxBitmap& bmp)
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    Map::iterator it = m_map.find(bmp.GetRefData());
+    if ( it != m_map.end() )
+    {
+        it->second.lastUsed = ++m_lastUsed;
+        return it->second.graphicsBitmap;
+    }
+
+    const wxGraphicsBitmap graphicsBitmap = renderer->CreateBitmap(bmp);
+    if ( graphicsBitmap.IsNull() )
+        return graphicsBitmap;
+
+    // The bitmap can be changed by drawing on it at any moment.
+    if ( m_selected.find(bmp.GetRefData()) != m_selected.end() )
+        return graphicsBitmap;
+
+    // Don't cache huge bitmaps, this would just evict all the other ones.
+    const size_t size = 4*size_t(bmp.GetWidth())*bmp.GetHeight();
+    if ( size > MAX_TOTAL_SIZE / 4 )
+        return graphicsBitmap;
+
+    MakeRoom(size);
+
+    Entry& entry = m_map[bmp.GetRefData()];
+    entry.bitmap = bmp;
+    entry.graphicsBitmap = graphicsBitmap;
+    entry.size = size;
+    entry.lastUsed = ++m_lastUsed;
+
+    m_totalSize += size;
+
+    return graphicsBitmap;
+}
+
+void wxCairoBitmapCache::Remove(const wxBitmap& bmp)
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    Map::iterator it = m_map.find(bmp.GetRefData());
+    if ( it != m_map.end() )
+        Erase(it);
+}
+
+void wxCairoBitmapCache::Select(const wxBitmap& bmp, bool selected)
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    // Whatever was cached is invalid after drawing on the bitmap, but also
+    // before it, as it could have been modified while it was selected into
+    // another DC.
+    Map::iterator it = m_map.find(bmp.GetRefData());
+    if ( it != m_map.end() )
+        Erase(it);
+
+    if ( selected )
+    {
+        m_selected[bmp.GetRefData()]++;
+    }
+    else
+    {
+        SelectedMap::iterator sel = m_selected.find(bmp.GetRefData());
+        if ( sel != m_selected.end() && !--sel->second )
+            m_selected.erase(sel);
+    }
+}
+
+void wxCairoBitmapCache::Clear()
+{
+    wxCRIT_SECT_LOCKER(lock, m_cs);
+
+    m_map.clear();
+    m_totalSize = 0;
+}
+
+void wxCairoBitmapCache::MakeRoom(size_t size)
+{
+    for ( Map::iterator it = m_map.begin(); it != m_map.end(); )
+    {
+        Map::iterator current = it++;
+        if ( current->second.bitmap.GetRefData()->GetRefCount() == 1 )
+            Erase(current);
+    }
+
+    while ( !m_map.empty() &&
+                (m_totalSize + size > MAX_TOTAL_SIZE ||
+                    m_map.size() >= MAX_COUNT) )
+    {
+        Map::iterator oldest = m_map.begin();
+        for ( Map::iterator it = oldest; it != m_map.end(); ++it )
+        {
+            if ( it->second.lastUsed < oldest->second.lastUsed )
+                oldest = it;
+        }
+
+        Erase(oldest);
+    }
+}
+
+wxCairoBitmapCache gs_cairoBitmapCache;
+
+} // anonymous namespace
+
+void wxCairoBitmapChanged(const wxBitmap& bmp)
+{
+    gs_cairoBitmapCache.Remove(bmp);
+}
+
+void wxCairoBitmapSelected(const wxBitmap& bmp, bool selected)
+{
+    gs_cairoBitmapCache.Select(bmp, selected);
+}
+
+#endif // wxHAS_CAIRO_BITMAP_CACHE
+
+#ifdef __WXGTK__
+
+// ----------------------------------------------------------------------------
+// wxCairoTextLayoutCache: Pango layouts used for drawing and measuring text
+// ----------------------------------------------------------------------------
+
+// Creating a PangoLayout requires itemizing and shaping the text, which is by
+// far the most expensive part of drawing or measuring it, and the same short
+// strings, such as labels, are typically drawn and measured many times, so we
+// keep the recently used layouts, containing the already shaped glyph runs, in
+// a cache shared by all wxCairoContexts.
+//
+// The layouts are indexed by the font ref data and the text. As for the
+// bitmaps cache above, we keep a reference to the font to ensure that the ref
+// data pointer is not reused and changing the font un-shares its data. The
+// layouts are updated to match the Cairo context they're used with, so they
+// can be shared between the contexts.
+//
+// The cache is only used from the main thread because the layouts can't be
+// used from several threads at once.
+namespace
+{
+
+// Create a new layout for the given text using the given font.
+PangoLayout* CreateTextLayout(cairo_t* cr,
+                              const wxFont& font,
+                              const wxCharBuffer& text)
+{
+    PangoLayout* const layout = pango_cairo_create_layout(cr);
+    pango_layout_set_font_description(layout,
+                                      font.GetNativeFontInfo()->description);
+    pango_layout_set_text(layout, text, text.length());
+
+    return layout;
+}
+
+struct wxCairoTextKey
+{
+    wxCairoTextKey() : font(NULL) { }
+    wxCairoTextKey(const wxObjectRefData* font_, const wxCharBuffer& text_)
+        : font(font_), text(text_)
+    {
+    }
+
+    const wxObjectRefData* font;
+    wxCharBuffer text;
+};
+
+class wxCairoTextKeyHash
+{
+public:
+    wxCairoTextKeyHash() { }
+
+    unsigned long operator()(const wxCairoTextKey& key) const
+    {
+        return wxStringHash::stringHash(key.text.data()) ^
+                    wxPointerHash()(key.font);
+    }
+
+    wxCairoTextKeyHash& operator=(const wxCairoTextKeyHash&) { return *this; }
+};
+
+class wxCairoTextKeyEqual
+{
+public:
+    wxCairoTextKeyEqual() { }
+
+    bool operator()(const wxCairoTextKey& a, const wxCairoTextKey& b) const
+    {
+        return a.font == b.font &&
+                a.text.length() == b.text.length() &&
+                    memcmp(a.text.data(), b.text.data(), a.text.length()) == 0;
+    }
+
+    wxCairoTextKeyEqual& operator=(const wxCairoTextKeyEqual&) { return *this; }
+};
+
+class wxCairoTextLayoutCache
+{
+public:
+    wxCairoTextLayoutCache()
+    {
+        m_head =
+        m_tail = NULL;
+
+        m_hits =
+        m_misses = 0;
+    }
+
+    // Return a new reference to the layout of the given text using the given
+    // font updated to be used with the given Cairo context. The caller must
+    // release it with g_object_unref() and must not modify it.
+    PangoLayout* Get(cairo_t* cr, const wxFont& font, const wxCharBuffer& text);
+
+    // Remove everything from the cache.
+    void Clear();
+
+    unsigned long GetHits() const { return m_hits; }
+    unsigned long GetMisses() const { return m_misses; }
+
+private:
+    // Maximal number of layouts kept in the cache.
+    enum { MAX_COUNT = 1024 };
+
+    // The entries are kept in a doubly linked list ordered by the last use
+    // time, with the most recently used one at its head.
+    struct Entry
+    {
+        wxFont font;
+        wxCairoTextKey key;
+        PangoLayout* layout;
+
+        Entry* prev;
+        Entry* next;
+    };
+
+    WX_DECLARE_HASH_MAP(wxCairoTextKey, Entry*,
+                        wxCairoTextKeyHash, wxCairoTextKeyEqual,
+                        Map);
+
+    void Unlink(Entry* entry);
+    void LinkAtHead(Entry* entry);
+
+    Map m_map;
+    Entry* m_head;
+    Entry* m_tail;
+
+    unsigned long m_hits,
+                  m_misses;
+};
+
+PangoLayout*
+wxCairoTextLayoutCache::Get(cairo_t* cr,
+                            const wxFont& font,
+                            const wxCharBuffer& text)
+{
+    const wxCairoTextKey key(font.GetRefData(), text);
+
+    Map::iterator it = m_map.find(key);
+    if ( it != m_map.end() )
+    {
+        m_hits++;
+
+        Entry* const entry = it->second;
+        if ( entry != m_head )
+        {
+            Unlink(entry);
+            LinkAtHead(entry);
+        }
+
+        // This only invalidates the layout if the context font options or
+        // transformation are different from the ones it was created with.
+        pango_cairo_update_layout(cr, entry->layout);
+
+        return static_cast<PangoLayout*>(g_object_ref(entry->layout));
+    }
+
+    m_misses++;
+
+    PangoLayout* const layout = CreateTextLayout(cr, font, text);
+
+    Entry* entry;
+    if ( m_map.size() < MAX_COUNT )
+    {
+        entry = new Entry;
+    }
+    else // Reuse the least recently used entry.
+    {
+        entry = m_tail;
+        Unlink(entry);
+        m_map.erase(entry->key);
+        g_object_unref(entry->layout);
+    }
+
+    entry->font = font;
+    entry->key = key;
+    entry->layout = layout;
+
+    m_map[key] = entry;
+    LinkAtHead(entry);
+
+    return static_cast<PangoLayout*>(g_object_ref(layout));
+}
+
+void wxCairoTextLayoutCache::Clear()
+{
+    while ( m_head )
+    {
+        Entry* const entry = m_head;
+        m_head = entry->next;
+
+        g_object_unref(entry->layout);
+        delete entry;
+    }
+
+    m_tail = NULL;
+    m_map.clear();
+}
+
+void wxCairoTextLayoutCache::Unlink(Entry* entry)
+{
+    if ( entry->prev )
+        entry->prev->next = entry->next;
+    else
+        m_head = entry->next;
+
+    if ( entry->next )
+        entry->next->prev = entry->prev;
+    else
+        m_tail = entry->prev;
+}
+
+void wxCairoTextLayoutCache::LinkAtHead(Entry* entry)
+{
+    entry->prev = NULL;
+    entry->next = m_head;
+
+    if ( m_head )
+        m_head->prev = entry;
+    else
+        m_tail = entry;
+
+    m_head = entry;
+}
+
+wxCairoTextLayoutCache gs_cairoTextLayoutCache;
+
+// Return the layout for the given text which must be released by the caller.
+PangoLayout* GetTextLayout(cairo_t* cr,
+                           const wxFont& font,
+                           const wxCharBuffer& text)
+{
+    if ( wxIsMainThread() )
+        return gs_cairoTextLayoutCache.Get(cr, font, text);
+
+    return CreateTextLayout(cr, font, text);
+}
+
+} // anonymous namespace
+
+#endif // __WXGTK__
+
+// Clear the caches on shutdown, while their contents can still be destroyed.
+class wxCairoCacheModule : public wxModule
+{
+public:
+    virtual bool OnInit() { return true; }
+    virtual void OnExit()
+    {
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+        gs_cairoBitmapCache.Clear();
+#endif
+#ifdef __WXGTK__
+        gs_cairoTextLayoutCache.Clear();
+#endif
+    }
+
+private:
+    DECLARE_DYNAMIC_CLASS(wxCairoCacheModule)
+};
+
+IMPLEMENT_DYNAMIC_CLASS(wxCairoCacheModule, wxModule)
+
+void wxGetCairoTextCacheStats(unsigned long* hits, unsigned long* misses)
+{
+#ifdef __WXGTK__
+    if ( hits )
+        *hits = gs_cairoTextLayoutCache.GetHits();
+    if ( misses )
+        *misses = gs_cairoTextLayoutCache.GetMisses();
+#else // !__WXGTK__
+    // The text layouts are not cached in the other ports.
+    if ( hits )
+        *hits = 0;
+    if ( misses )
+        *misses = 0;
+#endif // __WXGTK__/!__WXGTK__
+}
+
 //-----------------------------------------------------------------------------
 // wxCairoContext implementation
 //-----------------------------------------------------------------------------
@@ -2098,7 +2619,11 @@ void wxCairoContext::PopState()
 
 void wxCairoContext::DrawBitmap( const wxBitmap &bmp, wxDouble x, wxDouble y, wxDouble w, wxDouble h )
 {
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+    wxGraphicsBitmap bitmap = gs_cairoBitmapCache.Get(GetRenderer(), bmp);
+#else
     wxGraphicsBitmap bitmap = GetRenderer()->CreateBitmap(bmp);
+#endif
     DrawBitmap(bitmap, x, y, w, h);
 
 }
@@ -2153,11 +2678,20 @@ void wxCairoContext::DoDrawText(const wxString& str, wxDouble x, wxDouble y)
     if ( ((wxCairoFontData*)m_font.GetRefData())->Apply(this) )
     {
 #ifdef __WXGTK__
-        PangoLayout *layout = pango_cairo_create_layout (m_context);
         const wxFont& font = static_cast<wxCairoFontData*>(m_font.GetRefData())->GetFont();
-        pango_layout_set_font_description(layout, font.GetNativeFontInfo()->description);
-        pango_layout_set_text(layout, data, data.length());
-        font.GTKSetPangoAttrs(layout);
+
+        // The attributes modify the layout, so don't use the cached one if
+        // they're needed.
+        PangoLayout *layout;
+        if ( font.GetUnderlined() || font.GetStrikethrough() )
+        {
+            layout = CreateTextLayout(m_context, font, data);
+            font.GTKSetPangoAttrs(layout);
+        }
+        else
+        {
+            layout = GetTextLayout(m_context, font, data);
+        }
 
         cairo_move_to(m_context, x, y);
         pango_cairo_show_layout (m_context, layout);
@@ -2200,15 +2734,13 @@ void wxCairoContext::GetTextExtent( const wxString &str, wxDouble *width, wxDoub
 #ifdef __WXGTK__
         int w, h;
 
-        PangoLayout *layout = pango_cairo_create_layout (m_context);
-        const wxFont& font = static_cast<wxCairoFontData*>(m_font.GetRefData())->GetFont();
-        pango_layout_set_font_description(layout, font.GetNativeFontInfo()->description);
         const wxCharBuffer data = str.utf8_str();
         if ( !data )
         {
             return;
         }
-        pango_layout_set_text(layout, data, data.length());
+        const wxFont& font = static_cast<wxCairoFontData*>(m_font.GetRefData())->GetFont();
+        PangoLayout *layout = GetTextLayout(m_context, font, data);
         pango_layout_get_pixel_size (layout, &w, &h);
         if ( width )
             *width = w;
@@ -2268,10 +2800,8 @@ void wxCairoContext::GetPartialTextExtents(const wxString& text, wxArrayDouble&
     int w = 0;
     if (data.length())
     {
-        PangoLayout* layout = pango_cairo_create_layout(m_context);
         const wxFont& font = static_cast<wxCairoFontData*>(m_font.GetRefData())->GetFont();
-        pango_layout_set_font_description(layout, font.GetNativeFontInfo()->description);
-        pango_layout_set_text(layout, data, data.length());
+        PangoLayout* layout = GetTextLayout(m_context, font, data);
         PangoLayoutIter* iter = pango_layout_get_iter(layout);
         PangoRectangle rect;
         do {
@@ -116,7 +116,6 @@ const int DRAG_SENSITIVITY = 3;
 #include "wx/arrimpl.cpp"
 
 WX_DEFINE_OBJARRAY(wxGridCellCoordsArray)
-WX_DEFINE_OBJARRAY(wxGridCellWithAttrArray)
 
 // ----------------------------------------------------------------------------
 // events
@@ -599,131 +598,198 @@ wxGridCellEditor* wxGridCellAttr::GetEditor(const wxGrid* grid, int row, int col
 // wxGridCellAttrData
 // ----------------------------------------------------------------------------
 
+wxGridCellAttrData::~wxGridCellAttrData()
+{
+    for ( Rows::iterator it = m_rows.begin(); it != m_rows.end(); ++it )
+    {
+        RowAttrs * const rowAttrs = *it;
+        FreeCells(rowAttrs->cells, 0, rowAttrs->cells.size());
+        delete rowAttrs;
+    }
+}
+
+size_t wxGridCellAttrData::LowerBoundRow(int row) const
+{
+    size_t lo = 0,
+           hi = m_rows.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( m_rows[mid]->row < row )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* static */
+size_t wxGridCellAttrData::LowerBoundCol(const CellAttrs& cells, int col)
+{
+    size_t lo = 0,
+           hi = cells.size();
+    while ( lo < hi )
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if ( cells[mid].col < col )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    return lo;
+}
+
+/* static */
+void wxGridCellAttrData::FreeCells(CellAttrs& cells, size_t first, size_t last)
+{
+    for ( size_t n = first; n < last; n++ )
+        cells[n].attr->DecRef();
+}
+
 void wxGridCellAttrData::SetAttr(wxGridCellAttr *attr, int row, int col)
 {
-    // Note: contrary to wxGridRowOrColAttrData::SetAttr, we must not
-    //       touch attribute's reference counting explicitly, since this
-    //       is managed by class wxGridCellWithAttr
-    int n = FindIndex(row, col);
-    if ( n == wxNOT_FOUND )
+    // Note: as in wxGridRowOrColAttrData::SetAttr, we take ownership of the
+    //       attribute passed to us, i.e. we don't IncRef() it, and DecRef()
+    //       the attributes we remove or replace
+    const size_t nRow = LowerBoundRow(row);
+    const bool hasRow = nRow < m_rows.size() && m_rows[nRow]->row == row;
+
+    if ( !hasRow )
+    {
+        if ( attr )
+        {
+            // add the attribute to a new row entry
+            RowAttrs * const rowAttrs = new RowAttrs(row);
+
+            CellAttr cellAttr;
+            cellAttr.col = col;
+            cellAttr.attr = attr;
+            rowAttrs->cells.push_back(cellAttr);
+
+            m_rows.insert(m_rows.begin() + nRow, rowAttrs);
+        }
+        //else: nothing to do
+
+        return;
+    }
+
+    RowAttrs * const rowAttrs = m_rows[nRow];
+    CellAttrs& cells = rowAttrs->cells;
+
+    const size_t nCol = LowerBoundCol(cells, col);
+    if ( nCol == cells.size() || cells[nCol].col != col )
     {
         if ( attr )
         {
             // add the attribute
-            m_attrs.Add(new wxGridCellWithAttr(row, col, attr));
+            CellAttr cellAttr;
+            cellAttr.col = col;
+            cellAttr.attr = attr;
+            cells.insert(cells.begin() + nCol, cellAttr);
         }
         //else: nothing to do
     }
     else // we already have an attribute for this cell
     {
+        // see the comment in wxGridRowOrColAttrData::SetAttr() for why this
+        // is correct even if the new attribute is the same as the old one
+        cells[nCol].attr->DecRef();
+
         if ( attr )
         {
             // change the attribute
-            m_attrs[(size_t)n].ChangeAttr(attr);
+            cells[nCol].attr = attr;
         }
         else
         {
-            // remove this attribute
-            m_attrs.RemoveAt((size_t)n);
+            // remove this attribute and the whole row entry if it was the
+            // last one in it
+            cells.erase(cells.begin() + nCol);
+            if ( cells.empty() )
+            {
+                delete rowAttrs;
+                m_rows.erase(m_rows.begin() + nRow);
+            }
         }
     }
 }
 
 wxGridCellAttr *wxGridCellAttrData::GetAttr(int row, int col) const
 {
-    wxGridCellAttr *attr = NULL;
+    const size_t nRow = LowerBoundRow(row);
+    if ( nRow == m_rows.size() || m_rows[nRow]->row != row )
+        return NULL;
 
-    int n = FindIndex(row, col);
-    if ( n != wxNOT_FOUND )
-    {
-        attr = m_attrs[(size_t)n].attr;
-        attr->IncRef();
-    }
+    const CellAttrs& cells = m_rows[nRow]->cells;
+    const size_t nCol = LowerBoundCol(cells, col);
+    if ( nCol == cells.size() || cells[nCol].col != col )
+        return NULL;
+
+    wxGridCellAttr * const attr = cells[nCol].attr;
+    attr->IncRef();
 
     return attr;
 }
 
 void wxGridCellAttrData::UpdateAttrRows( size_t pos, int numRows )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    // all the rows affected by this change are contiguous in m_rows, so find
+    // the first of them
+    size_t n = LowerBoundRow(static_cast<int>(pos));
+
+    if ( numRows < 0 )
     {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord row = coords.GetRow();
-        if ((size_t)row >= pos)
+        // If rows deleted, remove the attributes of all of them...
+        const size_t last = LowerBoundRow(static_cast<int>(pos - numRows));
+        for ( size_t i = n; i < last; i++ )
         {
-            if (numRows > 0)
-            {
-                // If rows inserted, include row counter where necessary
-                coords.SetRow(row + numRows);
-            }
-            else if (numRows < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)row >= pos - numRows)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetRow(row + numRows);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
+            FreeCells(m_rows[i]->cells, 0, m_rows[i]->cells.size());
+            delete m_rows[i];
         }
+
+        m_rows.erase(m_rows.begin() + n, m_rows.begin() + last);
     }
+
+    // ...and shift all the following rows, without touching their cells
+    const size_t count = m_rows.size();
+    for ( ; n < count; n++ )
+        m_rows[n]->row += numRows;
 }
 
 void wxGridCellAttrData::UpdateAttrCols( size_t pos, int numCols )
 {
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
+    for ( size_t n = 0; n < m_rows.size(); )
     {
-        wxGridCellCoords& coords = m_attrs[n].coords;
-        wxCoord col = coords.GetCol();
-        if ( (size_t)col >= pos )
+        CellAttrs& cells = m_rows[n]->cells;
+
+        size_t i = LowerBoundCol(cells, static_cast<int>(pos));
+
+        if ( numCols < 0 )
         {
-            if ( numCols > 0 )
-            {
-                // If rows inserted, include row counter where necessary
-                coords.SetCol(col + numCols);
-            }
-            else if (numCols < 0)
-            {
-                // If rows deleted ...
-                if ((size_t)col >= pos - numCols)
-                {
-                    // ...either decrement row counter (if row still exists)...
-                    coords.SetCol(col + numCols);
-                }
-                else
-                {
-                    // ...or remove the attribute
-                    m_attrs.RemoveAt(n);
-                    n--;
-                    count--;
-                }
-            }
+            // If columns deleted, remove the attributes of their cells...
+            const size_t last = LowerBoundCol(cells,
+                                              static_cast<int>(pos - numCols));
+            FreeCells(cells, i, last);
+            cells.erase(cells.begin() + i, cells.begin() + last);
         }
-    }
-}
 
-int wxGridCellAttrData::FindIndex(int row, int col) const
-{
-    size_t count = m_attrs.GetCount();
-    for ( size_t n = 0; n < count; n++ )
-    {
-        const wxGridCellCoords& coords = m_attrs[n].coords;
-        if ( (coords.GetRow() == row) && (coords.GetCol() == col) )
+        // ...and shift the remaining cells in this row
+        const size_t count = cells.size();
+        for ( ; i < count; i++ )
+            cells[i].col += numCols;
+
+        if ( cells.empty() )
+        {
+            delete m_rows[n];
+            m_rows.erase(m_rows.begin() + n);
+        }
+        else
         {
-            return n;
+            n++;
         }
     }
-
-    return wxNOT_FOUND;
 }
 
 // ----------------------------------------------------------------------------
@@ -1598,6 +1664,783 @@ void wxGridStringTable::SetColLabelValue( int col, const wxString& value )
     m_colLabels[col] = value;
 }
 
+//////////////////////////////////////////////////////////////////////
+//
+// A grid table storing the values of each column in an array of the type
+// of the column instead of storing all of them as strings.
+//
+
+// Base class for the columns of wxGridColumnarTable: it doesn't store the
+// values itself, this is done by the derived classes using the appropriate
+// type.
+class wxGridColumnarTableColumn
+{
+public:
+    enum Kind
+    {
+        Kind_String,
+        Kind_Number,
+        Kind_Float,
+        Kind_Bool
+    };
+
+    wxGridColumnarTableColumn(Kind kind, const wxString& typeName)
+        : m_kind(kind),
+          m_typeName(typeName),
+          m_baseTypeName(typeName.BeforeFirst(wxT(':')))
+    {
+        m_formattedFirst = 0;
+    }
+
+    virtual ~wxGridColumnarTableColumn() { }
+
+    Kind GetKind() const { return m_kind; }
+
+    // the full type name, possibly including the renderer parameters
+    const wxString& GetTypeName() const { return m_typeName; }
+
+    // the type name without any parameters
+    const wxString& GetBaseTypeName() const { return m_baseTypeName; }
+
+    // the label is empty if the default one should be used
+    const wxString& GetLabel() const { return m_label; }
+    void SetLabel(const wxString& label) { m_label = label; }
+
+    virtual void InsertRows(size_t pos, size_t numRows) = 0;
+    virtual void DeleteRows(size_t pos, size_t numRows) = 0;
+    virtual void Clear() = 0;
+
+    virtual bool IsEmpty(size_t row) const = 0;
+    virtual wxString GetValue(size_t row) const = 0;
+    virtual void SetValue(size_t row, const wxString& value) = 0;
+
+    // the strings formatted by the renderers for a range of rows using the
+    // given format, see wxGridColumnarTable::GetFormattedValue()
+    bool GetFormattedValue(size_t row, const wxString& format,
+                           wxString *value) const
+    {
+        if ( row < m_formattedFirst ||
+                row - m_formattedFirst >= m_formattedValues.size() ||
+                    format != m_formattedFormat )
+            return false;
+
+        *value = m_formattedValues[row - m_formattedFirst];
+        return true;
+    }
+
+    void SetFormattedValues(size_t row, const wxString& format,
+                            const wxArrayString& values)
+    {
+        m_formattedFirst = row;
+        m_formattedFormat = format;
+        m_formattedValues = values;
+    }
+
+    // must be called whenever the values change
+    void InvalidateFormattedValues() { m_formattedValues.clear(); }
+
+private:
+    const Kind m_kind;
+    const wxString m_typeName;
+    const wxString m_baseTypeName;
+    wxString m_label;
+
+    size_t m_formattedFirst;
+    wxString m_formattedFormat;
+    wxArrayString m_formattedValues;
+
+    wxDECLARE_NO_COPY_CLASS(wxGridColumnarTableColumn);
+};
+
+namespace
+{
+
+// helpers for storing the values of different types in the columns
+inline wxGridColumnarTableColumn::Kind GetColumnKind(long)
+    { return wxGridColumnarTableColumn::Kind_Number; }
+inline wxGridColumnarTableColumn::Kind GetColumnKind(double)
+    { return wxGridColumnarTableColumn::Kind_Float; }
+inline wxGridColumnarTableColumn::Kind GetColumnKind(bool)
+    { return wxGridColumnarTableColumn::Kind_Bool; }
+
+inline wxString FormatColumnValue(long value)
+    { return wxString::Format(wxT("%ld"), value); }
+inline wxString FormatColumnValue(double value)
+    { return wxString::Format(wxT("%.15g"), value); }
+inline wxString FormatColumnValue(bool value)
+    { return value ? wxString(wxT("1")) : wxString(); }
+
+inline void ParseColumnValue(const wxString& s, long *value)
+{
+    if ( !s.ToLong(value) )
+        *value = 0;
+}
+
+inline void ParseColumnValue(const wxString& s, double *value)
+{
+    if ( !s.ToDouble(value) )
+        *value = 0.;
+}
+
+inline void ParseColumnValue(const wxString& s, bool *value)
+{
+    *value = !s.empty() && s != wxT("0");
+}
+
+inline bool IsEmptyColumnValue(long WXUNUSED(value)) { return false; }
+inline bool IsEmptyColumnValue(double WXUNUSED(value)) { return false; }
+inline bool IsEmptyColumnValue(bool value) { return !value; }
+
+// insert numItems default-initialized elements at the given position
+template <typename T>
+void InsertVectorItems(wxVector<T>& v, size_t pos, size_t numItems)
+{
+    const size_t numOld = v.size();
+    v.resize(numOld + numItems, T());
+
+    for ( size_t n = numOld; n > pos; n-- )
+        v[n + numItems - 1] = v[n - 1];
+
+    for ( size_t n = pos; n < pos + numItems; n++ )
+        v[n] = T();
+}
+
+template <typename T>
+void DeleteVectorItems(wxVector<T>& v, size_t pos, size_t numItems)
+{
+    v.erase(v.begin() + pos, v.begin() + pos + numItems);
+}
+
+// column storing values of type long, double or bool
+template <typename T>
+class wxGridTypedColumn : public wxGridColumnarTableColumn
+{
+public:
+    wxGridTypedColumn(const wxString& typeName, size_t numRows)
+        : wxGridColumnarTableColumn(GetColumnKind(T()), typeName)
+    {
+        m_values.resize(numRows, T());
+    }
+
+    T Get(size_t row) const { return m_values[row]; }
+    void Set(size_t row, T value)
+    {
+        m_values[row] = value;
+
+        InvalidateFormattedValues();
+    }
+
+    void GetRange(size_t row, size_t count, T *values) const
+    {
+        for ( size_t n = 0; n < count; n++ )
+            values[n] = m_values[row + n];
+    }
+
+    void SetRange(size_t row, size_t count, const T *values)
+    {
+        for ( size_t n = 0; n < count; n++ )
+            m_values[row + n] = values[n];
+
+        InvalidateFormattedValues();
+    }
+
+    virtual void InsertRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        InsertVectorItems(m_values, pos, numRows);
+
+        InvalidateFormattedValues();
+    }
+
+    virtual void DeleteRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        DeleteVectorItems(m_values, pos, numRows);
+
+        InvalidateFormattedValues();
+    }
+
+    virtual void Clear() wxOVERRIDE
+    {
+        m_values.assign(m_values.size(), T());
+
+        InvalidateFormattedValues();
+    }
+
+    virtual bool IsEmpty(size_t row) const wxOVERRIDE
+    {
+        return IsEmptyColumnValue(m_values[row]);
+    }
+
+    virtual wxString GetValue(size_t row) const wxOVERRIDE
+    {
+        return FormatColumnValue(m_values[row]);
+    }
+
+    virtual void SetValue(size_t row, const wxString& value) wxOVERRIDE
+    {
+        T t;
+        ParseColumnValue(value, &t);
+        Set(row, t);
+    }
+
+private:
+    wxVector<T> m_values;
+};
+
+WX_DECLARE_STRING_HASH_MAP(unsigned, wxGridStringIndexHashMap);
+
+// column storing strings: as columns often contain many identical strings,
+// each distinct string is only stored once and the column only contains the
+// indices of the strings
+//
+// notice that the strings are never removed from the pool, even when they
+// are not used any more, until the column is cleared
+class wxGridInternedStringColumn : public wxGridColumnarTableColumn
+{
+public:
+    wxGridInternedStringColumn(const wxString& typeName, size_t numRows)
+        : wxGridColumnarTableColumn(Kind_String, typeName)
+    {
+        m_indices.resize(numRows, 0);
+
+        InitStrings();
+    }
+
+    virtual void InsertRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        InsertVectorItems(m_indices, pos, numRows);
+    }
+
+    virtual void DeleteRows(size_t pos, size_t numRows) wxOVERRIDE
+    {
+        DeleteVectorItems(m_indices, pos, numRows);
+    }
+
+    virtual void Clear() wxOVERRIDE
+    {
+        m_indices.assign(m_indices.size(), 0);
+
+        m_strings.clear();
+        m_stringIndices.clear();
+        InitStrings();
+    }
+
+    virtual bool IsEmpty(size_t row) const wxOVERRIDE
+    {
+        return m_indices[row] == 0;
+    }
+
+    virtual wxString GetValue(size_t row) const wxOVERRIDE
+    {
+        return m_strings[m_indices[row]];
+    }
+
+    virtual void SetValue(size_t row, const wxString& value) wxOVERRIDE
+    {
+        wxGridStringIndexHashMap::const_iterator it = m_stringIndices.find(value);
+        if ( it != m_stringIndices.end() )
+        {
+            m_indices[row] = it->second;
+            return;
+        }
+
+        const unsigned index = m_strings.size();
+        m_strings.push_back(value);
+        m_stringIndices[value] = index;
+
+        m_indices[row] = index;
+    }
+
+private:
+    // the empty string, used for all the new cells, always has index 0
+    void InitStrings()
+    {
+        m_strings.push_back(wxString());
+        m_stringIndices[wxString()] = 0;
+    }
+
+    wxVector<unsigned> m_indices;
+    wxArrayString m_strings;
+    wxGridStringIndexHashMap m_stringIndices;
+};
+
+// create a column of the given type, return NULL if the type is unsupported
+wxGridColumnarTableColumn *
+CreateColumnarTableColumn(const wxString& typeName, size_t numRows)
+{
+    const wxString baseTypeName = typeName.BeforeFirst(wxT(':'));
+    if ( baseTypeName == wxGRID_VALUE_STRING )
+        return new wxGridInternedStringColumn(typeName, numRows);
+    if ( baseTypeName == wxGRID_VALUE_NUMBER )
+        return new wxGridTypedColumn<long>(typeName, numRows);
+    if ( baseTypeName == wxGRID_VALUE_FLOAT )
+        return new wxGridTypedColumn<double>(typeName, numRows);
+    if ( baseTypeName == wxGRID_VALUE_BOOL )
+        return new wxGridTypedColumn<bool>(typeName, numRows);
+
+    return NULL;
+}
+
+// return the column as a column of the given type or NULL if it's NULL
+// itself or of a different type
+template <typename T>
+wxGridTypedColumn<T> *GetTypedColumn(wxGridColumnarTableColumn *column)
+{
+    if ( !column || column->GetKind() != GetColumnKind(T()) )
+        return NULL;
+
+    return static_cast<wxGridTypedColumn<T> *>(column);
+}
+
+template <typename T>
+bool GetTypedColumnRange(wxGridColumnarTableColumn *column, size_t numRows,
+                         int row, int count, T *values)
+{
+    wxGridTypedColumn<T> * const typedColumn = GetTypedColumn<T>(column);
+    wxCHECK_MSG( typedColumn, false,
+                 wxT("invalid column index or type in wxGridColumnarTable") );
+    wxCHECK_MSG( row >= 0 && count >= 0 &&
+                 static_cast<size_t>(row) + count <= numRows, false,
+                 wxT("invalid rows range in wxGridColumnarTable") );
+
+    typedColumn->GetRange(row, count, values);
+
+    return true;
+}
+
+template <typename T>
+bool SetTypedColumnRange(wxGridColumnarTableColumn *column, size_t numRows,
+                         int row, int count, const T *values)
+{
+    wxGridTypedColumn<T> * const typedColumn = GetTypedColumn<T>(column);
+    wxCHECK_MSG( typedColumn, false,
+                 wxT("invalid column index or type in wxGridColumnarTable") );
+    wxCHECK_MSG( row >= 0 && count >= 0 &&
+                 static_cast<size_t>(row) + count <= numRows, false,
+                 wxT("invalid rows range in wxGridColumnarTable") );
+
+    typedColumn->SetRange(row, count, values);
+
+    return true;
+}
+
+} // anonymous namespace
+
+IMPLEMENT_DYNAMIC_CLASS( wxGridColumnarTable, wxGridTableBase )
+
+wxGridColumnarTable::wxGridColumnarTable()
+        : wxGridTableBase()
+{
+    m_numRows = 0;
+}
+
+wxGridColumnarTable::wxGridColumnarTable( int numRows )
+        : wxGridTableBase()
+{
+    m_numRows = numRows;
+}
+
+wxGridColumnarTable::~wxGridColumnarTable()
+{
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        delete m_cols[col];
+}
+
+wxGridColumnarTableColumn *wxGridColumnarTable::GetCol( int col ) const
+{
+    if ( col < 0 || static_cast<size_t>(col) >= m_cols.size() )
+        return NULL;
+
+    return m_cols[col];
+}
+
+wxGridColumnarTableColumn *
+wxGridColumnarTable::GetCellCol( int row, int col ) const
+{
+    if ( row < 0 || static_cast<size_t>(row) >= m_numRows )
+        return NULL;
+
+    return GetCol(col);
+}
+
+void wxGridColumnarTable::NotifyView( int id, int comInt1, int comInt2 )
+{
+    if ( GetView() )
+    {
+        wxGridTableMessage msg( this, id, comInt1, comInt2 );
+
+        GetView()->ProcessTableMessage( msg );
+    }
+}
+
+wxString wxGridColumnarTable::GetValue( int row, int col )
+{
+    wxGridColumnarTableColumn * const column = GetCellCol(row, col);
+    wxCHECK_MSG( column, wxEmptyString,
+                 wxT("invalid row or column index in wxGridColumnarTable") );
+
+    return column->GetValue(row);
+}
+
+void wxGridColumnarTable::SetValue( int row, int col, const wxString& value )
+{
+    wxGridColumnarTableColumn * const column = GetCellCol(row, col);
+    wxCHECK_RET( column,
+                 wxT("invalid row or column index in wxGridColumnarTable") );
+
+    column->SetValue(row, value);
+}
+
+bool wxGridColumnarTable::IsEmptyCell( int row, int col )
+{
+    wxGridColumnarTableColumn * const column = GetCellCol(row, col);
+    wxCHECK_MSG( column, true,
+                 wxT("invalid row or column index in wxGridColumnarTable") );
+
+    return column->IsEmpty(row);
+}
+
+wxString wxGridColumnarTable::GetTypeName( int row, int col )
+{
+    wxGridColumnarTableColumn * const column = GetCellCol(row, col);
+    wxCHECK_MSG( column, wxGRID_VALUE_STRING,
+                 wxT("invalid row or column index in wxGridColumnarTable") );
+
+    return column->GetTypeName();
+}
+
+bool wxGridColumnarTable::CanGetValueAs( int row, int col,
+                                         const wxString& typeName )
+{
+    wxGridColumnarTableColumn * const column = GetCellCol(row, col);
+    if ( !column )
+        return false;
+
+    // all values can be retrieved as strings
+    return typeName == wxGRID_VALUE_STRING ||
+                typeName == column->GetBaseTypeName();
+}
+
+long wxGridColumnarTable::GetValueAsLong( int row, int col )
+{
+    wxGridTypedColumn<long> * const column =
+        GetTypedColumn<long>(GetCellCol(row, col));
+    wxCHECK_MSG( column, 0,
+                 wxT("invalid cell or column type in wxGridColumnarTable") );
+
+    return column->Get(row);
+}
+
+double wxGridColumnarTable::GetValueAsDouble( int row, int col )
+{
+    wxGridTypedColumn<double> * const column =
+        GetTypedColumn<double>(GetCellCol(row, col));
+    wxCHECK_MSG( column, 0.,
+                 wxT("invalid cell or column type in wxGridColumnarTable") );
+
+    return column->Get(row);
+}
+
+bool wxGridColumnarTable::GetValueAsBool( int row, int col )
+{
+    wxGridTypedColumn<bool> * const column =
+        GetTypedColumn<bool>(GetCellCol(row, col));
+    wxCHECK_MSG( column, false,
+                 wxT("invalid cell or column type in wxGridColumnarTable") );
+
+    return column->Get(row);
+}
+
+void wxGridColumnarTable::SetValueAsLong( int row, int col, long value )
+{
+    wxGridTypedColumn<long> * const column =
+        GetTypedColumn<long>(GetCellCol(row, col));
+    wxCHECK_RET( column,
+                 wxT("invalid cell or column type in wxGridColumnarTable") );
+
+    column->Set(row, value);
+}
+
+void wxGridColumnarTable::SetValueAsDouble( int row, int col, double value )
+{
+    wxGridTypedColumn<double> * const column =
+        GetTypedColumn<double>(GetCellCol(row, col));
+    wxCHECK_RET( column,
+                 wxT("invalid cell or column type in wxGridColumnarTable") );
+
+    column->Set(row, value);
+}
+
+void wxGridColumnarTable::SetValueAsBool( int row, int col, bool value )
+{
+    wxGridTypedColumn<bool> * const column =
+        GetTypedColumn<bool>(GetCellCol(row, col));
+    wxCHECK_RET( column,
+                 wxT("invalid cell or column type in wxGridColumnarTable") );
+
+    column->Set(row, value);
+}
+
+bool wxGridColumnarTable::GetColValuesAsLong( int col, int row, int count,
+                                              long *values ) const
+{
+    return GetTypedColumnRange(GetCol(col), m_numRows, row, count, values);
+}
+
+bool wxGridColumnarTable::GetColValuesAsDouble( int col, int row, int count,
+                                                double *values ) const
+{
+    return GetTypedColumnRange(GetCol(col), m_numRows, row, count, values);
+}
+
+bool wxGridColumnarTable::GetColValuesAsBool( int col, int row, int count,
+                                              bool *values ) const
+{
+    return GetTypedColumnRange(GetCol(col), m_numRows, row, count, values);
+}
+
+bool wxGridColumnarTable::SetColValuesAsLong( int col, int row, int count,
+                                              const long *values )
+{
+    return SetTypedColumnRange(GetCol(col), m_numRows, row, count, values);
+}
+
+bool wxGridColumnarTable::SetColValuesAsDouble( int col, int row, int count,
+                                                const double *values )
+{
+    return SetTypedColumnRange(GetCol(col), m_numRows, row, count, values);
+}
+
+bool wxGridColumnarTable::SetColValuesAsBool( int col, int row, int count,
+                                              const bool *values )
+{
+    return SetTypedColumnRange(GetCol(col), m_numRows, row, count, values);
+}
+
+bool wxGridColumnarTable::GetFormattedValue( int row, int col,
+                                             const wxString& format,
+                                             wxString *value ) const
+{
+    wxGridColumnarTableColumn * const column = GetCellCol(row, col);
+    wxCHECK_MSG( column && value, false,
+                 wxT("invalid cell in wxGridColumnarTable") );
+
+    return column->GetFormattedValue(row, format, value);
+}
+
+void wxGridColumnarTable::SetFormattedValues( int col, int row,
+                                              const wxString& format,
+                                              const wxArrayString& values )
+{
+    wxGridColumnarTableColumn * const column = GetCol(col);
+    wxCHECK_RET( column && row >= 0 &&
+                 static_cast<size_t>(row) + values.size() <= m_numRows,
+                 wxT("invalid rows range in wxGridColumnarTable") );
+
+    column->SetFormattedValues(row, format, values);
+}
+
+void wxGridColumnarTable::Clear()
+{
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        m_cols[col]->Clear();
+}
+
+bool wxGridColumnarTable::InsertRows( size_t pos, size_t numRows )
+{
+    if ( pos >= m_numRows )
+    {
+        return AppendRows( numRows );
+    }
+
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        m_cols[col]->InsertRows( pos, numRows );
+
+    m_numRows += numRows;
+
+    NotifyView( wxGRIDTABLE_NOTIFY_ROWS_INSERTED, pos, numRows );
+
+    return true;
+}
+
+bool wxGridColumnarTable::AppendRows( size_t numRows )
+{
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        m_cols[col]->InsertRows( m_numRows, numRows );
+
+    m_numRows += numRows;
+
+    NotifyView( wxGRIDTABLE_NOTIFY_ROWS_APPENDED, numRows );
+
+    return true;
+}
+
+bool wxGridColumnarTable::DeleteRows( size_t pos, size_t numRows )
+{
+    if ( pos >= m_numRows )
+    {
+        wxFAIL_MSG( wxString::Format
+                    (
+                        wxT("Called wxGridColumnarTable::DeleteRows(pos=%lu, N=%lu)\nPos value is invalid for present table with %lu rows"),
+                        (unsigned long)pos,
+                        (unsigned long)numRows,
+                        (unsigned long)m_numRows
+                    ) );
+
+        return false;
+    }
+
+    if ( numRows > m_numRows - pos )
+    {
+        numRows = m_numRows - pos;
+    }
+
+    for ( size_t col = 0; col < m_cols.size(); col++ )
+        m_cols[col]->DeleteRows( pos, numRows );
+
+    m_numRows -= numRows;
+
+    NotifyView( wxGRIDTABLE_NOTIFY_ROWS_DELETED, pos, numRows );
+
+    return true;
+}
+
+bool wxGridColumnarTable::DoInsertTypedCols( const wxString& typeName,
+                                             size_t pos, size_t numCols )
+{
+    for ( size_t n = 0; n < numCols; n++ )
+    {
+        wxGridColumnarTableColumn * const
+            column = CreateColumnarTableColumn( typeName, m_numRows );
+        wxCHECK_MSG( column, false,
+                     wxT("unsupported column type in wxGridColumnarTable") );
+
+        m_cols.insert( m_cols.begin() + pos + n, column );
+    }
+
+    return true;
+}
+
+bool wxGridColumnarTable::InsertTypedCols( const wxString& typeName,
+                                           size_t pos, size_t numCols )
+{
+    if ( pos >= m_cols.size() )
+    {
+        return AppendTypedCols( typeName, numCols );
+    }
+
+    if ( !DoInsertTypedCols( typeName, pos, numCols ) )
+        return false;
+
+    NotifyView( wxGRIDTABLE_NOTIFY_COLS_INSERTED, pos, numCols );
+
+    return true;
+}
+
+bool wxGridColumnarTable::AppendTypedCols( const wxString& typeName,
+                                           size_t numCols )
+{
+    if ( !DoInsertTypedCols( typeName, m_cols.size(), numCols ) )
+        return false;
+
+    NotifyView( wxGRIDTABLE_NOTIFY_COLS_APPENDED, numCols );
+
+    return true;
+}
+
+bool wxGridColumnarTable::InsertCols( size_t pos, size_t numCols )
+{
+    return InsertTypedCols( wxGRID_VALUE_STRING, pos, numCols );
+}
+
+bool wxGridColumnarTable::AppendCols( size_t numCols )
+{
+    return AppendTypedCols( wxGRID_VALUE_STRING, numCols );
+}
+
+bool wxGridColumnarTable::DeleteCols( size_t pos, size_t numCols )
+{
+    const size_t curNumCols = m_cols.size();
+
+    if ( pos >= curNumCols )
+    {
+        wxFAIL_MSG( wxString::Format
+                    (
+                        wxT("Called wxGridColumnarTable::DeleteCols(pos=%lu, N=%lu)\nPos value is invalid for present table with %lu cols"),
+                        (unsigned long)pos,
+                        (unsigned long)numCols,
+                        (unsigned long)curNumCols
+                    ) );
+        return false;
+    }
+
+    if ( numCols > curNumCols - pos )
+    {
+        numCols = curNumCols - pos;
+    }
+
+    for ( size_t col = pos; col < pos + numCols; col++ )
+        delete m_cols[col];
+
+    m_cols.erase( m_cols.begin() + pos, m_cols.begin() + pos + numCols );
+
+    NotifyView( wxGRIDTABLE_NOTIFY_COLS_DELETED, pos, numCols );
+
+    return true;
+}
+
+wxString wxGridColumnarTable::GetRowLabelValue( int row )
+{
+    if ( row > (int)(m_rowLabels.GetCount()) - 1 )
+    {
+        // using default label
+        //
+        return wxGridTableBase::GetRowLabelValue( row );
+    }
+    else
+    {
+        return m_rowLabels[row];
+    }
+}
+
+wxString wxGridColumnarTable::GetColLabelValue( int col )
+{
+    wxGridColumnarTableColumn * const column = GetCol(col);
+    if ( !column || column->GetLabel().empty() )
+    {
+        // using default label
+        //
+        return wxGridTableBase::GetColLabelValue( col );
+    }
+    else
+    {
+        return column->GetLabel();
+    }
+}
+
+void wxGridColumnarTable::SetRowLabelValue( int row, const wxString& value )
+{
+    if ( row > (int)(m_rowLabels.GetCount()) - 1 )
+    {
+        int n = m_rowLabels.GetCount();
+        int i;
+
+        for ( i = n; i <= row; i++ )
+        {
+            m_rowLabels.Add( wxGridTableBase::GetRowLabelValue(i) );
+        }
+    }
+
+    m_rowLabels[row] = value;
+}
+
+void wxGridColumnarTable::SetColLabelValue( int col, const wxString& value )
+{
+    wxGridColumnarTableColumn * const column = GetCol(col);
+    wxCHECK_RET( column, wxT("invalid column index in wxGridColumnarTable") );
+
+    column->SetLabel( value );
+}
+
 
 //////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
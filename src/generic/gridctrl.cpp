@@ -30,6 +30,68 @@
 
 #include "wx/tokenzr.h"
 #include "wx/renderer.h"
+#include "wx/vector.h"
+
+namespace
+{
+
+inline bool GetColumnValues(const wxGridColumnarTable& table,
+                            int col, int row, int count, long *values)
+{
+    return table.GetColValuesAsLong(col, row, count, values);
+}
+
+inline bool GetColumnValues(const wxGridColumnarTable& table,
+                            int col, int row, int count, double *values)
+{
+    return table.GetColValuesAsDouble(col, row, count, values);
+}
+
+// If the grid uses wxGridColumnarTable and the cell is of the given type,
+// return its value formatted using the given format. The values of all the
+// visible rows of the column (or of the same number of rows starting at this
+// one, if it's not visible) are retrieved and formatted at once and cached in
+// the table, so that they are not formatted again when redrawing the grid.
+template <typename T>
+bool GetColumnarTableString(const wxGrid& grid, int row, int col,
+                            const wxString& typeName, const wxString& format,
+                            wxString& text)
+{
+    wxGridColumnarTable * const
+        table = wxDynamicCast(grid.GetTable(), wxGridColumnarTable);
+    if ( !table || !table->CanGetValueAs(row, col, typeName) )
+        return false;
+
+    if ( table->GetFormattedValue(row, col, format, &text) )
+        return true;
+
+    int x, y;
+    grid.CalcUnscrolledPosition(0, 0, &x, &y);
+    const int height = grid.GetGridWindow()->GetClientSize().y;
+
+    int first = grid.YToRow(y, true);
+    int count = grid.YToRow(y + height, true) - first + 1;
+    if ( row < first || row >= first + count )
+        first = row;
+    count = wxMin(count, table->GetNumberRows() - first);
+
+    wxVector<T> values(count);
+    if ( !GetColumnValues(*table, col, first, count, &values[0]) )
+        return false;
+
+    wxArrayString strings;
+    strings.reserve(count);
+    for ( int n = 0; n < count; n++ )
+        strings.push_back(wxString::Format(format, values[n]));
+
+    table->SetFormattedValues(col, first, format, strings);
+
+    text = strings[row - first];
+
+    return true;
+}
+
+} // anonymous namespace
 
 
 // ----------------------------------------------------------------------------
@@ -661,8 +723,12 @@ void wxGridCellStringRenderer::Draw(wxGrid& grid,
 
 wxString wxGridCellNumberRenderer::GetString(const wxGrid& grid, int row, int col)
 {
-    wxGridTableBase *table = grid.GetTable();
     wxString text;
+    if ( GetColumnarTableString<long>(grid, row, col, wxGRID_VALUE_NUMBER,
+                                      wxT("%ld"), text) )
+        return text;
+
+    wxGridTableBase *table = grid.GetTable();
     if ( table->CanGetValueAs(row, col, wxGRID_VALUE_NUMBER) )
     {
         text.Printf(wxT("%ld"), table->GetValueAsLong(row, col));
@@ -731,11 +797,48 @@ wxGridCellRenderer *wxGridCellFloatRenderer::Clone() const
 
 wxString wxGridCellFloatRenderer::GetString(const wxGrid& grid, int row, int col)
 {
+    if ( !m_format )
+    {
+        if ( m_width == -1 )
+        {
+            if ( m_precision == -1 )
+            {
+                // default width/precision
+                m_format = wxT("%");
+            }
+            else
+            {
+                m_format.Printf(wxT("%%.%d"), m_precision);
+            }
+        }
+        else if ( m_precision == -1 )
+        {
+            // default precision
+            m_format.Printf(wxT("%%%d."), m_width);
+        }
+        else
+        {
+            m_format.Printf(wxT("%%%d.%d"), m_width, m_precision);
+        }
+
+        bool isUpper = ( ( m_style & wxGRID_FLOAT_FORMAT_UPPER ) == wxGRID_FLOAT_FORMAT_UPPER);
+        if ( ( m_style & wxGRID_FLOAT_FORMAT_SCIENTIFIC ) == wxGRID_FLOAT_FORMAT_SCIENTIFIC)
+            m_format += isUpper ? wxT('E') : wxT('e');
+        else if ( ( m_style & wxGRID_FLOAT_FORMAT_COMPACT ) == wxGRID_FLOAT_FORMAT_COMPACT)
+            m_format += isUpper ? wxT('G') : wxT('g');
+        else
+            m_format += wxT('f');
+    }
+
+    wxString text;
+    if ( GetColumnarTableString<double>(grid, row, col, wxGRID_VALUE_FLOAT,
+                                        m_format, text) )
+        return text;
+
     wxGridTableBase *table = grid.GetTable();
 
     bool hasDouble;
     double val;
-    wxString text;
     if ( table->CanGetValueAs(row, col, wxGRID_VALUE_FLOAT) )
     {
         val = table->GetValueAsDouble(row, col);
@@ -749,39 +852,6 @@ wxString wxGridCellFloatRenderer::GetString(const wxGrid& grid, int row, int col
 
     if ( hasDouble )
     {
-        if ( !m_format )
-        {
-            if ( m_width == -1 )
-            {
-                if ( m_precision == -1 )
-                {
-                    // default width/precision
-                    m_format = wxT("%");
-                }
-                else
-                {
-                    m_format.Printf(wxT("%%.%d"), m_precision);
-                }
-            }
-            else if ( m_precision == -1 )
-            {
-                // default precision
-                m_format.Printf(wxT("%%%d."), m_width);
-            }
-            else
-            {
-                m_format.Printf(wxT("%%%d.%d"), m_width, m_precision);
-            }
-
-            bool isUpper = ( ( m_style & wxGRID_FLOAT_FORMAT_UPPER ) == wxGRID_FLOAT_FORMAT_UPPER);
-            if ( ( m_style & wxGRID_FLOAT_FORMAT_SCIENTIFIC ) == wxGRID_FLOAT_FORMAT_SCIENTIFIC)
-                m_format += isUpper ? wxT('E') : wxT('e');
-            else if ( ( m_style & wxGRID_FLOAT_FORMAT_COMPACT ) == wxGRID_FLOAT_FORMAT_COMPACT)
-                m_format += isUpper ? wxT('G') : wxT('g');
-            else
-                m_format += wxT('f');
-        }
-
         text.Printf(m_format, val);
 
     }
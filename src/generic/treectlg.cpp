@@ -397,6 +397,42 @@ IsDescendantOf(const wxGenericTreeItem *parent, const wxGenericTreeItem *item)
     return false;
 }
 
+// return the item which is shown above the other one, both items must be
+// shown, i.e. all their parents must be expanded
+static wxGenericTreeItem *
+GetUpperItem(wxGenericTreeItem *item1, wxGenericTreeItem *item2)
+{
+    size_t depth1 = 0,
+           depth2 = 0;
+    wxGenericTreeItem *i;
+    for ( i = item1->GetParent(); i; i = i->GetParent() )
+        depth1++;
+    for ( i = item2->GetParent(); i; i = i->GetParent() )
+        depth2++;
+
+    // bring both items to the same level
+    wxGenericTreeItem *i1 = item1,
+                      *i2 = item2;
+    for ( ; depth1 > depth2; depth1-- )
+        i1 = i1->GetParent();
+    for ( ; depth2 > depth1; depth2-- )
+        i2 = i2->GetParent();
+
+    // if one of the items is an ancestor of the other one, it comes first
+    if ( i1 == i2 )
+        return i1;
+
+    // otherwise compare the positions of their ancestors with the same parent
+    while ( i1->GetParent() != i2->GetParent() )
+    {
+        i1 = i1->GetParent();
+        i2 = i2->GetParent();
+    }
+
+    const wxArrayGenericTreeItems& siblings = i1->GetParent()->GetChildren();
+    return siblings.Index(i1) < siblings.Index(i2) ? item1 : item2;
+}
+
 // -----------------------------------------------------------------------------
 // wxTreeRenameTimer (internal)
 // -----------------------------------------------------------------------------
@@ -928,6 +964,7 @@ void wxGenericTreeCtrl::Init()
     m_select_me = NULL;
     m_hasFocus = false;
     m_dirty = false;
+    m_dirtyItem = NULL;
 
     m_lineHeight = 10;
     m_indent = 15;
@@ -1083,7 +1120,7 @@ unsigned int wxGenericTreeCtrl::GetCount() const
 void wxGenericTreeCtrl::SetIndent(unsigned int indent)
 {
     m_indent = (unsigned short) indent;
-    m_dirty = true;
+    InvalidatePositions();
 }
 
 size_t
@@ -1103,14 +1140,13 @@ void wxGenericTreeCtrl::SetWindowStyle(const long styles)
         // if we will hide the root, make sure children are visible
         m_anchor->SetHasPlus();
         m_anchor->Expand();
-        CalculatePositions();
     }
 
     // right now, just sets the styles.  Eventually, we may
     // want to update the inherited styles, but right now
     // none of the parents has updatable styles
     m_windowStyle = styles;
-    m_dirty = true;
+    InvalidatePositions();
 }
 
 // -----------------------------------------------------------------------------
@@ -1180,6 +1216,7 @@ wxGenericTreeCtrl::SetItemText(const wxTreeItemId& item, const wxString& text)
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->SetText(text);
     pItem->CalculateSize(this);
+    UpdateItemHeight(pItem);
     RefreshLine(pItem);
 }
 
@@ -1192,6 +1229,7 @@ void wxGenericTreeCtrl::SetItemImage(const wxTreeItemId& item,
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->SetImage(image, which);
     pItem->CalculateSize(this);
+    UpdateItemHeight(pItem);
     RefreshLine(pItem);
 }
 
@@ -1213,6 +1251,7 @@ void wxGenericTreeCtrl::DoSetItemState(const wxTreeItemId& item, int state)
     wxGenericTreeItem *pItem = (wxGenericTreeItem*) item.m_pItem;
     pItem->SetState(state);
     pItem->CalculateSize(this);
+    UpdateItemHeight(pItem);
     RefreshLine(pItem);
 }
 
@@ -1238,6 +1277,7 @@ void wxGenericTreeCtrl::SetItemBold(const wxTreeItemId& item, bool bold)
         // recalculate the item size as bold and non bold fonts have different
         // widths
         pItem->CalculateSize(this);
+        UpdateItemHeight(pItem);
         RefreshLine(pItem);
     }
 }
@@ -1290,6 +1330,7 @@ wxGenericTreeCtrl::SetItemFont(const wxTreeItemId& item, const wxFont& font)
     pItem->Attr().SetFont(font);
     pItem->ResetTextSize();
     pItem->CalculateSize(this);
+    UpdateItemHeight(pItem);
     RefreshLine(pItem);
 }
 
@@ -1301,7 +1342,10 @@ bool wxGenericTreeCtrl::SetFont( const wxFont &font )
     m_boldFont = m_normalFont.Bold();
 
     if (m_anchor)
+    {
         m_anchor->RecursiveResetTextSize();
+        InvalidatePositions();
+    }
 
     return true;
 }
@@ -1665,10 +1709,56 @@ wxTreeItemId wxGenericTreeCtrl::DoInsertItem(const wxTreeItemId& parentId,
     parent->Insert( item, previous == (size_t)-1 ? parent->GetChildren().size()
                                                  : previous );
 
+    if ( parent->IsExpanded() )
+        InvalidatePositions(parent);
+
     InvalidateBestSize();
     return item;
 }
 
+void wxGenericTreeCtrl::DoInsertItems(const wxTreeItemId& parentId,
+                                      size_t pos,
+                                      const wxArrayString& texts,
+                                      int image,
+                                      int selImage,
+                                      wxArrayTreeItemIds *ids)
+{
+    wxGenericTreeItem *parent = (wxGenericTreeItem*) parentId.m_pItem;
+    wxCHECK_RET( parent, "can't insert items without parent" );
+
+    const size_t count = texts.size();
+    if ( !count )
+        return;
+
+    m_dirty = true;     // do this first so stuff below doesn't cause flicker
+
+    wxArrayGenericTreeItems& children = parent->GetChildren();
+    if ( pos == (size_t)-1 || pos > children.size() )
+        pos = children.size();
+
+    // Make room for all the new items at once instead of moving the
+    // following items for each of them.
+    children.Insert(NULL, pos, count);
+
+    if ( ids )
+        ids->Alloc(ids->size() + count);
+
+    for ( size_t n = 0; n < count; n++ )
+    {
+        wxGenericTreeItem * const
+            item = new wxGenericTreeItem(parent, texts[n], image, selImage, NULL);
+        children[pos + n] = item;
+
+        if ( ids )
+            ids->Add(item);
+    }
+
+    if ( parent->IsExpanded() )
+        InvalidatePositions(parent);
+
+    InvalidateBestSize();
+}
+
 wxTreeItemId wxGenericTreeCtrl::AddRoot(const wxString& text,
                                         int image,
                                         int selImage,
@@ -1691,9 +1781,10 @@ wxTreeItemId wxGenericTreeCtrl::AddRoot(const wxString& text,
         // into children
         m_anchor->SetHasPlus();
         m_anchor->Expand();
-        CalculatePositions();
     }
 
+    InvalidatePositions();
+
     if (!HasFlag(wxTR_MULTIPLE))
     {
         m_current = m_key_current = m_anchor;
@@ -1770,6 +1861,8 @@ void wxGenericTreeCtrl::DeleteChildren(const wxTreeItemId& itemId)
 
     wxGenericTreeItem *item = (wxGenericTreeItem*) itemId.m_pItem;
     ChildrenClosing(item);
+    if ( item->IsExpanded() )
+        InvalidatePositions(item);
     item->DeleteChildren(this);
     InvalidateBestSize();
 }
@@ -1830,12 +1923,18 @@ void wxGenericTreeCtrl::Delete(const wxTreeItemId& itemId)
     // remove the item from the tree
     if ( parent )
     {
+        // this must be done before removing it as it also ensures that
+        // m_dirtyItem doesn't point to the item being deleted
+        if ( parent->IsExpanded() )
+            InvalidatePositions(parent);
+
         parent->GetChildren().Remove( item );  // remove by value
     }
     else // deleting the root
     {
         // nothing will be left in the tree
         m_anchor = NULL;
+        m_dirtyItem = NULL;
     }
 
     // and delete all of its children and the item itself now
@@ -1881,16 +1980,10 @@ void wxGenericTreeCtrl::Expand(const wxTreeItemId& itemId)
     }
 
     item->Expand();
-    if ( !IsFrozen() )
-    {
-        CalculatePositions();
 
-        RefreshSubtree(item);
-    }
-    else // frozen
-    {
-        m_dirty = true;
-    }
+    // don't recalculate the positions immediately, this will be done when
+    // needed, so that expanding many items at once doesn't take too long
+    InvalidatePositions(item);
 
     event.SetEventType(wxEVT_TREE_ITEM_EXPANDED);
     GetEventHandler()->ProcessEvent( event );
@@ -1925,9 +2018,7 @@ void wxGenericTreeCtrl::Collapse(const wxTreeItemId& itemId)
     }
 #endif
 
-    CalculatePositions();
-
-    RefreshSubtree(item);
+    InvalidatePositions(item);
 
     event.SetEventType(wxEVT_TREE_ITEM_COLLAPSED);
     GetEventHandler()->ProcessEvent( event );
@@ -2105,6 +2196,9 @@ wxGenericTreeCtrl::SelectItemRange(wxGenericTreeItem *item1,
 {
     m_select_me = NULL;
 
+    // the items positions may be out of date if the layout was deferred
+    CalculatePositions();
+
     // item2 is not necessary after item1
     // choice first' and 'last' between item1 and item2
     wxGenericTreeItem *first= (item1->GetY()<item2->GetY()) ? item1 : item2;
@@ -2308,6 +2402,9 @@ void wxGenericTreeCtrl::ScrollTo(const wxTreeItemId &item)
 #endif
     }
         
+    // the above doesn't update the layout if we're frozen
+    CalculatePositions();
+
     wxGenericTreeItem *gitem = (wxGenericTreeItem*) item.m_pItem;
 
     int itemY = gitem->GetY();
@@ -2364,7 +2461,10 @@ void wxGenericTreeCtrl::SortChildren(const wxTreeItemId& itemId)
     wxArrayGenericTreeItems& children = item->GetChildren();
     if ( children.GetCount() > 1 )
     {
-        m_dirty = true;
+        if ( item->IsExpanded() )
+            InvalidatePositions(item);
+        else
+            m_dirty = true;
 
         s_treeBeingSorted = this;
         children.Sort(tree_ctrl_compare_func);
@@ -2431,7 +2531,7 @@ void wxGenericTreeCtrl::SetImageList(wxImageList *imageList)
     if (m_ownsImageListNormal) delete m_imageListNormal;
     m_imageListNormal = imageList;
     m_ownsImageListNormal = false;
-    m_dirty = true;
+    InvalidatePositions();
 
     if (m_anchor)
         m_anchor->RecursiveResetSize();
@@ -2447,7 +2547,7 @@ void wxGenericTreeCtrl::SetStateImageList(wxImageList *imageList)
     if (m_ownsImageListState) delete m_imageListState;
     m_imageListState = imageList;
     m_ownsImageListState = false;
-    m_dirty = true;
+    InvalidatePositions();
 
     if (m_anchor)
         m_anchor->RecursiveResetSize();
@@ -2463,7 +2563,7 @@ void wxGenericTreeCtrl::SetButtonsImageList(wxImageList *imageList)
     if (m_ownsImageListButtons) delete m_imageListButtons;
     m_imageListButtons = imageList;
     m_ownsImageListButtons = false;
-    m_dirty = true;
+    InvalidatePositions();
 
     if (m_anchor)
         m_anchor->RecursiveResetSize();
@@ -2728,6 +2828,47 @@ void wxGenericTreeCtrl::PaintItem(wxGenericTreeItem *item, wxDC& dc)
     }
 }
 
+void
+wxGenericTreeCtrl::PaintChildren(wxGenericTreeItem *item,
+                                 wxDC &dc,
+                                 int level,
+                                 int &y)
+{
+    wxArrayGenericTreeItems& children = item->GetChildren();
+    const int count = children.GetCount();
+
+    // find the visible part of the tree in logical coordinates
+    int yTop;
+    CalcUnscrolledPosition(0, 0, NULL, &yTop);
+    const int yBottom = yTop + GetClientSize().y;
+
+    // skip all children above the visible part: as the subtree of each child
+    // ends where the next child starts, we need to start painting from the
+    // last child starting above it
+    int lo = 0,
+        hi = count;
+    while ( lo < hi )
+    {
+        const int mid = lo + (hi - lo)/2;
+        if ( children[mid]->GetY() <= yTop )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+
+    for ( int n = lo > 0 ? lo - 1 : 0; n < count; n++ )
+    {
+        wxGenericTreeItem * const child = children[n];
+
+        // and stop after reaching the bottom of the visible part
+        if ( child->GetY() > yBottom )
+            break;
+
+        y = child->GetY();
+        PaintLevel(child, dc, level, y);
+    }
+}
+
 void
 wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
                               wxDC &dc,
@@ -2742,23 +2883,20 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
     else if (level == 0)
     {
         // always expand hidden root
-        int origY = y;
         wxArrayGenericTreeItems& children = item->GetChildren();
         int count = children.GetCount();
         if (count > 0)
         {
-            int n = 0, oldY;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, 1, y);
-            } while (++n < count);
+            PaintChildren(item, dc, 1, y);
 
             if ( !HasFlag(wxTR_NO_LINES) && HasFlag(wxTR_LINES_AT_ROOT)
                     && count > 0 )
             {
                 // draw line down to last child
-                origY += GetLineHeight(children[0])>>1;
-                oldY += GetLineHeight(children[n-1])>>1;
+                int origY = children[0]->GetY() +
+                                (GetLineHeight(children[0])>>1);
+                int oldY = children[count-1]->GetY() +
+                                (GetLineHeight(children[count-1])>>1);
                 dc.DrawLine(3, origY, 3, oldY);
             }
         }
@@ -2899,17 +3037,13 @@ wxGenericTreeCtrl::PaintLevel(wxGenericTreeItem *item,
         int count = children.GetCount();
         if (count > 0)
         {
-            int n = 0, oldY;
-            ++level;
-            do {
-                oldY = y;
-                PaintLevel(children[n], dc, level, y);
-            } while (++n < count);
+            PaintChildren(item, dc, level + 1, y);
 
             if (!HasFlag(wxTR_NO_LINES) && count > 0)
             {
                 // draw line down to last child
-                oldY += GetLineHeight(children[n-1])>>1;
+                int oldY = children[count-1]->GetY() +
+                                (GetLineHeight(children[count-1])>>1);
                 if (HasButtons()) y_mid += 5;
 
                 // Only draw the portion of the line that is visible, in case
@@ -3028,6 +3162,9 @@ void wxGenericTreeCtrl::OnPaint( wxPaintEvent &WXUNUSED(event) )
     if ( !m_anchor)
         return;
 
+    // PaintLevel() relies on the items positions being up to date
+    CalculatePositions();
+
     dc.SetFont( m_normalFont );
     dc.SetPen( m_dottedPen );
 
@@ -3415,6 +3552,9 @@ wxGenericTreeCtrl::DoTreeHitTest(const wxPoint& point, int& flags) const
         return wxTreeItemId();
     }
 
+    // the items positions must be up to date
+    wxConstCast(this, wxGenericTreeCtrl)->CalculatePositions();
+
     wxGenericTreeItem *hit =  m_anchor->HitTest(CalcUnscrolledPosition(point),
                                                 this, flags, 0);
     if (hit == NULL)
@@ -3435,6 +3575,8 @@ bool wxGenericTreeCtrl::GetBoundingRect(const wxTreeItemId& item,
 
     wxGenericTreeItem *i = (wxGenericTreeItem*) item.m_pItem;
 
+    wxConstCast(this, wxGenericTreeCtrl)->CalculatePositions();
+
     if ( textOnly )
     {
         int image_h = 0, image_w = 0;
@@ -3978,7 +4120,7 @@ wxGenericTreeCtrl::CalculateLevel(wxGenericTreeItem *item,
 
 void wxGenericTreeCtrl::CalculatePositions()
 {
-    if ( !m_anchor ) return;
+    if ( !m_anchor || !m_dirtyItem ) return;
 
     wxClientDC dc(this);
     PrepareDC( dc );
@@ -3989,8 +4131,71 @@ void wxGenericTreeCtrl::CalculatePositions()
     //if(GetImageList() == NULL)
     // m_lineHeight = (int)(dc.GetCharHeight() + 4);
 
-    int y = 2;
-    CalculateLevel( m_anchor, dc, 0, y ); // start recursion
+    wxGenericTreeItem * const start = m_dirtyItem;
+    m_dirtyItem = NULL;
+
+    const int lineHeight = m_lineHeight;
+
+    if ( start != m_anchor )
+    {
+        // the items before the first changed one keep their positions, so
+        // only calculate the positions of this item subtree and of all the
+        // items following it
+        int level = 0;
+        wxGenericTreeItem *item;
+        for ( item = start->GetParent(); item; item = item->GetParent() )
+            level++;
+
+        int y = start->GetY();
+        CalculateLevel( start, dc, level, y );
+
+        item = start;
+        for ( wxGenericTreeItem *parent = item->GetParent();
+              parent;
+              item = parent, parent = parent->GetParent(), level-- )
+        {
+            const wxArrayGenericTreeItems& siblings = parent->GetChildren();
+            const size_t count = siblings.GetCount();
+            for ( size_t n = siblings.Index(item) + 1; n < count; ++n )
+                CalculateLevel( siblings[n], dc, level, y );
+        }
+    }
+
+    // if the line height has changed, the positions of all items change
+    if ( start == m_anchor || m_lineHeight != lineHeight )
+    {
+        int y = 2;
+        CalculateLevel( m_anchor, dc, 0, y ); // start recursion
+    }
+}
+
+void wxGenericTreeCtrl::InvalidatePositions(wxGenericTreeItem *item)
+{
+    m_dirty = true;
+
+    if ( !item )
+    {
+        m_dirtyItem = m_anchor;
+        return;
+    }
+
+    // nothing to do if the item is inside a collapsed branch
+    for ( wxGenericTreeItem *parent = item->GetParent();
+          parent;
+          parent = parent->GetParent() )
+    {
+        if ( !parent->IsExpanded() )
+            return;
+    }
+
+    m_dirtyItem = m_dirtyItem ? GetUpperItem(m_dirtyItem, item) : item;
+}
+
+void wxGenericTreeCtrl::UpdateItemHeight(wxGenericTreeItem *item)
+{
+    // with fixed height rows the items positions don't depend on their sizes
+    if ( HasFlag(wxTR_HAS_VARIABLE_ROW_HEIGHT) )
+        InvalidatePositions(item);
 }
 
 void wxGenericTreeCtrl::Refresh(bool eraseBackground, const wxRect *rect)
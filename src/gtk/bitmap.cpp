@@ -19,6 +19,7 @@
 #endif
 
 #include "wx/rawbmp.h"
+#include "wx/private/graphics.h"
 
 #include "wx/gtk/private/object.h"
 #include "wx/gtk/private.h"
@@ -1459,11 +1460,22 @@ void *wxBitmap::GetRawData(wxPixelDataBase& data, int bpp)
         bits = gdk_pixbuf_get_pixels(pixbuf);
     }
 #endif
+
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+    // The pixels are going to be modified without un-sharing our data.
+    if (bits)
+        wxCairoBitmapChanged(*this);
+#endif
+
     return bits;
 }
 
 void wxBitmap::UngetRawData(wxPixelDataBase& WXUNUSED(data))
 {
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+    // Also do it here in case the bitmap was drawn while being modified.
+    wxCairoBitmapChanged(*this);
+#endif
 }
 #endif // wxHAS_RAW_BITMAP
 
@@ -17,6 +17,7 @@
 #include "wx/dcscreen.h"
 #include "wx/icon.h"
 #include "wx/gtk/dc.h"
+#include "wx/private/graphics.h"
 
 #include <gtk/gtk.h>
 
@@ -316,6 +317,14 @@ wxMemoryDCImpl::wxMemoryDCImpl(wxMemoryDC* owner, wxDC*)
     m_ok = false;
 }
 
+wxMemoryDCImpl::~wxMemoryDCImpl()
+{
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+    if (m_bitmap.IsOk())
+        wxCairoBitmapSelected(m_bitmap, false);
+#endif
+}
+
 wxBitmap wxMemoryDCImpl::DoGetAsBitmap(const wxRect* subrect) const
 {
     return subrect ? m_bitmap.GetSubBitmap(*subrect) : m_bitmap;
@@ -323,6 +332,10 @@ wxBitmap wxMemoryDCImpl::DoGetAsBitmap(const wxRect* subrect) const
 
 void wxMemoryDCImpl::DoSelect(const wxBitmap& bitmap)
 {
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+    if (m_bitmap.IsOk())
+        wxCairoBitmapSelected(m_bitmap, false);
+#endif
     m_bitmap = bitmap;
     Setup();
 }
@@ -345,6 +358,10 @@ void wxMemoryDCImpl::Setup()
     {
         m_width = m_bitmap.GetWidth();
         m_height = m_bitmap.GetHeight();
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+        // Drawing on the DC changes the bitmap without un-sharing it.
+        wxCairoBitmapSelected(m_bitmap, true);
+#endif
         cairo_t* cr = m_bitmap.CairoCreate();
         gc = wxGraphicsContext::CreateFromNative(cr);
         gc->EnableOffset(true);
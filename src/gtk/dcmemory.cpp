@@ -10,6 +10,7 @@
 #include "wx/wxprec.h"
 
 #include "wx/gtk/dcmemory.h"
+#include "wx/private/graphics.h"
 
 #include <gtk/gtk.h>
 
@@ -40,6 +41,11 @@ wxMemoryDCImpl::wxMemoryDCImpl( wxMemoryDC *owner, wxDC *WXUNUSED(dc) )
 
 wxMemoryDCImpl::~wxMemoryDCImpl()
 {
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+    if (m_selected.IsOk())
+        wxCairoBitmapSelected(m_selected, false);
+#endif
+
     g_object_unref(m_context);
 }
 
@@ -61,9 +67,19 @@ void wxMemoryDCImpl::DoSelect( const wxBitmap& bitmap )
 {
     Destroy();
 
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+    if (m_selected.IsOk())
+        wxCairoBitmapSelected(m_selected, false);
+#endif
+
     m_selected = bitmap;
     if (m_selected.IsOk())
     {
+#ifdef wxHAS_CAIRO_BITMAP_CACHE
+        // Drawing on the DC changes the bitmap without un-sharing it.
+        wxCairoBitmapSelected(m_selected, true);
+#endif
+
         m_gdkwindow = m_selected.GetPixmap();
 
         m_selected.PurgeOtherRepresentations(wxBitmap::Pixmap);
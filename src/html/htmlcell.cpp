@@ -635,6 +635,313 @@ wxString wxHtmlWordWithTabsCell::GetPartAsText(int begin, int end) const
 
 
 
+//-----------------------------------------------------------------------------
+// wxHtmlDrawingState
+//-----------------------------------------------------------------------------
+
+// Drawing the cells outside of the visible area is only necessary because the
+// font and colour cells among them change the state used for drawing all the
+// subsequent cells. But only the last cell changing each part of this state
+// matters, so drawing just a few of them results in the same state as drawing
+// all of them: this class stores these cells in the order of drawing.
+class wxHtmlDrawingState
+{
+public:
+    // parts of the state which can be changed by the cells
+    enum
+    {
+        Part_Font       = 1,
+        Part_Foreground = 2,
+        Part_Background = 4,    // text background colour and mode
+        Part_DCBrush    = 8,    // background of the DC itself
+        Part_Count      = 4
+    };
+
+    wxHtmlDrawingState() { m_count = 0; }
+
+    // add a cell changing the given parts of the state
+    void Add(wxHtmlCell *cell, int parts)
+    {
+        // the previously added cells don't matter for the parts changed by
+        // the new one any more, so forget about the cells which don't change
+        // anything else
+        int n = 0;
+        for ( int i = 0; i < m_count; i++ )
+        {
+            m_parts[i] &= ~parts;
+            if ( m_parts[i] )
+            {
+                m_cells[n] = m_cells[i];
+                m_parts[n] = m_parts[i];
+                n++;
+            }
+        }
+
+        m_cells[n] = cell;
+        m_parts[n] = parts;
+        m_count = n + 1;
+    }
+
+    // add all cells of another state, which comes after this one
+    void Add(const wxHtmlDrawingState& state)
+    {
+        for ( int i = 0; i < state.m_count; i++ )
+            Add(state.m_cells[i], state.m_parts[i]);
+    }
+
+    void Apply(wxDC& dc, int x, int y, wxHtmlRenderingInfo& info) const
+    {
+        for ( int i = 0; i < m_count; i++ )
+            m_cells[i]->DrawInvisible(dc, x, y, info);
+    }
+
+private:
+    // as each cell changes at least one part not changed by the cells after
+    // it, there can't be more cells than parts
+    wxHtmlCell *m_cells[Part_Count];
+    int m_parts[Part_Count];
+    int m_count;
+};
+
+//-----------------------------------------------------------------------------
+// wxHtmlContainerIndex
+//-----------------------------------------------------------------------------
+
+// Information computed during wxHtmlContainerCell layout allowing to avoid
+// laying it out again if its width doesn't change and to avoid iterating over
+// all of its cells when only a small part of them is drawn or hit tested.
+class wxHtmlContainerIndex
+{
+public:
+    wxHtmlContainerIndex() { }
+
+    // update the index after laying out the container for the given width
+    void Build(const wxHtmlContainerCell& cont, int widthLayout);
+
+    // return true if the state changes done by all cells can be replayed
+    // instead of drawing the cells
+    bool CanReplayState(const wxHtmlRenderingInfo& info) const
+    {
+        // When the selection is shown, the state also changes when passing
+        // over the selection boundaries and this is not taken into account
+        // by wxHtmlDrawingState, and the widgets need to be repositioned when
+        // "drawing" them even if they're invisible.
+        return !m_hasWidgets && !info.GetSelection();
+    }
+
+    // return true if the cells positions are indexed, this is only done for
+    // the containers with many cells
+    bool HasCellsIndex() const { return !m_cells.empty(); }
+
+    size_t GetCount() const { return m_cells.size(); }
+
+    // get the cell with the given index or NULL if it's equal to GetCount()
+    wxHtmlCell *GetCell(size_t n) const
+    {
+        return n < m_cells.size() ? m_cells[n] : NULL;
+    }
+
+    // return the index of the first cell not ending above or at the given
+    // position, i.e. all cells before it are entirely above it
+    size_t GetFirstEndingBelow(int y) const
+    {
+        return FindFirstGreater(m_maxBottom, y);
+    }
+
+    // return the index of the first cell starting below the given position,
+    // i.e. all the cells after it are entirely below it too
+    size_t GetFirstStartingBelow(int y) const
+    {
+        return FindFirstGreater(m_minTop, y);
+    }
+
+    // restore the drawing state as if all the cells before the given one were
+    // drawn
+    void RestoreStateBefore(size_t n, wxDC& dc, int x, int y,
+                            wxHtmlRenderingInfo& info) const
+    {
+        m_states[n / CELLS_PER_STATE].Apply(dc, x, y, info);
+        for ( size_t i = n - n % CELLS_PER_STATE; i < n; i++ )
+            m_cells[i]->DrawInvisible(dc, x, y, info);
+    }
+
+    // restore the drawing state as if all cells were drawn
+    void RestoreFinalState(wxDC& dc, int x, int y,
+                           wxHtmlRenderingInfo& info) const
+    {
+        m_state.Apply(dc, x, y, info);
+    }
+
+    // return true if the layout done for the given width can be reused and
+    // return the width of the container after this layout if so
+    bool IsLaidOutFor(int widthLayout, int *width) const
+    {
+        if ( widthLayout != m_widthLayout )
+            return false;
+
+        *width = m_width;
+        return true;
+    }
+
+private:
+    // only index the cells of the containers with at least this many of them
+    enum { MIN_INDEXED_CELLS = 32 };
+
+    // store the drawing state before every this many cells
+    enum { CELLS_PER_STATE = 32 };
+
+    static size_t FindFirstGreater(const wxVector<int>& values, int value)
+    {
+        size_t lo = 0,
+               hi = values.size();
+        while ( lo < hi )
+        {
+            const size_t mid = (lo + hi) / 2;
+            if ( values[mid] > value )
+                hi = mid;
+            else
+                lo = mid + 1;
+        }
+
+        return lo;
+    }
+
+    // update m_state and m_hasWidgets to take into account the given cell
+    void AddCell(wxHtmlCell *cell);
+
+
+    // the width the container was laid out for and its actual width after
+    // layout, which may be greater if its contents didn't fit
+    int m_widthLayout,
+        m_width;
+
+    // the state after drawing all cells
+    wxHtmlDrawingState m_state;
+
+    // true if there are any widget cells inside this container
+    bool m_hasWidgets;
+
+    // the direct children of the container and, for each of them, the
+    // maximal bottom coordinate of it and all the cells before it and the
+    // minimal top coordinate of it and all the cells after it: both arrays
+    // are sorted, allowing to find the visible cells using binary search
+    // even if their positions are not
+    wxVector<wxHtmlCell *> m_cells;
+    wxVector<int> m_maxBottom,
+                  m_minTop;
+
+    // the state before drawing the cells with the indices multiple of
+    // CELLS_PER_STATE
+    wxVector<wxHtmlDrawingState> m_states;
+
+    wxDECLARE_NO_COPY_CLASS(wxHtmlContainerIndex);
+};
+
+void wxHtmlContainerIndex::AddCell(wxHtmlCell *cell)
+{
+    if ( !cell->IsTerminalCell() )
+    {
+        wxHtmlContainerCell * const cont = wxDynamicCast(cell, wxHtmlContainerCell);
+        if ( !cont )
+        {
+            // we don't know what this cell does when it's drawn
+            m_hasWidgets = true;
+        }
+        else if ( cont->m_index )
+        {
+            m_state.Add(cont->m_index->m_state);
+            if ( cont->m_index->m_hasWidgets )
+                m_hasWidgets = true;
+        }
+        else // container not laid out by wxHtmlContainerCell, e.g. table
+        {
+            for ( wxHtmlCell *c = cont->GetFirstChild(); c; c = c->GetNext() )
+                AddCell(c);
+        }
+    }
+    else if ( cell->IsFormattingCell() && wxDynamicCast(cell, wxHtmlFontCell) )
+    {
+        m_state.Add(cell, wxHtmlDrawingState::Part_Font);
+    }
+    else if ( cell->IsFormattingCell() && wxDynamicCast(cell, wxHtmlColourCell) )
+    {
+        const unsigned flags = static_cast<wxHtmlColourCell *>(cell)->m_Flags;
+
+        int parts = 0;
+        if ( flags & wxHTML_CLR_FOREGROUND )
+            parts |= wxHtmlDrawingState::Part_Foreground;
+        if ( flags & wxHTML_CLR_BACKGROUND )
+            parts |= wxHtmlDrawingState::Part_Background |
+                     wxHtmlDrawingState::Part_DCBrush;
+        if ( flags & wxHTML_CLR_TRANSPARENT_BACKGROUND )
+            parts |= wxHtmlDrawingState::Part_Background;
+
+        if ( parts )
+            m_state.Add(cell, parts);
+    }
+    else if ( wxDynamicCast(cell, wxHtmlWidgetCell) )
+    {
+        m_hasWidgets = true;
+    }
+}
+
+void wxHtmlContainerIndex::Build(const wxHtmlContainerCell& cont,
+                                 int widthLayout)
+{
+    m_widthLayout = widthLayout;
+    m_width = cont.GetWidth();
+
+    m_state = wxHtmlDrawingState();
+    m_hasWidgets = false;
+
+    m_cells.clear();
+    m_maxBottom.clear();
+    m_minTop.clear();
+    m_states.clear();
+
+    size_t count = 0;
+    wxHtmlCell *cell;
+    for ( cell = cont.GetFirstChild(); cell; cell = cell->GetNext() )
+        count++;
+
+    if ( count < MIN_INDEXED_CELLS )
+    {
+        for ( cell = cont.GetFirstChild(); cell; cell = cell->GetNext() )
+            AddCell(cell);
+
+        return;
+    }
+
+    m_cells.reserve(count);
+    m_maxBottom.reserve(count);
+    m_minTop.reserve(count);
+    m_states.reserve(count / CELLS_PER_STATE + 1);
+
+    int maxBottom = 0;
+    for ( cell = cont.GetFirstChild(); cell; cell = cell->GetNext() )
+    {
+        if ( m_cells.size() % CELLS_PER_STATE == 0 )
+            m_states.push_back(m_state);
+
+        const int top = cell->GetPosY(),
+                  bottom = top + cell->GetHeight();
+        if ( m_cells.empty() || bottom > maxBottom )
+            maxBottom = bottom;
+
+        m_cells.push_back(cell);
+        m_maxBottom.push_back(maxBottom);
+        m_minTop.push_back(top);
+
+        AddCell(cell);
+    }
+
+    for ( size_t n = count - 1; n > 0; n-- )
+    {
+        if ( m_minTop[n] < m_minTop[n - 1] )
+            m_minTop[n - 1] = m_minTop[n];
+    }
+}
+
 //-----------------------------------------------------------------------------
 // wxHtmlContainerCell
 //-----------------------------------------------------------------------------
@@ -656,10 +963,13 @@ wxHtmlContainerCell::wxHtmlContainerCell(wxHtmlContainerCell *parent) : wxHtmlCe
     m_MinHeight = 0;
     m_MinHeightAlign = wxHTML_ALIGN_TOP;
     m_LastLayout = -1;
+    m_index = NULL;
 }
 
 wxHtmlContainerCell::~wxHtmlContainerCell()
 {
+    delete m_index;
+
     wxHtmlCell *cell = m_Cells;
     while ( cell )
     {
@@ -737,14 +1047,12 @@ void wxHtmlContainerCell::Layout(int w)
 
     if (m_LastLayout == w)
         return;
-    m_LastLayout = w;
 
     // VS: Any attempt to layout with negative or zero width leads to hell,
     // but we can't ignore such attempts completely, since it sometimes
     // happen (e.g. when trying how small a table can be), so use at least one
     // pixel width, this will at least give us the correct height sometimes.
-    if (w < 1)
-        w = 1;
+    const int widthAvail = w < 1 ? 1 : w;
 
     wxHtmlCell *nextCell;
     long xpos = 0, ypos = m_IndentTop;
@@ -764,15 +1072,28 @@ void wxHtmlContainerCell::Layout(int w)
 
     if (m_WidthFloatUnits == wxHTML_UNITS_PERCENT)
     {
-        if (m_WidthFloat < 0) m_Width = (100 + m_WidthFloat) * w / 100;
-        else m_Width = m_WidthFloat * w / 100;
+        if (m_WidthFloat < 0) m_Width = (100 + m_WidthFloat) * widthAvail / 100;
+        else m_Width = m_WidthFloat * widthAvail / 100;
     }
     else
     {
-        if (m_WidthFloat < 0) m_Width = w + m_WidthFloat;
+        if (m_WidthFloat < 0) m_Width = widthAvail + m_WidthFloat;
         else m_Width = m_WidthFloat;
     }
 
+    // The layout only depends on our own width, so if it didn't change, e.g.
+    // because it's fixed or the difference is too small to matter for the
+    // percentage width, the previous layout is still valid.
+    const int widthOwn = m_Width;
+    if ( m_LastLayout != -1 && m_index &&
+            m_index->IsLaidOutFor(widthOwn, &m_Width) )
+    {
+        m_LastLayout = w;
+        return;
+    }
+
+    m_LastLayout = w;
+
     if (m_Cells)
     {
         int l = (m_IndentLeft < 0) ? (-m_IndentLeft * m_Width / 100) : m_IndentLeft;
@@ -986,6 +1307,10 @@ void wxHtmlContainerCell::Layout(int w)
     m_MaxTotalWidth += s_indent + ((m_IndentRight < 0) ? (-m_IndentRight * m_Width / 100) : m_IndentRight);
     MaxLineWidth += s_indent + ((m_IndentRight < 0) ? (-m_IndentRight * m_Width / 100) : m_IndentRight);
     if (m_Width < MaxLineWidth) m_Width = MaxLineWidth;
+
+    if ( !m_index )
+        m_index = new wxHtmlContainerIndex;
+    m_index->Build(*this, widthOwn);
 }
 
 void wxHtmlContainerCell::UpdateRenderingStatePre(wxHtmlRenderingInfo& info,
@@ -1101,8 +1426,35 @@ void wxHtmlContainerCell::Draw(wxDC& dc, int x, int y, int view_y1, int view_y2,
     }
     if (m_Cells)
     {
+        wxHtmlCell *cell = m_Cells,
+                   *cellEnd = NULL;
+        bool restoreFinalState = false;
+        if ( m_index && m_index->HasCellsIndex() &&
+                m_index->CanReplayState(info) )
+        {
+            // Only draw the cells which can be visible. The cells before them
+            // don't need to be drawn, but we still need to restore the state
+            // they would have set and also the state after all of them for
+            // the cells following this container.
+            const size_t
+                first = m_index->GetFirstEndingBelow(view_y1 - ylocal),
+                end = m_index->GetFirstStartingBelow(view_y2 - ylocal);
+            if ( first < end )
+            {
+                m_index->RestoreStateBefore(first, dc, xlocal, ylocal, info);
+                cell = m_index->GetCell(first);
+                cellEnd = m_index->GetCell(end);
+            }
+            else
+            {
+                cell = NULL;
+            }
+
+            restoreFinalState = cellEnd || !cell;
+        }
+
         // draw container's contents:
-        for (wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext())
+        for ( ; cell != cellEnd; cell = cell->GetNext() )
         {
 
             // optimize drawing: don't render off-screen content:
@@ -1123,6 +1475,9 @@ void wxHtmlContainerCell::Draw(wxDC& dc, int x, int y, int view_y1, int view_y2,
                 cell->DrawInvisible(dc, xlocal, ylocal, info);
             }
         }
+
+        if ( restoreFinalState )
+            m_index->RestoreFinalState(dc, xlocal, ylocal, info);
     }
 }
 
@@ -1133,6 +1488,14 @@ void wxHtmlContainerCell::DrawInvisible(wxDC& dc, int x, int y,
 {
     if (m_Cells)
     {
+        // there is no need to go through all cells if we already know what
+        // changes they do
+        if ( m_index && m_index->CanReplayState(info) )
+        {
+            m_index->RestoreFinalState(dc, x + m_PosX, y + m_PosY, info);
+            return;
+        }
+
         for (wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext())
         {
             UpdateRenderingStatePre(info, cell);
@@ -1172,7 +1535,19 @@ void wxHtmlContainerCell::InsertCell(wxHtmlCell *f)
         if (m_LastCell) while (m_LastCell->GetNext()) m_LastCell = m_LastCell->GetNext();
     }
     f->SetParent(this);
-    m_LastLayout = -1;
+    InvalidateLayout();
+}
+
+
+void wxHtmlContainerCell::InvalidateLayout()
+{
+    // The parents need to be invalidated too as otherwise their Layout()
+    // wouldn't even call ours if their width didn't change.
+    for ( wxHtmlContainerCell *c = this; c; c = c->GetParent() )
+    {
+        c->m_LastLayout = -1;
+        wxDELETE(c->m_index);
+    }
 }
 
 
@@ -1234,9 +1609,26 @@ const wxHtmlCell* wxHtmlContainerCell::Find(int condition, const void* param) co
 wxHtmlCell *wxHtmlContainerCell::FindCellByPos(wxCoord x, wxCoord y,
                                                unsigned flags) const
 {
+    // If we have the index, use it to skip the cells entirely above the
+    // given position, which can't be the ones we're looking for.
+    const bool useIndex = m_index && m_index->HasCellsIndex();
+
     if ( flags & wxHTML_FIND_EXACT )
     {
-        for ( const wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext() )
+        const wxHtmlCell *cell = m_Cells,
+                         *cellEnd = NULL;
+        if ( useIndex )
+        {
+            const size_t first = m_index->GetFirstEndingBelow(y),
+                         end = m_index->GetFirstStartingBelow(y);
+            if ( first >= end )
+                return NULL;
+
+            cell = m_index->GetCell(first);
+            cellEnd = m_index->GetCell(end);
+        }
+
+        for ( ; cell != cellEnd; cell = cell->GetNext() )
         {
             int cx = cell->GetPosX(),
                 cy = cell->GetPosY();
@@ -1250,8 +1642,12 @@ wxHtmlCell *wxHtmlContainerCell::FindCellByPos(wxCoord x, wxCoord y,
     }
     else if ( flags & wxHTML_FIND_NEAREST_AFTER )
     {
+        const wxHtmlCell *cell = m_Cells;
+        if ( useIndex )
+            cell = m_index->GetCell(m_index->GetFirstEndingBelow(y));
+
         wxHtmlCell *c;
-        for ( const wxHtmlCell *cell = m_Cells; cell; cell = cell->GetNext() )
+        for ( ; cell; cell = cell->GetNext() )
         {
             if ( cell->IsFormattingCell() )
                 continue;
@@ -1264,6 +1660,36 @@ wxHtmlCell *wxHtmlContainerCell::FindCellByPos(wxCoord x, wxCoord y,
             if (c) return c;
         }
     }
+    else if ( (flags & wxHTML_FIND_NEAREST_BEFORE) && useIndex )
+    {
+        // All cells above the given position satisfy the condition below, so
+        // the loop can only stop at one of the subsequent cells. Find it and
+        // then look for the last matching cell going backwards from it.
+        const size_t count = m_index->GetCount();
+        size_t n;
+        for ( n = m_index->GetFirstEndingBelow(y); n < count; n++ )
+        {
+            const wxHtmlCell * const cell = m_index->GetCell(n);
+            if ( cell->IsFormattingCell() )
+                continue;
+            int cellY = cell->GetPosY();
+            if (!( cellY + cell->GetHeight() <= y ||
+                   (y >= cellY && x >= cell->GetPosX()) ))
+                break;
+        }
+
+        while ( n-- > 0 )
+        {
+            const wxHtmlCell * const cell = m_index->GetCell(n);
+            if ( cell->IsFormattingCell() )
+                continue;
+            wxHtmlCell * const c = cell->FindCellByPos(x - cell->GetPosX(),
+                                                       y - cell->GetPosY(),
+                                                       flags);
+            if (c)
+                return c;
+        }
+    }
     else if ( flags & wxHTML_FIND_NEAREST_BEFORE )
     {
         wxHtmlCell *c2, *c = NULL;
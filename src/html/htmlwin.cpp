@@ -46,6 +46,10 @@ wxDEFINE_EVENT( wxEVT_HTML_CELL_CLICKED, wxHtmlCellEvent );
 wxDEFINE_EVENT( wxEVT_HTML_CELL_HOVER, wxHtmlCellEvent );
 wxDEFINE_EVENT( wxEVT_HTML_LINK_CLICKED, wxHtmlLinkEvent );
 
+// default delay after which the part of the page parsed so far is shown for
+// the first time if progressive rendering is enabled, in milliseconds
+const int HTML_PROGRESSIVE_RENDERING_DELAY = 200;
+
 
 #if wxUSE_CLIPBOARD
 // ----------------------------------------------------------------------------
@@ -303,6 +307,8 @@ void wxHtmlWindow::CleanUpStatics()
 void wxHtmlWindow::Init()
 {
     m_tmpCanDrawLocks = 0;
+    m_progressiveRendering = false;
+    m_progressiveRenderingDelay = HTML_PROGRESSIVE_RENDERING_DELAY;
     m_FS = new wxFileSystem();
 #if wxUSE_STATUSBAR
     m_RelatedStatusBar = NULL;
@@ -493,8 +499,18 @@ bool wxHtmlWindow::DoSetPage(const wxString& source)
     // wxDELETE() and not just delete here
     wxDELETE(m_Cell);
 
+    // Show the beginning of the page while the rest of it is being parsed if
+    // requested, unless drawing is locked, e.g. because we're going to scroll
+    // to another position in the page after loading it. Notice that the
+    // parser interprets 0 interval as disabling the notifications, so use
+    // the smallest positive one to show the page as soon as possible.
+    if ( m_progressiveRendering && m_tmpCanDrawLocks == 0 )
+        m_Parser->SetProgressInterval(wxMax(m_progressiveRenderingDelay, 1));
+
     m_Cell = (wxHtmlContainerCell*) m_Parser->Parse(newsrc);
 
+    m_Parser->SetProgressInterval(0);
+
     // The parser doesn't need the DC any more, so ensure it's not left with a
     // dangling pointer after the DC object goes out of scope.
     m_Parser->SetDC(NULL);
@@ -613,7 +629,17 @@ bool wxHtmlWindow::LoadPage(const wxString& location)
             }
 
             m_FS->ChangePathTo(f->GetLocation());
+
+            // The page can be shown while it's being parsed if we don't need
+            // to scroll to an anchor in it later.
+            const bool canDrawPartially = f->GetAnchor().empty();
+            if ( canDrawPartially )
+                m_tmpCanDrawLocks--;
+
             rt_val = SetPage(src);
+
+            if ( canDrawPartially )
+                m_tmpCanDrawLocks++;
             m_OpenedPage = f->GetLocation();
             if (f->GetAnchor() != wxEmptyString)
             {
@@ -1815,6 +1841,24 @@ wxCursor wxHtmlWindow::GetHTMLCursor(HTMLCursor type) const
     return GetDefaultHTMLCursor(type);
 }
 
+void wxHtmlWindow::OnHTMLParsingProgress(wxHtmlContainerCell *cell)
+{
+    // Lay out and draw the part of the page parsed so far immediately, without
+    // dispatching any events as the parser is still running. This is not
+    // wasted as the layout of the already parsed cells is cached and will be
+    // reused when the entire page is laid out later.
+    m_Cell = cell;
+    m_Cell->SetIndent(m_Borders, wxHTML_INDENT_ALL, wxHTML_UNITS_PIXELS);
+    m_Cell->SetAlignHor(wxHTML_ALIGN_CENTER);
+
+    CreateLayout();
+    Refresh();
+    Update();
+
+    // Don't let anything else use the incomplete page.
+    m_Cell = NULL;
+}
+
 /*static*/
 void wxHtmlWindow::SetDefaultHTMLCursor(HTMLCursor type, const wxCursor& cursor)
 {
@@ -429,6 +429,15 @@ void wxHtmlTableCell::ComputeMinMaxWidths()
 
 void wxHtmlTableCell::Layout(int w)
 {
+    // If the table contents changed since the last layout, which may happen
+    // if it was laid out while it was still being parsed, the columns widths
+    // need to be recomputed.
+    if ( m_LastLayout == -1 )
+    {
+        for ( int c = 0; c < m_NumCols; c++ )
+            m_ColsInfo[c].minWidth = m_ColsInfo[c].maxWidth = -1;
+    }
+
     ComputeMinMaxWidths();
 
     wxHtmlCell::Layout(w);
@@ -660,6 +669,9 @@ void wxHtmlTableCell::Layout(int w)
         if (twidth > m_Width)
             m_Width = twidth;
     }
+
+    // remember that the columns widths are up to date
+    m_LastLayout = w;
 }
 
 
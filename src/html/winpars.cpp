@@ -55,6 +55,8 @@ wxHtmlWinParser::wxHtmlWinParser(wxHtmlWindowInterface *wndIface)
     m_whitespaceMode = Whitespace_Normal;
     m_lastWordCell = NULL;
     m_posColumn = 0;
+    m_progressInterval = 0;
+    m_progressDelay = 0;
 
     {
         int i, j, k, l, m;
@@ -232,6 +234,12 @@ void wxHtmlWinParser::InitParser(const wxString& source)
     // then open the first container into which page's content will go:
     OpenContainer();
 
+    if ( m_progressInterval > 0 )
+    {
+        m_progressDelay = m_progressInterval;
+        m_nextProgress = wxGetLocalTimeMillis() + m_progressDelay;
+    }
+
 #if !wxUSE_UNICODE
     wxString charset = ExtractCharsetInformation(source);
     if (!charset.empty())
@@ -345,8 +353,28 @@ wxFSFile *wxHtmlWinParser::OpenURL(wxHtmlURLType type,
     #define CUR_NBSP_VALUE NBSP_UNICODE_VALUE
 #endif
 
+void wxHtmlWinParser::NotifyProgressIfNeeded()
+{
+    if ( !m_windowInterface || wxGetLocalTimeMillis() < m_nextProgress )
+        return;
+
+    wxHtmlContainerCell *top = m_Container;
+    while ( top->GetParent() )
+        top = top->GetParent();
+
+    m_windowInterface->OnHTMLParsingProgress(top);
+
+    // Doubling the interval ensures that the total time spent on showing the
+    // partial results remains proportional to the document size.
+    m_progressDelay *= 2;
+    m_nextProgress = wxGetLocalTimeMillis() + m_progressDelay;
+}
+
 void wxHtmlWinParser::AddText(const wxString& txt)
 {
+    if ( m_progressInterval > 0 )
+        NotifyProgressIfNeeded();
+
 #if !wxUSE_UNICODE
     if ( m_nbsp == 0 )
         m_nbsp = GetEntitiesParser()->GetCharForCode(NBSP_UNICODE_VALUE);
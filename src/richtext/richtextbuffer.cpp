@@ -46,6 +46,7 @@
 
 #include "wx/listimpl.cpp"
 #include "wx/arrimpl.cpp"
+#include "wx/vector.h"
 
 WX_DEFINE_LIST(wxRichTextObjectList)
 WX_DEFINE_LIST(wxRichTextLineList)
@@ -1305,6 +1306,7 @@ size_t wxRichTextCompositeObject::AppendChild(wxRichTextObject* child)
 {
     m_children.Append(child);
     child->SetParent(this);
+    OnChildrenChanged();
     return m_children.GetCount() - 1;
 }
 
@@ -1319,6 +1321,7 @@ bool wxRichTextCompositeObject::InsertChild(wxRichTextObject* child, wxRichTextO
     else
         m_children.Insert(child);
     child->SetParent(this);
+    OnChildrenChanged();
 
     return true;
 }
@@ -1331,6 +1334,7 @@ bool wxRichTextCompositeObject::RemoveChild(wxRichTextObject* child, bool delete
     {
         wxRichTextObject* obj = node->GetData();
         m_children.Erase(node);
+        OnChildrenChanged();
         if (deleteChild)
             delete obj;
 
@@ -1354,6 +1358,8 @@ bool wxRichTextCompositeObject::DeleteChildren()
         m_children.Erase(oldNode);
     }
 
+    OnChildrenChanged();
+
     return true;
 }
 
@@ -1380,6 +1386,8 @@ void wxRichTextCompositeObject::Copy(const wxRichTextCompositeObject& obj)
 
         node = node->GetNext();
     }
+
+    OnChildrenChanged();
 }
 
 /// Hit-testing: returns a flag indicating hit test details, plus
@@ -1595,6 +1603,7 @@ bool wxRichTextCompositeObject::Defragment(wxRichTextDrawingContext& context, co
                         {
                             nextChild->Dereference();
                             m_children.Erase(node->GetNext());
+                            OnChildrenChanged();
                         }
                         else
                             node = node->GetNext();
@@ -1641,6 +1650,7 @@ bool wxRichTextCompositeObject::Defragment(wxRichTextDrawingContext& context, co
                         {
                             nextChild->Dereference();
                             m_children.Erase(node->GetNext());
+                            OnChildrenChanged();
 
                             // Don't set node -- we'll see if we can merge again with the next
                             // child. UNLESS we split this or the next child, in which case we know we have to
@@ -1679,6 +1689,7 @@ bool wxRichTextCompositeObject::Defragment(wxRichTextDrawingContext& context, co
                 {
                     child->Dereference();
                     m_children.Erase(node);
+                    OnChildrenChanged();
                 }
                 node = next;
             }
@@ -1855,6 +1866,161 @@ void wxRichTextCompositeObject::Move(const wxPoint& pt)
 }
 
 
+/*!
+ * wxRichTextParagraphIndex
+ * This allows to find the paragraphs of wxRichTextParagraphLayoutBox
+ * by position or by y coordinate without iterating over all of them.
+ */
+
+// Don't bother with the index for boxes with fewer paragraphs than this.
+#define wxRICHTEXT_MIN_INDEXED_PARAGRAPHS 32
+
+// Only the list nodes are stored in the index while the ranges and positions
+// are always taken from the paragraphs themselves, so the index remains valid
+// until the list of paragraphs changes, even if they are laid out again or
+// their ranges are updated. The search results are only correct if the
+// paragraphs are sorted by their ranges and positions, which is the case for
+// an up to date buffer, so all searches check that the paragraphs around the
+// found one are in the expected order and give up otherwise, letting the
+// caller fall back to the linear search.
+class wxRichTextParagraphIndex
+{
+public:
+    // Returns NULL if the index wouldn't be useful or if not all the
+    // children are paragraphs.
+    static wxRichTextParagraphIndex* Create(const wxRichTextObjectList& children)
+    {
+        if (children.GetCount() < wxRICHTEXT_MIN_INDEXED_PARAGRAPHS)
+            return NULL;
+
+        wxRichTextParagraphIndex* const index = new wxRichTextParagraphIndex;
+        index->m_nodes.reserve(children.GetCount());
+
+        wxRichTextObjectList::compatibility_iterator node;
+        for (node = children.GetFirst(); node; node = node->GetNext())
+        {
+            if (!wxDynamicCast(node->GetData(), wxRichTextParagraph))
+            {
+                delete index;
+                return NULL;
+            }
+
+            index->m_nodes.push_back(node);
+        }
+
+        return index;
+    }
+
+    size_t GetCount() const { return m_nodes.size(); }
+
+    wxRichTextObjectList::compatibility_iterator GetNode(size_t n) const
+    {
+        return m_nodes[n];
+    }
+
+    wxRichTextParagraph* GetParagraph(size_t n) const
+    {
+        return static_cast<wxRichTextParagraph*>(m_nodes[n]->GetData());
+    }
+
+    // Finds the paragraph containing the given position, setting n to
+    // GetCount() if there is none. Returns false if the index can't be used.
+    bool FindParagraphAtPosition(long pos, size_t& n) const
+    {
+        // Find the first paragraph not ending before the position.
+        size_t lo = 0,
+               hi = m_nodes.size();
+        while (lo < hi)
+        {
+            const size_t mid = lo + (hi - lo)/2;
+            if (GetParagraph(mid)->GetRange().GetEnd() < pos)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        if (lo > 0)
+        {
+            const long prevEnd = GetParagraph(lo - 1)->GetRange().GetEnd();
+            if (prevEnd >= pos)
+                return false;
+
+            if (lo < m_nodes.size() &&
+                    GetParagraph(lo)->GetRange().GetStart() <= prevEnd)
+                return false;
+        }
+
+        if (lo < m_nodes.size() && GetParagraph(lo)->GetRange().Contains(pos))
+            n = lo;
+        else
+            n = m_nodes.size();
+
+        return true;
+    }
+
+    // Finds the first paragraph whose last line ends at or below the given
+    // coordinate, setting n to GetCount() if there is none. Returns false if
+    // the index can't be used because the paragraphs are not laid out.
+    bool FindFirstParagraphEndingBelow(int y, size_t& n) const
+    {
+        size_t lo = 0,
+               hi = m_nodes.size();
+        while (lo < hi)
+        {
+            const size_t mid = lo + (hi - lo)/2;
+
+            int bottom;
+            if (!GetBottom(mid, bottom))
+                return false;
+
+            if (bottom < y)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+
+        int prevBottom = 0;
+        if (lo > 0 && (!GetBottom(lo - 1, prevBottom) || prevBottom >= y))
+            return false;
+
+        if (lo < m_nodes.size())
+        {
+            int bottom;
+            if (!GetBottom(lo, bottom) || bottom < y ||
+                    (lo > 0 && bottom < prevBottom))
+                return false;
+        }
+
+        n = lo;
+
+        return true;
+    }
+
+private:
+    wxRichTextParagraphIndex() { }
+
+    // Gets the bottom of the last line of the given paragraph, returns false
+    // if it doesn't have any lines or is hidden.
+    bool GetBottom(size_t n, int& bottom) const
+    {
+        wxRichTextParagraph* const para = GetParagraph(n);
+        if (!para->IsShown())
+            return false;
+
+        wxRichTextLineList::compatibility_iterator node = para->GetLines().GetLast();
+        if (!node)
+            return false;
+
+        bottom = node->GetData()->GetRect().GetBottom();
+
+        return true;
+    }
+
+    wxVector<wxRichTextObjectList::compatibility_iterator> m_nodes;
+
+    wxDECLARE_NO_COPY_CLASS(wxRichTextParagraphIndex);
+};
+
 /*!
  * wxRichTextParagraphLayoutBox
  * This box knows how to lay out paragraphs.
@@ -1875,6 +2041,8 @@ wxRichTextParagraphLayoutBox::~wxRichTextParagraphLayoutBox()
         delete m_floatCollector;
         m_floatCollector = NULL;
     }
+
+    wxDELETE(m_paragraphIndex);
 }
 
 /// Initialize the object.
@@ -1890,6 +2058,7 @@ void wxRichTextParagraphLayoutBox::Init()
 
     m_partialParagraph = false;
     m_floatCollector = NULL;
+    m_paragraphIndex = NULL;
 }
 
 void wxRichTextParagraphLayoutBox::Clear()
@@ -1913,6 +2082,21 @@ void wxRichTextParagraphLayoutBox::Copy(const wxRichTextParagraphLayoutBox& obj)
     m_defaultAttributes = obj.m_defaultAttributes;
 }
 
+void wxRichTextParagraphLayoutBox::OnChildrenChanged()
+{
+    wxDELETE(m_paragraphIndex);
+
+    wxRichTextCompositeObject::OnChildrenChanged();
+}
+
+const wxRichTextParagraphIndex* wxRichTextParagraphLayoutBox::GetParagraphIndex() const
+{
+    if (!m_paragraphIndex)
+        m_paragraphIndex = wxRichTextParagraphIndex::Create(m_children);
+
+    return m_paragraphIndex;
+}
+
 // Gather information about floating objects; only gather floats for those paragraphs that
 // will not be formatted again due to optimization, after which floats will be gathered per-paragraph
 // during layout.
@@ -1988,7 +2172,28 @@ int wxRichTextParagraphLayoutBox::HitTest(wxDC& dc, wxRichTextDrawingContext& co
     }
 
     if (ret == wxRICHTEXT_HITTEST_NONE)
+    {
+        // Skip the paragraphs entirely above the point: they can't be hit.
+        const wxRichTextParagraphIndex* index = GetParagraphIndex();
+        size_t n;
+        if (index && index->FindFirstParagraphEndingBelow(pt.y - 1, n))
+        {
+            for ( ; n < index->GetCount(); n++)
+            {
+                wxRichTextParagraph* child = index->GetParagraph(n);
+                if (child->IsShown())
+                {
+                    ret = child->HitTest(dc, context, pt, textPosition, obj, contextObj, flags);
+                    if (ret != wxRICHTEXT_HITTEST_NONE)
+                        return ret;
+                }
+            }
+
+            return wxRICHTEXT_HITTEST_NONE;
+        }
+
         return wxRichTextCompositeObject::HitTest(dc, context, pt, textPosition, obj, contextObj, flags);
+    }
     else
     {
         *contextObj = this;
@@ -1996,6 +2201,21 @@ int wxRichTextParagraphLayoutBox::HitTest(wxDC& dc, wxRichTextDrawingContext& co
     }
 }
 
+/// Finds the absolute position and row height for the given character position
+bool wxRichTextParagraphLayoutBox::FindPosition(wxDC& dc, wxRichTextDrawingContext& context, long index, wxPoint& pt, int* height, bool forceLineStart)
+{
+    // Only the paragraph containing the position can find it.
+    const wxRichTextParagraphIndex* paraIndex = GetParagraphIndex();
+    size_t n;
+    if (index != -1 && paraIndex && paraIndex->FindParagraphAtPosition(index, n))
+    {
+        return n < paraIndex->GetCount() &&
+                paraIndex->GetParagraph(n)->FindPosition(dc, context, index, pt, height, forceLineStart);
+    }
+
+    return wxRichTextCompositeObject::FindPosition(dc, context, index, pt, height, forceLineStart);
+}
+
 /// Draw the floating objects
 void wxRichTextParagraphLayoutBox::DrawFloats(wxDC& dc, wxRichTextDrawingContext& context, const wxRichTextRange& range, const wxRichTextSelection& selection, const wxRect& rect, int descent, int style)
 {
@@ -2511,6 +2731,11 @@ wxRichTextParagraph* wxRichTextParagraphLayoutBox::GetParagraphAtPosition(long p
     if (caretPosition)
         pos ++;
 
+    const wxRichTextParagraphIndex* index = GetParagraphIndex();
+    size_t n;
+    if (index && index->FindParagraphAtPosition(pos, n))
+        return n < index->GetCount() ? index->GetParagraph(n) : NULL;
+
     // First find the first paragraph whose starting position is within the range.
     wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
     while (node)
@@ -2542,7 +2767,26 @@ wxRichTextLine* wxRichTextParagraphLayoutBox::GetLineAtPosition(long pos, bool c
 
     // First find the first paragraph whose starting position is within the range.
     wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
-    while (node)
+
+    // Use the index to go directly to it if possible: no other paragraph can
+    // contain this position then.
+    wxRichTextObjectList::compatibility_iterator end;
+    const wxRichTextParagraphIndex* index = GetParagraphIndex();
+    size_t n;
+    if (index && index->FindParagraphAtPosition(pos, n))
+    {
+        if (n < index->GetCount())
+        {
+            node = index->GetNode(n);
+            end = node->GetNext();
+        }
+        else
+        {
+            node = end;
+        }
+    }
+
+    while (node != end)
     {
         wxRichTextObject* obj = (wxRichTextObject*) node->GetData();
         if (obj->GetRange().Contains(pos))
@@ -2586,6 +2830,13 @@ wxRichTextLine* wxRichTextParagraphLayoutBox::GetLineAtPosition(long pos, bool c
 wxRichTextLine* wxRichTextParagraphLayoutBox::GetLineAtYPosition(int y) const
 {
     wxRichTextObjectList::compatibility_iterator node = m_children.GetFirst();
+
+    // Skip all the paragraphs above this position if we can.
+    const wxRichTextParagraphIndex* index = GetParagraphIndex();
+    size_t n;
+    if (index && index->FindFirstParagraphEndingBelow(y, n))
+        node = n < index->GetCount() ? index->GetNode(n) : wxRichTextObjectList::compatibility_iterator();
+
     while (node)
     {
         wxRichTextParagraph* child = wxDynamicCast(node->GetData(), wxRichTextParagraph);
@@ -6691,6 +6942,37 @@ wxRichTextRange wxRichTextLine::GetAbsoluteRange() const
 
 IMPLEMENT_DYNAMIC_CLASS(wxRichTextPlainText, wxRichTextObject)
 
+// The extents of the text of wxRichTextPlainText cached by GetRangeSize()
+// together with everything they depend on.
+class wxRichTextPlainTextExtents
+{
+public:
+    wxRichTextPlainTextExtents()
+    {
+        m_scaleX =
+        m_scaleY = 1.0;
+        m_charHeight =
+        m_descent = 0;
+    }
+
+    bool Matches(const wxString& text, const wxFont& font, const wxSize& ppi,
+                 double scaleX, double scaleY) const
+    {
+        return scaleX == m_scaleX && scaleY == m_scaleY && ppi == m_ppi &&
+                font == m_font && text == m_text;
+    }
+
+    wxString m_text;
+    wxFont m_font;
+    wxSize m_ppi;
+    double m_scaleX,
+           m_scaleY;
+
+    wxArrayInt m_extents;
+    int m_charHeight;
+    int m_descent;
+};
+
 wxRichTextPlainText::wxRichTextPlainText(const wxString& text, wxRichTextObject* parent, wxRichTextAttr* style):
     wxRichTextObject(parent)
 {
@@ -6698,6 +6980,17 @@ wxRichTextPlainText::wxRichTextPlainText(const wxString& text, wxRichTextObject*
         SetAttributes(*style);
 
     m_text = text;
+    m_extentsCache = NULL;
+}
+
+wxRichTextPlainText::~wxRichTextPlainText()
+{
+    delete m_extentsCache;
+}
+
+void wxRichTextPlainText::ClearExtentsCache()
+{
+    wxDELETE(m_extentsCache);
 }
 
 #define USE_KERNING_FIX 1
@@ -7077,6 +7370,7 @@ void wxRichTextPlainText::Copy(const wxRichTextPlainText& obj)
     wxRichTextObject::Copy(obj);
 
     m_text = obj.m_text;
+    wxDELETE(m_extentsCache);
 }
 
 /// Get/set the object size for the given range. Returns false if the range
@@ -7153,6 +7447,54 @@ bool wxRichTextPlainText::GetRangeSize(const wxRichTextRange& range, wxSize& siz
 
     wxCoord w, h;
     int width = 0;
+
+    // Measuring the text is relatively slow, so remember the extents of the
+    // entire text if the context asks for it: they don't depend on the layout
+    // width and so can be reused when the paragraph is laid out again, until
+    // ClearExtentsCache() is called. Text with tabs and virtual text are not
+    // cached, the former depends on the position of the text and the latter
+    // could change at any moment.
+    const bool canCache = partialExtents && range == GetRange() &&
+                          (m_extentsCache || context.GetTextExtentsCacheEnabled()) &&
+                          !context.HasVirtualText(this) &&
+                          stringChunk.Find(wxT('\t')) == wxNOT_FOUND;
+    if (canCache)
+    {
+        double scaleX, scaleY;
+        dc.GetUserScale(&scaleX, &scaleY);
+
+        wxRichTextPlainTextExtents* const cache = m_extentsCache;
+        if (cache && cache->Matches(stringChunk, dc.GetFont(), dc.GetPPI(), scaleX, scaleY))
+        {
+            int oldWidth = 0;
+            if (partialExtents->GetCount() > 0)
+                oldWidth = (*partialExtents)[partialExtents->GetCount()-1];
+
+            const wxArrayInt& p = cache->m_extents;
+            for (size_t j = 0; j < p.GetCount(); j++)
+                partialExtents->Add(oldWidth + p[j]);
+
+            w = partialExtents->GetCount() > 0 ? (*partialExtents)[partialExtents->GetCount()-1] : 0;
+            size = wxSize(w, cache->m_charHeight);
+            descent = cache->m_descent;
+
+            if ( bScript )
+                dc.SetFont(font);
+
+            return true;
+        }
+
+        if (!cache)
+            m_extentsCache = new wxRichTextPlainTextExtents;
+
+        m_extentsCache->m_text = stringChunk;
+        m_extentsCache->m_font = dc.GetFont();
+        m_extentsCache->m_ppi = dc.GetPPI();
+        m_extentsCache->m_scaleX = scaleX;
+        m_extentsCache->m_scaleY = scaleY;
+        m_extentsCache->m_extents.Clear();
+    }
+
     if (stringChunk.Find(wxT('\t')) != wxNOT_FOUND)
     {
         // the string has a tab
@@ -7252,6 +7594,9 @@ bool wxRichTextPlainText::GetRangeSize(const wxRichTextRange& range, wxSize& siz
             size_t j;
             for (j = 0; j < p.GetCount(); j++)
                 partialExtents->Add(oldWidth + p[j]);
+
+            if (canCache)
+                m_extentsCache->m_extents = p;
         }
         else
         {
@@ -7278,6 +7623,12 @@ bool wxRichTextPlainText::GetRangeSize(const wxRichTextRange& range, wxSize& siz
     if (!haveDescent)
         dc.GetTextExtent(wxT("X"), & w, & h, & descent);
 
+    if (canCache)
+    {
+        m_extentsCache->m_charHeight = size.y;
+        m_extentsCache->m_descent = descent;
+    }
+
     if ( bScript )
         dc.SetFont(font);
 
@@ -11861,6 +12212,8 @@ bool wxRichTextAction::Do()
                         wxRichTextObject* obj = node->GetData();
                         node->SetData(m_object);
                         m_object = obj;
+
+                        parent->OnChildrenChanged();
                     }
                 }
             }
@@ -12230,6 +12583,7 @@ void wxRichTextAction::ApplyParagraphs(const wxRichTextParagraphLayoutBox& fragm
                 newPara->SetParent(container);
 
                 bufferParaNode->SetData(newPara);
+                container->OnChildrenChanged();
 
                 delete existingPara;
             }
@@ -375,6 +375,8 @@ void wxRichTextCtrl::Init()
     m_fullLayoutRequired = false;
     m_fullLayoutTime = 0;
     m_fullLayoutSavedPosition = 0;
+    m_fullLayoutNextPosition = 0;
+    m_fullLayoutPartHeight = 0;
     m_delayedLayoutThreshold = wxRICHTEXT_DEFAULT_DELAYED_LAYOUT_THRESHOLD;
     m_caretPositionForDefaultStyle = -2;
     m_focusObject = & m_buffer;
@@ -2815,6 +2817,7 @@ void wxRichTextCtrl::OnSize(wxSizeEvent& event)
         m_fullLayoutRequired = true;
         m_fullLayoutTime = wxGetLocalTimeMillis();
         m_fullLayoutSavedPosition = GetFirstVisiblePosition();
+        m_fullLayoutNextPosition = 0;
         LayoutContent(true /* onlyVisibleRect */);
     }
     else
@@ -2834,6 +2837,31 @@ void wxRichTextCtrl::OnSize(wxSizeEvent& event)
     event.Skip();
 }
 
+// Free the text extents cached while laying out the visible part of the
+// buffer after resizing it.
+static void wxRichTextClearExtentsCache(wxRichTextCompositeObject& obj)
+{
+    wxRichTextObjectList::compatibility_iterator node = obj.GetChildren().GetFirst();
+    while (node)
+    {
+        wxRichTextObject* child = node->GetData();
+
+        wxRichTextPlainText* text = wxDynamicCast(child, wxRichTextPlainText);
+        if (text)
+        {
+            text->ClearExtentsCache();
+        }
+        else
+        {
+            wxRichTextCompositeObject* composite = wxDynamicCast(child, wxRichTextCompositeObject);
+            if (composite)
+                wxRichTextClearExtentsCache(*composite);
+        }
+
+        node = node->GetNext();
+    }
+}
+
 // Force any pending layout due to large buffer
 void wxRichTextCtrl::ForceDelayedLayout()
 {
@@ -2841,6 +2869,7 @@ void wxRichTextCtrl::ForceDelayedLayout()
     {
         m_fullLayoutRequired = false;
         m_fullLayoutTime = 0;
+        wxRichTextClearExtentsCache(GetBuffer());
         GetBuffer().Invalidate(wxRICHTEXT_ALL);
         ShowPosition(m_fullLayoutSavedPosition);
         Refresh(false);
@@ -2864,11 +2893,20 @@ void wxRichTextCtrl::OnIdle(wxIdleEvent& event)
 
     if (m_fullLayoutRequired && (wxGetLocalTimeMillis() > (m_fullLayoutTime + layoutInterval)))
     {
-        m_fullLayoutRequired = false;
-        m_fullLayoutTime = 0;
-        GetBuffer().Invalidate(wxRICHTEXT_ALL);
-        ShowPosition(m_fullLayoutSavedPosition);
-        Refresh(false);
+        // Only the visible part has been laid out after resizing, do the rest
+        // of the buffer now, but without blocking for too long if it's big.
+        if (LayoutNextPart())
+        {
+            event.RequestMore();
+        }
+        else
+        {
+            m_fullLayoutRequired = false;
+            m_fullLayoutTime = 0;
+            wxRichTextClearExtentsCache(GetBuffer());
+            SetupScrollbars();
+            Refresh(false);
+        }
     }
 
     const int imageProcessingInterval = wxRICHTEXT_DEFAULT_DELAYED_IMAGE_PROCESSING_INTERVAL;
@@ -4284,6 +4322,11 @@ bool wxRichTextCtrl::LayoutContent(bool onlyVisibleRect)
         dc.SetUserScale(GetScale(), GetScale());
 
         wxRichTextDrawingContext context(& GetBuffer());
+
+        // The visible part is laid out again on every resize until the full
+        // layout is done, so keep the extents of its text until then.
+        context.EnableTextExtentsCache(onlyVisibleRect && m_fullLayoutRequired);
+
         GetBuffer().Defragment(context);
         GetBuffer().UpdateRanges();     // If items were deleted, ranges need recalculation
         DoLayoutBuffer(GetBuffer(), dc, context, availableSpace, availableSpace, flags);
@@ -4306,6 +4349,96 @@ void wxRichTextCtrl::DoLayoutBuffer(wxRichTextBuffer& buffer, wxDC& dc, wxRichTe
     buffer.Layout(dc, context, rect, parentRect, flags);
 }
 
+bool wxRichTextCtrl::LayoutNextPart()
+{
+    wxRichTextBuffer& buffer = GetBuffer();
+
+    wxRichTextParagraph* para = buffer.GetParagraphAtPosition(m_fullLayoutNextPosition);
+    if (!para || buffer.IsDirty())
+    {
+        // Something changed since we started, just lay out everything.
+        buffer.Invalidate(wxRICHTEXT_ALL);
+        ShowPosition(m_fullLayoutSavedPosition);
+        return false;
+    }
+
+    // Remember where the first visible line is relative to the window, to
+    // keep it there even if the height of the text above it changes.
+    const int viewY = GetUnscaledPoint(GetLogicalPoint(wxPoint(0, 0))).y;
+    int savedLineOffset = 0;
+    wxRichTextLine* line = buffer.GetLineAtPosition(m_fullLayoutSavedPosition);
+    if (line)
+        savedLineOffset = line->GetAbsolutePosition().y - viewY;
+
+    wxRect availableSpace(GetUnscaledSize(GetClientSize()));
+    if (availableSpace.width == 0)
+        availableSpace.width = 10;
+    if (availableSpace.height == 0)
+        availableSpace.height = 10;
+
+    if (m_fullLayoutPartHeight < availableSpace.height)
+        m_fullLayoutPartHeight = availableSpace.height;
+
+    // Use the existing, out of date, layout to estimate which paragraphs fit
+    // into the part to lay out now: only they are laid out again while the
+    // rest of the buffer is just moved, which is much faster.
+    long endPos = buffer.GetOwnRange().GetEnd();
+    line = buffer.GetLineAtYPosition(para->GetPosition().y + m_fullLayoutPartHeight);
+    if (line && line->GetParent()->GetRange().GetEnd() < endPos)
+        endPos = line->GetParent()->GetRange().GetEnd();
+
+    buffer.Invalidate(wxRichTextRange(m_fullLayoutNextPosition, endPos));
+
+    wxClientDC dc(this);
+
+    PrepareDC(dc);
+    dc.SetFont(GetFont());
+    dc.SetUserScale(GetScale(), GetScale());
+
+    const wxLongLong startTime = wxGetLocalTimeMillis();
+
+    wxRichTextDrawingContext context(& buffer);
+    DoLayoutBuffer(buffer, dc, context, availableSpace, availableSpace,
+                   wxRICHTEXT_FIXED_WIDTH|wxRICHTEXT_VARIABLE_HEIGHT);
+    buffer.Invalidate(wxRICHTEXT_NONE);
+
+    dc.SetUserScale(1.0, 1.0);
+
+    // Adjust the amount of text laid out at once to take approximately the
+    // desired time.
+    const long duration = (wxGetLocalTimeMillis() - startTime).ToLong();
+    if (duration < wxRICHTEXT_DEFAULT_LAYOUT_PART_DURATION/2)
+        m_fullLayoutPartHeight *= 2;
+    else if (duration > wxRICHTEXT_DEFAULT_LAYOUT_PART_DURATION)
+        m_fullLayoutPartHeight /= 2;
+
+    // Restore the scroll position.
+    line = buffer.GetLineAtPosition(m_fullLayoutSavedPosition);
+    if (line && !IsFrozen())
+    {
+        SetupScrollbars();
+
+        int ppuX, ppuY;
+        GetScrollPixelsPerUnit(& ppuX, & ppuY);
+        if (ppuY > 0)
+        {
+            int y = line->GetAbsolutePosition().y - savedLineOffset;
+            y = (int) (0.5 + GetScale() * y);
+            if (y < 0)
+                y = 0;
+
+            int startX, startY;
+            GetViewStart(& startX, & startY);
+            if (y / ppuY != startY)
+                Scroll(-1, y / ppuY);
+        }
+    }
+
+    m_fullLayoutNextPosition = endPos + 1;
+
+    return m_fullLayoutNextPosition <= buffer.GetOwnRange().GetEnd();
+}
+
 /// Is all of the selection, or the current caret position, bold?
 bool wxRichTextCtrl::IsSelectionBold()
 {
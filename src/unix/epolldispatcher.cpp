@@ -23,6 +23,8 @@
 #include "wx/unix/private/epolldispatcher.h"
 #include "wx/unix/private.h"
 #include "wx/stopwatch.h"
+#include "wx/sysopt.h"
+#include "wx/scopedarray.h"
 
 #ifndef WX_PRECOMP
     #include "wx/log.h"
@@ -68,6 +70,13 @@ static uint32_t GetEpollMask(int flags, int fd)
                    wxT("Registered fd %d for exceptional events"), fd);
     }
 
+    if ( flags & wxFDIO_EDGE_TRIGGERED )
+    {
+        ep |= EPOLLET;
+        wxLogTrace(wxEpollDispatcher_Trace,
+                   wxT("Registered fd %d as edge-triggered"), fd);
+    }
+
     return ep;
 }
 
@@ -94,10 +103,24 @@ wxEpollDispatcher::wxEpollDispatcher(int epollDescriptor)
     wxASSERT_MSG( epollDescriptor != -1, wxT("invalid descriptor") );
 
     m_epollDescriptor = epollDescriptor;
+
+    m_maxEvents = 256;
+    if ( wxSystemOptions::HasOption(wxT("unix.epoll.max-events")) )
+    {
+        const int maxEvents =
+            wxSystemOptions::GetOptionInt(wxT("unix.epoll.max-events"));
+        if ( maxEvents > 0 )
+            m_maxEvents = maxEvents;
+    }
+
+    m_events = new epoll_event[m_maxEvents];
+    m_eventsInUse = false;
 }
 
 wxEpollDispatcher::~wxEpollDispatcher()
 {
+    delete [] m_events;
+
     if ( close(m_epollDescriptor) != 0 )
     {
         wxLogSysError(_("Error closing epoll descriptor"));
@@ -204,9 +227,17 @@ bool wxEpollDispatcher::HasPending() const
 
 int wxEpollDispatcher::Dispatch(int timeout)
 {
-    epoll_event events[16];
+    // the handlers can call Dispatch() recursively (e.g. by yielding), so
+    // use a temporary buffer if ours is being used by the outer call
+    epoll_event *events = m_events;
+    wxScopedArray<epoll_event> eventsNested;
+    if ( m_eventsInUse )
+    {
+        eventsNested.reset(new epoll_event[m_maxEvents]);
+        events = eventsNested.get();
+    }
 
-    const int rc = DoPoll(events, WXSIZEOF(events), timeout);
+    const int rc = DoPoll(events, m_maxEvents, timeout);
 
     if ( rc == -1 )
     {
@@ -215,6 +246,9 @@ int wxEpollDispatcher::Dispatch(int timeout)
         return -1;
     }
 
+    const bool eventsWereInUse = m_eventsInUse;
+    m_eventsInUse = true;
+
     int numEvents = 0;
     for ( epoll_event *p = events; p < events + rc; p++ )
     {
@@ -241,6 +275,8 @@ int wxEpollDispatcher::Dispatch(int timeout)
         numEvents++;
     }
 
+    m_eventsInUse = eventsWereInUse;
+
     return numEvents;
 }
 
@@ -45,6 +45,42 @@
     #include "wx/evtloopsrc.h"
 #endif // wxUSE_EVENTLOOP_SOURCE
 
+#if wxUSE_TIMER && defined(wxHAS_TIMERFD)
+    #include <sys/timerfd.h>
+    #include <errno.h>
+    #include <unistd.h>
+
+namespace
+{
+
+// Handler just resetting the timerfd when it expires, the timers themselves
+// are notified by DispatchTimeout().
+class wxTimerFDHandler : public wxEventLoopSourceHandler
+{
+public:
+    explicit wxTimerFDHandler(int fd) : m_fd(fd) { }
+
+    virtual void OnReadWaiting() wxOVERRIDE
+    {
+        wxUint64 expirations;
+        while ( read(m_fd, &expirations, sizeof(expirations)) == -1 &&
+                    errno == EINTR )
+            ;
+    }
+
+    virtual void OnWriteWaiting() wxOVERRIDE { }
+    virtual void OnExceptionWaiting() wxOVERRIDE { }
+
+private:
+    const int m_fd;
+
+    wxDECLARE_NO_COPY_CLASS(wxTimerFDHandler);
+};
+
+} // anonymous namespace
+
+#endif // wxUSE_TIMER && wxHAS_TIMERFD
+
 // ===========================================================================
 // wxEventLoop implementation
 // ===========================================================================
@@ -60,6 +96,32 @@ wxConsoleEventLoop::wxConsoleEventLoop()
     m_wakeupPipe = NULL;
     m_wakeupSource = NULL;
 
+#if wxUSE_TIMER && defined(wxHAS_TIMERFD)
+    m_timerArmed = false;
+    m_timerHandler = NULL;
+    m_timerSource = NULL;
+
+    // If we can't create the timerfd, we just wait for the timers using the
+    // dispatcher timeout as usual.
+    m_timerFD = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if ( m_timerFD != -1 )
+    {
+        m_timerHandler = new wxTimerFDHandler(m_timerFD);
+        m_timerSource = wxEventLoopBase::AddSourceForFD
+                                         (
+                                            m_timerFD,
+                                            m_timerHandler,
+                                            wxFDIO_INPUT
+                                         );
+        if ( !m_timerSource )
+        {
+            wxDELETE(m_timerHandler);
+            close(m_timerFD);
+            m_timerFD = -1;
+        }
+    }
+#endif // wxUSE_TIMER && wxHAS_TIMERFD
+
     // Create the pipe.
     wxScopedPtr<wxWakeUpPipeMT> wakeupPipe(new wxWakeUpPipeMT);
     const int pipeFD = wakeupPipe->GetReadFd();
@@ -90,6 +152,15 @@ wxConsoleEventLoop::wxConsoleEventLoop()
 
 wxConsoleEventLoop::~wxConsoleEventLoop()
 {
+#if wxUSE_TIMER && defined(wxHAS_TIMERFD)
+    if ( m_timerFD != -1 )
+    {
+        delete m_timerSource;
+        delete m_timerHandler;
+        close(m_timerFD);
+    }
+#endif // wxUSE_TIMER && wxHAS_TIMERFD
+
     if ( m_wakeupPipe )
     {
         delete m_wakeupSource;
@@ -183,10 +254,44 @@ int wxConsoleEventLoop::DispatchTimeout(unsigned long timeout)
     wxUsecClock_t nextTimer;
     if ( wxTimerScheduler::Get().GetNext(&nextTimer) )
     {
-        unsigned long timeUntilNextTimer = wxMilliClockToLong(nextTimer / 1000);
-        if ( timeUntilNextTimer < timeout )
-            timeout = timeUntilNextTimer;
+#ifdef wxHAS_TIMERFD
+        // Notice that we can't arm the timer for 0 delay as this would
+        // disarm it instead, so use the timeout for the expired timers.
+        if ( m_timerFD != -1 && nextTimer > 0 )
+        {
+            const long sec = wxMilliClockToLong(nextTimer / 1000000);
+            const long usec = wxMilliClockToLong(nextTimer -
+                                                 wxUsecClock_t(sec)*1000000);
+
+            itimerspec spec;
+            spec.it_interval.tv_sec = 0;
+            spec.it_interval.tv_nsec = 0;
+            spec.it_value.tv_sec = sec;
+            spec.it_value.tv_nsec = usec*1000;
+            if ( timerfd_settime(m_timerFD, 0, &spec, NULL) == 0 )
+            {
+                m_timerArmed = true;
+                nextTimer = -1;
+            }
+        }
+
+        if ( nextTimer >= 0 )
+#endif // wxHAS_TIMERFD
+        {
+            unsigned long timeUntilNextTimer = wxMilliClockToLong(nextTimer / 1000);
+            if ( timeUntilNextTimer < timeout )
+                timeout = timeUntilNextTimer;
+        }
+    }
+#ifdef wxHAS_TIMERFD
+    else if ( m_timerArmed )
+    {
+        // There are no more timers, so don't wake up unnecessarily.
+        const itimerspec spec = { { 0, 0 }, { 0, 0 } };
+        timerfd_settime(m_timerFD, 0, &spec, NULL);
+        m_timerArmed = false;
     }
+#endif // wxHAS_TIMERFD
 #endif // wxUSE_TIMER
 
     bool hadEvent = m_dispatcher->Dispatch(timeout) > 0;
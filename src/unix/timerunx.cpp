@@ -23,7 +23,6 @@
     #include "wx/log.h"
     #include "wx/module.h"
     #include "wx/app.h"
-    #include "wx/list.h"
     #include "wx/hashmap.h"
     #include "wx/event.h"
 #endif
@@ -37,9 +36,7 @@
 #include <signal.h>
 
 #include "wx/unix/private/timer.h"
-
-#include "wx/listimpl.cpp"
-WX_DEFINE_LIST(wxTimerList)
+#include "wx/sysopt.h"
 
 // trace mask for the debugging messages used here
 #define wxTrace_Timer wxT("timer")
@@ -50,58 +47,132 @@ WX_DEFINE_LIST(wxTimerList)
 
 wxTimerScheduler *wxTimerScheduler::ms_instance = NULL;
 
+wxTimerScheduler::wxTimerScheduler()
+{
+    m_nextOrder = 0;
+    m_slack = wxSystemOptions::GetOptionInt(wxT("unix.timer.slack"))*1000;
+}
+
 wxTimerScheduler::~wxTimerScheduler()
 {
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    for ( size_t n = 0; n < m_timers.size(); n++ )
     {
-        delete *node;
+        m_timers[n]->m_timer->SetSchedule(NULL);
+        delete m_timers[n];
     }
 }
 
-void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
+bool wxTimerScheduler::IsBefore(size_t n1, size_t n2) const
 {
-    DoAddTimer(new wxTimerSchedule(timer, expiration));
+    const wxTimerSchedule * const s1 = m_timers[n1];
+    const wxTimerSchedule * const s2 = m_timers[n2];
+
+    if ( s1->m_expiration != s2->m_expiration )
+        return s1->m_expiration < s2->m_expiration;
+
+    // use wrap-around safe comparison for the order
+    return static_cast<long>(s1->m_order - s2->m_order) < 0;
 }
 
-void wxTimerScheduler::DoAddTimer(wxTimerSchedule *s)
+void wxTimerScheduler::SetAt(size_t n, wxTimerSchedule *s)
+{
+    m_timers[n] = s;
+    s->m_heapIndex = n;
+}
+
+void wxTimerScheduler::SiftUp(size_t n)
+{
+    wxTimerSchedule * const s = m_timers[n];
+    while ( n > 0 )
+    {
+        const size_t parent = (n - 1) / 2;
+
+        // temporarily put the element being moved in its candidate position
+        // to be able to use IsBefore()
+        m_timers[n] = s;
+        if ( !IsBefore(n, parent) )
+            break;
+
+        SetAt(n, m_timers[parent]);
+        n = parent;
+    }
+
+    SetAt(n, s);
+}
+
+void wxTimerScheduler::SiftDown(size_t n)
 {
-    // do an insertion sort to keep the list sorted in expiration order
-    wxTimerList::iterator node;
-    for ( node = m_timers.begin(); node != m_timers.end(); ++node )
+    const size_t count = m_timers.size();
+    for ( ;; )
     {
-        wxASSERT_MSG( (*node)->m_timer != s->m_timer,
-                      wxT("adding the same timer twice?") );
+        size_t first = n;
+
+        const size_t left = 2*n + 1;
+        if ( left < count && IsBefore(left, first) )
+            first = left;
 
-        if ( (*node)->m_expiration > s->m_expiration )
+        const size_t right = left + 1;
+        if ( right < count && IsBefore(right, first) )
+            first = right;
+
+        if ( first == n )
             break;
+
+        wxTimerSchedule * const s = m_timers[n];
+        SetAt(n, m_timers[first]);
+        SetAt(first, s);
+        n = first;
     }
+}
+
+void wxTimerScheduler::AddTimer(wxUnixTimerImpl *timer, wxUsecClock_t expiration)
+{
+    wxASSERT_MSG( !timer->GetSchedule(), wxT("adding the same timer twice?") );
 
-    m_timers.insert(node, s);
+    DoAddTimer(new wxTimerSchedule(timer, expiration));
+}
+
+void wxTimerScheduler::DoAddTimer(wxTimerSchedule *s)
+{
+    s->m_order = m_nextOrder++;
+    s->m_timer->SetSchedule(s);
+
+    m_timers.push_back(s);
+    SiftUp(m_timers.size() - 1);
 
     wxLogTrace(wxTrace_Timer, wxT("Inserted timer %d expiring at %s"),
                s->m_timer->GetId(),
                s->m_expiration.ToString());
 }
 
-void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
+wxTimerSchedule *wxTimerScheduler::DoRemoveAt(size_t n)
 {
-    wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
+    wxTimerSchedule * const s = m_timers[n];
 
-    for ( wxTimerList::iterator node = m_timers.begin();
-          node != m_timers.end();
-          ++node )
+    // replace the removed element with the last one and restore the heap
+    // invariant by moving it in the appropriate direction
+    wxTimerSchedule * const last = m_timers.back();
+    m_timers.pop_back();
+    if ( last != s )
     {
-        if ( (*node)->m_timer == timer )
-        {
-            delete *node;
-            m_timers.erase(node);
-            return;
-        }
+        SetAt(n, last);
+        SiftDown(n);
+        SiftUp(last->m_heapIndex);
     }
 
-    wxFAIL_MSG( wxT("removing inexistent timer?") );
+    s->m_timer->SetSchedule(NULL);
+
+    return s;
+}
+
+void wxTimerScheduler::RemoveTimer(wxUnixTimerImpl *timer)
+{
+    wxLogTrace(wxTrace_Timer, wxT("Removing timer %d"), timer->GetId());
+
+    wxTimerSchedule * const s = timer->GetSchedule();
+    wxCHECK_RET( s, wxT("removing inexistent timer?") );
+
+    delete DoRemoveAt(s->m_heapIndex);
 }
 
 bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
@@ -111,7 +182,17 @@ bool wxTimerScheduler::GetNext(wxUsecClock_t *remaining) const
 
     wxCHECK_MSG( remaining, false, wxT("NULL pointer") );
 
-    *remaining = (*m_timers.begin())->m_expiration - wxGetUTCTimeUSec();
+    wxUsecClock_t expiration = m_timers[0]->m_expiration;
+    if ( m_slack > 0 )
+    {
+        // round the wake up time up to the multiple of the slack, so that all
+        // timers expiring during the same slack interval are notified at once
+        const wxUsecClock_t rest = expiration % m_slack;
+        if ( rest != 0 )
+            expiration += m_slack - rest;
+    }
+
+    *remaining = expiration - wxGetUTCTimeUSec();
     if ( *remaining < 0 )
     {
         // timer already expired, don't wait at all before notifying it
@@ -128,30 +209,34 @@ bool wxTimerScheduler::NotifyExpired()
 
     const wxUsecClock_t now = wxGetUTCTimeUSec();
 
-    typedef wxVector<wxUnixTimerImpl *> TimerImpls;
-    TimerImpls toNotify;
-    for ( wxTimerList::iterator next,
-            cur = m_timers.begin(); cur != m_timers.end(); cur = next )
+    // first take all the expired timers from the heap: we can't reschedule
+    // the periodic ones immediately as they could expire again if we're late
+    typedef wxVector<wxTimerSchedule *> TimerSchedules;
+    TimerSchedules expired;
+    while ( !m_timers.empty() && m_timers[0]->m_expiration <= now )
     {
-        wxTimerSchedule * const s = *cur;
-        if ( s->m_expiration > now )
-        {
-            // as the list is sorted by expiration time, we can skip the rest
-            break;
-        }
+        expired.push_back(DoRemoveAt(0));
+    }
 
-        // remember next as we will delete the node pointed to by cur
-        next = cur;
-        ++next;
+    if ( expired.empty() )
+        return false;
 
-        m_timers.erase(cur);
+    typedef wxVector<wxUnixTimerImpl *> TimerImpls;
+    TimerImpls toNotify;
+    toNotify.reserve(expired.size());
+    for ( TimerSchedules::const_iterator i = expired.begin(),
+                                         end = expired.end();
+          i != end;
+          ++i )
+    {
+        wxTimerSchedule * const s = *i;
 
         // check whether we need to keep this timer
         wxUnixTimerImpl * const timer = s->m_timer;
         if ( timer->IsOneShot() )
         {
             // the timer needs to be stopped but don't call its Stop() from
-            // here as it would attempt to remove the timer from our list and
+            // here as it would attempt to remove the timer from our heap and
             // we had already done it, so we just need to reset its state
             timer->MarkStopped();
 
@@ -170,14 +255,10 @@ bool wxTimerScheduler::NotifyExpired()
 
         // we can't notify the timer from this loop as the timer event handler
         // could modify m_timers (for example, but not only, by stopping this
-        // timer) which would render our iterators invalid, so do it after the
-        // loop end
+        // timer), so do it after the loop end
         toNotify.push_back(timer);
     }
 
-    if ( toNotify.empty() )
-        return false;
-
     for ( TimerImpls::const_iterator i = toNotify.begin(),
                                      end = toNotify.end();
           i != end;
@@ -197,6 +278,7 @@ wxUnixTimerImpl::wxUnixTimerImpl(wxTimer* timer)
                : wxTimerImpl(timer)
 {
     m_isRunning = false;
+    m_schedule = NULL;
 }
 
 bool wxUnixTimerImpl::Start(int milliseconds, bool oneShot)
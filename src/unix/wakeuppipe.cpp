@@ -29,6 +29,10 @@
 
 #include <errno.h>
 
+#ifdef wxHAS_EVENTFD
+    #include <sys/eventfd.h>
+#endif
+
 // ----------------------------------------------------------------------------
 // constants
 // ----------------------------------------------------------------------------
@@ -47,6 +51,17 @@ wxWakeUpPipe::wxWakeUpPipe()
 {
     m_pipeIsEmpty = true;
 
+#ifdef wxHAS_EVENTFD
+    // Prefer eventfd if it's available, but fall back to the pipe if it
+    // isn't supported by the running kernel.
+    m_eventFD = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if ( m_eventFD != wxPipe::INVALID_FD )
+    {
+        wxLogTrace(TRACE_EVENTS, wxT("Wake up eventfd %d created"), m_eventFD);
+        return;
+    }
+#endif // wxHAS_EVENTFD
+
     if ( !m_pipe.Create() )
     {
         wxLogError(_("Failed to create wake up pipe used by event loop."));
@@ -64,6 +79,14 @@ wxWakeUpPipe::wxWakeUpPipe()
                m_pipe[wxPipe::Read], m_pipe[wxPipe::Write]);
 }
 
+wxWakeUpPipe::~wxWakeUpPipe()
+{
+#ifdef wxHAS_EVENTFD
+    if ( m_eventFD != wxPipe::INVALID_FD )
+        close(m_eventFD);
+#endif // wxHAS_EVENTFD
+}
+
 // ----------------------------------------------------------------------------
 // wakeup handling
 // ----------------------------------------------------------------------------
@@ -74,6 +97,25 @@ void wxWakeUpPipe::WakeUpNoLock()
     if ( !m_pipeIsEmpty )
       return;
 
+#ifdef wxHAS_EVENTFD
+    if ( m_eventFD != wxPipe::INVALID_FD )
+    {
+        // Notice that we can't use eventfd_write() here as this function is
+        // called from signal handlers and only write() is safe to use there.
+        const wxUint64 value = 1;
+        if ( write(m_eventFD, &value, sizeof(value)) != sizeof(value) )
+        {
+            perror("write(wake up eventfd)");
+        }
+        else
+        {
+            m_pipeIsEmpty = false;
+        }
+
+        return;
+    }
+#endif // wxHAS_EVENTFD
+
     if ( write(m_pipe[wxPipe::Write], "s", 1) != 1 )
     {
         // don't use wxLog here, we can be in another thread and this could
@@ -92,14 +134,21 @@ void wxWakeUpPipe::OnReadWaiting()
     // got wakeup from child thread, remove the data that provoked it from the
     // pipe
 
-    char buf[4];
+    // Notice that reading from eventfd requires a buffer of at least 8 bytes
+    // and always resets its counter, so we never get more than that from it.
+    char buf[8];
     for ( ;; )
     {
         const int size = read(GetReadFd(), buf, WXSIZEOF(buf));
 
         if ( size > 0 )
         {
-            wxASSERT_MSG( size == 1, "Too many writes to wake-up pipe?" );
+#ifdef wxHAS_EVENTFD
+            if ( m_eventFD == wxPipe::INVALID_FD )
+#endif // wxHAS_EVENTFD
+            {
+                wxASSERT_MSG( size == 1, "Too many writes to wake-up pipe?" );
+            }
 
             break;
         }
@@ -30,6 +30,7 @@
 #include "wx/strconv.h"
 #include "wx/scopedptr.h"
 #include "wx/versioninfo.h"
+#include "wx/vector.h"
 
 #include "expat.h" // from Expat
 
@@ -600,6 +601,53 @@ bool wxIsWhiteOnly(const wxString& buf)
 }
 
 
+// extracts the version and encoding from the XML declaration, if s is one
+static void ParseXmlDeclaration(wxMBConv *conv, const char *s, int len,
+                                wxString& version, wxString& encoding)
+{
+    if (len > 6 && memcmp(s, "<?xml ", 6) == 0)
+    {
+        wxString buf = CharToString(conv, s, (size_t)len);
+        int pos;
+        pos = buf.Find(wxS("encoding="));
+        if (pos != wxNOT_FOUND)
+            encoding = buf.Mid(pos + 10).BeforeFirst(buf[(size_t)pos+9]);
+        pos = buf.Find(wxS("version="));
+        if (pos != wxNOT_FOUND)
+            version = buf.Mid(pos + 9).BeforeFirst(buf[(size_t)pos+8]);
+    }
+}
+
+// feeds the next chunk of the stream to the parser, returns false and logs an
+// error if parsing it failed, done is set to true after the last chunk
+static bool ParseNextChunk(XML_Parser parser, wxInputStream& stream, bool& done)
+{
+    // read directly into the parser buffer to avoid copying the data
+    const size_t BUFSIZE = 16384;
+    void * const buf = XML_GetBuffer(parser, BUFSIZE);
+    if ( !buf )
+    {
+        wxLogError(_("XML parsing error: '%s' at line %d"),
+                   _("out of memory"),
+                   (int)XML_GetCurrentLineNumber(parser));
+        return false;
+    }
+
+    size_t len = stream.Read(buf, BUFSIZE).LastRead();
+    done = (len < BUFSIZE);
+    if (!XML_ParseBuffer(parser, len, done))
+    {
+        wxString error(XML_ErrorString(XML_GetErrorCode(parser)),
+                       *wxConvCurrent);
+        wxLogError(_("XML parsing error: '%s' at line %d"),
+                   error.c_str(),
+                   (int)XML_GetCurrentLineNumber(parser));
+        return false;
+    }
+
+    return true;
+}
+
 struct wxXmlParsingContext
 {
     wxXmlParsingContext()
@@ -615,11 +663,22 @@ struct wxXmlParsingContext
     wxXmlNode *node;                    // the node being parsed
     wxXmlNode *lastChild;               // the last child of "node"
     wxXmlNode *lastAsText;              // the last _text_ child of "node"
+    wxString   text;                    // the contents of lastAsText
     wxString   encoding;
     wxString   version;
     bool       removeWhiteOnlyNodes;
 };
 
+// the text of the text and CDATA nodes is accumulated in ctx->text instead of
+// being appended to the node content directly, as doing the latter for every
+// line of the text would take quadratic time, so this function must be called
+// to update lastAsText before modifying it
+static void FlushText(wxXmlParsingContext *ctx)
+{
+    if (ctx->lastAsText)
+        ctx->lastAsText->SetContent(ctx->text);
+}
+
 // checks that ctx->lastChild is in consistent state
 #define ASSERT_LAST_CHILD_OK(ctx)                                   \
     wxASSERT( ctx->lastChild == NULL ||                             \
@@ -631,6 +690,8 @@ extern "C" {
 static void StartElementHnd(void *userData, const char *name, const char **atts)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    FlushText(ctx);
+
     wxXmlNode *node = new wxXmlNode(wxXML_ELEMENT_NODE,
                                     CharToString(ctx->conv, name),
                                     wxEmptyString,
@@ -655,6 +716,7 @@ static void StartElementHnd(void *userData, const char *name, const char **atts)
 static void EndElementHnd(void *userData, const char* WXUNUSED(name))
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    FlushText(ctx);
 
     // we're exiting the last children of ctx->node->GetParent() and going
     // back one level up, so current value of ctx->node points to the last
@@ -672,7 +734,7 @@ static void TextHnd(void *userData, const char *s, int len)
 
     if (ctx->lastAsText)
     {
-        ctx->lastAsText->SetContent(ctx->lastAsText->GetContent() + str);
+        ctx->text += str;
     }
     else
     {
@@ -683,12 +745,13 @@ static void TextHnd(void *userData, const char *s, int len)
         if (!whiteOnly)
         {
             wxXmlNode *textnode =
-                new wxXmlNode(wxXML_TEXT_NODE, wxS("text"), str,
+                new wxXmlNode(wxXML_TEXT_NODE, wxS("text"), wxS(""),
                               XML_GetCurrentLineNumber(ctx->parser));
 
             ASSERT_LAST_CHILD_OK(ctx);
             ctx->node->InsertChildAfter(textnode, ctx->lastChild);
             ctx->lastChild= ctx->lastAsText = textnode;
+            ctx->text = str;
         }
     }
 }
@@ -696,6 +759,7 @@ static void TextHnd(void *userData, const char *s, int len)
 static void StartCdataHnd(void *userData)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    FlushText(ctx);
 
     wxXmlNode *textnode =
         new wxXmlNode(wxXML_CDATA_SECTION_NODE, wxS("cdata"), wxS(""),
@@ -704,11 +768,13 @@ static void StartCdataHnd(void *userData)
     ASSERT_LAST_CHILD_OK(ctx);
     ctx->node->InsertChildAfter(textnode, ctx->lastChild);
     ctx->lastChild= ctx->lastAsText = textnode;
+    ctx->text.clear();
 }
 
 static void EndCdataHnd(void *userData)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    FlushText(ctx);
 
     // we need to reset this pointer so that subsequent text nodes don't append
     // their contents to this one but create new wxXML_TEXT_NODE objects (or
@@ -720,6 +786,7 @@ static void EndCdataHnd(void *userData)
 static void CommentHnd(void *userData, const char *data)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    FlushText(ctx);
 
     wxXmlNode *commentnode =
         new wxXmlNode(wxXML_COMMENT_NODE,
@@ -735,6 +802,7 @@ static void CommentHnd(void *userData, const char *data)
 static void PIHnd(void *userData, const char *target, const char *data)
 {
     wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    FlushText(ctx);
 
     wxXmlNode *pinode =
         new wxXmlNode(wxXML_PI_NODE, CharToString(ctx->conv, target),
@@ -749,20 +817,9 @@ static void PIHnd(void *userData, const char *target, const char *data)
 
 static void DefaultHnd(void *userData, const char *s, int len)
 {
-    // XML header:
-    if (len > 6 && memcmp(s, "<?xml ", 6) == 0)
-    {
-        wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
+    wxXmlParsingContext *ctx = (wxXmlParsingContext*)userData;
 
-        wxString buf = CharToString(ctx->conv, s, (size_t)len);
-        int pos;
-        pos = buf.Find(wxS("encoding="));
-        if (pos != wxNOT_FOUND)
-            ctx->encoding = buf.Mid(pos + 10).BeforeFirst(buf[(size_t)pos+9]);
-        pos = buf.Find(wxS("version="));
-        if (pos != wxNOT_FOUND)
-            ctx->version = buf.Mid(pos + 9).BeforeFirst(buf[(size_t)pos+8]);
-    }
+    ParseXmlDeclaration(ctx->conv, s, len, ctx->version, ctx->encoding);
 }
 
 static int UnknownEncodingHnd(void * WXUNUSED(encodingHandlerData),
@@ -806,8 +863,6 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
     m_encoding = encoding;
 #endif
 
-    const size_t BUFSIZE = 1024;
-    char buf[BUFSIZE];
     wxXmlParsingContext ctx;
     bool done;
     XML_Parser parser = XML_ParserCreate(NULL);
@@ -835,15 +890,8 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
     bool ok = true;
     do
     {
-        size_t len = stream.Read(buf, BUFSIZE).LastRead();
-        done = (len < BUFSIZE);
-        if (!XML_Parse(parser, buf, len, done))
+        if (!ParseNextChunk(parser, stream, done))
         {
-            wxString error(XML_ErrorString(XML_GetErrorCode(parser)),
-                           *wxConvCurrent);
-            wxLogError(_("XML parsing error: '%s' at line %d"),
-                       error.c_str(),
-                       (int)XML_GetCurrentLineNumber(parser));
             ok = false;
             break;
         }
@@ -851,6 +899,8 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
 
     if (ok)
     {
+        FlushText(&ctx);
+
         if (!ctx.version.empty())
             SetVersion(ctx.version);
         if (!ctx.encoding.empty())
@@ -874,6 +924,351 @@ bool wxXmlDocument::Load(wxInputStream& stream, const wxString& encoding, int fl
 
 
 
+//-----------------------------------------------------------------------------
+//  wxXmlReader
+//-----------------------------------------------------------------------------
+
+// an item parsed by wxXmlReader
+struct wxXmlReaderItem
+{
+    wxXmlReaderItem() : event(wxXML_READER_NONE), depth(0), lineNo(-1) { }
+
+    wxXmlReaderEvent event;
+    wxString name;
+    wxString content;
+    wxVector<wxString> attrs;           // names and values, interleaved
+    int depth;
+    int lineNo;
+};
+
+class wxXmlReaderImpl
+{
+public:
+    wxXmlReaderImpl(wxInputStream& stream_)
+        : stream(stream_),
+          conv(NULL),
+          removeWhiteOnlyNodes(false),
+          head(0),
+          lastOpen(false),
+          depth(0),
+          done(false),
+          ok(true)
+    {
+    }
+
+    // the current item or an empty one if there is none
+    const wxXmlReaderItem& GetCurrent() const
+    {
+        return head < items.size() ? items[head] : empty;
+    }
+
+    // add a new item to the queue, closing the last one
+    wxXmlReaderItem& Add(wxXmlReaderEvent event)
+    {
+        CloseLast();
+
+        items.push_back(wxXmlReaderItem());
+
+        wxXmlReaderItem& item = items.back();
+        item.event = event;
+        item.depth = depth;
+        item.lineNo = XML_GetCurrentLineNumber(parser);
+        return item;
+    }
+
+    // the last text item may be continued by the next chunk of text, this
+    // function is called when we know that it won't be
+    void CloseLast()
+    {
+        if ( !lastOpen )
+            return;
+
+        lastOpen = false;
+
+        const wxXmlReaderItem& last = items.back();
+        if ( removeWhiteOnlyNodes &&
+                last.event == wxXML_READER_TEXT &&
+                    wxIsWhiteOnly(last.content) )
+            items.pop_back();
+    }
+
+    XML_Parser parser;
+    wxInputStream& stream;
+    wxMBConv *conv;
+    bool removeWhiteOnlyNodes;
+
+    // the items parsed but not consumed yet, the current one is at head
+    wxVector<wxXmlReaderItem> items;
+    size_t head;
+
+    // true if the last item is a text item which may still grow
+    bool lastOpen;
+
+    // the number of currently open elements
+    int depth;
+
+    bool done,
+         ok;
+
+    wxString version,
+             encoding;
+
+    const wxXmlReaderItem empty;
+};
+
+extern "C" {
+static void ReaderStartElementHnd(void *userData,
+                                  const char *name, const char **atts)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    wxXmlReaderItem& item = impl->Add(wxXML_READER_START_ELEMENT);
+    item.name = CharToString(impl->conv, name);
+
+    for ( const char **a = atts; *a; a++ )
+        item.attrs.push_back(CharToString(impl->conv, *a));
+
+    impl->depth++;
+}
+
+static void ReaderEndElementHnd(void *userData, const char *name)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    impl->depth--;
+
+    impl->Add(wxXML_READER_END_ELEMENT).name = CharToString(impl->conv, name);
+}
+
+static void ReaderTextHnd(void *userData, const char *s, int len)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    if ( !impl->lastOpen )
+    {
+        impl->Add(wxXML_READER_TEXT);
+        impl->lastOpen = true;
+    }
+
+    impl->items.back().content += CharToString(impl->conv, s, len);
+}
+
+static void ReaderStartCdataHnd(void *userData)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    impl->Add(wxXML_READER_CDATA);
+    impl->lastOpen = true;
+}
+
+static void ReaderEndCdataHnd(void *userData)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    // don't call CloseLast() as CDATA sections are never removed
+    impl->lastOpen = false;
+}
+
+static void ReaderCommentHnd(void *userData, const char *data)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    impl->Add(wxXML_READER_COMMENT).content = CharToString(impl->conv, data);
+}
+
+static void ReaderPIHnd(void *userData, const char *target, const char *data)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    wxXmlReaderItem& item = impl->Add(wxXML_READER_PI);
+    item.name = CharToString(impl->conv, target);
+    item.content = CharToString(impl->conv, data);
+}
+
+static void ReaderDefaultHnd(void *userData, const char *s, int len)
+{
+    wxXmlReaderImpl *impl = (wxXmlReaderImpl*)userData;
+
+    ParseXmlDeclaration(impl->conv, s, len, impl->version, impl->encoding);
+}
+} // extern "C"
+
+wxXmlReader::wxXmlReader(wxInputStream& stream,
+                         const wxString& encoding,
+                         int flags)
+{
+    m_impl = new wxXmlReaderImpl(stream);
+
+    m_impl->encoding = wxS("UTF-8"); // default in absence of encoding=""
+#if wxUSE_UNICODE
+    wxUnusedVar(encoding);
+#else
+    if ( encoding.CmpNoCase(wxS("UTF-8")) != 0 )
+        m_impl->conv = new wxCSConv(encoding);
+#endif
+    m_impl->removeWhiteOnlyNodes = (flags & wxXMLDOC_KEEP_WHITESPACE_NODES) == 0;
+
+    XML_Parser parser = XML_ParserCreate(NULL);
+    m_impl->parser = parser;
+
+    XML_SetUserData(parser, m_impl);
+    XML_SetElementHandler(parser, ReaderStartElementHnd, ReaderEndElementHnd);
+    XML_SetCharacterDataHandler(parser, ReaderTextHnd);
+    XML_SetCdataSectionHandler(parser, ReaderStartCdataHnd, ReaderEndCdataHnd);
+    XML_SetCommentHandler(parser, ReaderCommentHnd);
+    XML_SetProcessingInstructionHandler(parser, ReaderPIHnd);
+    XML_SetDefaultHandler(parser, ReaderDefaultHnd);
+    XML_SetUnknownEncodingHandler(parser, UnknownEncodingHnd, NULL);
+}
+
+wxXmlReader::~wxXmlReader()
+{
+    XML_ParserFree(m_impl->parser);
+    delete m_impl->conv;
+    delete m_impl;
+}
+
+bool wxXmlReader::IsOk() const
+{
+    return m_impl->ok;
+}
+
+bool wxXmlReader::Feed()
+{
+    if ( m_impl->done )
+        return false;
+
+    if ( !ParseNextChunk(m_impl->parser, m_impl->stream, m_impl->done) )
+    {
+        m_impl->ok = false;
+        m_impl->done = true;
+        return false;
+    }
+
+    if ( m_impl->done )
+        m_impl->CloseLast();
+
+    return true;
+}
+
+wxXmlReaderEvent wxXmlReader::Next()
+{
+    wxVector<wxXmlReaderItem>& items = m_impl->items;
+
+    size_t& head = m_impl->head;
+
+    // advance to the next item, forgetting all the previous ones if there are
+    // no more of them
+    if ( head < items.size() )
+        head++;
+
+    if ( head == items.size() )
+    {
+        items.clear();
+        head = 0;
+    }
+
+    // we can only return the last item once it's complete
+    while ( head == items.size() ||
+                (head + 1 == items.size() && m_impl->lastOpen) )
+    {
+        if ( head )
+        {
+            items.erase(items.begin(), items.begin() + head);
+            head = 0;
+        }
+
+        if ( !Feed() )
+            break;
+    }
+
+    return GetEvent();
+}
+
+wxXmlReaderEvent wxXmlReader::GetEvent() const
+{
+    return m_impl->GetCurrent().event;
+}
+
+const wxString& wxXmlReader::GetName() const
+{
+    return m_impl->GetCurrent().name;
+}
+
+const wxString& wxXmlReader::GetContent() const
+{
+    return m_impl->GetCurrent().content;
+}
+
+size_t wxXmlReader::GetAttributeCount() const
+{
+    return m_impl->GetCurrent().attrs.size() / 2;
+}
+
+const wxString& wxXmlReader::GetAttributeName(size_t n) const
+{
+    const wxVector<wxString>& attrs = m_impl->GetCurrent().attrs;
+    wxCHECK_MSG( 2*n < attrs.size(), m_impl->empty.name,
+                 "invalid attribute index" );
+
+    return attrs[2*n];
+}
+
+const wxString& wxXmlReader::GetAttributeValue(size_t n) const
+{
+    const wxVector<wxString>& attrs = m_impl->GetCurrent().attrs;
+    wxCHECK_MSG( 2*n < attrs.size(), m_impl->empty.name,
+                 "invalid attribute index" );
+
+    return attrs[2*n + 1];
+}
+
+bool wxXmlReader::HasAttribute(const wxString& attrName) const
+{
+    const wxVector<wxString>& attrs = m_impl->GetCurrent().attrs;
+    for ( size_t n = 0; n < attrs.size(); n += 2 )
+    {
+        if ( attrs[n] == attrName )
+            return true;
+    }
+
+    return false;
+}
+
+wxString wxXmlReader::GetAttribute(const wxString& attrName,
+                                   const wxString& defaultVal) const
+{
+    const wxVector<wxString>& attrs = m_impl->GetCurrent().attrs;
+    for ( size_t n = 0; n < attrs.size(); n += 2 )
+    {
+        if ( attrs[n] == attrName )
+            return attrs[n + 1];
+    }
+
+    return defaultVal;
+}
+
+int wxXmlReader::GetDepth() const
+{
+    return m_impl->GetCurrent().depth;
+}
+
+int wxXmlReader::GetLineNumber() const
+{
+    return m_impl->GetCurrent().lineNo;
+}
+
+const wxString& wxXmlReader::GetVersion() const
+{
+    return m_impl->version;
+}
+
+const wxString& wxXmlReader::GetFileEncoding() const
+{
+    return m_impl->encoding;
+}
+
+
 //-----------------------------------------------------------------------------
 //  wxXmlDocument saving routines
 //-----------------------------------------------------------------------------
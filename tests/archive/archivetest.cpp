@@ -1405,6 +1405,26 @@ string ArchiveTestSuite::Description(const wxString& type,
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// Helpers for the random access archive tests
+
+void WriteArchiveEntries(wxArchiveOutputStream& arc, int count)
+{
+    arc.PutNextDirEntry("dir");
+    for ( int n = 0; n < count; n++ )
+    {
+        arc.PutNextEntry(wxString::Format("dir/%d/file%d", n % 3, n));
+
+        // Use entries of different sizes, including empty ones.
+        for ( int i = 0; i < n; i++ )
+        {
+            const wxString line = wxString::Format("line %d\n", i);
+            arc.Write(line.utf8_str(), line.length());
+        }
+    }
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Instantiations
 
@@ -12,6 +12,8 @@
 #define WX_TEST_ARCHIVE_ITERATOR
 
 #include "wx/archive.h"
+#include "wx/filename.h"
+#include "wx/scopedptr.h"
 #include "wx/wfstream.h"
 
 
@@ -274,4 +276,61 @@ private:
     void AddCmd(wxArrayString& cmdlist, const wxString& cmd);
 };
 
+
+///////////////////////////////////////////////////////////////////////////////
+// Helpers for testing the random access archive classes, wxZipArchive and
+// wxTarArchive, with the entries written by WriteArchiveEntries()
+
+// Write a "dir" directory entry and the given number of "dir/<n%3>/file<n>"
+// entries of n lines each.
+void WriteArchiveEntries(wxArchiveOutputStream& arc, int count);
+
+// Check reading of an archive containing the entries written above.
+template <class ArchiveT>
+void CheckArchiveRead(const ArchiveT& archive)
+{
+    CPPUNIT_ASSERT( archive.IsOk() );
+
+    CPPUNIT_ASSERT_EQUAL( wxNOT_FOUND, archive.Find("nonexistent") );
+
+    const int n = archive.Find("dir/1/file10", wxPATH_UNIX);
+    CPPUNIT_ASSERT( n != wxNOT_FOUND );
+    CPPUNIT_ASSERT_EQUAL( "dir/1/file10", archive.GetEntry(n).GetInternalName() );
+
+    // Several streams for the same entry can be used at once.
+    wxScopedPtr<wxInputStream> in1(archive.OpenEntry(n)),
+                               in2(archive.OpenEntry(n));
+    CPPUNIT_ASSERT( in1 );
+    CPPUNIT_ASSERT( in2 );
+
+    char data1[100], data2[100];
+    CPPUNIT_ASSERT( in1->ReadAll(data1, 7) );
+    CPPUNIT_ASSERT( in2->ReadAll(data2, 7) );
+    CPPUNIT_ASSERT( memcmp(data1, "line 0\n", 7) == 0 );
+    CPPUNIT_ASSERT( memcmp(data2, "line 0\n", 7) == 0 );
+
+    in1->Read(data1, sizeof(data1));
+    CPPUNIT_ASSERT_EQUAL( archive.GetEntry(n).GetSize() - 7,
+                          (wxFileOffset)in1->LastRead() );
+    CPPUNIT_ASSERT_EQUAL( wxSTREAM_EOF, in1->GetLastError() );
+}
+
+// Extract an archive containing at least 50 entries written above into the
+// given directory and check the result. The caller is responsible for
+// removing the directory after performing any additional checks.
+template <class ArchiveT>
+void CheckArchiveExtract(const ArchiveT& archive, const wxString& dir)
+{
+    CPPUNIT_ASSERT( archive.IsOk() );
+    CPPUNIT_ASSERT( archive.ExtractAll(dir) );
+
+    CPPUNIT_ASSERT( wxFileName::DirExists(dir + "/dir/2") );
+    CPPUNIT_ASSERT( wxFileName::GetSize(dir + "/dir/0/file0") == 0 );
+    CPPUNIT_ASSERT_EQUAL
+    (
+        archive.GetEntry(archive.Find("dir/1/file49", wxPATH_UNIX)).GetSize(),
+        (wxFileOffset)wxFileName::GetSize(dir + "/dir/1/file49").GetValue()
+    );
+}
+
 #endif
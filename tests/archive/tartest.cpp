@@ -24,6 +24,124 @@
 using std::string;
 
 
+///////////////////////////////////////////////////////////////////////////////
+// wxTarArchive tests
+
+class TarArchiveTestCase : public CppUnit::TestCase
+{
+public:
+    TarArchiveTestCase() { }
+
+    virtual void setUp() wxOVERRIDE;
+    virtual void tearDown() wxOVERRIDE;
+
+private:
+    CPPUNIT_TEST_SUITE( TarArchiveTestCase );
+        CPPUNIT_TEST( Read );
+        CPPUNIT_TEST( Index );
+        CPPUNIT_TEST( Extract );
+    CPPUNIT_TEST_SUITE_END();
+
+    void Read();
+    void Index();
+    void Extract();
+
+    wxDECLARE_NO_COPY_CLASS(TarArchiveTestCase);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( TarArchiveTestCase );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( TarArchiveTestCase, "archive/tar" );
+
+static const char *TAR_ARCHIVE_FILE = "tararchive.tar";
+static const char *TAR_ARCHIVE_INDEX = "tararchive.idx";
+
+void TarArchiveTestCase::setUp()
+{
+    wxFileOutputStream out(TAR_ARCHIVE_FILE);
+    wxTarOutputStream tar(out);
+
+    WriteArchiveEntries(tar, 100);
+
+    // A later entry with the same name replaces the previous one.
+    tar.PutNextEntry("dup");
+    tar.Write("old", 3);
+    tar.PutNextEntry("dup");
+    tar.Write("new data", 8);
+}
+
+void TarArchiveTestCase::tearDown()
+{
+    wxRemoveFile(TAR_ARCHIVE_FILE);
+    if ( wxFileExists(TAR_ARCHIVE_INDEX) )
+        wxRemoveFile(TAR_ARCHIVE_INDEX);
+}
+
+void TarArchiveTestCase::Read()
+{
+    wxTarArchive archive(TAR_ARCHIVE_FILE);
+    CheckArchiveRead(archive);
+    CPPUNIT_ASSERT_EQUAL( 103, (int)archive.GetCount() );
+    CPPUNIT_ASSERT( !archive.OpenEntry("nonexistent") );
+
+    wxScopedPtr<wxInputStream> in(archive.OpenEntry("dup"));
+    CPPUNIT_ASSERT( in );
+
+    char data[100];
+    in->Read(data, sizeof(data));
+    CPPUNIT_ASSERT_EQUAL( 8, (int)in->LastRead() );
+    CPPUNIT_ASSERT( memcmp(data, "new data", 8) == 0 );
+}
+
+void TarArchiveTestCase::Index()
+{
+    {
+        wxTarArchive archive(TAR_ARCHIVE_FILE, TAR_ARCHIVE_INDEX);
+        CPPUNIT_ASSERT( archive.IsOk() );
+    }
+
+    CPPUNIT_ASSERT( wxFileExists(TAR_ARCHIVE_INDEX) );
+
+    // The index saved above is used now, check that it is correct.
+    wxTarArchive archive(TAR_ARCHIVE_FILE, TAR_ARCHIVE_INDEX);
+    CPPUNIT_ASSERT( archive.IsOk() );
+    CPPUNIT_ASSERT_EQUAL( 103, (int)archive.GetCount() );
+    CPPUNIT_ASSERT( archive.GetEntry(archive.Find("dir")).IsDir() );
+
+    const wxTarEntry& entry = archive.GetEntry(archive.Find("dir/2/file50",
+                                                            wxPATH_UNIX));
+    CPPUNIT_ASSERT_EQUAL( "dir/2/file50", entry.GetInternalName() );
+
+    wxScopedPtr<wxInputStream> in(archive.OpenEntry(archive.Find("dup")));
+    CPPUNIT_ASSERT( in );
+
+    char data[100];
+    in->Read(data, sizeof(data));
+    CPPUNIT_ASSERT_EQUAL( 8, (int)in->LastRead() );
+    CPPUNIT_ASSERT( memcmp(data, "new data", 8) == 0 );
+
+    // A corrupted index is ignored and rebuilt.
+    {
+        wxFileOutputStream out(TAR_ARCHIVE_INDEX);
+        out.Write("garbage", 7);
+    }
+
+    wxTarArchive archive2(TAR_ARCHIVE_FILE, TAR_ARCHIVE_INDEX);
+    CPPUNIT_ASSERT( archive2.IsOk() );
+    CPPUNIT_ASSERT_EQUAL( 103, (int)archive2.GetCount() );
+}
+
+void TarArchiveTestCase::Extract()
+{
+    wxTarArchive archive(TAR_ARCHIVE_FILE);
+
+    const wxString dir = "tararchive.test";
+    CheckArchiveExtract(archive, dir);
+    CPPUNIT_ASSERT( wxFileName::GetSize(dir + "/dup") == 8 );
+
+    CPPUNIT_ASSERT( wxFileName::Rmdir(dir, wxPATH_RMDIR_RECURSIVE) );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Tar suite 
 
@@ -20,6 +20,7 @@
 
 #include "archivetest.h"
 #include "wx/zipstrm.h"
+#include "wx/mstream.h"
 
 using std::string;
 using std::auto_ptr;
@@ -204,6 +205,79 @@ void ZipPipeTestCase::runTest()
 }
 
 
+///////////////////////////////////////////////////////////////////////////////
+// wxZipArchive tests
+
+class ZipArchiveTestCase : public CppUnit::TestCase
+{
+public:
+    ZipArchiveTestCase() { }
+
+private:
+    CPPUNIT_TEST_SUITE( ZipArchiveTestCase );
+        CPPUNIT_TEST( Read );
+        CPPUNIT_TEST( Extract );
+    CPPUNIT_TEST_SUITE_END();
+
+    void Read();
+    void Extract();
+
+    // Create an archive with the given number of entries.
+    static void CreateArchive(wxMemoryOutputStream& out, int count);
+
+    wxDECLARE_NO_COPY_CLASS(ZipArchiveTestCase);
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION( ZipArchiveTestCase );
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ZipArchiveTestCase, "archive/zip" );
+
+void ZipArchiveTestCase::CreateArchive(wxMemoryOutputStream& out, int count)
+{
+    wxZipOutputStream zip(out);
+
+    WriteArchiveEntries(zip, count);
+
+    zip.PutNextEntry("stored");
+    zip.SetLevel(0);
+    zip.Write("stored data", 11);
+}
+
+void ZipArchiveTestCase::Read()
+{
+    wxMemoryOutputStream out;
+    CreateArchive(out, 100);
+
+    const wxStreamBuffer * const buf = out.GetOutputStreamBuffer();
+    wxZipArchive archive(buf->GetBufferStart(), out.GetLength());
+    CheckArchiveRead(archive);
+    CPPUNIT_ASSERT_EQUAL( 102, (int)archive.GetCount() );
+
+    wxScopedPtr<wxInputStream> in(archive.OpenEntry(archive.Find("stored")));
+    CPPUNIT_ASSERT( in );
+
+    char data[100];
+    in->Read(data, sizeof(data));
+    CPPUNIT_ASSERT_EQUAL( 11, (int)in->LastRead() );
+    CPPUNIT_ASSERT( memcmp(data, "stored data", 11) == 0 );
+    CPPUNIT_ASSERT_EQUAL( wxSTREAM_EOF, in->GetLastError() );
+}
+
+void ZipArchiveTestCase::Extract()
+{
+    wxMemoryOutputStream out;
+    CreateArchive(out, 50);
+
+    const wxStreamBuffer * const buf = out.GetOutputStreamBuffer();
+    wxZipArchive archive(buf->GetBufferStart(), out.GetLength());
+
+    const wxString dir = "ziparchive.test";
+    CheckArchiveExtract(archive, dir);
+    CPPUNIT_ASSERT( wxFileName::FileExists(dir + "/stored") );
+
+    CPPUNIT_ASSERT( wxFileName::Rmdir(dir, wxPATH_RMDIR_RECURSIVE) );
+}
+
+
 ///////////////////////////////////////////////////////////////////////////////
 // Zip suite 
 
@@ -58,10 +58,12 @@ struct GraphicsBenchmarkOptions
         numIters = 1000;
 
         testBitmaps =
+        testIcons =
         testImages =
         testLines =
         testRawBitmaps =
-        testRectangles = false;
+        testRectangles =
+        testText = false;
 
         usePaint =
         useClient =
@@ -79,10 +81,12 @@ struct GraphicsBenchmarkOptions
          numIters;
 
     bool testBitmaps,
+         testIcons,
          testImages,
          testLines,
          testRawBitmaps,
-         testRectangles;
+         testRectangles,
+         testText;
 
     bool usePaint,
          useClient,
@@ -248,10 +252,12 @@ private:
     void BenchmarkAll(const wxString& msg, wxDC& dc)
     {
         BenchmarkBitmaps(msg, dc);
+        BenchmarkIcons(msg, dc);
         BenchmarkImages(msg, dc);
         BenchmarkLines(msg, dc);
         BenchmarkRawBitmaps(msg, dc);
         BenchmarkRectangles(msg, dc);
+        BenchmarkText(msg, dc);
     }
 
     void BenchmarkLines(const wxString& msg, wxDC& dc)
@@ -318,6 +324,52 @@ private:
                  opts.numIters, t, (1000. * t)/opts.numIters);
     }
 
+    // Measure and draw short strings, as e.g. labels of a chart axis do.
+    void BenchmarkText(const wxString& msg, wxDC& dc)
+    {
+        if ( !opts.testText )
+            return;
+
+        if ( opts.mapMode != 0 )
+            dc.SetMapMode((wxMappingMode)opts.mapMode);
+
+        wxPrintf("Benchmarking %s: ", msg);
+        fflush(stdout);
+
+#if wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+        unsigned long hitsBefore, missesBefore;
+        wxGetCairoTextCacheStats(&hitsBefore, &missesBefore);
+#endif // wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+
+        wxStopWatch sw;
+        for ( int n = 0; n < opts.numIters; n++ )
+        {
+            const wxString label = wxString::Format("%d.%d", n % 10, n % 100);
+
+            const wxSize size = dc.GetTextExtent(label);
+            dc.DrawText(label,
+                        rand() % opts.width - size.x / 2,
+                        rand() % opts.height - size.y / 2);
+        }
+
+        const long t = sw.Time();
+
+        wxPrintf("%ld strings done in %ldms = %gus/string",
+                 opts.numIters, t, (1000. * t)/opts.numIters);
+
+#if wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+        unsigned long hits, misses;
+        wxGetCairoTextCacheStats(&hits, &misses);
+        if ( hits != hitsBefore || misses != missesBefore )
+        {
+            wxPrintf(" (%lu cache hits, %lu misses)",
+                     hits - hitsBefore, misses - missesBefore);
+        }
+#endif // wxUSE_GRAPHICS_CONTEXT && wxUSE_CAIRO
+
+        wxPrintf("\n");
+    }
+
     void BenchmarkBitmaps(const wxString& msg, wxDC& dc)
     {
         if ( !opts.testBitmaps )
@@ -346,6 +398,54 @@ private:
                  opts.numIters, t, (1000. * t)/opts.numIters);
     }
 
+    // Draw many small bitmaps with alpha, as e.g. icons in a toolbar or a
+    // list, repeatedly.
+    void BenchmarkIcons(const wxString& msg, wxDC& dc)
+    {
+        if ( !opts.testIcons )
+            return;
+
+        if ( opts.mapMode != 0 )
+            dc.SetMapMode((wxMappingMode)opts.mapMode);
+
+        static const int NUM_ICONS = 64;
+        static const int ICON_SIZE = 32;
+
+        wxBitmap icons[NUM_ICONS];
+        for ( int i = 0; i < NUM_ICONS; i++ )
+        {
+            wxImage image(ICON_SIZE, ICON_SIZE);
+            image.SetAlpha();
+            for ( int y = 0; y < ICON_SIZE; y++ )
+            {
+                for ( int x = 0; x < ICON_SIZE; x++ )
+                {
+                    image.SetRGB(x, y, 4*i, 8*x, 8*y);
+                    image.SetAlpha(x, y, (x + y)*4);
+                }
+            }
+
+            icons[i] = wxBitmap(image);
+        }
+
+        wxPrintf("Benchmarking %s: ", msg);
+        fflush(stdout);
+
+        wxStopWatch sw;
+        for ( int n = 0; n < opts.numIters; n++ )
+        {
+            int x = rand() % opts.width,
+                y = rand() % opts.height;
+
+            dc.DrawBitmap(icons[n % NUM_ICONS], x, y, true);
+        }
+
+        const long t = sw.Time();
+
+        wxPrintf("%ld icons done in %ldms = %gus/icon\n",
+                 opts.numIters, t, (1000. * t)/opts.numIters);
+    }
+
     void BenchmarkImages(const wxString& msg, wxDC& dc)
     {
         if ( !opts.testImages )
@@ -437,10 +537,12 @@ public:
         static const wxCmdLineEntryDesc desc[] =
         {
             { wxCMD_LINE_SWITCH, "",  "bitmaps" },
+            { wxCMD_LINE_SWITCH, "",  "icons" },
             { wxCMD_LINE_SWITCH, "",  "images" },
             { wxCMD_LINE_SWITCH, "",  "lines" },
             { wxCMD_LINE_SWITCH, "",  "rawbmp" },
             { wxCMD_LINE_SWITCH, "",  "rectangles" },
+            { wxCMD_LINE_SWITCH, "",  "text" },
             { wxCMD_LINE_SWITCH, "",  "paint" },
             { wxCMD_LINE_SWITCH, "",  "client" },
             { wxCMD_LINE_SWITCH, "",  "memory" },
@@ -476,19 +578,24 @@ public:
             return false;
 
         opts.testBitmaps = parser.Found("bitmaps");
+        opts.testIcons = parser.Found("icons");
         opts.testImages = parser.Found("images");
         opts.testLines = parser.Found("lines");
         opts.testRawBitmaps = parser.Found("rawbmp");
         opts.testRectangles = parser.Found("rectangles");
-        if ( !(opts.testBitmaps || opts.testImages || opts.testLines
-                    || opts.testRawBitmaps || opts.testRectangles) )
+        opts.testText = parser.Found("text");
+        if ( !(opts.testBitmaps || opts.testIcons || opts.testImages
+                    || opts.testLines || opts.testRawBitmaps
+                    || opts.testRectangles || opts.testText) )
         {
             // Do everything by default.
             opts.testBitmaps =
+            opts.testIcons =
             opts.testImages =
             opts.testLines =
             opts.testRawBitmaps =
-            opts.testRectangles = true;
+            opts.testRectangles =
+            opts.testText = true;
         }
 
         opts.usePaint = parser.Found("paint");
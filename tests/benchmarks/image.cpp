@@ -88,3 +88,103 @@ BENCHMARK_FUNC(ShrinkHighQuality)
 {
     return GetTestImage().Scale(50, 50, wxIMAGE_QUALITY_HIGH).IsOk();
 }
+
+// Bigger image for the benchmarks of the resampling and blurring functions:
+// the test image is too small to show the differences between them.
+static const wxImage& GetBigTestImage()
+{
+    static wxImage s_image;
+    if ( !s_image.IsOk() )
+        s_image = GetTestImage().Scale(2000, 2000, wxIMAGE_QUALITY_BILINEAR);
+
+    return s_image;
+}
+
+BENCHMARK_FUNC(ThumbnailBoxAverage)
+{
+    return GetBigTestImage().Scale(160, 160, wxIMAGE_QUALITY_BOX_AVERAGE).IsOk();
+}
+
+BENCHMARK_FUNC(ScaleBilinear)
+{
+    return GetBigTestImage().Scale(1500, 1500, wxIMAGE_QUALITY_BILINEAR).IsOk();
+}
+
+BENCHMARK_FUNC(ScaleBicubic)
+{
+    return GetBigTestImage().Scale(1500, 1500, wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC(Blur)
+{
+    return GetBigTestImage().Blur(5).IsOk();
+}
+
+static bool AreImagesIdentical(const wxImage& image1, const wxImage& image2)
+{
+    if ( image1.GetSize() != image2.GetSize() ||
+            image1.HasAlpha() != image2.HasAlpha() )
+        return false;
+
+    const size_t numPixels = image1.GetWidth()*image1.GetHeight();
+    if ( memcmp(image1.GetData(), image2.GetData(), numPixels*3) != 0 )
+        return false;
+
+    return !image1.HasAlpha() ||
+                memcmp(image1.GetAlpha(), image2.GetAlpha(), numPixels) == 0;
+}
+
+// Check that processing the image in parallel gives exactly the same results
+// as doing it in a single thread before benchmarking it.
+static bool InitParallelProcessing()
+{
+    wxImage image = GetBigTestImage();
+    image.InitAlpha();
+
+    wxImage::SetProcessingThreads(1);
+    const wxImage box = image.Scale(160, 160, wxIMAGE_QUALITY_BOX_AVERAGE),
+                  bilinear = image.Scale(1500, 1500, wxIMAGE_QUALITY_BILINEAR),
+                  bicubic = image.Scale(1500, 1500, wxIMAGE_QUALITY_BICUBIC),
+                  blur = image.Blur(5);
+
+    wxImage::SetProcessingThreads(0);
+    if ( !AreImagesIdentical(box, image.Scale(160, 160, wxIMAGE_QUALITY_BOX_AVERAGE)) ||
+            !AreImagesIdentical(bilinear, image.Scale(1500, 1500, wxIMAGE_QUALITY_BILINEAR)) ||
+            !AreImagesIdentical(bicubic, image.Scale(1500, 1500, wxIMAGE_QUALITY_BICUBIC)) ||
+            !AreImagesIdentical(blur, image.Blur(5)) )
+    {
+        wxPrintf("Parallel image processing results differ, ");
+        return false;
+    }
+
+    return true;
+}
+
+static void DoneParallelProcessing()
+{
+    wxImage::SetProcessingThreads(1);
+}
+
+BENCHMARK_FUNC_WITH_INIT(ThumbnailBoxAverageParallel,
+                         InitParallelProcessing, DoneParallelProcessing)
+{
+    return GetBigTestImage().Scale(160, 160, wxIMAGE_QUALITY_BOX_AVERAGE).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ScaleBilinearParallel,
+                         InitParallelProcessing, DoneParallelProcessing)
+{
+    return GetBigTestImage().Scale(1500, 1500, wxIMAGE_QUALITY_BILINEAR).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(ScaleBicubicParallel,
+                         InitParallelProcessing, DoneParallelProcessing)
+{
+    return GetBigTestImage().Scale(1500, 1500, wxIMAGE_QUALITY_BICUBIC).IsOk();
+}
+
+BENCHMARK_FUNC_WITH_INIT(BlurParallel,
+                         InitParallelProcessing, DoneParallelProcessing)
+{
+    return GetBigTestImage().Blur(5).IsOk();
+}
@@ -42,6 +42,66 @@ bool ConvertToMB(const wxMBConv& conv)
     return conv.FromWChar(buf.data(), outlen, TEST_STRING) == outlen;
 }
 
+// Return a long UTF-8 string, either pure ASCII or a mix of ASCII and non
+// ASCII characters, used for the throughput benchmarks below.
+const wxCharBuffer& GetUTF8Text(bool ascii)
+{
+    static wxCharBuffer s_texts[2];
+
+    wxCharBuffer& text = s_texts[ascii];
+    if ( !text )
+    {
+        wxString s;
+        for ( int n = 0; n < 1000; n++ )
+        {
+            s += TEST_STRING;
+            if ( !ascii )
+                s += L"\u00e9t\u00e9 \u20ac \u0436\u0443\u043a ";
+        }
+
+        text = s.utf8_str();
+    }
+
+    return text;
+}
+
+const wxWCharBuffer& GetWideText(bool ascii)
+{
+    static wxWCharBuffer s_texts[2];
+
+    wxWCharBuffer& text = s_texts[ascii];
+    if ( !text )
+        text = wxString::FromUTF8(GetUTF8Text(ascii)).wc_str();
+
+    return text;
+}
+
+bool DecodeUTF8(const wxMBConv& conv, bool ascii)
+{
+    const wxCharBuffer& text = GetUTF8Text(ascii);
+    const size_t len = text.length();
+
+    static wxWCharBuffer s_buf;
+    if ( s_buf.length() < len )
+        s_buf = wxWCharBuffer(len);
+
+    const size_t wlen = conv.ToWChar(s_buf.data(), len, text, len);
+    return wlen != wxCONV_FAILED && wlen <= len;
+}
+
+bool EncodeUTF8(const wxMBConv& conv, bool ascii)
+{
+    const wxWCharBuffer& text = GetWideText(ascii);
+    const size_t len = text.length();
+
+    static wxCharBuffer s_buf;
+    if ( s_buf.length() < 4*len )
+        s_buf = wxCharBuffer(4*len);
+
+    return conv.FromWChar(s_buf.data(), 4*len, text, len)
+            == GetUTF8Text(ascii).length();
+}
+
 } // anonymous namespace
 
 BENCHMARK_FUNC(UTF16InitWX)
@@ -76,3 +136,38 @@ BENCHMARK_FUNC(UTF16Sys)
     return ConvertToMB(wxCSConv("UTF-16LE"));
 }
 
+
+BENCHMARK_FUNC(UTF8DecodeASCII)
+{
+    return DecodeUTF8(wxMBConvStrictUTF8(), true);
+}
+
+BENCHMARK_FUNC(UTF8DecodeMixed)
+{
+    return DecodeUTF8(wxMBConvStrictUTF8(), false);
+}
+
+BENCHMARK_FUNC(UTF8DecodeASCIIToPUA)
+{
+    return DecodeUTF8(wxMBConvUTF8(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA), true);
+}
+
+BENCHMARK_FUNC(UTF8DecodeMixedToOctal)
+{
+    return DecodeUTF8(wxMBConvUTF8(wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL), false);
+}
+
+BENCHMARK_FUNC(UTF8EncodeASCII)
+{
+    return EncodeUTF8(wxMBConvStrictUTF8(), true);
+}
+
+BENCHMARK_FUNC(UTF8EncodeMixed)
+{
+    return EncodeUTF8(wxMBConvStrictUTF8(), false);
+}
+
+BENCHMARK_FUNC(UTF8EncodeASCIIToPUA)
+{
+    return EncodeUTF8(wxMBConvUTF8(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA), true);
+}
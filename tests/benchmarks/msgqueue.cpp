@@ -0,0 +1,136 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/msgqueue.cpp
+// Purpose:     wxMessageQueue and wxLockFreeMessageQueue benchmarks
+// Author:      wxWidgets team
+// Created:     2016-03-12
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "bench.h"
+
+#include "wx/msgqueue.h"
+#include "wx/thread.h"
+#include "wx/vector.h"
+
+// number of messages posted by each producer thread
+static const int NUM_MESSAGES = 100000;
+
+// capacity of the lock-free queue: make it big enough for the producers to
+// rarely find it full, as this benchmark is about the queue operations cost
+static const int QUEUE_CAPACITY = 65536;
+
+// ----------------------------------------------------------------------------
+// helpers
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Return the number of threads posting to the queue, it can be specified
+// using the numeric parameter and defaults to 4.
+int GetProducersCount()
+{
+    const long count = Bench::GetNumericParameter();
+    return count > 0 ? count : 4;
+}
+
+// Post a message, retrying if the queue is full.
+inline void PostMessage(wxMessageQueue<int>& queue, int msg)
+{
+    queue.Post(msg);
+}
+
+inline void PostMessage(wxLockFreeMessageQueue<int>& queue, int msg)
+{
+    while ( queue.Post(msg) == wxMSGQUEUE_FULL )
+        wxThread::Yield();
+}
+
+template <class Queue>
+class ProducerThread : public wxThread
+{
+public:
+    explicit ProducerThread(Queue& queue)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_queue(queue)
+    {
+    }
+
+    virtual void *Entry() wxOVERRIDE
+    {
+        for ( int n = 0; n < NUM_MESSAGES; n++ )
+            PostMessage(m_queue, n);
+
+        return NULL;
+    }
+
+private:
+    Queue& m_queue;
+};
+
+// Run several producers posting to the given queue and receive all their
+// messages in the main thread.
+template <class Queue>
+bool RunQueueBenchmark(Queue& queue)
+{
+    const int producersCount = GetProducersCount();
+
+    wxVector<ProducerThread<Queue>*> threads;
+    int i;
+    for ( i = 0; i < producersCount; i++ )
+    {
+        ProducerThread<Queue>* const thread = new ProducerThread<Queue>(queue);
+        if ( thread->Run() != wxTHREAD_NO_ERROR )
+        {
+            delete thread;
+            break;
+        }
+
+        threads.push_back(thread);
+    }
+
+    bool ok = !threads.empty();
+
+    wxLongLong_t sum = 0;
+    const int total = threads.size()*NUM_MESSAGES;
+    for ( i = 0; i < total && ok; i++ )
+    {
+        int msg;
+        if ( queue.Receive(msg) != wxMSGQUEUE_NO_ERROR )
+            ok = false;
+        else
+            sum += msg;
+    }
+
+    for ( i = 0; i < (int)threads.size(); i++ )
+    {
+        threads[i]->Wait();
+        delete threads[i];
+    }
+
+    const wxLongLong_t expected =
+        threads.size()*(static_cast<wxLongLong_t>(NUM_MESSAGES)*(NUM_MESSAGES - 1)/2);
+
+    return ok && sum == expected;
+}
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// the benchmarks
+// ----------------------------------------------------------------------------
+
+BENCHMARK_FUNC(MessageQueue)
+{
+    wxMessageQueue<int> queue;
+
+    return RunQueueBenchmark(queue);
+}
+
+BENCHMARK_FUNC(LockFreeMessageQueue)
+{
+    wxLockFreeMessageQueue<int> queue(QUEUE_CAPACITY);
+
+    return RunQueueBenchmark(queue);
+}
@@ -0,0 +1,246 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/sockets.cpp
+// Purpose:     wxSocket benchmarks
+// Author:      wxWidgets team
+// Created:     2016-04-12
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/socket.h"
+#include "wx/thread.h"
+#include "wx/utils.h"
+
+#include "bench.h"
+
+#if wxUSE_SOCKETS && wxUSE_THREADS
+
+// All benchmarks send small messages consisting of a header and a payload to
+// a server listening on the loopback interface and running in another thread
+// and wait until it acknowledges receiving all of them, so the number of
+// messages sent per second can be deduced from the time they take.
+
+namespace
+{
+
+// The size of the message header and payload.
+const wxUint32 HEADER_SIZE = 8;
+const wxUint32 PAYLOAD_SIZE = 56;
+
+// The size of the write buffer used by the buffered benchmark.
+const wxUint32 WRITE_BUFFER_SIZE = 64*1024;
+
+// Return the number of messages sent by each benchmark, it can be specified
+// using the numeric parameter and defaults to 10000.
+wxUint32 GetMessagesCount()
+{
+    const long count = Bench::GetNumericParameter();
+    return count > 0 ? count : 10000;
+}
+
+// The thread reading all the data sent to the server socket.
+//
+// It first reads the number of bytes to expect, then reads all of them and
+// sends back a single byte to acknowledge this, until the connection is
+// closed.
+class SinkThread : public wxThread
+{
+public:
+    SinkThread(wxSocketBase *socket)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_socket(socket)
+    {
+    }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        char buf[WRITE_BUFFER_SIZE];
+
+        for ( ;; )
+        {
+            wxUint32 total;
+            m_socket->SetFlags(wxSOCKET_WAITALL | wxSOCKET_BLOCK);
+            m_socket->Read(&total, sizeof(total));
+            if ( m_socket->LastReadCount() != sizeof(total) )
+                break;
+
+            m_socket->SetFlags(wxSOCKET_BLOCK);
+            while ( total )
+            {
+                m_socket->Read(buf, wxMin(total, sizeof(buf)));
+                if ( m_socket->Error() )
+                    return NULL;
+
+                total -= m_socket->LastReadCount();
+            }
+
+            const char ack = 0;
+            m_socket->Write(&ack, sizeof(ack));
+        }
+
+        return NULL;
+    }
+
+private:
+    wxSocketBase * const m_socket;
+
+    wxDECLARE_NO_COPY_CLASS(SinkThread);
+};
+
+wxSocketServer *gs_server = NULL;
+wxSocketBase *gs_peer = NULL;
+wxSocketClient *gs_client = NULL;
+SinkThread *gs_thread = NULL;
+
+char gs_header[HEADER_SIZE];
+char gs_payload[PAYLOAD_SIZE];
+
+void StopServer()
+{
+    // Closing the client socket makes the thread exit.
+    if ( gs_client )
+        gs_client->Close();
+
+    if ( gs_thread )
+    {
+        gs_thread->Wait();
+        delete gs_thread;
+        gs_thread = NULL;
+    }
+
+    delete gs_client;
+    gs_client = NULL;
+
+    delete gs_peer;
+    gs_peer = NULL;
+
+    delete gs_server;
+    gs_server = NULL;
+}
+
+bool DoStartServer()
+{
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    gs_server = new wxSocketServer(addr, wxSOCKET_BLOCK | wxSOCKET_REUSEADDR);
+    if ( !gs_server->IsOk() )
+        return false;
+
+    wxIPV4address local;
+    gs_server->GetLocal(local);
+    addr.Service(local.Service());
+
+    gs_client = new wxSocketClient(wxSOCKET_WAITALL | wxSOCKET_BLOCK);
+    if ( !gs_client->Connect(addr) )
+        return false;
+
+    gs_peer = gs_server->Accept();
+    if ( !gs_peer )
+        return false;
+
+    gs_thread = new SinkThread(gs_peer);
+    if ( gs_thread->Run() != wxTHREAD_NO_ERROR )
+    {
+        delete gs_thread;
+        gs_thread = NULL;
+        return false;
+    }
+
+    return true;
+}
+
+bool StartServer()
+{
+    if ( !DoStartServer() )
+    {
+        StopServer();
+        return false;
+    }
+
+    return true;
+}
+
+bool StartServerBuffered()
+{
+    if ( !StartServer() )
+        return false;
+
+    gs_client->SetWriteBufferSize(WRITE_BUFFER_SIZE);
+
+    return true;
+}
+
+// Send all the messages using the given function writing a single message
+// and wait until they're received.
+bool SendMessages(void (*sendMessage)(), wxUint32 messageSize)
+{
+    const wxUint32 count = GetMessagesCount();
+    const wxUint32 total = count*messageSize;
+    gs_client->Write(&total, sizeof(total));
+
+    for ( wxUint32 n = 0; n < count; n++ )
+        sendMessage();
+
+    if ( !gs_client->Flush() )
+        return false;
+
+    char ack;
+    gs_client->Read(&ack, sizeof(ack));
+
+    return gs_client->LastReadCount() == sizeof(ack);
+}
+
+void SendSeparately()
+{
+    gs_client->Write(gs_header, sizeof(gs_header));
+    gs_client->Write(gs_payload, sizeof(gs_payload));
+}
+
+void SendGathered()
+{
+    const wxSocketBuffer buffers[] =
+    {
+        wxSocketBuffer(gs_header, sizeof(gs_header)),
+        wxSocketBuffer(gs_payload, sizeof(gs_payload))
+    };
+
+    gs_client->WriteV(buffers, WXSIZEOF(buffers));
+}
+
+void SendMsg()
+{
+    gs_client->WriteMsg(gs_payload, sizeof(gs_payload));
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(SocketWrite, StartServer, StopServer)
+{
+    return SendMessages(SendSeparately, HEADER_SIZE + PAYLOAD_SIZE);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWriteV, StartServer, StopServer)
+{
+    return SendMessages(SendGathered, HEADER_SIZE + PAYLOAD_SIZE);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWriteBuffered, StartServerBuffered, StopServer)
+{
+    return SendMessages(SendSeparately, HEADER_SIZE + PAYLOAD_SIZE);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWriteMsg, StartServer, StopServer)
+{
+    // WriteMsg() uses 8 byte header and trailer.
+    return SendMessages(SendMsg, 8 + PAYLOAD_SIZE + 8);
+}
+
+BENCHMARK_FUNC_WITH_INIT(SocketWriteMsgBuffered, StartServerBuffered, StopServer)
+{
+    return SendMessages(SendMsg, 8 + PAYLOAD_SIZE + 8);
+}
+
+#endif // wxUSE_SOCKETS && wxUSE_THREADS
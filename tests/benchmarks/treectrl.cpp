@@ -0,0 +1,181 @@
+/////////////////////////////////////////////////////////////////////////////
+// Name:        tests/benchmarks/treectrl.cpp
+// Purpose:     wxGenericTreeCtrl benchmarks
+// Author:      wxWidgets team
+// Created:     2016-04-04
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+/////////////////////////////////////////////////////////////////////////////
+
+#include "wx/frame.h"
+#include "wx/treectrl.h"
+#include "wx/generic/treectlg.h"
+
+#include "bench.h"
+
+#if wxUSE_TREECTRL
+
+// All benchmarks use a tree control with 10000*N items, where N is the
+// numeric parameter, by default. The items are either appended directly to
+// the root or, for the expand and scroll benchmarks, in 100 branches.
+
+namespace
+{
+
+wxFrame *gs_frame = NULL;
+wxGenericTreeCtrl *gs_tree = NULL;
+
+int GetItemsCount()
+{
+    return 10000*Bench::GetNumericParameter();
+}
+
+bool CreateTree()
+{
+    gs_frame = new wxFrame(NULL, wxID_ANY, "wxGenericTreeCtrl benchmark",
+                           wxDefaultPosition, wxSize(400, 600));
+
+    // Give the control its size immediately, without waiting for the size
+    // event which is only generated from the event loop by some ports.
+    gs_tree = new wxGenericTreeCtrl(gs_frame, wxID_ANY,
+                                    wxDefaultPosition,
+                                    gs_frame->GetClientSize());
+    gs_frame->Show();
+
+    return true;
+}
+
+bool CreateTreeWithBranches()
+{
+    CreateTree();
+
+    const wxTreeItemId root = gs_tree->AddRoot("Root");
+
+    const int numBranches = 100;
+    const int numLeaves = GetItemsCount() / numBranches;
+
+    wxArrayString texts;
+    for ( int n = 0; n < numLeaves; n++ )
+        texts.push_back(wxString::Format("Leaf %d", n));
+
+    for ( int n = 0; n < numBranches; n++ )
+    {
+        const wxTreeItemId
+            branch = gs_tree->AppendItem(root, wxString::Format("Branch %d", n));
+        gs_tree->AppendItems(branch, texts);
+    }
+
+    gs_tree->ExpandAll();
+
+    return true;
+}
+
+// Create the tree with branches and make sure it can be scrolled: as there is
+// no event loop running while benchmarking, the layout and the scrollbars
+// would otherwise only be updated lazily during idle time, i.e. never.
+bool CreateScrollableTree()
+{
+    CreateTreeWithBranches();
+
+    // Do what would be done during idle time, i.e. update the layout and the
+    // scrollbars, explicitly.
+    gs_tree->OnInternalIdle();
+
+    int xUnit, yUnit;
+    gs_tree->GetScrollPixelsPerUnit(&xUnit, &yUnit);
+    if ( !yUnit || gs_tree->GetClientSize().y < yUnit )
+    {
+        wxFprintf(stderr, "Tree control can't be scrolled, "
+                          "scroll benchmark can't be run.\n");
+        return false;
+    }
+
+    return true;
+}
+
+void DestroyTree()
+{
+    delete gs_frame;
+    gs_frame = NULL;
+    gs_tree = NULL;
+}
+
+// Make sure all the pending layout is done, as it's done lazily otherwise.
+bool UpdateLayout(const wxTreeItemId& item)
+{
+    wxRect rect;
+    return gs_tree->GetBoundingRect(item, rect);
+}
+
+} // anonymous namespace
+
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlAppend, CreateTree, DestroyTree)
+{
+    gs_tree->DeleteAllItems();
+
+    const wxTreeItemId root = gs_tree->AddRoot("Root");
+    gs_tree->SetItemHasChildren(root);
+    gs_tree->Expand(root);
+
+    wxTreeItemId item;
+    const int count = GetItemsCount();
+    for ( int n = 0; n < count; n++ )
+        item = gs_tree->AppendItem(root, wxString::Format("Item %d", n));
+
+    return UpdateLayout(item);
+}
+
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlAppendItems, CreateTree, DestroyTree)
+{
+    gs_tree->DeleteAllItems();
+
+    const wxTreeItemId root = gs_tree->AddRoot("Root");
+    gs_tree->SetItemHasChildren(root);
+    gs_tree->Expand(root);
+
+    wxArrayString texts;
+    const int count = GetItemsCount();
+    for ( int n = 0; n < count; n++ )
+        texts.push_back(wxString::Format("Item %d", n));
+
+    gs_tree->AppendItems(root, texts);
+
+    return UpdateLayout(gs_tree->GetLastChild(root));
+}
+
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlExpandAll, CreateTreeWithBranches, DestroyTree)
+{
+    gs_tree->CollapseAll();
+    gs_tree->ExpandAll();
+
+    const wxTreeItemId root = gs_tree->GetRootItem();
+    return UpdateLayout(gs_tree->GetLastChild(gs_tree->GetLastChild(root)));
+}
+
+BENCHMARK_FUNC_WITH_INIT(TreeCtrlScroll, CreateScrollableTree, DestroyTree)
+{
+    int xUnit, yUnit;
+    gs_tree->GetScrollPixelsPerUnit(&xUnit, &yUnit);
+
+    const int pageUnits = gs_tree->GetClientSize().y / yUnit;
+    const int totalUnits = gs_tree->GetVirtualSize().y / yUnit;
+
+    // Scroll through the entire tree page by page and repaint it each time.
+    for ( int pos = 0; pos < totalUnits; pos += pageUnits )
+    {
+        gs_tree->Scroll(0, pos);
+        gs_tree->Update();
+    }
+
+    int xStart, yStart;
+    gs_tree->GetViewStart(&xStart, &yStart);
+    if ( !yStart )
+    {
+        wxFprintf(stderr, "Tree control wasn't scrolled.\n");
+        return false;
+    }
+
+    return true;
+}
+
+#endif // wxUSE_TREECTRL
@@ -83,6 +83,7 @@ private:
         CPPUNIT_TEST( ReadNonExistent );
         CPPUNIT_TEST( ReadEmpty );
         CPPUNIT_TEST( ReadFloat );
+        CPPUNIT_TEST( ManyEntries );
     CPPUNIT_TEST_SUITE_END();
 
     void Path();
@@ -108,6 +109,7 @@ private:
     void ReadNonExistent();
     void ReadEmpty();
     void ReadFloat();
+    void ManyEntries();
 
 
     static wxString ChangePath(wxFileConfig& fc, const wxChar *path)
@@ -701,3 +703,59 @@ void FileConfigTestCase::ReadFloat()
 
 #endif // wxUSE_FILECONFIG
 
+
+void FileConfigTestCase::ManyEntries()
+{
+    // Create a config with many entries and groups not in alphabetical order.
+    wxString text;
+    int n;
+    for ( n = 999; n >= 0; n-- )
+        text += wxString::Format("key%03d=%d\n", n, n);
+    for ( n = 99; n >= 0; n-- )
+        text += wxString::Format("[Group%02d]\nentry=%d\n", n, n);
+
+    wxStringInputStream sis(text);
+    wxFileConfig fc(sis);
+
+    // Saving it must preserve the original order of lines.
+    wxVERIFY_FILECONFIG( text, fc );
+
+    // But enumerating must return the entries and groups sorted.
+    CPPUNIT_ASSERT_EQUAL( 1000, (int)fc.GetNumberOfEntries() );
+    CPPUNIT_ASSERT_EQUAL( 100, (int)fc.GetNumberOfGroups() );
+
+    wxString name;
+    long cookie;
+    CPPUNIT_ASSERT( fc.GetFirstEntry(name, cookie) );
+    CPPUNIT_ASSERT_EQUAL( "key000", name );
+    CPPUNIT_ASSERT( fc.GetFirstGroup(name, cookie) );
+    CPPUNIT_ASSERT_EQUAL( "Group00", name );
+    CPPUNIT_ASSERT( fc.GetNextGroup(name, cookie) );
+    CPPUNIT_ASSERT_EQUAL( "Group01", name );
+
+    // Lookup is case-insensitive.
+    CPPUNIT_ASSERT_EQUAL( 123L, fc.ReadLong("KEY123", 0) );
+    CPPUNIT_ASSERT_EQUAL( 12L, fc.ReadLong("group12/Entry", 0) );
+
+    // Deleting the last entry of a group and a new entry must insert it at
+    // the right place.
+    CPPUNIT_ASSERT( fc.DeleteEntry("key000") );
+    CPPUNIT_ASSERT( fc.DeleteEntry("key001") );
+    fc.Write("new", "value");
+    CPPUNIT_ASSERT( fc.DeleteGroup("Group00") );
+    fc.Write("Group50/new", "value");
+    fc.Write("Group99/renamed", "value");
+    CPPUNIT_ASSERT( fc.RenameGroup("Group99", "Group100") );
+    CPPUNIT_ASSERT( !fc.HasGroup("Group99") );
+
+    const wxString dump = Dump(fc);
+    CPPUNIT_ASSERT( dump.find("key002=2\nnew=value\n[Group100]") != wxString::npos );
+    CPPUNIT_ASSERT( dump.find("[Group50]\nentry=50\nnew=value\n") != wxString::npos );
+    CPPUNIT_ASSERT( dump.find("[Group100]\nentry=99\nrenamed=value\n") != wxString::npos );
+    CPPUNIT_ASSERT( dump.EndsWith("[Group01]\nentry=1\n") );
+
+    CPPUNIT_ASSERT( fc.GetFirstGroup(name, cookie) );
+    CPPUNIT_ASSERT_EQUAL( "Group01", name );
+    CPPUNIT_ASSERT( fc.GetNextGroup(name, cookie) );
+    CPPUNIT_ASSERT_EQUAL( "Group02", name );
+}
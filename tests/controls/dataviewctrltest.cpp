@@ -20,6 +20,7 @@
 
 #include "wx/app.h"
 #include "wx/dataview.h"
+#include "wx/scopedptr.h"
 
 #include "testableframe.h"
 
@@ -41,6 +42,11 @@ private:
         CPPUNIT_TEST( DeleteNotSelected );
         CPPUNIT_TEST( GetSelectionForMulti );
         CPPUNIT_TEST( GetSelectionForSingle );
+        CPPUNIT_TEST( SelectManyItems );
+        CPPUNIT_TEST( VariableLineHeight );
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+        CPPUNIT_TEST( VariableLineHeightSorted );
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
     CPPUNIT_TEST_SUITE_END();
 
     // Create wxDataViewTreeCtrl with the given style.
@@ -50,6 +56,11 @@ private:
     void DeleteNotSelected();
     void GetSelectionForMulti();
     void GetSelectionForSingle();
+    void SelectManyItems();
+    void VariableLineHeight();
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+    void VariableLineHeightSorted();
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
 
     void TestSelectionFor0and1();
 
@@ -198,4 +209,177 @@ void DataViewCtrlTestCase::GetSelectionForSingle()
     TestSelectionFor0and1();
 }
 
+void DataViewCtrlTestCase::SelectManyItems()
+{
+    wxDataViewItemArray items;
+    for ( int n = 0; n < 100; n++ )
+        items.push_back(m_dvc->AppendItem(m_root, wxString::Format("item%d", n)));
+
+    wxDataViewItemArray sel;
+    sel.push_back(items[50]);
+    sel.push_back(m_grandchild);
+    m_dvc->SetSelections(sel);
+
+    // The selection is returned in the order of rows.
+    CPPUNIT_ASSERT_EQUAL( 2, m_dvc->GetSelections(sel) );
+    CPPUNIT_ASSERT( sel[0] == m_grandchild );
+    CPPUNIT_ASSERT( sel[1] == items[50] );
+
+    // Deleting an item before the selected one must shift it.
+    m_dvc->DeleteItem(m_child1);
+    CPPUNIT_ASSERT_EQUAL( 1, m_dvc->GetSelections(sel) );
+    CPPUNIT_ASSERT( sel[0] == items[50] );
+
+    m_dvc->Select(items[99]);
+    m_dvc->Unselect(items[50]);
+    CPPUNIT_ASSERT_EQUAL( 1, m_dvc->GetSelections(sel) );
+    CPPUNIT_ASSERT( sel[0] == items[99] );
+}
+
+void DataViewCtrlTestCase::VariableLineHeight()
+{
+    delete m_dvc;
+    Create(wxDV_VARIABLE_LINE_HEIGHT);
+
+    // Check that the rows of all the given items follow each other.
+    #define CHECK_ROWS_ADJACENT(item1, item2) \
+        { \
+            const wxRect rect1 = m_dvc->GetItemRect(item1); \
+            const wxRect rect2 = m_dvc->GetItemRect(item2); \
+            CPPUNIT_ASSERT( rect1.height > 0 ); \
+            CPPUNIT_ASSERT_EQUAL( rect1.y + rect1.height, rect2.y ); \
+        }
+
+    CHECK_ROWS_ADJACENT( m_root, m_child1 );
+    CHECK_ROWS_ADJACENT( m_child1, m_grandchild );
+    CHECK_ROWS_ADJACENT( m_grandchild, m_child2 );
+
+    m_dvc->Collapse(m_child1);
+    CHECK_ROWS_ADJACENT( m_child1, m_child2 );
+
+    const wxDataViewItem item = m_dvc->AppendItem(m_root, "item");
+    CHECK_ROWS_ADJACENT( m_child2, item );
+
+    m_dvc->Expand(m_child1);
+    CHECK_ROWS_ADJACENT( m_grandchild, m_child2 );
+
+    m_dvc->DeleteItem(m_child2);
+    CHECK_ROWS_ADJACENT( m_grandchild, item );
+
+    #undef CHECK_ROWS_ADJACENT
+}
+
+#ifdef wxHAS_GENERIC_DATAVIEWCTRL
+
+namespace
+{
+
+// Renderer whose height depends on the length of the value and which
+// remembers the values it was asked to measure.
+class HeightRenderer : public wxDataViewCustomRenderer
+{
+public:
+    HeightRenderer() : wxDataViewCustomRenderer("string") { }
+
+    static int GetHeightFor(const wxString& value)
+    {
+        return 30 + 10*static_cast<int>(value.length());
+    }
+
+    virtual bool SetValue(const wxVariant& value) wxOVERRIDE
+    {
+        m_value = value.GetString();
+        return true;
+    }
+
+    virtual bool GetValue(wxVariant& value) const wxOVERRIDE
+    {
+        value = m_value;
+        return true;
+    }
+
+    virtual wxSize GetSize() const wxOVERRIDE
+    {
+        m_measured.push_back(m_value);
+        return wxSize(50, GetHeightFor(m_value));
+    }
+
+    virtual bool Render(wxRect WXUNUSED(cell), wxDC *WXUNUSED(dc),
+                        int WXUNUSED(state)) wxOVERRIDE
+    {
+        return true;
+    }
+
+    mutable wxArrayString m_measured;
+
+private:
+    wxString m_value;
+};
+
+// Check that the items at the given rows of the store follow each other in
+// this order and have the heights corresponding to their values.
+void CheckRowsHeights(wxDataViewListCtrl* list, const unsigned (&rows)[4])
+{
+    int y = list->GetItemRect(list->RowToItem(rows[0])).y;
+    for ( unsigned n = 0; n < WXSIZEOF(rows); n++ )
+    {
+        const wxRect rect = list->GetItemRect(list->RowToItem(rows[n]));
+        CPPUNIT_ASSERT_EQUAL( y, rect.y );
+        CPPUNIT_ASSERT_EQUAL
+        (
+            HeightRenderer::GetHeightFor(list->GetTextValue(rows[n], 0)),
+            rect.height
+        );
+
+        y += rect.height;
+    }
+}
+
+} // anonymous namespace
+
+void DataViewCtrlTestCase::VariableLineHeightSorted()
+{
+    wxDataViewListCtrl* const
+        list = new wxDataViewListCtrl(wxTheApp->GetTopWindow(),
+                                      wxID_ANY,
+                                      wxDefaultPosition,
+                                      wxSize(400, 200),
+                                      wxDV_VARIABLE_LINE_HEIGHT);
+    wxScopedPtr<wxDataViewListCtrl> deleteList(list);
+
+    HeightRenderer* const renderer = new HeightRenderer;
+    wxDataViewColumn* const
+        column = new wxDataViewColumn("value", renderer, 0);
+    list->AppendColumn(column, "string");
+
+    const char* const values[] = { "dd", "aaaa", "ccc", "b" };
+    for ( unsigned n = 0; n < WXSIZEOF(values); n++ )
+    {
+        wxVector<wxVariant> data;
+        data.push_back(values[n]);
+        list->AppendItem(data);
+    }
+
+    // The rows are sorted, so their order differs from the store one.
+    column->SetSortOrder(true);
+    list->GetModel()->Resort();
+
+    const unsigned rowsBefore[] = { 1, 3, 2, 0 };
+    CheckRowsHeights(list, rowsBefore);
+
+    // Changing the value moves the item to the end, but the other rows must
+    // keep their heights without being measured again.
+    renderer->m_measured.clear();
+    list->SetTextValue("eeeee", 3, 0);
+
+    CPPUNIT_ASSERT( !renderer->m_measured.empty() );
+    for ( unsigned n = 0; n < renderer->m_measured.size(); n++ )
+        CPPUNIT_ASSERT_EQUAL( "eeeee", renderer->m_measured[n] );
+
+    const unsigned rowsAfter[] = { 1, 2, 0, 3 };
+    CheckRowsHeights(list, rowsAfter);
+}
+
+#endif // wxHAS_GENERIC_DATAVIEWCTRL
+
 #endif //wxUSE_DATAVIEWCTRL
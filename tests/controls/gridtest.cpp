@@ -16,6 +16,7 @@
 
 #ifndef WX_PRECOMP
     #include "wx/app.h"
+    #include "wx/dcclient.h"
 #endif // WX_PRECOMP
 
 #include "wx/grid.h"
@@ -64,6 +65,9 @@ private:
         CPPUNIT_TEST( Labels );
         CPPUNIT_TEST( SelectionMode );
         CPPUNIT_TEST( CellFormatting );
+        CPPUNIT_TEST( CellAttrInsertDelete );
+        CPPUNIT_TEST( ColumnarTable );
+        CPPUNIT_TEST( ColumnarTableFormattedValues );
         WXUISIM_TEST( Editable );
         WXUISIM_TEST( ReadOnly );
         CPPUNIT_TEST( PseudoTest_NativeHeader );
@@ -93,6 +97,9 @@ private:
     void Labels();
     void SelectionMode();
     void CellFormatting();
+    void CellAttrInsertDelete();
+    void ColumnarTable();
+    void ColumnarTableFormattedValues();
     void Editable();
     void ReadOnly();
     void PseudoTest_NativeHeader() { ms_nativeheader = true; }
@@ -683,6 +690,190 @@ void GridTestCase::CellFormatting()
     CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellTextColour(0, 0));
 }
 
+void GridTestCase::CellAttrInsertDelete()
+{
+    const wxColour back = m_grid->GetDefaultCellBackgroundColour();
+
+    m_grid->SetCellBackgroundColour(1, 0, *wxRED);
+    m_grid->SetCellBackgroundColour(5, 1, *wxGREEN);
+    m_grid->SetCellBackgroundColour(5, 0, *wxBLUE);
+
+    // Inserting rows shifts the attributes of the following rows only.
+    m_grid->InsertRows(3, 2);
+    CPPUNIT_ASSERT_EQUAL(*wxRED, m_grid->GetCellBackgroundColour(1, 0));
+    CPPUNIT_ASSERT_EQUAL(back, m_grid->GetCellBackgroundColour(5, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellBackgroundColour(7, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxBLUE, m_grid->GetCellBackgroundColour(7, 0));
+
+    // Deleting rows removes their attributes.
+    m_grid->DeleteRows(0, 2);
+    CPPUNIT_ASSERT_EQUAL(back, m_grid->GetCellBackgroundColour(0, 0));
+    CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellBackgroundColour(5, 1));
+
+    // Same thing for columns.
+    m_grid->InsertCols(1);
+    CPPUNIT_ASSERT_EQUAL(*wxBLUE, m_grid->GetCellBackgroundColour(5, 0));
+    CPPUNIT_ASSERT_EQUAL(back, m_grid->GetCellBackgroundColour(5, 1));
+    CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellBackgroundColour(5, 2));
+
+    m_grid->DeleteCols(0);
+    CPPUNIT_ASSERT_EQUAL(back, m_grid->GetCellBackgroundColour(5, 0));
+    CPPUNIT_ASSERT_EQUAL(*wxGREEN, m_grid->GetCellBackgroundColour(5, 1));
+
+    // And resetting the attribute removes it.
+    m_grid->GetTable()->SetAttr(NULL, 5, 1);
+    CPPUNIT_ASSERT_EQUAL(back, m_grid->GetCellBackgroundColour(5, 1));
+}
+
+void GridTestCase::ColumnarTable()
+{
+    wxGridColumnarTable * const table = new wxGridColumnarTable(5);
+    table->AppendTypedCols(wxGRID_VALUE_NUMBER);
+    table->AppendTypedCols(wxGRID_VALUE_FLOAT);
+    table->AppendTypedCols(wxGRID_VALUE_BOOL);
+    table->AppendCols();
+    m_grid->SetTable(table, true);
+
+    CPPUNIT_ASSERT_EQUAL(5, m_grid->GetNumberRows());
+    CPPUNIT_ASSERT_EQUAL(4, m_grid->GetNumberCols());
+
+    CPPUNIT_ASSERT_EQUAL("long", table->GetTypeName(0, 0));
+    CPPUNIT_ASSERT_EQUAL("double", table->GetTypeName(0, 1));
+    CPPUNIT_ASSERT_EQUAL("bool", table->GetTypeName(0, 2));
+    CPPUNIT_ASSERT_EQUAL("string", table->GetTypeName(0, 3));
+
+    CPPUNIT_ASSERT( table->CanGetValueAs(0, 0, wxGRID_VALUE_NUMBER) );
+    CPPUNIT_ASSERT( !table->CanGetValueAs(0, 0, wxGRID_VALUE_FLOAT) );
+    CPPUNIT_ASSERT( table->CanGetValueAs(0, 0, wxGRID_VALUE_STRING) );
+
+    // Values set using strings can be retrieved as numbers and vice versa.
+    m_grid->SetCellValue(1, 0, "17");
+    CPPUNIT_ASSERT_EQUAL(17L, table->GetValueAsLong(1, 0));
+    CPPUNIT_ASSERT_EQUAL("0", m_grid->GetCellValue(0, 0));
+
+    table->SetValueAsDouble(2, 1, 1.5);
+    CPPUNIT_ASSERT_EQUAL("1.5", m_grid->GetCellValue(2, 1));
+
+    // Check that the string value changes when the cell changes.
+    table->SetValueAsDouble(2, 1, 2.5);
+    CPPUNIT_ASSERT_EQUAL("2.5", m_grid->GetCellValue(2, 1));
+
+    CPPUNIT_ASSERT( table->IsEmptyCell(3, 2) );
+    m_grid->SetCellValue(3, 2, "1");
+    CPPUNIT_ASSERT( table->GetValueAsBool(3, 2) );
+    CPPUNIT_ASSERT( !table->IsEmptyCell(3, 2) );
+
+    m_grid->SetCellValue(0, 3, "foo");
+    m_grid->SetCellValue(4, 3, "foo");
+    CPPUNIT_ASSERT_EQUAL("foo", m_grid->GetCellValue(4, 3));
+    CPPUNIT_ASSERT( table->IsEmptyCell(1, 3) );
+
+    // Bulk access.
+    const long values[] = { 1, 2, 3, 4, 5 };
+    CPPUNIT_ASSERT( table->SetColValuesAsLong(0, 0, 5, values) );
+    CPPUNIT_ASSERT_EQUAL("5", m_grid->GetCellValue(4, 0));
+
+    long got[3];
+    CPPUNIT_ASSERT( table->GetColValuesAsLong(0, 1, 3, got) );
+    CPPUNIT_ASSERT_EQUAL(2L, got[0]);
+    CPPUNIT_ASSERT_EQUAL(4L, got[2]);
+
+    // Inserting and deleting rows moves the values of all columns.
+    m_grid->InsertRows(1, 2);
+    CPPUNIT_ASSERT_EQUAL(7, m_grid->GetNumberRows());
+    CPPUNIT_ASSERT_EQUAL("1", m_grid->GetCellValue(0, 0));
+    CPPUNIT_ASSERT_EQUAL("0", m_grid->GetCellValue(1, 0));
+    CPPUNIT_ASSERT_EQUAL("2", m_grid->GetCellValue(3, 0));
+    CPPUNIT_ASSERT_EQUAL("2.5", m_grid->GetCellValue(4, 1));
+    CPPUNIT_ASSERT_EQUAL("foo", m_grid->GetCellValue(6, 3));
+
+    m_grid->DeleteRows(0, 3);
+    CPPUNIT_ASSERT_EQUAL(4, m_grid->GetNumberRows());
+    CPPUNIT_ASSERT_EQUAL("2", m_grid->GetCellValue(0, 0));
+    CPPUNIT_ASSERT( table->GetValueAsBool(2, 2) );
+
+    m_grid->DeleteCols(0, 1);
+    CPPUNIT_ASSERT_EQUAL(3, m_grid->GetNumberCols());
+    CPPUNIT_ASSERT_EQUAL("double", table->GetTypeName(0, 0));
+}
+
+void GridTestCase::ColumnarTableFormattedValues()
+{
+    wxGridColumnarTable * const table = new wxGridColumnarTable(100);
+    table->AppendTypedCols(wxGRID_VALUE_NUMBER);
+    table->AppendTypedCols(wxGRID_VALUE_FLOAT ":6,2");
+    m_grid->SetTable(table, true);
+
+    for ( int row = 0; row < 100; row++ )
+    {
+        table->SetValueAsLong(row, 0, row);
+        table->SetValueAsDouble(row, 1, row + 0.5);
+    }
+
+    // The formatted values are only cached if they were formatted using the
+    // same format and are forgotten when the values change.
+    wxArrayString strings;
+    strings.push_back("10");
+    strings.push_back("11");
+    table->SetFormattedValues(0, 10, "%ld", strings);
+
+    wxString value;
+    CPPUNIT_ASSERT( table->GetFormattedValue(11, 0, "%ld", &value) );
+    CPPUNIT_ASSERT_EQUAL("11", value);
+    CPPUNIT_ASSERT( !table->GetFormattedValue(12, 0, "%ld", &value) );
+    CPPUNIT_ASSERT( !table->GetFormattedValue(11, 0, "%lx", &value) );
+
+    table->SetValueAsLong(12, 0, 12);
+    CPPUNIT_ASSERT( !table->GetFormattedValue(11, 0, "%ld", &value) );
+
+    table->SetFormattedValues(0, 10, "%ld", strings);
+    m_grid->SetCellValue(10, 0, "10");
+    CPPUNIT_ASSERT( !table->GetFormattedValue(11, 0, "%ld", &value) );
+
+    table->SetFormattedValues(0, 10, "%ld", strings);
+    m_grid->InsertRows(0);
+    CPPUNIT_ASSERT( !table->GetFormattedValue(11, 0, "%ld", &value) );
+    m_grid->DeleteRows(0);
+
+    // The renderers format the values of all the visible cells of the column
+    // at once and use the cached strings.
+    wxClientDC dc(m_grid->GetGridWindow());
+
+    wxGridCellAttr * const attr = m_grid->GetOrCreateCellAttr(0, 0);
+    wxGridCellRenderer * const renderer = attr->GetRenderer(m_grid, 0, 0);
+    renderer->GetBestSize(*m_grid, *attr, dc, 0, 0);
+
+    CPPUNIT_ASSERT( table->GetFormattedValue(0, 0, "%ld", &value) );
+    CPPUNIT_ASSERT_EQUAL("0", value);
+    if ( m_grid->IsVisible(1, 0, false) )
+    {
+        CPPUNIT_ASSERT( table->GetFormattedValue(1, 0, "%ld", &value) );
+        CPPUNIT_ASSERT_EQUAL("1", value);
+    }
+
+    renderer->DecRef();
+    attr->DecRef();
+
+    wxGridCellAttr * const attrFloat = m_grid->GetOrCreateCellAttr(0, 1);
+    wxGridCellRenderer * const
+        rendererFloat = attrFloat->GetRenderer(m_grid, 0, 1);
+    rendererFloat->GetBestSize(*m_grid, *attrFloat, dc, 0, 1);
+
+    CPPUNIT_ASSERT( table->GetFormattedValue(0, 1, "%6.2f", &value) );
+    CPPUNIT_ASSERT_EQUAL("  0.50", value);
+
+    // Changing the format results in the values being formatted again.
+    static_cast<wxGridCellFloatRenderer *>(rendererFloat)->SetPrecision(1);
+    rendererFloat->GetBestSize(*m_grid, *attrFloat, dc, 0, 1);
+
+    CPPUNIT_ASSERT( !table->GetFormattedValue(0, 1, "%6.2f", &value) );
+    CPPUNIT_ASSERT( table->GetFormattedValue(0, 1, "%6.1f", &value) );
+    CPPUNIT_ASSERT_EQUAL("   0.5", value);
+
+    rendererFloat->DecRef();
+    attrFloat->DecRef();
+}
+
 void GridTestCase::Editable()
 {
 #if wxUSE_UIACTIONSIMULATOR
@@ -62,6 +62,8 @@ private:
         CPPUNIT_TEST( Delete );
         CPPUNIT_TEST( Url );
         CPPUNIT_TEST( Table );
+        CPPUNIT_TEST( LayoutInParts );
+        CPPUNIT_TEST( FindParagraph );
     CPPUNIT_TEST_SUITE_END();
 
     void CharacterEvent();
@@ -92,6 +94,8 @@ private:
     void Delete();
     void Url();
     void Table();
+    void LayoutInParts();
+    void FindParagraph();
 
     wxRichTextCtrl* m_rich;
 
@@ -888,4 +892,87 @@ void RichTextCtrlTestCase::Table()
     m_rich->SetFocusObject(NULL);
 }
 
+void RichTextCtrlTestCase::LayoutInParts()
+{
+    m_rich->BeginSuppressUndo();
+    for ( int n = 0; n < 500; n++ )
+    {
+        m_rich->WriteText(wxString::Format("Paragraph %d is long enough to be "
+                                           "wrapped when the control is narrow.",
+                                           n));
+        m_rich->Newline();
+    }
+    m_rich->EndSuppressUndo();
+
+    m_rich->LayoutContent();
+
+    // Lay out the buffer for the new size in parts, as is done in idle time
+    // after resizing the control.
+    m_rich->SetSize(wxSize(150, 200));
+
+    int parts = 0;
+    while ( m_rich->LayoutNextPart() )
+        parts++;
+
+    CPPUNIT_ASSERT( parts > 0 );
+
+    wxRichTextBuffer& buffer = m_rich->GetBuffer();
+    wxRichTextParagraph* const last = buffer.GetParagraphAtPosition(buffer.GetOwnRange().GetEnd());
+    CPPUNIT_ASSERT( last );
+
+    const int y = last->GetPosition().y;
+    const int height = buffer.GetCachedSize().y;
+
+    // The result must be the same as when laying out everything at once.
+    buffer.Invalidate(wxRICHTEXT_ALL);
+    m_rich->LayoutContent();
+
+    CPPUNIT_ASSERT_EQUAL( last->GetPosition().y, y );
+    CPPUNIT_ASSERT_EQUAL( buffer.GetCachedSize().y, height );
+}
+
+void RichTextCtrlTestCase::FindParagraph()
+{
+    m_rich->BeginSuppressUndo();
+    for ( int n = 0; n < 100; n++ )
+    {
+        m_rich->WriteText(wxString::Format("Paragraph %d", n));
+        m_rich->Newline();
+    }
+    m_rich->EndSuppressUndo();
+
+    m_rich->LayoutContent();
+
+    wxRichTextBuffer& buffer = m_rich->GetBuffer();
+
+    // Each paragraph, except the last one, is "Paragraph N" followed by the
+    // paragraph separator.
+    const long start50 = m_rich->XYToPosition(0, 50);
+    wxRichTextParagraph* const para50 = buffer.GetParagraphAtPosition(start50);
+    CPPUNIT_ASSERT( para50 );
+    CPPUNIT_ASSERT_EQUAL( "Paragraph 50", para50->GetTextForRange(para50->GetRange()).Trim() );
+    CPPUNIT_ASSERT( para50 == buffer.GetParagraphAtPosition(para50->GetRange().GetEnd()) );
+    CPPUNIT_ASSERT( para50 != buffer.GetParagraphAtPosition(para50->GetRange().GetEnd() + 1) );
+    CPPUNIT_ASSERT( !buffer.GetParagraphAtPosition(buffer.GetOwnRange().GetEnd() + 1) );
+
+    wxRichTextLine* const line = buffer.GetLineAtPosition(start50 + 3);
+    CPPUNIT_ASSERT( line );
+    CPPUNIT_ASSERT( line->GetParent() == para50 );
+
+    const wxRect rect = line->GetRect();
+    CPPUNIT_ASSERT( buffer.GetLineAtYPosition(rect.y + rect.height/2) == line );
+
+    long pos;
+    CPPUNIT_ASSERT( m_rich->HitTest(m_rich->GetPhysicalPoint(wxPoint(rect.x + 1, rect.y + rect.height/2)), &pos) != wxTE_HT_UNKNOWN );
+    CPPUNIT_ASSERT( para50->GetRange().Contains(pos) );
+
+    // Removing a paragraph must be taken into account.
+    m_rich->Delete(para50->GetRange());
+    m_rich->LayoutContent();
+
+    wxRichTextParagraph* const para = buffer.GetParagraphAtPosition(start50);
+    CPPUNIT_ASSERT( para );
+    CPPUNIT_ASSERT_EQUAL( "Paragraph 51", para->GetTextForRange(para->GetRange()).Trim() );
+}
+
 #endif //wxUSE_RICHTEXT
@@ -61,6 +61,7 @@ private:
         CPPUNIT_TEST( Bold );
         CPPUNIT_TEST( Visible );
         CPPUNIT_TEST( Sort );
+        CPPUNIT_TEST( AppendItems );
         WXUISIM_TEST( KeyNavigation );
         CPPUNIT_TEST( HasChildren );
         CPPUNIT_TEST( SelectItemSingle );
@@ -88,6 +89,7 @@ private:
     void Bold();
     void Visible();
     void Sort();
+    void AppendItems();
     void KeyNavigation();
     void HasChildren();
     void SelectItemSingle();
@@ -572,6 +574,42 @@ void TreeCtrlTestCase::Sort()
     CPPUNIT_ASSERT_EQUAL(zitem, m_tree->GetNextChild(m_root, cookie));
 }
 
+void TreeCtrlTestCase::AppendItems()
+{
+    wxArrayString texts;
+    for ( int n = 0; n < 100; n++ )
+        texts.push_back(wxString::Format("item%d", n));
+
+    wxArrayTreeItemIds ids;
+    m_tree->AppendItems(m_child1, texts, -1, -1, &ids);
+
+    CPPUNIT_ASSERT_EQUAL( 100, ids.size() );
+    CPPUNIT_ASSERT_EQUAL( 101, m_tree->GetChildrenCount(m_child1, false) );
+
+    wxTreeItemIdValue cookie;
+    CPPUNIT_ASSERT_EQUAL( m_grandchild, m_tree->GetFirstChild(m_child1, cookie) );
+    CPPUNIT_ASSERT_EQUAL( ids[99], m_tree->GetLastChild(m_child1) );
+    CPPUNIT_ASSERT_EQUAL( "item50", m_tree->GetItemText(ids[50]) );
+
+    // The new items must be positioned between the existing ones.
+    wxRect rectRoot, rectChild1, rectChild2, rectFirst, rectLast;
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_root, rectRoot) );
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_child1, rectChild1) );
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(ids[0], rectFirst) );
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(ids[99], rectLast) );
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_child2, rectChild2) );
+
+    const int height = rectChild1.y - rectRoot.y;
+    CPPUNIT_ASSERT_EQUAL( rectChild1.y + 2*height, rectFirst.y );
+    CPPUNIT_ASSERT_EQUAL( rectFirst.y + 99*height, rectLast.y );
+    CPPUNIT_ASSERT_EQUAL( rectLast.y + height, rectChild2.y );
+
+    // And collapsing the branch must move the following items back up.
+    m_tree->Collapse(m_child1);
+    CPPUNIT_ASSERT( m_tree->GetBoundingRect(m_child2, rectChild2) );
+    CPPUNIT_ASSERT_EQUAL( rectChild1.y + height, rectChild2.y );
+}
+
 void TreeCtrlTestCase::KeyNavigation()
 {
 #if wxUSE_UIACTIONSIMULATOR && !defined(__WXGTK__)
@@ -18,6 +18,24 @@
 
 #include "wx/timer.h"
 
+// The tests of the Unix console event loop implementation details.
+#if !wxUSE_GUI && wxUSE_CONSOLE_EVENTLOOP && \
+        defined(__UNIX__) && !defined(__DARWIN__)
+    #define TEST_CONSOLE_EVENTLOOP
+
+    #include "wx/app.h"
+    #include "wx/evtloop.h"
+    #include "wx/evtloopsrc.h"
+    #include "wx/scopedptr.h"
+    #include "wx/stopwatch.h"
+    #include "wx/vector.h"
+    #include "wx/private/fdiodispatcher.h"
+    #include "wx/unix/pipe.h"
+
+    #include <dirent.h>
+    #include <unistd.h>
+#endif
+
 // ----------------------------------------------------------------------------
 // constants
 // ----------------------------------------------------------------------------
@@ -38,9 +56,27 @@ public:
 private:
     CPPUNIT_TEST_SUITE( EvtloopTestCase );
         CPPUNIT_TEST( TestExit );
+#ifdef TEST_CONSOLE_EVENTLOOP
+        CPPUNIT_TEST( WakeUpCoalesced );
+#ifdef wxHAS_TIMERFD
+        CPPUNIT_TEST( TimerFD );
+#endif // wxHAS_TIMERFD
+#if wxUSE_EPOLL_DISPATCHER
+        CPPUNIT_TEST( DispatchBatch );
+#endif // wxUSE_EPOLL_DISPATCHER
+#endif // TEST_CONSOLE_EVENTLOOP
     CPPUNIT_TEST_SUITE_END();
 
     void TestExit();
+#ifdef TEST_CONSOLE_EVENTLOOP
+    void WakeUpCoalesced();
+#ifdef wxHAS_TIMERFD
+    void TimerFD();
+#endif // wxHAS_TIMERFD
+#if wxUSE_EPOLL_DISPATCHER
+    void DispatchBatch();
+#endif // wxUSE_EPOLL_DISPATCHER
+#endif // TEST_CONSOLE_EVENTLOOP
 
     DECLARE_NO_COPY_CLASS(EvtloopTestCase)
 };
@@ -125,3 +161,219 @@ void EvtloopTestCase::TestExit()
     timerRun2.StartOnce(1);
     CPPUNIT_ASSERT_EQUAL( EXIT_CODE_OUTER_LOOP, loopOuter.Run() );
 }
+
+#ifdef TEST_CONSOLE_EVENTLOOP
+
+namespace
+{
+
+// Handler counting the events it gets.
+class CountingHandler : public wxEvtHandler
+{
+public:
+    CountingHandler()
+    {
+        m_events = 0;
+
+        Bind(wxEVT_THREAD, &CountingHandler::OnThreadEvent, this);
+    }
+
+    int GetNumEvents() const { return m_events; }
+
+private:
+    void OnThreadEvent(wxThreadEvent& WXUNUSED(event)) { m_events++; }
+
+    int m_events;
+
+    wxDECLARE_NO_COPY_CLASS(CountingHandler);
+};
+
+// Event loop source handler counting the notifications about the read end of
+// a pipe becoming readable and, optionally, reading the data from it.
+class PipeSourceHandler : public wxEventLoopSourceHandler
+{
+public:
+    explicit PipeSourceHandler(bool drain)
+        : m_drain(drain)
+    {
+        m_notifications = 0;
+
+        CPPUNIT_ASSERT( m_pipe.Create() );
+        CPPUNIT_ASSERT_EQUAL( 1, write(m_pipe[wxPipe::Write], "x", 1) );
+    }
+
+    int GetReadFd() const { return m_pipe[wxPipe::Read]; }
+    int GetNumNotifications() const { return m_notifications; }
+
+    virtual void OnReadWaiting() wxOVERRIDE
+    {
+        m_notifications++;
+
+        if ( m_drain )
+        {
+            char ch;
+            CPPUNIT_ASSERT_EQUAL( 1, read(GetReadFd(), &ch, 1) );
+        }
+    }
+
+    virtual void OnWriteWaiting() wxOVERRIDE { }
+    virtual void OnExceptionWaiting() wxOVERRIDE { }
+
+private:
+    wxPipe m_pipe;
+    const bool m_drain;
+    int m_notifications;
+
+    wxDECLARE_NO_COPY_CLASS(PipeSourceHandler);
+};
+
+} // anonymous namespace
+
+void EvtloopTestCase::WakeUpCoalesced()
+{
+    wxEventLoop loop;
+    CPPUNIT_ASSERT( loop.IsOk() );
+
+    // Several wake ups result in a single notification, after which nothing
+    // remains to be read.
+    for ( int n = 0; n < 5; n++ )
+        loop.WakeUp();
+
+    CPPUNIT_ASSERT_EQUAL( 1, loop.DispatchTimeout(0) );
+    CPPUNIT_ASSERT_EQUAL( -1, loop.DispatchTimeout(0) );
+
+    // The same happens when the loop is woken up by the posted events, which
+    // must all be processed after it.
+    wxEventLoopActivator activate(&loop);
+
+    CountingHandler handler;
+    for ( int n = 0; n < 10; n++ )
+        handler.QueueEvent(new wxThreadEvent);
+
+    CPPUNIT_ASSERT_EQUAL( 1, loop.DispatchTimeout(0) );
+    CPPUNIT_ASSERT_EQUAL( -1, loop.DispatchTimeout(0) );
+
+    wxTheApp->ProcessPendingEvents();
+    CPPUNIT_ASSERT_EQUAL( 10, handler.GetNumEvents() );
+}
+
+#ifdef wxHAS_TIMERFD
+
+// Return the number of timerfd descriptors opened by this process.
+static int GetNumTimerFDs()
+{
+    DIR * const dir = opendir("/proc/self/fd");
+    if ( !dir )
+        return -1;
+
+    int count = 0;
+    while ( dirent * const entry = readdir(dir) )
+    {
+        const wxString path = wxString("/proc/self/fd/") + entry->d_name;
+
+        char target[64];
+        const ssize_t len = readlink(path.c_str(), target, sizeof(target) - 1);
+        if ( len > 0 )
+        {
+            target[len] = '\0';
+            if ( strcmp(target, "anon_inode:[timerfd]") == 0 )
+                count++;
+        }
+    }
+
+    closedir(dir);
+
+    return count;
+}
+
+void EvtloopTestCase::TimerFD()
+{
+    const int numTimerFDs = GetNumTimerFDs();
+    if ( numTimerFDs == -1 )
+        return;
+
+    wxEventLoop loop;
+    CPPUNIT_ASSERT( loop.IsOk() );
+    CPPUNIT_ASSERT_EQUAL( numTimerFDs + 1, GetNumTimerFDs() );
+
+    // The timer must expire during the single dispatch, as the timerfd wakes
+    // up the loop only after its expiration time: when waiting for it using
+    // the timeout rounded to milliseconds, the dispatcher could return before
+    // it expired.
+    ScheduleLoopExitTimer timer(loop, EXIT_CODE_OUTER_LOOP);
+
+    wxStopWatch sw;
+    timer.StartOnce(50);
+
+    CPPUNIT_ASSERT_EQUAL( 1, loop.DispatchTimeout(1000) );
+    CPPUNIT_ASSERT( sw.Time() >= 50 );
+    CPPUNIT_ASSERT( sw.Time() < 1000 );
+    CPPUNIT_ASSERT( !timer.IsRunning() );
+
+    // And there is nothing left to dispatch after it.
+    CPPUNIT_ASSERT_EQUAL( -1, loop.DispatchTimeout(0) );
+}
+
+#endif // wxHAS_TIMERFD
+
+#if wxUSE_EPOLL_DISPATCHER
+
+void EvtloopTestCase::DispatchBatch()
+{
+    wxEventLoop loop;
+    CPPUNIT_ASSERT( loop.IsOk() );
+
+    // Use more descriptors than the number of events which used to be
+    // retrieved by a single epoll_wait() call.
+    static const int NUM_PIPES = 40;
+
+    wxVector<PipeSourceHandler*> handlers;
+    wxVector<wxEventLoopSource*> sources;
+    for ( int n = 0; n < NUM_PIPES; n++ )
+    {
+        PipeSourceHandler * const handler = new PipeSourceHandler(true);
+        handlers.push_back(handler);
+        sources.push_back(wxEventLoopBase::AddSourceForFD
+                          (
+                            handler->GetReadFd(),
+                            handler,
+                            wxEVENT_SOURCE_INPUT
+                          ));
+        CPPUNIT_ASSERT( sources.back() );
+    }
+
+    // All of the ready descriptors must be dispatched at once.
+    CPPUNIT_ASSERT_EQUAL( 1, loop.DispatchTimeout(0) );
+    for ( int n = 0; n < NUM_PIPES; n++ )
+        CPPUNIT_ASSERT_EQUAL( 1, handlers[n]->GetNumNotifications() );
+
+    CPPUNIT_ASSERT_EQUAL( -1, loop.DispatchTimeout(0) );
+
+    for ( int n = 0; n < NUM_PIPES; n++ )
+    {
+        delete sources[n];
+        delete handlers[n];
+    }
+
+    // An edge-triggered descriptor is notified only once even if its data is
+    // not read.
+    PipeSourceHandler handlerET(false);
+    wxScopedPtr<wxEventLoopSource>
+        sourceET(wxEventLoopBase::AddSourceForFD
+                 (
+                    handlerET.GetReadFd(),
+                    &handlerET,
+                    wxEVENT_SOURCE_INPUT | wxFDIO_EDGE_TRIGGERED
+                 ));
+    CPPUNIT_ASSERT( sourceET );
+
+    CPPUNIT_ASSERT_EQUAL( 1, loop.DispatchTimeout(0) );
+    CPPUNIT_ASSERT_EQUAL( 1, handlerET.GetNumNotifications() );
+
+    CPPUNIT_ASSERT_EQUAL( -1, loop.DispatchTimeout(0) );
+    CPPUNIT_ASSERT_EQUAL( 1, handlerET.GetNumNotifications() );
+}
+
+#endif // wxUSE_EPOLL_DISPATCHER
+
+#endif // TEST_CONSOLE_EVENTLOOP
@@ -23,6 +23,7 @@
 
 #include "wx/evtloop.h"
 #include "wx/timer.h"
+#include "wx/vector.h"
 
 // --------------------------------------------------------------------------
 // helper class counting the number of timer events
@@ -68,10 +69,12 @@ private:
     CPPUNIT_TEST_SUITE( TimerEventTestCase );
         CPPUNIT_TEST( OneShot );
         CPPUNIT_TEST( Multiple );
+        CPPUNIT_TEST( Many );
     CPPUNIT_TEST_SUITE_END();
 
     void OneShot();
     void Multiple();
+    void Many();
 
     DECLARE_NO_COPY_CLASS(TimerEventTestCase)
 };
@@ -145,3 +148,48 @@ void TimerEventTestCase::Multiple()
     CPPUNIT_ASSERT( numTicks > 1 );
 #endif // !(wxGTK Unicode)
 }
+
+void TimerEventTestCase::Many()
+{
+    wxEventLoop loop;
+
+    TimerCounterHandler handler;
+
+    // start many one-shot timers with different, and sometimes equal,
+    // intervals and stop some of them before they expire
+    const int numTimers = 100;
+    wxVector<wxTimer*> timers;
+    int n;
+    for ( n = 0; n < numTimers; n++ )
+    {
+        wxTimer* const timer = new wxTimer(&handler);
+        timer->Start(10 + (n*7) % 50, true);
+        timers.push_back(timer);
+    }
+
+    int numStopped = 0;
+    for ( n = 0; n < numTimers; n += 3 )
+    {
+        timers[n]->Stop();
+        numStopped++;
+    }
+
+    // restarting a timer shouldn't result in it being notified twice
+    timers[1]->Start(30, true);
+
+    time_t t;
+    time(&t);
+    const time_t tEnd = t + 2;
+    while ( time(&t) < tEnd && handler.GetNumEvents() < numTimers - numStopped )
+    {
+        loop.Dispatch();
+    }
+
+    CPPUNIT_ASSERT_EQUAL( numTimers - numStopped, handler.GetNumEvents() );
+
+    for ( n = 0; n < numTimers; n++ )
+    {
+        CPPUNIT_ASSERT( !timers[n]->IsRunning() );
+        delete timers[n];
+    }
+}
@@ -18,6 +18,7 @@
 
 #include "wx/bitmap.h"
 #include "wx/dcmemory.h"
+#include "wx/graphics.h"
 
 // ----------------------------------------------------------------------------
 // test class
@@ -34,9 +35,15 @@ public:
 private:
     CPPUNIT_TEST_SUITE( BitmapTestCase );
         CPPUNIT_TEST( Mask );
+#if wxUSE_GRAPHICS_CONTEXT
+        CPPUNIT_TEST( DrawModified );
+#endif // wxUSE_GRAPHICS_CONTEXT
     CPPUNIT_TEST_SUITE_END();
 
     void Mask();
+#if wxUSE_GRAPHICS_CONTEXT
+    void DrawModified();
+#endif // wxUSE_GRAPHICS_CONTEXT
 
     wxBitmap m_bmp;
 
@@ -80,3 +87,60 @@ void BitmapTestCase::Mask()
     m_bmp.SetMask(mask2);
 }
 
+#if wxUSE_GRAPHICS_CONTEXT
+
+// Return the colour of the centre of the bitmap drawn using wxGraphicsContext.
+static wxColour GetDrawnColour(const wxBitmap& bmp)
+{
+    wxBitmap target(bmp.GetWidth(), bmp.GetHeight());
+    {
+        wxMemoryDC dc(target);
+        dc.SetBackground(*wxWHITE_BRUSH);
+        dc.Clear();
+
+        wxGraphicsContext* const gc = wxGraphicsContext::Create(dc);
+        gc->DrawBitmap(bmp, 0, 0, bmp.GetWidth(), bmp.GetHeight());
+        delete gc;
+    }
+
+    const wxImage image = target.ConvertToImage();
+    const int x = image.GetWidth() / 2,
+              y = image.GetHeight() / 2;
+    return wxColour(image.GetRed(x, y), image.GetGreen(x, y), image.GetBlue(x, y));
+}
+
+static void FillBitmap(wxDC& dc, const wxColour& colour)
+{
+    dc.SetBackground(wxBrush(colour));
+    dc.Clear();
+}
+
+void BitmapTestCase::DrawModified()
+{
+    // Drawing the same bitmap several times may reuse the data created for
+    // drawing it the first time, check that it's not used any more after the
+    // bitmap is modified by drawing on it.
+    wxBitmap bmp(8, 8);
+    {
+        wxMemoryDC dc(bmp);
+        FillBitmap(dc, *wxRED);
+    }
+
+    CPPUNIT_ASSERT_EQUAL( *wxRED, GetDrawnColour(bmp) );
+    CPPUNIT_ASSERT_EQUAL( *wxRED, GetDrawnColour(bmp) );
+
+    // Modify the bitmap while it is selected into the DC.
+    wxMemoryDC dc(bmp);
+    FillBitmap(dc, *wxBLUE);
+    CPPUNIT_ASSERT_EQUAL( *wxBLUE, GetDrawnColour(bmp) );
+
+    FillBitmap(dc, *wxGREEN);
+    CPPUNIT_ASSERT_EQUAL( *wxGREEN, GetDrawnColour(bmp) );
+
+    // And after deselecting it.
+    dc.SelectObject(wxNullBitmap);
+    CPPUNIT_ASSERT_EQUAL( *wxGREEN, GetDrawnColour(bmp) );
+    CPPUNIT_ASSERT_EQUAL( *wxGREEN, GetDrawnColour(bmp) );
+}
+
+#endif // wxUSE_GRAPHICS_CONTEXT
@@ -47,6 +47,8 @@ private:
         WXUISIM_TEST( LinkClick );
 #endif // wxUSE_UIACTIONSIMULATOR
         CPPUNIT_TEST( AppendToPage );
+        CPPUNIT_TEST( ProgressiveRendering );
+        CPPUNIT_TEST( FindCellByPos );
     CPPUNIT_TEST_SUITE_END();
 
     void SelectionToText();
@@ -54,6 +56,8 @@ private:
     void CellClick();
     void LinkClick();
     void AppendToPage();
+    void ProgressiveRendering();
+    void FindCellByPos();
 
     wxHtmlWindow *m_win;
 
@@ -164,4 +168,100 @@ void HtmlWindowTestCase::AppendToPage()
     CPPUNIT_ASSERT_EQUAL("link A new paragraph", m_win->ToText());
 }
 
+namespace
+{
+
+// Counts the number of times the partially parsed page was shown.
+class ProgressHtmlWindow : public wxHtmlWindow
+{
+public:
+    ProgressHtmlWindow(wxWindow* parent)
+        : wxHtmlWindow(parent, wxID_ANY, wxDefaultPosition, wxSize(400, 200)),
+          m_progressCount(0)
+    {
+    }
+
+    virtual void OnHTMLParsingProgress(wxHtmlContainerCell *cell) wxOVERRIDE
+    {
+        m_progressCount++;
+
+        wxHtmlWindow::OnHTMLParsingProgress(cell);
+    }
+
+    int m_progressCount;
+};
+
+} // anonymous namespace
+
+void HtmlWindowTestCase::ProgressiveRendering()
+{
+    // Create a page long enough to take some time to parse and containing
+    // tables, whose layout is the most complicated to update.
+    wxString page("<html><body>");
+    for ( int n = 0; n < 2000; n++ )
+    {
+        page += wxString::Format("<p>Paragraph %d with some text in it.</p>"
+                                 "<table border=1><tr><td>Cell</td>"
+                                 "<td>Another cell %d</td></tr></table>",
+                                 n, n);
+    }
+    page += "</body></html>";
+
+    ProgressHtmlWindow* const
+        win = new ProgressHtmlWindow(wxTheApp->GetTopWindow());
+    wxDELETE(m_win);
+    m_win = win;
+
+    win->SetPage(page);
+    const wxSize sizeAll = win->GetVirtualSize();
+    CPPUNIT_ASSERT_EQUAL( 0, win->m_progressCount );
+
+    win->EnableProgressiveRendering();
+    CPPUNIT_ASSERT( win->IsProgressiveRenderingEnabled() );
+
+    // Don't depend on the time taken by parsing the page.
+    win->SetProgressiveRenderingDelay(0);
+    CPPUNIT_ASSERT_EQUAL( 0, win->GetProgressiveRenderingDelay() );
+
+    // The final layout must be the same whether the page was drawn while it
+    // was being parsed or not.
+    win->SetPage(page);
+    CPPUNIT_ASSERT( win->m_progressCount > 0 );
+    CPPUNIT_ASSERT_EQUAL( sizeAll, win->GetVirtualSize() );
+    CPPUNIT_ASSERT_EQUAL( 0, win->GetParser()->GetProgressInterval() );
+}
+
+void HtmlWindowTestCase::FindCellByPos()
+{
+    // Use a page with many cells in the same container to check that finding
+    // them works correctly when using the index of their positions.
+    wxString page("<html><body>");
+    for ( int n = 0; n < 500; n++ )
+        page += wxString::Format("Line %d<br>", n);
+    page += "</body></html>";
+
+    m_win->SetPage(page);
+
+    const wxHtmlContainerCell * const top = m_win->GetInternalRepresentation();
+    CPPUNIT_ASSERT( top );
+
+    for ( int y = 0; y < top->GetHeight(); y += 7 )
+    {
+        const wxHtmlCell * const
+            cell = top->FindCellByPos(5, y, wxHTML_FIND_NEAREST_AFTER);
+        CPPUNIT_ASSERT( cell );
+
+        const wxPoint pos = cell->GetAbsPos();
+        CPPUNIT_ASSERT( pos.y + cell->GetHeight() > y );
+
+        const wxHtmlCell * const
+            before = top->FindCellByPos(5, y, wxHTML_FIND_NEAREST_BEFORE);
+        if ( before )
+            CPPUNIT_ASSERT( before->GetAbsPos().y <= y );
+    }
+
+    // There are no cells below the end of the page.
+    CPPUNIT_ASSERT( !top->FindCellByPos(5, top->GetHeight() + 10) );
+}
+
 #endif //wxUSE_HTML
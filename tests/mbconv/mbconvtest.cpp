@@ -100,6 +100,10 @@ private:
         CPPUNIT_TEST( UTF8_f4_8f_bf_bd );
         CPPUNIT_TEST( UTF8PUA_f4_80_82_a5 );
         CPPUNIT_TEST( UTF8Octal_backslash245 );
+        CPPUNIT_TEST( UTF8ASCIIRuns );
+        CPPUNIT_TEST( UTF8NonASCIIInRun );
+        CPPUNIT_TEST( UTF8OctalBackslashInRun );
+        CPPUNIT_TEST( UTF8FromWCharExplicitLength );
 #endif // HAVE_WCHAR_H
     CPPUNIT_TEST_SUITE_END();
 
@@ -203,6 +207,12 @@ private:
     void UTF8PUA_f4_80_82_a5() { UTF8PUA("\xf4\x80\x82\xa5", u1000a5); }
     void UTF8Octal_backslash245() { UTF8Octal("\\245", L"\\245"); }
 
+    // Tests for the runs of ASCII characters, which are converted in bulk.
+    void UTF8ASCIIRuns();
+    void UTF8NonASCIIInRun();
+    void UTF8OctalBackslashInRun();
+    void UTF8FromWCharExplicitLength();
+
     // implementation for the utf-8 tests (see comments below)
     void UTF8(const char *charSequence, const wchar_t *wideSequence);
     void UTF8PUA(const char *charSequence, const wchar_t *wideSequence);
@@ -1353,4 +1363,183 @@ void MBConvTestCase::UTF8(const char *charSequence,
     UTF8ASSERT(strlen(bytesAgain) == resultAgain);
 }
 
+// Check that the UTF-8 string is converted to the wide one and back by the
+// given converter, using both the explicit lengths and NUL-terminated strings,
+// and that nothing is written beyond the end of the output buffer.
+static void UTF8RoundTrip(wxMBConv& conv,
+                          const std::string& utf8,
+                          const std::wstring& wide)
+{
+    const size_t BUFSIZE = 128;
+    wxASSERT(utf8.length() < BUFSIZE && wide.length() < BUFSIZE);
+
+    const std::string errmsg(" (for \"" + utf8 + "\")");
+
+    wchar_t widechars[BUFSIZE];
+    for ( size_t n = 0; n < BUFSIZE; n++ )
+        widechars[n] = L'!';
+
+    UTF8ASSERT(conv.ToWChar(NULL, 0, utf8.data(), utf8.length()) == wide.length());
+    UTF8ASSERT(conv.ToWChar(widechars, wide.length(),
+                            utf8.data(), utf8.length()) == wide.length());
+    UTF8ASSERT(std::wstring(widechars, wide.length()) == wide);
+    UTF8ASSERT(widechars[wide.length()] == L'!');
+
+    UTF8ASSERT(conv.ToWChar(widechars, BUFSIZE, utf8.c_str()) == wide.length() + 1);
+    UTF8ASSERT(widechars == wide);
+
+    char bytes[BUFSIZE];
+    memset(bytes, '!', sizeof(bytes));
+
+    UTF8ASSERT(conv.FromWChar(NULL, 0, wide.data(), wide.length()) == utf8.length());
+    UTF8ASSERT(conv.FromWChar(bytes, utf8.length(),
+                              wide.data(), wide.length()) == utf8.length());
+    UTF8ASSERT(std::string(bytes, utf8.length()) == utf8);
+    UTF8ASSERT(bytes[utf8.length()] == '!');
+
+    UTF8ASSERT(conv.FromWChar(bytes, BUFSIZE, wide.c_str()) == utf8.length() + 1);
+    UTF8ASSERT(bytes == utf8);
+}
+
+// Check the round trip using all UTF-8 converters for a string without any
+// backslashes, which are converted differently in octal mode.
+static void UTF8RoundTripAll(const std::string& utf8, const std::wstring& wide)
+{
+    wxMBConvStrictUTF8 strict;
+    UTF8RoundTrip(strict, utf8, wide);
+
+    wxMBConvUTF8 utf8Not(wxMBConvUTF8::MAP_INVALID_UTF8_NOT);
+    UTF8RoundTrip(utf8Not, utf8, wide);
+
+    wxMBConvUTF8 utf8PUA(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA);
+    UTF8RoundTrip(utf8PUA, utf8, wide);
+
+    wxMBConvUTF8 utf8Octal(wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL);
+    UTF8RoundTrip(utf8Octal, utf8, wide);
+}
+
+// Return a string of ASCII characters of the given length.
+static std::string MakeASCIIRun(size_t len)
+{
+    std::string s;
+    for ( size_t n = 0; n < len; n++ )
+        s += static_cast<char>('a' + n % 26);
+    return s;
+}
+
+static std::wstring ASCIIToWide(const std::string& s)
+{
+    return std::wstring(s.begin(), s.end());
+}
+
+void MBConvTestCase::UTF8ASCIIRuns()
+{
+    // The runs are processed 16 characters at once, check the lengths around
+    // this and around twice as much.
+    static const size_t lengths[] = { 1, 15, 16, 17, 31, 32, 33 };
+    for ( size_t n = 0; n < WXSIZEOF(lengths); n++ )
+    {
+        const std::string run = MakeASCIIRun(lengths[n]);
+        const std::wstring wrun = ASCIIToWide(run);
+
+        UTF8RoundTripAll(run, wrun);
+
+        // Also check the runs followed and preceded by a non-ASCII character.
+        UTF8RoundTripAll(run + "\xc3\xa9", wrun + L'\xe9');
+        UTF8RoundTripAll("\xc3\xa9" + run, L'\xe9' + wrun);
+    }
+}
+
+void MBConvTestCase::UTF8NonASCIIInRun()
+{
+    // Put a non-ASCII character at every position in and around the first 16
+    // byte chunk, using sequences of all lengths.
+    static const struct
+    {
+        const char *utf8;
+        const wchar_t *wide;
+    } chars[] =
+    {
+        { "\xc2\x80", u80 },
+        { "\xe2\x98\xa0", u2620 },
+        { "\xf0\x90\x80\x80", u10000 },
+    };
+
+    for ( size_t c = 0; c < WXSIZEOF(chars); c++ )
+    {
+        for ( size_t pos = 0; pos <= 33; pos++ )
+        {
+            const std::string run = MakeASCIIRun(33);
+
+            std::string utf8 = run;
+            utf8.insert(pos, chars[c].utf8);
+
+            std::wstring wide = ASCIIToWide(run);
+            wide.insert(pos, chars[c].wide);
+
+            UTF8RoundTripAll(utf8, wide);
+        }
+    }
+}
+
+void MBConvTestCase::UTF8OctalBackslashInRun()
+{
+    wxMBConvUTF8 utf8Octal(wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL);
+    wxMBConvStrictUTF8 strict;
+
+    // The backslashes are escaped in octal mode, so they must not be handled
+    // as just another ASCII character, wherever they are in the run.
+    for ( size_t pos = 0; pos <= 33; pos++ )
+    {
+        const std::string run = MakeASCIIRun(33);
+
+        std::string utf8 = run;
+        utf8.insert(pos, "\\");
+
+        std::wstring wide = ASCIIToWide(run);
+        wide.insert(pos, L"\\");
+        UTF8RoundTrip(strict, utf8, wide);
+
+        wide.insert(pos, L"\\");
+        UTF8RoundTrip(utf8Octal, utf8, wide);
+    }
+}
+
+void MBConvTestCase::UTF8FromWCharExplicitLength()
+{
+    // The characters after the given length must not be used, even if they
+    // would form an escape sequence or a surrogate pair with the last one.
+    char bytes[16];
+
+    wxMBConvUTF8 utf8Octal(wxMBConvUTF8::MAP_INVALID_UTF8_TO_OCTAL);
+
+    memset(bytes, '!', sizeof(bytes));
+    CPPUNIT_ASSERT_EQUAL( 2, utf8Octal.FromWChar(bytes, sizeof(bytes), L"a\\101", 2) );
+    CPPUNIT_ASSERT_EQUAL( std::string("a\\!"), std::string(bytes, 3) );
+
+    memset(bytes, '!', sizeof(bytes));
+    CPPUNIT_ASSERT_EQUAL( 2, utf8Octal.FromWChar(bytes, sizeof(bytes), L"a\\\\b", 2) );
+    CPPUNIT_ASSERT_EQUAL( std::string("a\\!"), std::string(bytes, 3) );
+
+    // This is the same as above but in the middle of a long ASCII run.
+    const std::wstring run = ASCIIToWide(MakeASCIIRun(20)) + L"\\101";
+    memset(bytes, '!', sizeof(bytes));
+    CPPUNIT_ASSERT_EQUAL( 16, utf8Octal.FromWChar(bytes, sizeof(bytes), run.c_str(), 16) );
+    CPPUNIT_ASSERT_EQUAL( MakeASCIIRun(16), std::string(bytes, 16) );
+
+    wxMBConvUTF8 utf8PUA(wxMBConvUTF8::MAP_INVALID_UTF8_TO_PUA);
+
+    memset(bytes, '!', sizeof(bytes));
+    CPPUNIT_ASSERT_EQUAL( 2, utf8PUA.FromWChar(bytes, sizeof(bytes), L"ab\xe9", 2) );
+    CPPUNIT_ASSERT_EQUAL( std::string("ab!"), std::string(bytes, 3) );
+
+#if SIZEOF_WCHAR_T == 2
+    // Only the first half of the surrogate pair is converted, as an invalid
+    // character.
+    memset(bytes, '!', sizeof(bytes));
+    CPPUNIT_ASSERT( utf8PUA.FromWChar(bytes, sizeof(bytes), u10000, 1) != 4 );
+    CPPUNIT_ASSERT( memcmp(bytes, "\xf0\x90\x80\x80", 4) != 0 );
+#endif // SIZEOF_WCHAR_T == 2
+}
+
 #endif // HAVE_WCHAR_H
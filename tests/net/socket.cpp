@@ -11,7 +11,7 @@
     hostname of the server to use for the tests below, if it is not set all
     tests are silently skipped (rationale: this makes it possible to run the
     test in the restricted environments (e.g. sandboxes) without any network
-    connectivity).
+    connectivity), except for those using a server on the loopback interface.
  */
 
 // For compilers that support precompilation, includes "wx/wx.h".
@@ -26,8 +26,12 @@
 
 #include "wx/socket.h"
 #include "wx/url.h"
+#include "wx/protocol/http.h"
 #include "wx/sstream.h"
 #include "wx/evtloop.h"
+#include "wx/stopwatch.h"
+#include "wx/thread.h"
+#include "wx/scopedptr.h"
 #include <memory>
 
 typedef std::auto_ptr<wxSockAddress> wxSockAddressPtr;
@@ -50,12 +54,17 @@ private:
         CPPUNIT_TEST( ReadBlock ); \
         CPPUNIT_TEST( ReadNowait ); \
         CPPUNIT_TEST( ReadWaitall ); \
-        CPPUNIT_TEST( UrlTest )
+        CPPUNIT_TEST( UrlTest ); \
+        CPPUNIT_TEST( HTTPKeepAlive ); \
+        CPPUNIT_TEST( HTTPTimeoutNotRetried ); \
+        CPPUNIT_TEST( ScatterGather )
 
     CPPUNIT_TEST_SUITE( SocketTestCase );
         ALL_SOCKET_TESTS();
         CPPUNIT_TEST( PseudoTest_SetUseEventLoop );
         ALL_SOCKET_TESTS();
+        CPPUNIT_TEST( AsyncIO );
+        CPPUNIT_TEST( AsyncBuffered );
     CPPUNIT_TEST_SUITE_END();
 
     // helper event loop class which sets itself as active only if we pass it
@@ -104,6 +113,11 @@ private:
     void ReadWaitall();
 
     void UrlTest();
+    void HTTPKeepAlive();
+    void HTTPTimeoutNotRetried();
+    void ScatterGather();
+    void AsyncIO();
+    void AsyncBuffered();
 
     static bool ms_useLoop;
 
@@ -264,4 +278,561 @@ void SocketTestCase::UrlTest()
     CPPUNIT_ASSERT_EQUAL( wxSTREAM_EOF, in->Read(out).GetLastError() );
 }
 
+#if wxUSE_THREADS
+
+namespace
+{
+
+// Minimal HTTP server used by HTTP tests: it runs in its own thread and serves
+// the given number of requests on each of the connections it accepts before
+// closing it, recording all the requests it gets. Requests for "/slow" are
+// answered only after a delay longer than the client timeout used in tests.
+class HTTPTestServerThread : public wxThread
+{
+public:
+    HTTPTestServerThread(wxSocketServer& server,
+                         const int *requestsPerConnection,
+                         size_t connections)
+        : wxThread(wxTHREAD_JOINABLE),
+          m_server(server),
+          m_requestsPerConnection(requestsPerConnection),
+          m_connections(connections)
+    {
+    }
+
+    // Can only be used after the thread terminates.
+    const wxArrayString& GetRequests() const { return m_requests; }
+
+protected:
+    virtual ExitCode Entry() wxOVERRIDE
+    {
+        for ( size_t n = 0; n < m_connections; n++ )
+        {
+            wxSocketBase * const sock = m_server.Accept();
+            if ( !sock )
+                break;
+
+            sock->SetFlags(wxSOCKET_WAITALL | wxSOCKET_BLOCK);
+            sock->SetTimeout(10);
+
+            for ( int i = 0; i < m_requestsPerConnection[n]; i++ )
+            {
+                if ( !ServeRequest(*sock, n) )
+                    break;
+            }
+
+            sock->Destroy();
+        }
+
+        return NULL;
+    }
+
+private:
+    // Read a single request and send the response to it.
+    bool ServeRequest(wxSocketBase& sock, size_t connection)
+    {
+        wxString request;
+        if ( wxProtocol::ReadLine(&sock, request) != wxPROTO_NOERR )
+            return false;
+
+        size_t contentLength = 0;
+        bool hasContentLength = false;
+        for ( ;; )
+        {
+            wxString header;
+            if ( wxProtocol::ReadLine(&sock, header) != wxPROTO_NOERR )
+                return false;
+
+            if ( header.empty() )
+                break;
+
+            wxString value;
+            if ( header.Lower().StartsWith("content-length:", &value) )
+            {
+                hasContentLength = true;
+                contentLength = wxAtoi(value);
+            }
+        }
+
+        wxCharBuffer body(contentLength);
+        if ( contentLength )
+        {
+            sock.Read(body.data(), contentLength);
+            if ( sock.LastReadCount() != contentLength )
+                return false;
+        }
+
+        // Record the connection the request was received on, the request line
+        // without the protocol version and the body, if any.
+        const wxString method = request.BeforeFirst(' ');
+        const wxString path = request.AfterFirst(' ').BeforeFirst(' ');
+        wxString record = wxString::Format("%lu %s %s",
+                                           (unsigned long)connection,
+                                           method, path);
+        if ( hasContentLength )
+            record << " " << wxString::FromAscii(body.data(), contentLength);
+        m_requests.push_back(record);
+
+        if ( path == "/slow" )
+            wxThread::Sleep(2000);
+
+        wxString response;
+        if ( path == "/chunked" )
+        {
+            response = "HTTP/1.1 200 OK\r\n"
+                       "Transfer-Encoding: chunked\r\n"
+                       "\r\n"
+                       "7\r\nchunked\r\n"
+                       "5;ext=1\r\n body\r\n"
+                       "0\r\n"
+                       "\r\n";
+        }
+        else
+        {
+            // Echo the body of the request back, if any, or just send the path.
+            const wxString
+                content = hasContentLength
+                            ? wxString::FromAscii(body.data(), contentLength)
+                            : path;
+            response.Printf("HTTP/1.1 200 OK\r\n"
+                            "Content-Length: %lu\r\n"
+                            "\r\n"
+                            "%s",
+                            (unsigned long)content.length(), content);
+        }
+
+        const wxCharBuffer buf(response.ToAscii());
+        sock.Write(buf.data(), response.length());
+
+        return sock.LastWriteCount() == response.length();
+    }
+
+    wxSocketServer& m_server;
+    const int * const m_requestsPerConnection;
+    const size_t m_connections;
+
+    wxArrayString m_requests;
+
+    wxDECLARE_NO_COPY_CLASS(HTTPTestServerThread);
+};
+
+// Get the page at the given path using the given wxHTTP object.
+wxString GetHTTPPage(wxHTTP& http, const wxString& path)
+{
+    const std::auto_ptr<wxInputStream> in(http.GetInputStream(path));
+    if ( !in.get() )
+        return "ERROR";
+
+    wxString page;
+    wxStringOutputStream out(&page);
+    if ( in->Read(out).GetLastError() != wxSTREAM_EOF )
+        return "ERROR";
+
+    return page;
+}
+
+} // anonymous namespace
+
+#endif // wxUSE_THREADS
+
+void SocketTestCase::HTTPKeepAlive()
+{
+#if wxUSE_THREADS
+    SocketTestEventLoop loop(ms_useLoop);
+
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    wxSocketServer server(addr, wxSOCKET_BLOCK | wxSOCKET_REUSEADDR);
+    CPPUNIT_ASSERT( server.IsOk() );
+
+    wxIPV4address local;
+    CPPUNIT_ASSERT( server.GetLocal(local) );
+
+    // The server closes the connection after serving the given number of
+    // requests on it, which makes the client retry the next request using a
+    // new connection if it's a GET or a PUT, but not if it's a POST.
+    static const int requestsPerConnection[] = { 2, 1, 1, 2 };
+    HTTPTestServerThread thread(server, requestsPerConnection,
+                                WXSIZEOF(requestsPerConnection));
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, thread.Run() );
+
+    wxHTTP http;
+    http.SetTimeout(10);
+    CPPUNIT_ASSERT( http.Connect(local.IPAddress(), local.Service()) );
+
+    CPPUNIT_ASSERT_EQUAL( "/first", GetHTTPPage(http, "/first") );
+    CPPUNIT_ASSERT_EQUAL( "chunked body", GetHTTPPage(http, "/chunked") );
+    CPPUNIT_ASSERT_EQUAL( "/retried", GetHTTPPage(http, "/retried") );
+
+    // POST is not idempotent, so it fails on the closed connection, but it
+    // can still be sent again explicitly.
+    http.SetPostText("text/plain", "post data");
+    CPPUNIT_ASSERT_EQUAL( "ERROR", GetHTTPPage(http, "/post") );
+    CPPUNIT_ASSERT_EQUAL( "post data", GetHTTPPage(http, "/post") );
+
+    http.SetMethod("PUT");
+    http.SetPostText("text/plain", "put data");
+    CPPUNIT_ASSERT_EQUAL( "put data", GetHTTPPage(http, "/put") );
+    http.SetMethod(wxString());
+
+    // This request must not have the headers of the retried PUT one.
+    CPPUNIT_ASSERT_EQUAL( "/last", GetHTTPPage(http, "/last") );
+
+    thread.Wait();
+
+    const wxArrayString& requests = thread.GetRequests();
+    CPPUNIT_ASSERT_EQUAL( 6, (int)requests.size() );
+    CPPUNIT_ASSERT_EQUAL( "0 GET /first", requests[0] );
+    CPPUNIT_ASSERT_EQUAL( "0 GET /chunked", requests[1] );
+    CPPUNIT_ASSERT_EQUAL( "1 GET /retried", requests[2] );
+    CPPUNIT_ASSERT_EQUAL( "2 POST /post post data", requests[3] );
+    CPPUNIT_ASSERT_EQUAL( "3 PUT /put put data", requests[4] );
+    CPPUNIT_ASSERT_EQUAL( "3 GET /last", requests[5] );
+#endif // wxUSE_THREADS
+}
+
+void SocketTestCase::HTTPTimeoutNotRetried()
+{
+#if wxUSE_THREADS
+    SocketTestEventLoop loop(ms_useLoop);
+
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    wxSocketServer server(addr, wxSOCKET_BLOCK | wxSOCKET_REUSEADDR);
+    CPPUNIT_ASSERT( server.IsOk() );
+
+    wxIPV4address local;
+    CPPUNIT_ASSERT( server.GetLocal(local) );
+
+    static const int requestsPerConnection[] = { 2, 1 };
+    HTTPTestServerThread thread(server, requestsPerConnection,
+                                WXSIZEOF(requestsPerConnection));
+    CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, thread.Run() );
+
+    wxHTTP http;
+    http.SetTimeout(1);
+    CPPUNIT_ASSERT( http.Connect(local.IPAddress(), local.Service()) );
+
+    CPPUNIT_ASSERT_EQUAL( "/first", GetHTTPPage(http, "/first") );
+
+    // The server got this request on the kept alive connection and could have
+    // processed it even if it didn't respond in time, so it must not be sent
+    // again, even though GET is idempotent.
+    CPPUNIT_ASSERT_EQUAL( "ERROR", GetHTTPPage(http, "/slow") );
+
+    http.SetTimeout(10);
+    CPPUNIT_ASSERT_EQUAL( "/last", GetHTTPPage(http, "/last") );
+
+    thread.Wait();
+
+    const wxArrayString& requests = thread.GetRequests();
+    CPPUNIT_ASSERT_EQUAL( 3, (int)requests.size() );
+    CPPUNIT_ASSERT_EQUAL( "0 GET /first", requests[0] );
+    CPPUNIT_ASSERT_EQUAL( "0 GET /slow", requests[1] );
+    CPPUNIT_ASSERT_EQUAL( "1 GET /last", requests[2] );
+#endif // wxUSE_THREADS
+}
+
+void SocketTestCase::ScatterGather()
+{
+    SocketTestEventLoop loop(ms_useLoop);
+
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    wxSocketServer server(addr, wxSOCKET_REUSEADDR | wxSOCKET_WAITALL);
+    CPPUNIT_ASSERT( server.IsOk() );
+
+    wxIPV4address local;
+    CPPUNIT_ASSERT( server.GetLocal(local) );
+    addr.Service(local.Service());
+
+    wxSocketClient client(wxSOCKET_WAITALL);
+    client.SetTimeout(10);
+    CPPUNIT_ASSERT( client.Connect(addr) );
+
+    wxScopedPtr<wxSocketBase> peer(server.Accept());
+    CPPUNIT_ASSERT( peer.get() );
+    peer->SetTimeout(10);
+
+    // Send the data in several parts, including an empty one, which are
+    // accumulated in the write buffer until it's flushed.
+    client.SetWriteBufferSize(16);
+
+    const wxSocketBuffer request[] =
+    {
+        wxSocketBuffer("abc", 3),
+        wxSocketBuffer("", 0),
+        wxSocketBuffer("defgh", 5),
+        wxSocketBuffer("ij", 2)
+    };
+
+    client.WriteV(request, WXSIZEOF(request));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, client.LastError() );
+    CPPUNIT_ASSERT_EQUAL( 10, (int)client.LastWriteCount() );
+    CPPUNIT_ASSERT( !peer->WaitForRead(0, 100) );
+    CPPUNIT_ASSERT( client.Flush() );
+
+    // Read it into differently sized buffers, again including an empty one.
+    char start[4],
+         end[6];
+    const wxSocketBuffer response[] =
+    {
+        wxSocketBuffer(start, sizeof(start)),
+        wxSocketBuffer(NULL, 0),
+        wxSocketBuffer(end, sizeof(end))
+    };
+
+    peer->ReadV(response, WXSIZEOF(response));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, peer->LastError() );
+    CPPUNIT_ASSERT_EQUAL( 10, (int)peer->LastReadCount() );
+    CPPUNIT_ASSERT( memcmp(start, "abcd", sizeof(start)) == 0 );
+    CPPUNIT_ASSERT( memcmp(end, "efghij", sizeof(end)) == 0 );
+
+    // Data not fitting into the buffer any more must be sent after the
+    // already buffered one.
+    client.Write("0123456789", 10);
+    CPPUNIT_ASSERT_EQUAL( 10, (int)client.LastWriteCount() );
+
+    const wxSocketBuffer big[] =
+    {
+        wxSocketBuffer("abcdefghij", 10),
+        wxSocketBuffer("klmnopqrst", 10)
+    };
+
+    client.WriteV(big, WXSIZEOF(big));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, client.LastError() );
+    CPPUNIT_ASSERT_EQUAL( 20, (int)client.LastWriteCount() );
+
+    char all[30];
+    peer->Read(all, sizeof(all));
+    CPPUNIT_ASSERT_EQUAL( (int)sizeof(all), (int)peer->LastReadCount() );
+    CPPUNIT_ASSERT( memcmp(all, "0123456789abcdefghijklmnopqrst",
+                           sizeof(all)) == 0 );
+
+    // A message written into the buffer must be read back as it was sent.
+    client.SetWriteBufferSize(64);
+    client.Write("xy", 2);
+    client.WriteMsg("message", 7);
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, client.LastError() );
+    CPPUNIT_ASSERT_EQUAL( 7, (int)client.LastWriteCount() );
+    CPPUNIT_ASSERT( !peer->WaitForRead(0, 100) );
+    CPPUNIT_ASSERT( client.Flush() );
+
+    char prefix[2];
+    peer->Read(prefix, sizeof(prefix));
+    CPPUNIT_ASSERT( memcmp(prefix, "xy", sizeof(prefix)) == 0 );
+
+    char msg[16];
+    peer->ReadMsg(msg, sizeof(msg));
+    CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, peer->LastError() );
+    CPPUNIT_ASSERT_EQUAL( 7, (int)peer->LastReadCount() );
+    CPPUNIT_ASSERT( memcmp(msg, "message", 7) == 0 );
+}
+
+namespace
+{
+
+// Handler used by AsyncIO test: the server sends the data it receives back
+// and the client checks that it gets the same data.
+class AsyncEchoHandler : public wxSocketAsyncHandler
+{
+public:
+    AsyncEchoHandler(wxSocketClient& client)
+        : m_client(client)
+    {
+        m_peer = NULL;
+        m_done = false;
+        memset(m_serverBuf, 0, sizeof(m_serverBuf));
+        memset(m_clientBuf, 0, sizeof(m_clientBuf));
+    }
+
+    virtual ~AsyncEchoHandler()
+    {
+        delete m_peer;
+    }
+
+    bool IsDone() const { return m_done; }
+    wxString GetReply() const { return wxString(m_clientBuf); }
+
+    virtual void OnAsyncAccept(wxSocketServer& WXUNUSED(server),
+                               wxSocketError error,
+                               wxSocketBase *socket)
+    {
+        CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, error );
+        CPPUNIT_ASSERT( socket );
+
+        m_peer = socket;
+        CPPUNIT_ASSERT( m_peer->AsyncRead(m_serverBuf, 5, this) );
+    }
+
+    virtual void OnAsyncRead(wxSocketBase& socket,
+                             wxSocketError error,
+                             wxUint32 nbytes)
+    {
+        CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, error );
+        CPPUNIT_ASSERT_EQUAL( 5, (int)nbytes );
+
+        if ( &socket == m_peer )
+            CPPUNIT_ASSERT( socket.AsyncWrite(m_serverBuf, nbytes, this) );
+        else
+            m_done = true;
+    }
+
+    virtual void OnAsyncWrite(wxSocketBase& socket,
+                              wxSocketError error,
+                              wxUint32 nbytes)
+    {
+        CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, error );
+        CPPUNIT_ASSERT_EQUAL( 5, (int)nbytes );
+
+        if ( &socket == &m_client )
+            CPPUNIT_ASSERT( socket.AsyncRead(m_clientBuf, 5, this) );
+    }
+
+private:
+    wxSocketClient& m_client;
+    wxSocketBase *m_peer;
+    bool m_done;
+
+    char m_serverBuf[6];
+    char m_clientBuf[6];
+};
+
+} // anonymous namespace
+
+void SocketTestCase::AsyncIO()
+{
+    wxEventLoop loop;
+    wxEventLoopActivator activate(&loop);
+
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    wxSocketServer server(addr, wxSOCKET_REUSEADDR | wxSOCKET_WAITALL_READ);
+    CPPUNIT_ASSERT( server.IsOk() );
+
+    wxIPV4address local;
+    CPPUNIT_ASSERT( server.GetLocal(local) );
+    addr.Service(local.Service());
+
+    wxSocketClient client(wxSOCKET_WAITALL_READ);
+    AsyncEchoHandler handler(client);
+    CPPUNIT_ASSERT( server.AsyncAccept(&handler) );
+    CPPUNIT_ASSERT( server.IsAsyncAcceptPending() );
+
+    // The data is sent once the connection is established.
+    client.Connect(addr, false);
+    CPPUNIT_ASSERT( client.AsyncWrite("Hello", 5, &handler) );
+    CPPUNIT_ASSERT( client.IsAsyncWritePending() );
+
+    wxStopWatch sw;
+    while ( !handler.IsDone() && sw.Time() < 10000 )
+        loop.DispatchTimeout(100);
+
+    CPPUNIT_ASSERT( handler.IsDone() );
+    CPPUNIT_ASSERT_EQUAL( "Hello", handler.GetReply() );
+    CPPUNIT_ASSERT( !server.IsAsyncAcceptPending() );
+    CPPUNIT_ASSERT( !client.IsAsyncReadPending() );
+    CPPUNIT_ASSERT( !client.IsAsyncWritePending() );
+}
+
+namespace
+{
+
+// Handler used by AsyncBuffered test: just remembers the results.
+class AsyncResultHandler : public wxSocketAsyncHandler
+{
+public:
+    AsyncResultHandler()
+    {
+        m_read =
+        m_written = -1;
+    }
+
+    virtual void OnAsyncRead(wxSocketBase& WXUNUSED(socket),
+                             wxSocketError error,
+                             wxUint32 nbytes)
+    {
+        CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, error );
+        m_read = nbytes;
+    }
+
+    virtual void OnAsyncWrite(wxSocketBase& WXUNUSED(socket),
+                              wxSocketError error,
+                              wxUint32 nbytes)
+    {
+        CPPUNIT_ASSERT_EQUAL( wxSOCKET_NOERROR, error );
+        m_written = nbytes;
+    }
+
+    int m_read,
+        m_written;
+};
+
+} // anonymous namespace
+
+void SocketTestCase::AsyncBuffered()
+{
+    wxEventLoop loop;
+    wxEventLoopActivator activate(&loop);
+
+    wxIPV4address addr;
+    addr.LocalHost();
+    addr.Service(0);
+
+    wxSocketServer server(addr, wxSOCKET_REUSEADDR | wxSOCKET_WAITALL);
+    CPPUNIT_ASSERT( server.IsOk() );
+
+    wxIPV4address local;
+    CPPUNIT_ASSERT( server.GetLocal(local) );
+    addr.Service(local.Service());
+
+    wxSocketClient client(wxSOCKET_WAITALL);
+    client.SetTimeout(10);
+    CPPUNIT_ASSERT( client.Connect(addr) );
+
+    wxScopedPtr<wxSocketBase> peer(server.Accept());
+    CPPUNIT_ASSERT( peer.get() );
+    peer->SetTimeout(10);
+
+    // The buffered data must be sent before the asynchronously written one.
+    client.SetWriteBufferSize(64);
+    client.Write("He", 2);
+
+    AsyncResultHandler handler;
+    CPPUNIT_ASSERT( client.AsyncWrite("llo", 3, &handler) );
+
+    // Reading the pushed back data doesn't need to wait for the socket, but
+    // must still complete from the event loop, as the write does.
+    peer->Unread("xy", 2);
+    char pushback[2];
+    CPPUNIT_ASSERT( peer->AsyncRead(pushback, sizeof(pushback), &handler) );
+    CPPUNIT_ASSERT( peer->IsAsyncReadPending() );
+    CPPUNIT_ASSERT_EQUAL( -1, handler.m_read );
+    CPPUNIT_ASSERT_EQUAL( -1, handler.m_written );
+
+    wxStopWatch sw;
+    while ( (handler.m_read == -1 || handler.m_written == -1) &&
+                sw.Time() < 10000 )
+        loop.DispatchTimeout(100);
+
+    CPPUNIT_ASSERT_EQUAL( 2, handler.m_read );
+    CPPUNIT_ASSERT( memcmp(pushback, "xy", sizeof(pushback)) == 0 );
+    CPPUNIT_ASSERT_EQUAL( 3, handler.m_written );
+    CPPUNIT_ASSERT( !client.IsAsyncWritePending() );
+    CPPUNIT_ASSERT( client.Flush() );
+
+    char data[5];
+    peer->Read(data, sizeof(data));
+    CPPUNIT_ASSERT_EQUAL( (int)sizeof(data), (int)peer->LastReadCount() );
+    CPPUNIT_ASSERT( memcmp(data, "Hello", sizeof(data)) == 0 );
+}
+
 #endif // wxUSE_SOCKETS
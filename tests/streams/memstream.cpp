@@ -20,6 +20,8 @@
 #endif
 
 #include "wx/mstream.h"
+#include "wx/mappedfile.h"
+#include "wx/wfstream.h"
 
 #include "bstream.h"
 
@@ -58,12 +60,16 @@ public:
         // Other test specific for Memory stream test case.
         CPPUNIT_TEST(Ctor_InFromIn);
         CPPUNIT_TEST(Ctor_InFromOut);
+        CPPUNIT_TEST(GetCurrentData);
+        CPPUNIT_TEST(Mapped);
     CPPUNIT_TEST_SUITE_END();
 
 protected:
     // Add own test here.
     void Ctor_InFromIn();
     void Ctor_InFromOut();
+    void GetCurrentData();
+    void Mapped();
 
 private:
     const char *GetDataBuffer();
@@ -156,6 +162,76 @@ void memStream::Ctor_InFromOut()
     delete pMemOutStream;
 }
 
+void memStream::GetCurrentData()
+{
+    wxMemoryInputStream in(GetDataBuffer(), DATABUFFER_SIZE);
+
+    size_t len = 0;
+    CPPUNIT_ASSERT( in.GetCurrentData(&len) == GetDataBuffer() );
+    CPPUNIT_ASSERT_EQUAL( (size_t)DATABUFFER_SIZE, len );
+
+    char buf[10];
+    in.Read(buf, WXSIZEOF(buf));
+    CPPUNIT_ASSERT( in.GetCurrentData(&len) == GetDataBuffer() + 10 );
+    CPPUNIT_ASSERT_EQUAL( (size_t)DATABUFFER_SIZE - 10, len );
+
+    CPPUNIT_ASSERT( in.SeekI(len - 1, wxFromCurrent) != wxInvalidOffset );
+    CPPUNIT_ASSERT( in.GetCurrentData(&len) != NULL );
+    CPPUNIT_ASSERT_EQUAL( 1, (int)len );
+
+    // The data put back into the stream can't be accessed directly.
+    in.Ungetch('x');
+    CPPUNIT_ASSERT( in.GetCurrentData(&len) == NULL );
+    CPPUNIT_ASSERT_EQUAL( 'x', (char)in.GetC() );
+    CPPUNIT_ASSERT( in.GetCurrentData(&len) != NULL );
+}
+
+void memStream::Mapped()
+{
+    static const char *FILENAME_MAPPED = "mappedstream.test";
+
+    {
+        wxFileOutputStream out(FILENAME_MAPPED);
+        out.Write(GetDataBuffer(), DATABUFFER_SIZE);
+    }
+
+    {
+        wxMappedInputStream in(FILENAME_MAPPED);
+        CPPUNIT_ASSERT( in.IsOk() );
+        CPPUNIT_ASSERT_EQUAL( DATABUFFER_SIZE, (int)in.GetLength() );
+
+        size_t len = 0;
+        const void * const data = in.GetCurrentData(&len);
+        CPPUNIT_ASSERT_EQUAL( (size_t)DATABUFFER_SIZE, len );
+        CPPUNIT_ASSERT( memcmp(data, GetDataBuffer(), len) == 0 );
+
+        char buf[DATABUFFER_SIZE];
+        CPPUNIT_ASSERT( in.ReadAll(buf, DATABUFFER_SIZE) );
+        CPPUNIT_ASSERT( memcmp(buf, GetDataBuffer(), DATABUFFER_SIZE) == 0 );
+        CPPUNIT_ASSERT_EQUAL( wxEOF, in.GetC() );
+    }
+
+    // Empty files can be mapped too.
+    {
+        wxFileOutputStream out(FILENAME_MAPPED);
+    }
+
+    {
+        wxMappedInputStream in(FILENAME_MAPPED);
+        CPPUNIT_ASSERT( in.IsOk() );
+        CPPUNIT_ASSERT_EQUAL( 0, (int)in.GetLength() );
+        CPPUNIT_ASSERT_EQUAL( wxEOF, in.GetC() );
+    }
+
+    wxRemoveFile(FILENAME_MAPPED);
+
+    {
+        wxLogNull noLog;
+        wxMappedInputStream in(FILENAME_MAPPED);
+        CPPUNIT_ASSERT( !in.IsOk() );
+    }
+}
+
 // Register the stream sub suite, by using some stream helper macro.
 // Note: Don't forget to connect it to the base suite (See: bstream.cpp => StreamCase::suite())
 STREAM_TEST_SUBSUITE_NAMED_REGISTRATION(memStream)
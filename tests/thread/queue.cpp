@@ -23,6 +23,7 @@
 #endif // WX_PRECOMP
 
 #include "wx/msgqueue.h"
+#include "wx/vector.h"
 
 // ----------------------------------------------------------------------------
 // test class
@@ -72,13 +73,42 @@ private:
 
     WX_DEFINE_ARRAY_PTR(MyThread *, ArrayThread);
 
+    typedef wxLockFreeMessageQueue<int> LockFreeQueue;
+
+    // Thread posting the messages from the given range to the lock-free queue
+    // or receiving the given number of messages from it and summing them up.
+    class LockFreeThread : public wxThread
+    {
+    public:
+        LockFreeThread(LockFreeQueue& queue, bool post, int first, int count)
+           : wxThread(wxTHREAD_JOINABLE),
+             m_queue(queue), m_post(post), m_first(first), m_count(count),
+             m_sum(0)
+        {}
+
+        virtual void *Entry();
+
+        wxLongLong_t GetSum() const { return m_sum; }
+
+    private:
+        LockFreeQueue& m_queue;
+        const bool     m_post;
+        const int      m_first,
+                       m_count;
+        wxLongLong_t   m_sum;
+    };
+
     CPPUNIT_TEST_SUITE( QueueTestCase );
         CPPUNIT_TEST( TestReceive );
         CPPUNIT_TEST( TestReceiveTimeout );
+        CPPUNIT_TEST( TestLockFreeFull );
+        CPPUNIT_TEST( TestLockFreeMultiple );
     CPPUNIT_TEST_SUITE_END();
 
     void TestReceive();
     void TestReceiveTimeout();
+    void TestLockFreeFull();
+    void TestLockFreeMultiple();
 
     DECLARE_NO_COPY_CLASS(QueueTestCase)
 };
@@ -212,3 +242,122 @@ void *QueueTestCase::MyThread::Entry()
 
     return (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR;
 }
+
+// check that the lock-free queue preserves the messages order and correctly
+// detects when it's full or empty
+void QueueTestCase::TestLockFreeFull()
+{
+    LockFreeQueue queue(5);
+    CPPUNIT_ASSERT( queue.IsOk() );
+    CPPUNIT_ASSERT_EQUAL( 8, (int)queue.GetCapacity() );
+
+    int msg = -1;
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(0, msg) );
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(10, msg) );
+
+    // do it several times to wrap around the end of the buffer
+    for ( int pass = 0; pass < 3; pass++ )
+    {
+        int i;
+        for ( i = 0; i < 8; i++ )
+            CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Post(i) );
+
+        CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_FULL, queue.Post(8) );
+
+        for ( i = 0; i < 8; i++ )
+        {
+            CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Receive(msg) );
+            CPPUNIT_ASSERT_EQUAL( i, msg );
+        }
+
+        CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(0, msg) );
+    }
+
+    queue.Post(17);
+    queue.Post(42);
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_NO_ERROR, queue.Clear() );
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(0, msg) );
+}
+
+// this function creates several threads posting messages to the same small
+// lock-free queue and several other threads reading from it and checks that
+// all messages are received exactly once
+void QueueTestCase::TestLockFreeMultiple()
+{
+    const int msgCount = 10000;
+    const int producersCount = 4;
+    const int consumersCount = 3;
+
+    LockFreeQueue queue(16);
+
+    wxVector<LockFreeThread*> threads;
+    int i;
+    for ( i = 0; i < producersCount; i++ )
+    {
+        threads.push_back(new LockFreeThread(queue, true,
+                                             i*msgCount, msgCount));
+    }
+
+    // make the first consumer receive all the remaining messages
+    const int perConsumer = (producersCount*msgCount) / consumersCount;
+    for ( i = 0; i < consumersCount; i++ )
+    {
+        const int count = i == 0
+            ? producersCount*msgCount - (consumersCount - 1)*perConsumer
+            : perConsumer;
+        threads.push_back(new LockFreeThread(queue, false, 0, count));
+    }
+
+    for ( i = 0; i < (int)threads.size(); i++ )
+    {
+        CPPUNIT_ASSERT_EQUAL( wxTHREAD_NO_ERROR, threads[i]->Create() );
+        threads[i]->Run();
+    }
+
+    wxLongLong_t sumPosted = 0,
+                 sumReceived = 0;
+    for ( i = 0; i < (int)threads.size(); i++ )
+    {
+        LockFreeThread* const thread = threads[i];
+
+        wxThread::ExitCode code = thread->Wait();
+        CPPUNIT_ASSERT_EQUAL( (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR, code );
+
+        if ( i < producersCount )
+            sumPosted += thread->GetSum();
+        else
+            sumReceived += thread->GetSum();
+
+        delete thread;
+    }
+
+    CPPUNIT_ASSERT_EQUAL( sumPosted, sumReceived );
+
+    int msg;
+    CPPUNIT_ASSERT_EQUAL( wxMSGQUEUE_TIMEOUT, queue.ReceiveTimeout(0, msg) );
+}
+
+void *QueueTestCase::LockFreeThread::Entry()
+{
+    for ( int n = 0; n < m_count; n++ )
+    {
+        wxMessageQueueError result;
+        int msg = m_first + n;
+        if ( m_post )
+        {
+            while ( (result = m_queue.Post(msg)) == wxMSGQUEUE_FULL )
+                wxThread::Yield();
+        }
+        else
+        {
+            result = m_queue.ReceiveTimeout(10000, msg);
+        }
+
+        if ( result != wxMSGQUEUE_NO_ERROR )
+            return (wxThread::ExitCode)result;
+
+        m_sum += msg;
+    }
+
+    return (wxThread::ExitCode)wxMSGQUEUE_NO_ERROR;
+}
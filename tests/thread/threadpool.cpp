@@ -0,0 +1,255 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        tests/thread/threadpool.cpp
+// Purpose:     wxThreadPool unit test
+// Author:      wxWidgets team
+// Created:     2016-03-14
+// Copyright:   (c) 2016 wxWidgets team
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// ----------------------------------------------------------------------------
+// headers
+// ----------------------------------------------------------------------------
+
+#include "testprec.h"
+
+#ifdef __BORLANDC__
+    #pragma hdrstop
+#endif
+
+#ifndef WX_PRECOMP
+    #include "wx/app.h"
+#endif // WX_PRECOMP
+
+#include "wx/threadpool.h"
+
+// ----------------------------------------------------------------------------
+// helper classes
+// ----------------------------------------------------------------------------
+
+namespace
+{
+
+// Task simply incrementing the given counter.
+class CountingTask : public wxThreadPoolTask
+{
+public:
+    explicit CountingTask(wxAtomicInt& counter) : m_counter(counter) { }
+
+protected:
+    virtual void Execute() wxOVERRIDE
+    {
+        wxAtomicInc(m_counter);
+    }
+
+private:
+    wxAtomicInt& m_counter;
+};
+
+// Task submitting several other tasks to the same pool and waiting for them.
+class NestedTask : public wxThreadPoolTask
+{
+public:
+    NestedTask(wxThreadPool& pool, wxAtomicInt& counter)
+        : m_pool(pool),
+          m_counter(counter)
+    {
+    }
+
+protected:
+    virtual void Execute() wxOVERRIDE
+    {
+        wxThreadPoolTask* tasks[10];
+
+        unsigned n;
+        for ( n = 0; n < WXSIZEOF(tasks); n++ )
+        {
+            tasks[n] = new CountingTask(m_counter);
+            m_pool.Submit(tasks[n]);
+        }
+
+        for ( n = 0; n < WXSIZEOF(tasks); n++ )
+        {
+            tasks[n]->Wait();
+            tasks[n]->DecRef();
+        }
+    }
+
+private:
+    wxThreadPool& m_pool;
+    wxAtomicInt& m_counter;
+};
+
+// Body of ParallelFor() loop incrementing all the elements of an array.
+class IncrementBody : public wxParallelForBody
+{
+public:
+    explicit IncrementBody(wxVector<int>& values) : m_values(values) { }
+
+    virtual void Process(int first, int last) wxOVERRIDE
+    {
+        for ( int n = first; n < last; n++ )
+            m_values[n]++;
+    }
+
+private:
+    wxVector<int>& m_values;
+};
+
+// Handler counting the task completion notifications.
+class NotifyHandler : public wxEvtHandler
+{
+public:
+    NotifyHandler() : m_count(0)
+    {
+        Bind(wxEVT_THREAD, &NotifyHandler::OnThread, this);
+    }
+
+    int GetCount() const { return m_count; }
+
+private:
+    void OnThread(wxThreadEvent& event)
+    {
+        if ( event.GetId() == 17 )
+            m_count++;
+    }
+
+    int m_count;
+};
+
+} // anonymous namespace
+
+// ----------------------------------------------------------------------------
+// test class
+// ----------------------------------------------------------------------------
+
+class ThreadPoolTestCase : public CppUnit::TestCase
+{
+public:
+    ThreadPoolTestCase() { }
+
+private:
+    CPPUNIT_TEST_SUITE( ThreadPoolTestCase );
+        CPPUNIT_TEST( Submit );
+        CPPUNIT_TEST( Nested );
+        CPPUNIT_TEST( ParallelFor );
+        CPPUNIT_TEST( Notify );
+    CPPUNIT_TEST_SUITE_END();
+
+    void Submit();
+    void Nested();
+    void ParallelFor();
+    void Notify();
+
+    wxDECLARE_NO_COPY_CLASS(ThreadPoolTestCase);
+};
+
+// register in the unnamed registry so that these tests are run by default
+CPPUNIT_TEST_SUITE_REGISTRATION( ThreadPoolTestCase );
+
+// also include in its own registry so that these tests can be run alone
+CPPUNIT_TEST_SUITE_NAMED_REGISTRATION( ThreadPoolTestCase, "ThreadPoolTestCase" );
+
+void ThreadPoolTestCase::Submit()
+{
+    wxAtomicInt counter = 0;
+
+    {
+        wxThreadPool pool(4);
+        CPPUNIT_ASSERT( pool.IsOk() );
+        CPPUNIT_ASSERT_EQUAL( 4, pool.GetThreadCount() );
+
+        CountingTask* const task = new CountingTask(counter);
+        CPPUNIT_ASSERT( pool.Submit(task) );
+        task->Wait();
+        CPPUNIT_ASSERT( task->IsDone() );
+        CPPUNIT_ASSERT_EQUAL( 1, (int)counter );
+        task->DecRef();
+
+        // Submit more tasks without waiting for them: the pool dtor must
+        // still execute all of them.
+        for ( int n = 0; n < 1000; n++ )
+        {
+            CountingTask* const t = new CountingTask(counter);
+            pool.Submit(t);
+            t->DecRef();
+        }
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 1001, (int)counter );
+}
+
+void ThreadPoolTestCase::Nested()
+{
+    wxAtomicInt counter = 0;
+
+    // Use a single thread to check that waiting for the tasks submitted from
+    // inside another task doesn't deadlock.
+    wxThreadPool pool(1);
+
+    NestedTask* tasks[3];
+
+    unsigned n;
+    for ( n = 0; n < WXSIZEOF(tasks); n++ )
+    {
+        tasks[n] = new NestedTask(pool, counter);
+        pool.Submit(tasks[n]);
+    }
+
+    for ( n = 0; n < WXSIZEOF(tasks); n++ )
+    {
+        tasks[n]->Wait();
+        tasks[n]->DecRef();
+    }
+
+    CPPUNIT_ASSERT_EQUAL( 30, (int)counter );
+}
+
+void ThreadPoolTestCase::ParallelFor()
+{
+    wxThreadPool pool(3);
+
+    wxVector<int> values(1001);
+    IncrementBody body(values);
+
+    // Test with the default number of chunks and with more chunks than
+    // threads and an uneven division.
+    pool.ParallelFor(0, values.size(), body);
+    pool.ParallelFor(0, values.size(), body, 7);
+
+    // And also with a range not starting at 0.
+    pool.ParallelFor(1, values.size() - 1, body, 13);
+
+    for ( size_t n = 0; n < values.size(); n++ )
+    {
+        const int expected = n == 0 || n == values.size() - 1 ? 2 : 3;
+        CPPUNIT_ASSERT_EQUAL( expected, values[n] );
+    }
+
+    // Empty range must not do anything.
+    pool.ParallelFor(5, 5, body);
+    CPPUNIT_ASSERT_EQUAL( 3, values[5] );
+}
+
+void ThreadPoolTestCase::Notify()
+{
+    wxAtomicInt counter = 0;
+    NotifyHandler handler;
+
+    {
+        wxThreadPool pool(2);
+
+        for ( int n = 0; n < 5; n++ )
+        {
+            CountingTask* const task = new CountingTask(counter);
+            task->SetNotifyHandler(&handler, 17);
+            pool.Submit(task);
+            task->DecRef();
+        }
+    }
+
+    wxTheApp->ProcessPendingEvents();
+
+    CPPUNIT_ASSERT_EQUAL( 5, (int)counter );
+    CPPUNIT_ASSERT_EQUAL( 5, handler.GetCount() );
+}
@@ -82,6 +82,9 @@ private:
         CPPUNIT_TEST( AppendToProlog );
         CPPUNIT_TEST( SetRoot );
         CPPUNIT_TEST( CopyNode );
+        CPPUNIT_TEST( LongText );
+        CPPUNIT_TEST( Reader );
+        CPPUNIT_TEST( ReaderError );
     CPPUNIT_TEST_SUITE_END();
 
     void InsertChild();
@@ -94,6 +97,9 @@ private:
     void AppendToProlog();
     void SetRoot();
     void CopyNode();
+    void LongText();
+    void Reader();
+    void ReaderError();
 
     DECLARE_NO_COPY_CLASS(XmlTestCase)
 };
@@ -507,3 +513,125 @@ void XmlTestCase::CopyNode()
     ;
     CPPUNIT_ASSERT_EQUAL( xmlTextResult, sos.GetString() );
 }
+
+void XmlTestCase::LongText()
+{
+    // Text spanning many lines and several input buffers must be read
+    // entirely into a single node.
+    wxString text;
+    for ( int n = 0; n < 10000; n++ )
+        text += wxString::Format("line %d\n", n);
+
+    wxStringInputStream sis("<root>" + text + "<![CDATA[" + text + "]]></root>");
+    wxXmlDocument doc;
+    CPPUNIT_ASSERT( doc.Load(sis) );
+
+    wxXmlNode *n = doc.GetRoot()->GetChildren();
+    CPPUNIT_ASSERT( n );
+    CPPUNIT_ASSERT_EQUAL( wxXML_TEXT_NODE, n->GetType() );
+    CPPUNIT_ASSERT( n->GetContent() == text );
+
+    n = n->GetNext();
+    CPPUNIT_ASSERT( n );
+    CPPUNIT_ASSERT_EQUAL( wxXML_CDATA_SECTION_NODE, n->GetType() );
+    CPPUNIT_ASSERT( n->GetContent() == text );
+    CPPUNIT_ASSERT( !n->GetNext() );
+}
+
+void XmlTestCase::Reader()
+{
+    wxString text;
+    for ( int n = 0; n < 10000; n++ )
+        text += wxString::Format("line %d\n", n);
+
+    const wxString xmlText =
+        "<?xml version=\"1.0\" encoding=\"windows-1252\"?>\n"
+        "<root a=\"1\" b=\"two\">\n"
+        "  <!-- comment -->\n"
+        "  <?robot index=\"no\"?>\n"
+        "  <child>" + text + "</child>\n"
+        "  <empty/>\n"
+        "  <![CDATA[ <data> ]]>\n"
+        "</root>\n";
+
+    wxStringInputStream sis(xmlText);
+    wxXmlReader reader(sis);
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_START_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( "root", reader.GetName() );
+    CPPUNIT_ASSERT_EQUAL( 0, reader.GetDepth() );
+    CPPUNIT_ASSERT_EQUAL( 2, reader.GetLineNumber() );
+    CPPUNIT_ASSERT_EQUAL( 2, (int)reader.GetAttributeCount() );
+    CPPUNIT_ASSERT_EQUAL( "a", reader.GetAttributeName(0) );
+    CPPUNIT_ASSERT_EQUAL( "1", reader.GetAttributeValue(0) );
+    CPPUNIT_ASSERT_EQUAL( "two", reader.GetAttribute("b") );
+    CPPUNIT_ASSERT( !reader.HasAttribute("c") );
+    CPPUNIT_ASSERT_EQUAL( "1.0", reader.GetVersion() );
+    CPPUNIT_ASSERT_EQUAL( "windows-1252", reader.GetFileEncoding() );
+
+    // White space only text is skipped by default.
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_COMMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( " comment ", reader.GetContent() );
+    CPPUNIT_ASSERT_EQUAL( 1, reader.GetDepth() );
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_PI, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( "robot", reader.GetName() );
+    CPPUNIT_ASSERT_EQUAL( "index=\"no\"", reader.GetContent() );
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_START_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( "child", reader.GetName() );
+    CPPUNIT_ASSERT_EQUAL( 0, (int)reader.GetAttributeCount() );
+
+    // Long text must be returned as a single item.
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_TEXT, reader.Next() );
+    CPPUNIT_ASSERT( reader.GetContent() == text );
+    CPPUNIT_ASSERT_EQUAL( 2, reader.GetDepth() );
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_END_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( "child", reader.GetName() );
+    CPPUNIT_ASSERT_EQUAL( 1, reader.GetDepth() );
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_START_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( "empty", reader.GetName() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_END_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( "empty", reader.GetName() );
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_CDATA, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( " <data> ", reader.GetContent() );
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_END_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( "root", reader.GetName() );
+    CPPUNIT_ASSERT_EQUAL( 0, reader.GetDepth() );
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_NONE, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_NONE, reader.Next() );
+    CPPUNIT_ASSERT( reader.IsOk() );
+
+
+    // Check that white space is preserved if requested.
+    wxStringInputStream sis2("<root> <a/>\n</root>");
+    wxXmlReader reader2(sis2, "UTF-8", wxXMLDOC_KEEP_WHITESPACE_NODES);
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_START_ELEMENT, reader2.Next() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_TEXT, reader2.Next() );
+    CPPUNIT_ASSERT_EQUAL( " ", reader2.GetContent() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_START_ELEMENT, reader2.Next() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_END_ELEMENT, reader2.Next() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_TEXT, reader2.Next() );
+    CPPUNIT_ASSERT_EQUAL( "\n", reader2.GetContent() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_END_ELEMENT, reader2.Next() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_NONE, reader2.Next() );
+}
+
+void XmlTestCase::ReaderError()
+{
+    wxStringInputStream sis("<root><a></b></root>");
+    wxXmlReader reader(sis);
+
+    wxLogNull noLog;
+
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_START_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_START_ELEMENT, reader.Next() );
+    CPPUNIT_ASSERT_EQUAL( wxXML_READER_NONE, reader.Next() );
+    CPPUNIT_ASSERT( !reader.IsOk() );
+}